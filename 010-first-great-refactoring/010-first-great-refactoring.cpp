@@ -171,6 +171,7 @@ void OpenGLWindow010::releaseScene()
 	house.reset();
 	snowCoveredPlainGround.reset();
 	hud.reset();
+	static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 } // namespace tutorial010
@@ -5,6 +5,7 @@
 #include "HUD010.h"
 #include "../common_classes/textureManager.h"
 #include "../common_classes/matrixManager.h"
+#include "../common_classes/glStateCache.h"
 
 const std::string HUD010::CHRISTMAS_TREE_TEXTURE_KEY = "christmas_tree";
 const std::string HUD010::SNOWFLAKE_TREE_TEXTURE_KEY = "snowflake";
@@ -38,11 +39,12 @@ void HUD010::renderHUD() const
     shaderProgram.useProgram();
     sampler.bind();
 
-    glDisable(GL_DEPTH_TEST);
+    auto& stateCache = GLStateCache::getInstance();
+    stateCache.disable(GL_DEPTH_TEST);
     glDepthMask(0);
     if (_blendingEnabled)
     {
-        glEnable(GL_BLEND);
+        stateCache.enable(GL_BLEND);
         glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
     }
 
@@ -60,11 +62,11 @@ void HUD010::renderHUD() const
     renderTexturedQuad2D(0, 0, snowflakeTexture.getWidth(), snowflakeTexture.getHeight(), true);
 
     if (_blendingEnabled) {
-        glDisable(GL_BLEND);
+        stateCache.disable(GL_BLEND);
     }
 
     glDepthMask(1);
-    glEnable(GL_DEPTH_TEST);
+    stateCache.enable(GL_DEPTH_TEST);
 }
 
 const Texture& HUD010::getChristmasTreeTexture() const
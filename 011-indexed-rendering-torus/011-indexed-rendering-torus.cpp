@@ -172,6 +172,7 @@ void OpenGLWindow011::releaseScene()
 	pyramid.reset();
 	torus.reset();
 	plainGround.reset();
+	static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 } // namespace tutorial011
@@ -8,6 +8,7 @@
 // Project
 #include "012-freetype-fonts-pt1.h"
 #include "HUD012.h"
+#include "textStreamingBenchmark.h"
 
 #include "../common_classes/flyingCamera.h"
 
@@ -32,6 +33,9 @@ std::unique_ptr<static_meshes_3D::Pyramid> pyramid;
 std::unique_ptr<static_meshes_3D::Torus> torus;
 std::unique_ptr<static_meshes_3D::PlainGround> plainGround;
 std::unique_ptr<HUD012> hud;
+TextStreamingBenchmark textStreamingBenchmark; // Benchmark comparing re-specified and streamed text quads
+bool isStreamingBeforeBenchmark = true; // Text streaming flag to restore after the benchmark
+bool isVerticalSynchronizationBeforeBenchmark = false; // Vertical synchronization to restore after the benchmark
 
 float rotationAngleRad = 0.0f;
 std::vector<glm::vec3> objectPositions
@@ -137,7 +141,8 @@ void OpenGLWindow012::renderScene()
 	}
 
 	// Render HUD
-	hud->renderHUD();
+	const auto isBenchmarkRunning = textStreamingBenchmark.isRunning();
+	hud->renderHUD(isBenchmarkRunning, isBenchmarkRunning ? textStreamingBenchmark.getNumLines() : 0);
 }
 
 void OpenGLWindow012::updateScene()
@@ -160,6 +165,32 @@ void OpenGLWindow012::updateScene()
         [this](const glm::i32vec2& pos) {glfwSetCursorPos(this->getWindow(), pos.x, pos.y); },
         [this](float f) {return this->sof(f); });
 
+    if (keyPressedOnce(GLFW_KEY_T) && !textStreamingBenchmark.isRunning()) {
+        FreeTypeFont::setStreamingEnabled(!FreeTypeFont::isStreamingEnabled());
+    }
+
+    if (keyPressedOnce(GLFW_KEY_B) && !textStreamingBenchmark.isRunning())
+    {
+        // Remember the setup and measure without vertical synchronization, it would cap the frame times
+        isStreamingBeforeBenchmark = FreeTypeFont::isStreamingEnabled();
+        isVerticalSynchronizationBeforeBenchmark = isVerticalSynchronizationEnabled();
+        setVerticalSynchronization(false);
+        textStreamingBenchmark.start();
+        FreeTypeFont::setStreamingEnabled(textStreamingBenchmark.isUsingStreaming());
+    }
+    else if (textStreamingBenchmark.isRunning())
+    {
+        textStreamingBenchmark.update(getTimeDelta());
+        if (textStreamingBenchmark.isRunning()) {
+            FreeTypeFont::setStreamingEnabled(textStreamingBenchmark.isUsingStreaming());
+        }
+        else
+        {
+            FreeTypeFont::setStreamingEnabled(isStreamingBeforeBenchmark);
+            setVerticalSynchronization(isVerticalSynchronizationBeforeBenchmark);
+        }
+    }
+
     // Update rotation angle
     rotationAngleRad += sof(glm::radians(135.0f));
 }
@@ -176,6 +207,7 @@ void OpenGLWindow012::releaseScene()
 	pyramid.reset();
 	torus.reset();
 	plainGround.reset();
+	static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 } // namespace tutorial012
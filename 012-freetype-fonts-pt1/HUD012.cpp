@@ -17,10 +17,19 @@ HUD012::HUD012(const OpenGLWindow& window)
     });
 }
 
-void HUD012::renderHUD() const
+void HUD012::renderHUD(const bool isBenchmarkRunning, const int numBenchmarkLines) const
 {
+    FreeTypeFont::PrintBatch printBatch;
+
     printBuilder().print(10, 10, "FPS: {}", _window.getFPS());
     printBuilder().print(10, 40, "Vertical Synchronization: {} (Press F3 to toggle)", _window.isVerticalSynchronizationEnabled() ? "On" : "Off");
+    printBuilder().print(10, 70, "Text upload: {} (Press 'T' to toggle)", FreeTypeFont::isStreamingEnabled() ? "streaming" : "re-specification");
+    printBuilder().print(10, 100, "Text streaming benchmark: {}", isBenchmarkRunning ? "running, results will be printed to console" : "press 'B' to run");
+
+    // Benchmark lines are printed one by one, so that every line is a separate upload
+    for (auto i = 0; i < numBenchmarkLines; i++) {
+        printBuilder().print(10, 130 + (i % 20) * 30, "Benchmark line {}: The quick brown fox jumps over the lazy dog 0123456789", i);
+    }
 
     printBuilder()
         .fromRight()
@@ -18,7 +18,8 @@ public:
     /**
      * Renders HUD.
      */
-    void renderHUD() const override;
+    void renderHUD() const override { renderHUD(false, 0); }
+    void renderHUD(bool isBenchmarkRunning, int numBenchmarkLines) const;
 };
 
 } // namespace tutorial012
@@ -0,0 +1,92 @@
+// STL
+#include <iostream>
+#include <iomanip>
+
+// Project
+#include "textStreamingBenchmark.h"
+
+namespace opengl4_mbsoftworks {
+namespace tutorial012 {
+
+const int TextStreamingBenchmark::WARMUP_FRAMES = 30;
+const int TextStreamingBenchmark::MEASURED_FRAMES = 240;
+const std::vector<int> TextStreamingBenchmark::LINE_COUNTS{ 10, 25, 50, 100 };
+
+void TextStreamingBenchmark::start()
+{
+    isRunning_ = true;
+    lineCountIndex_ = 0;
+    useStreaming_ = false;
+    frameIndex_ = 0;
+    measuredTime_ = 0.0;
+    respecificationFrameTimes_.assign(LINE_COUNTS.size(), 0.0);
+    streamingFrameTimes_.assign(LINE_COUNTS.size(), 0.0);
+    std::cout << "Starting text streaming benchmark, this will take a while..." << std::endl;
+}
+
+bool TextStreamingBenchmark::isRunning() const
+{
+    return isRunning_;
+}
+
+void TextStreamingBenchmark::update(const double frameTime)
+{
+    if (!isRunning_) {
+        return;
+    }
+
+    // Warmup frames are not measured, they let the frame times settle after switching the upload mode
+    if (frameIndex_++ >= WARMUP_FRAMES) {
+        measuredTime_ += frameTime;
+    }
+
+    if (frameIndex_ < WARMUP_FRAMES + MEASURED_FRAMES) {
+        return;
+    }
+
+    auto& frameTimes = useStreaming_ ? streamingFrameTimes_ : respecificationFrameTimes_;
+    frameTimes[lineCountIndex_] = measuredTime_ * 1000.0 / MEASURED_FRAMES;
+    frameIndex_ = 0;
+    measuredTime_ = 0.0;
+
+    // Every lines count is measured with re-specification first and then with streaming
+    useStreaming_ = !useStreaming_;
+    if (!useStreaming_ && ++lineCountIndex_ >= LINE_COUNTS.size())
+    {
+        isRunning_ = false;
+        lineCountIndex_ = 0;
+        printResults();
+    }
+}
+
+int TextStreamingBenchmark::getNumLines() const
+{
+    return LINE_COUNTS[lineCountIndex_];
+}
+
+bool TextStreamingBenchmark::isUsingStreaming() const
+{
+    return useStreaming_;
+}
+
+void TextStreamingBenchmark::printResults() const
+{
+    const auto previousFlags = std::cout.flags();
+    const auto previousPrecision = std::cout.precision();
+    std::cout << "Text streaming benchmark results (average frame time in milliseconds):" << std::endl;
+    std::cout << std::setw(8) << "Lines" << std::setw(12) << "Respecify" << std::setw(12) << "Stream" << std::setw(12) << "Speedup" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < LINE_COUNTS.size(); i++)
+    {
+        const auto respecificationTime = respecificationFrameTimes_[i];
+        const auto streamingTime = streamingFrameTimes_[i];
+        std::cout << std::setw(8) << LINE_COUNTS[i] << std::setw(12) << respecificationTime << std::setw(12) << streamingTime
+            << std::setw(11) << (streamingTime > 0.0 ? respecificationTime / streamingTime : 0.0) << "x" << std::endl;
+    }
+
+    std::cout.flags(previousFlags);
+    std::cout.precision(previousPrecision);
+}
+
+} // namespace tutorial012
+} // namespace opengl4_mbsoftworks
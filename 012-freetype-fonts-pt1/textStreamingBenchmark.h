@@ -0,0 +1,64 @@
+#pragma once
+
+// STL
+#include <vector>
+
+namespace opengl4_mbsoftworks {
+namespace tutorial012 {
+
+/**
+ * Benchmark, that sweeps number of printed text lines and for every count measures average frame time
+ * with text quads re-specified with glBufferData for every print and with text quads streamed into
+ * persistently mapped ring buffer. Results are printed to standard output once the benchmark finishes.
+ */
+class TextStreamingBenchmark
+{
+public:
+    static const int WARMUP_FRAMES; // Frames rendered before measuring (so that frame times settle)
+    static const int MEASURED_FRAMES; // Frames measured for every lines count and upload mode
+    static const std::vector<int> LINE_COUNTS; // Numbers of text lines printed per frame, that are measured
+
+    /**
+     * Starts (or restarts) the benchmark from the lowest lines count.
+     */
+    void start();
+
+    /**
+     * Checks, if the benchmark is running.
+     */
+    bool isRunning() const;
+
+    /**
+     * Advances the benchmark by one frame. Once the benchmark finishes, results are printed.
+     *
+     * @param frameTime  Duration of the last frame in seconds
+     */
+    void update(double frameTime);
+
+    /**
+     * Gets number of text lines, that should be printed in the current benchmark step.
+     */
+    int getNumLines() const;
+
+    /**
+     * Checks, if text quads should be streamed in the current benchmark step.
+     */
+    bool isUsingStreaming() const;
+
+private:
+    /**
+     * Prints results of the benchmark as a table to standard output.
+     */
+    void printResults() const;
+
+    bool isRunning_{ false }; // Flag telling, whether the benchmark is running
+    size_t lineCountIndex_{ 0 }; // Index of lines count in the current step
+    bool useStreaming_{ false }; // Whether text quads are streamed in the current step
+    int frameIndex_{ 0 }; // Index of frame within the current step
+    double measuredTime_{ 0.0 }; // Time of measured frames within the current step
+    std::vector<double> respecificationFrameTimes_; // Average frame times (ms) with re-specification, indexed like LINE_COUNTS
+    std::vector<double> streamingFrameTimes_; // Average frame times (ms) with streaming, indexed like LINE_COUNTS
+};
+
+} // namespace tutorial012
+} // namespace opengl4_mbsoftworks
@@ -18,6 +18,7 @@
 #include "../common_classes/samplerManager.h"
 #include "../common_classes/freeTypeFontManager.h"
 #include "../common_classes/matrixManager.h"
+#include "../common_classes/glStateCache.h"
 
 #include "../common_classes/static_meshes_3D/plainGround.h"
 #include "../common_classes/static_meshes_3D/primitives/cube.h"
@@ -140,7 +141,7 @@ void OpenGLWindow013::renderScene()
 		cube->render();
 	}
 
-	glEnable(GL_BLEND);
+	GLStateCache::getInstance().enable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	// Turn also depth mask back off, if it's desired
@@ -170,7 +171,7 @@ void OpenGLWindow013::renderScene()
 	if (turnDepthMaskOff) {
 		glDepthMask(1);
 	}
-	glDisable(GL_BLEND);
+	GLStateCache::getInstance().disable(GL_BLEND);
 
 	// Render HUD
 	hud->renderHUD(turnDepthMaskOff);
@@ -216,6 +217,7 @@ void OpenGLWindow013::releaseScene()
 	pyramid.reset();
 	cube.reset();
 	plainGround.reset();
+	static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 } // namespace tutorial013
@@ -19,6 +19,8 @@ HUD013::HUD013(const OpenGLWindow& window)
 
 void HUD013::renderHUD(bool turnDepthMaskOff) const
 {
+    FreeTypeFont::PrintBatch printBatch;
+
     printBuilder().print(10, 10, "FPS: {}", _window.getFPS());
     printBuilder().print(10, 40, "Vertical Synchronization: {} (Press F3 to toggle)", _window.isVerticalSynchronizationEnabled() ? "On" : "Off");
     printBuilder().print(10, 70, "Turn depth mask off? {} (Press F4 to toggle)", turnDepthMaskOff ? "Yes" : "No");
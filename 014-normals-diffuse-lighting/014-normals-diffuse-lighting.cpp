@@ -274,6 +274,7 @@ void OpenGLWindow014::releaseScene()
 	cube.reset();
 	torus.reset();
 	plainGround.reset();
+	static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 } // namespace tutorial014
@@ -23,6 +23,8 @@ HUD014::HUD014(const OpenGLWindow& window)
 
 void HUD014::renderHUD(const shader_structs::AmbientLight& ambientLight, const shader_structs::DiffuseLight& diffuseLight) const
 {
+    FreeTypeFont::PrintBatch printBatch;
+
     printBuilder().print(10, 10, "FPS: {}", _window.getFPS());
     printBuilder().print(10, 40, "Vertical Synchronization: {} (Press F3 to toggle)", _window.isVerticalSynchronizationEnabled() ? "On" : "Off");
 
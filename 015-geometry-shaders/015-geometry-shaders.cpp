@@ -337,6 +337,7 @@ void OpenGLWindow015::releaseScene()
 	cube.reset();
 	torus.reset();
 	plainGround.reset();
+	static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 } // namespace tutorial015
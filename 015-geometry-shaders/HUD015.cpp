@@ -23,6 +23,8 @@ HUD015::HUD015(const OpenGLWindow& window)
 
 void HUD015::renderHUD(const shader_structs::AmbientLight& ambientLight, const shader_structs::DiffuseLight& diffuseLight, const bool displayNormals, const float normalLength) const
 {
+    FreeTypeFont::PrintBatch printBatch;
+
     printBuilder().print(10, 10, "FPS: {}", _window.getFPS());
     printBuilder().print(10, 40, "Vertical Synchronization: {} (Press F3 to toggle)", _window.isVerticalSynchronizationEnabled() ? "On" : "Off");
 
@@ -274,6 +274,7 @@ void OpenGLWindow016::releaseScene()
 	cube.reset();
 	torus.reset();
 	heightmap.reset();
+	static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 } // namespace tutorial016
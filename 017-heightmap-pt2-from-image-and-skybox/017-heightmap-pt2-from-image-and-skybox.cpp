@@ -269,6 +269,7 @@ void OpenGLWindow017::releaseScene()
 	cube.reset();
 	torus.reset();
 	heightmap.reset();
+	static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 } // namespace tutorial017
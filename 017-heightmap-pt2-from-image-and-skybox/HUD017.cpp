@@ -23,6 +23,8 @@ HUD017::HUD017(const OpenGLWindow& window)
 
 void HUD017::renderHUD(const bool displayNormals) const
 {
+    FreeTypeFont::PrintBatch printBatch;
+
     printBuilder().print(10, 10, "FPS: {}", _window.getFPS());
     printBuilder().print(10, 40, "Vertical Synchronization: {} (Press F3 to toggle)", _window.isVerticalSynchronizationEnabled() ? "On" : "Off");
     
@@ -1,4 +1,5 @@
 // STL
+#include <fstream>
 #include <iostream>
 #include <memory>
 
@@ -18,9 +19,13 @@
 #include "../common_classes/samplerManager.h"
 #include "../common_classes/freeTypeFontManager.h"
 #include "../common_classes/matrixManager.h"
+#include "../common_classes/frustum.h"
 
 #include "../common_classes/static_meshes_3D/skybox.h"
 #include "../common_classes/static_meshes_3D/heightmap.h"
+#include "../common_classes/static_meshes_3D/cdlodTerrain.h"
+#include "../common_classes/static_meshes_3D/terrainTileStreamer.h"
+#include "../common_classes/static_meshes_3D/tiledHeightFile.h"
 #include "../common_classes/static_meshes_3D/primitives/cube.h"
 #include "../common_classes/static_meshes_3D/primitives/pyramid.h"
 #include "../common_classes/static_meshes_3D/primitives/torus.h"
@@ -37,11 +42,15 @@ std::unique_ptr<static_meshes_3D::Cube> cube;
 std::unique_ptr<static_meshes_3D::Pyramid> pyramid;
 std::unique_ptr<static_meshes_3D::Torus> torus;
 std::unique_ptr<static_meshes_3D::Heightmap> heightmap;
+std::unique_ptr<static_meshes_3D::CDLODTerrain> cdlodTerrain;
+std::unique_ptr<static_meshes_3D::TerrainTileStreamer> terrainTileStreamer;
 std::unique_ptr<static_meshes_3D::Skybox> skybox;
 std::unique_ptr<HUD018> hud;
 
 float rotationAngleRad = 0.0f;
 bool displayNormals = false;
+bool renderWithCDLOD = false;
+bool renderStreamedTiles = false;
 shader_structs::AmbientLight ambientLight(glm::vec3(0.6f, 0.6f, 0.6f));
 shader_structs::DiffuseLight diffuseLight(glm::vec3(1.0f, 1.0f, 1.0f), glm::normalize(glm::vec3(0.0f, -1.0f, -1.0f)), 0.4f);
 
@@ -110,6 +119,17 @@ void OpenGLWindow018::initializeScene()
 		static_meshes_3D::Heightmap::prepareMultiLayerShaderProgram();
 		heightmap = std::make_unique<static_meshes_3D::Heightmap>("data\\heightmaps\\tut018.png", true, true, true);
 
+		// Same terrain rendered with continuous LOD - it takes height data of the heightmap
+		static_meshes_3D::CDLODTerrain::prepareShaderProgram();
+		cdlodTerrain = std::make_unique<static_meshes_3D::CDLODTerrain>(heightmap->getHeightData());
+
+		// Huge terrain (heightmap repeated many times) streamed tile by tile from memory mapped file, converted on the first run
+		const std::string tiledHeightFileName = "data/heightmaps/tut018" + static_meshes_3D::TiledHeightFile::FILE_EXTENSION;
+		if (!std::ifstream(tiledHeightFileName).good()) {
+			static_meshes_3D::TiledHeightFile::convertFromImage("data/heightmaps/tut018.png", tiledHeightFileName, 256, 20);
+		}
+		terrainTileStreamer = std::make_unique<static_meshes_3D::TerrainTileStreamer>(tiledHeightFileName, glm::vec3(1.0f, heightMapSize.y, 1.0f), 600.0f, 36);
+
 		spm.linkAllPrograms();
 	}
 	catch (const std::runtime_error& ex)
@@ -190,8 +210,8 @@ void OpenGLWindow018::renderScene()
 		torus->render();
 	}
 
-	// Render heightmap
-	auto& heightmapShaderProgram = static_meshes_3D::Heightmap::getMultiLayerShaderProgram();
+	// Render heightmap (either the whole heightmap or nodes of CDLOD terrain selected for the current camera)
+	auto& heightmapShaderProgram = renderWithCDLOD || renderStreamedTiles ? static_meshes_3D::CDLODTerrain::getShaderProgram() : static_meshes_3D::Heightmap::getMultiLayerShaderProgram();
 	heightmapShaderProgram.useProgram();
 	heightmapShaderProgram[ShaderConstants::projectionMatrix()] = getProjectionMatrix();
 	heightmapShaderProgram[ShaderConstants::viewMatrix()] = camera.getViewMatrix();
@@ -202,7 +222,18 @@ void OpenGLWindow018::renderScene()
 
 	const auto heightmapModelMatrix = glm::scale(glm::mat4(1.0f), heightMapSize);
 	heightmapShaderProgram.setModelAndNormalMatrix(heightmapModelMatrix);
-	heightmap->renderMultilayered({"rocky_terrain", "grass", "snow"}, {0.2f, 0.3f, 0.55f, 0.7f});
+	const Frustum frustum(getProjectionMatrix() * camera.getViewMatrix());
+	if (renderStreamedTiles) {
+		terrainTileStreamer->renderMultilayered(camera.getEye(), frustum, {"rocky_terrain", "grass", "snow"}, {0.2f, 0.3f, 0.55f, 0.7f});
+	}
+	else if (renderWithCDLOD)
+	{
+		cdlodTerrain->selectNodes(heightmapModelMatrix, camera.getEye(), frustum);
+		cdlodTerrain->renderMultilayered({"rocky_terrain", "grass", "snow"}, {0.2f, 0.3f, 0.55f, 0.7f});
+	}
+	else {
+		heightmap->renderMultilayered({"rocky_terrain", "grass", "snow"}, {0.2f, 0.3f, 0.55f, 0.7f});
+	}
 
 	if (displayNormals)
 	{
@@ -234,7 +265,9 @@ void OpenGLWindow018::renderScene()
 	}
 
 	// Render HUD
-	hud->renderHUD(displayNormals);
+	hud->renderHUD(displayNormals, renderWithCDLOD, renderStreamedTiles, cdlodTerrain->getNumSelectedNodes(),
+		renderStreamedTiles ? terrainTileStreamer->getNumRenderedTriangles() : cdlodTerrain->getNumRenderedTriangles(),
+		terrainTileStreamer->getNumResidentTiles(), terrainTileStreamer->getNumPendingTiles(), terrainTileStreamer->getNumTiles());
 }
 
 void OpenGLWindow018::updateScene()
@@ -251,6 +284,14 @@ void OpenGLWindow018::updateScene()
         displayNormals = !displayNormals;
     }
 
+    if (keyPressedOnce(GLFW_KEY_L)) {
+        renderWithCDLOD = !renderWithCDLOD;
+    }
+
+    if (keyPressedOnce(GLFW_KEY_T)) {
+        renderStreamedTiles = !renderStreamedTiles;
+    }
+
     int posX, posY, width, height;
     glfwGetWindowPos(getWindow(), &posX, &posY);
     glfwGetWindowSize(getWindow(), &width, &height);
@@ -261,6 +302,11 @@ void OpenGLWindow018::updateScene()
         [this](const glm::i32vec2& pos) {glfwSetCursorPos(this->getWindow(), pos.x, pos.y); },
         [this](float f) {return this->sof(f); });
 
+    // Stream in the tiles around the camera
+    if (renderStreamedTiles) {
+        terrainTileStreamer->update(camera.getEye());
+    }
+
     // Update rotation angle
     rotationAngleRad += sof(glm::radians(45.0f));
 }
@@ -280,6 +326,9 @@ void OpenGLWindow018::releaseScene()
 	cube.reset();
 	torus.reset();
 	heightmap.reset();
+	cdlodTerrain.reset();
+	terrainTileStreamer.reset();
+	static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 } // namespace tutorial018
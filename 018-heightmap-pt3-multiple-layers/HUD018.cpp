@@ -21,14 +21,26 @@ HUD018::HUD018(const OpenGLWindow& window)
     });
 }
 
-void HUD018::renderHUD(const bool displayNormals) const
+void HUD018::renderHUD(const bool displayNormals, const bool renderWithCDLOD, const bool renderStreamedTiles, const size_t numCDLODNodes, const size_t numTriangles,
+    const size_t numResidentTiles, const size_t numPendingTiles, const size_t numTiles) const
 {
+    FreeTypeFont::PrintBatch printBatch;
+
     printBuilder().print(10, 10, "FPS: {}", _window.getFPS());
     printBuilder().print(10, 40, "Vertical Synchronization: {} (Press F3 to toggle)", _window.isVerticalSynchronizationEnabled() ? "On" : "Off");
     
     // Print information about displaying normals
     printBuilder().print(10, 70, "Display Normals: {} (Press 'N' to toggle)", displayNormals ? "On" : "Off");
 
+    // Print information about continuous LOD terrain
+    printBuilder().print(10, 100, "Terrain Rendering: {} (Press 'L' to toggle, 'T' for streamed tiles)", renderStreamedTiles ? "Streamed tiles" : renderWithCDLOD ? "CDLOD" : "Whole heightmap");
+    if (renderStreamedTiles) {
+        printBuilder().print(10, 130, "Resident tiles: {} / {}, pending: {}, triangles: {}", numResidentTiles, numTiles, numPendingTiles, numTriangles);
+    }
+    else if (renderWithCDLOD) {
+        printBuilder().print(10, 130, "CDLOD nodes: {}, triangles: {}", numCDLODNodes, numTriangles);
+    }
+
     printBuilder()
         .fromRight()
         .fromBottom()
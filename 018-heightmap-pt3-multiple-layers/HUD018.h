@@ -19,7 +19,8 @@ public:
      * Renders HUD.
      */
     void renderHUD() const override {} // Don't need this, but had to override, so that class is not abstract
-    void renderHUD(bool displayNormals) const;
+    void renderHUD(bool displayNormals, bool renderWithCDLOD, bool renderStreamedTiles, size_t numCDLODNodes, size_t numTriangles,
+        size_t numResidentTiles, size_t numPendingTiles, size_t numTiles) const;
 };
 
 } // namespace tutorial018
@@ -264,6 +264,7 @@ void OpenGLWindow019::releaseScene()
 
 	hud.reset();
 	heightmap.reset();
+	static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 } // namespace tutorial019
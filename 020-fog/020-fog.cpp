@@ -8,6 +8,7 @@
 // Project
 #include "020-fog.h"
 #include "HUD020.h"
+#include "shaderPreprocessorBenchmark.h"
 #include "../common_classes/flyingCamera.h"
 
 #include "../common_classes/freeTypeFont.h"
@@ -36,6 +37,7 @@ std::unique_ptr<static_meshes_3D::Skybox> skybox;
 std::unique_ptr<static_meshes_3D::AssimpModel> medievalHouseModel;
 std::unique_ptr<static_meshes_3D::AssimpModel> classicHouseModel;
 std::unique_ptr<HUD020> hud;
+ShaderPreprocessorBenchmark shaderPreprocessorBenchmark;
 
 shader_structs::AmbientLight ambientLight(glm::vec3(0.6f, 0.6f, 0.6f));
 shader_structs::DiffuseLight diffuseLight(glm::vec3(1.0f, 1.0f, 1.0f), glm::normalize(glm::vec3(0.0f, -1.0f, -1.0f)), 0.4f);
@@ -204,6 +206,10 @@ void OpenGLWindow020::updateScene()
         fogParameters.isEnabled = !fogParameters.isEnabled;
     }
 
+    if (keyPressedOnce(GLFW_KEY_B)) {
+        shaderPreprocessorBenchmark.run("data/shaders");
+    }
+
     if (fogParameters.equation == shader_structs::FogParameters::FOG_EQUATION_LINEAR)
     {
         if (keyPressed(GLFW_KEY_1)) {
@@ -259,6 +265,7 @@ void OpenGLWindow020::releaseScene()
 
 	hud.reset();
 	heightmapWithFog.reset();
+	static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 } // namespace tutorial020
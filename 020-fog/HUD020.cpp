@@ -23,6 +23,8 @@ HUD020::HUD020(const OpenGLWindow& window)
 
 void HUD020::renderHUD(const shader_structs::FogParameters& fogParameters) const
 {
+    FreeTypeFont::PrintBatch printBatch;
+
     printBuilder().print(10, 10, "FPS: {}", _window.getFPS());
     printBuilder().print(10, 40, "Vertical Synchronization: {} (Press F3 to toggle)", _window.isVerticalSynchronizationEnabled() ? "On" : "Off");
     
@@ -40,6 +42,8 @@ void HUD020::renderHUD(const shader_structs::FogParameters& fogParameters) const
         printBuilder().print(10, 130, "Density: {} (Press '1' and '2' to change)", fogParameters.density);
     }
 
+    printBuilder().print(10, 190, "Shader preprocessor benchmark: press 'B' to run (results are printed to console)");
+
     printBuilder()
         .fromRight()
         .fromBottom()
@@ -0,0 +1,185 @@
+// STL
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+// Platform specific directory listing
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+// Project
+#include "shaderPreprocessorBenchmark.h"
+#include "../common_classes/shaderPreprocessor.h"
+
+namespace opengl4_mbsoftworks {
+namespace tutorial020 {
+
+const int ShaderPreprocessorBenchmark::NUM_RUNS = 20;
+
+namespace {
+
+/**
+ * Checks, if the file name has one of the shader file extensions.
+ */
+bool isShaderFileName(const std::string& fileName)
+{
+    const auto dotPosition = fileName.find_last_of('.');
+    if (dotPosition == std::string::npos) {
+        return false;
+    }
+
+    const auto extension = fileName.substr(dotPosition + 1);
+    return extension == "vert" || extension == "frag" || extension == "geom" || extension == "glsl";
+}
+
+} // namespace
+
+void ShaderPreprocessorBenchmark::run(const std::string& shadersDirectory)
+{
+    shaderFileNames_.clear();
+    collectShaderFiles(shadersDirectory, shaderFileNames_);
+    std::sort(shaderFileNames_.begin(), shaderFileNames_.end());
+    if (shaderFileNames_.empty())
+    {
+        std::cout << "No shader files found in " << shadersDirectory << ", shader preprocessor benchmark is skipped!" << std::endl;
+        return;
+    }
+
+    std::cout << "Starting shader preprocessor benchmark over " << shaderFileNames_.size() << " shader files in " << shadersDirectory << "..." << std::endl;
+
+    modeResults_.clear();
+    modeResults_.push_back(measurePass("No cache", true, true));
+    modeResults_.push_back(measurePass("Cold cache", false, true));
+    modeResults_.push_back(measurePass("Warm cache", false, false));
+    printResults();
+}
+
+ShaderPreprocessorBenchmark::ModeResult ShaderPreprocessorBenchmark::measurePass(const std::string& name, const bool clearCachePerFile, const bool clearCachePerPass) const
+{
+    auto& preprocessor = ShaderPreprocessor::getInstance();
+    ModeResult modeResult{ name, 0.0, 0, 0 };
+
+    // Warm cache mode must start with all files parsed already
+    ShaderPreprocessor::Result result;
+    if (!clearCachePerFile && !clearCachePerPass)
+    {
+        for (const auto& fileName : shaderFileNames_) {
+            preprocessor.preprocessFile(fileName, result);
+        }
+    }
+
+    for (auto run = 0; run < NUM_RUNS; run++)
+    {
+        if (clearCachePerPass) {
+            preprocessor.clearCache();
+        }
+
+        const auto fileReadsBefore = preprocessor.getNumFileReads();
+        const auto cacheHitsBefore = preprocessor.getNumCacheHits();
+        const auto startTime = std::chrono::high_resolution_clock::now();
+        for (const auto& fileName : shaderFileNames_)
+        {
+            if (clearCachePerFile) {
+                preprocessor.clearCache();
+            }
+
+            preprocessor.preprocessFile(fileName, result);
+        }
+
+        const auto passTime = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - startTime).count();
+        if (run == 0 || passTime < modeResult.passTime) {
+            modeResult.passTime = passTime;
+        }
+
+        modeResult.numFileReads = preprocessor.getNumFileReads() - fileReadsBefore;
+        modeResult.numCacheHits = preprocessor.getNumCacheHits() - cacheHitsBefore;
+    }
+
+    return modeResult;
+}
+
+void ShaderPreprocessorBenchmark::collectShaderFiles(const std::string& directory, std::vector<std::string>& fileNames)
+{
+#ifdef _WIN32
+    WIN32_FIND_DATAA findData;
+    const auto findHandle = FindFirstFileA((directory + "/*").c_str(), &findData);
+    if (findHandle == INVALID_HANDLE_VALUE) {
+        return;
+    }
+
+    do
+    {
+        const std::string entryName = findData.cFileName;
+        if (entryName == "." || entryName == "..") {
+            continue;
+        }
+
+        const auto entryPath = directory + "/" + entryName;
+        if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+            collectShaderFiles(entryPath, fileNames);
+        }
+        else if (isShaderFileName(entryName)) {
+            fileNames.push_back(entryPath);
+        }
+    } while (FindNextFileA(findHandle, &findData));
+
+    FindClose(findHandle);
+#else
+    const auto directoryHandle = opendir(directory.c_str());
+    if (directoryHandle == nullptr) {
+        return;
+    }
+
+    while (const auto entry = readdir(directoryHandle))
+    {
+        const std::string entryName = entry->d_name;
+        if (entryName == "." || entryName == "..") {
+            continue;
+        }
+
+        const auto entryPath = directory + "/" + entryName;
+        struct stat entryStatus;
+        if (stat(entryPath.c_str(), &entryStatus) != 0) {
+            continue;
+        }
+
+        if (S_ISDIR(entryStatus.st_mode)) {
+            collectShaderFiles(entryPath, fileNames);
+        }
+        else if (isShaderFileName(entryName)) {
+            fileNames.push_back(entryPath);
+        }
+    }
+
+    closedir(directoryHandle);
+#endif
+}
+
+void ShaderPreprocessorBenchmark::printResults() const
+{
+    const auto previousFlags = std::cout.flags();
+    const auto previousPrecision = std::cout.precision();
+    std::cout << "Shader preprocessor benchmark results (" << shaderFileNames_.size() << " files per pass, fastest of " << NUM_RUNS << " passes):" << std::endl;
+    std::cout << std::setw(12) << "Mode" << std::setw(16) << "Pass time (us)" << std::setw(16) << "Per file (us)"
+        << std::setw(12) << "File reads" << std::setw(12) << "Cache hits" << std::setw(10) << "Speedup" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& modeResult : modeResults_)
+    {
+        const auto speedup = modeResult.passTime > 0.0 ? modeResults_[0].passTime / modeResult.passTime : 0.0;
+        std::cout << std::setw(12) << modeResult.name << std::setw(16) << modeResult.passTime << std::setw(16) << modeResult.passTime / shaderFileNames_.size()
+            << std::setw(12) << modeResult.numFileReads << std::setw(12) << modeResult.numCacheHits << std::setw(9) << speedup << "x" << std::endl;
+    }
+
+    std::cout.flags(previousFlags);
+    std::cout.precision(previousPrecision);
+}
+
+} // namespace tutorial020
+} // namespace opengl4_mbsoftworks
@@ -0,0 +1,64 @@
+#pragma once
+
+// STL
+#include <string>
+#include <vector>
+
+namespace opengl4_mbsoftworks {
+namespace tutorial020 {
+
+/**
+ * Benchmark, that measures preprocessing of all shader files found in a directory (recursively) by ShaderPreprocessor.
+ * One pass preprocesses every file once. Passes are measured without any caching (cache is cleared before every file,
+ * so each shader reads all of its includes again), with cold cache (cleared once per pass) and with warm cache.
+ * Benchmark runs synchronously and results are printed to standard output.
+ */
+class ShaderPreprocessorBenchmark
+{
+public:
+    static const int NUM_RUNS; // Number of measured passes for every mode (the fastest one is taken)
+
+    /**
+     * Runs the benchmark and prints the results.
+     *
+     * @param shadersDirectory  Directory to search for shader files
+     */
+    void run(const std::string& shadersDirectory);
+
+private:
+    /**
+     * Result of one benchmark mode.
+     */
+    struct ModeResult
+    {
+        std::string name; // Name of the mode
+        double passTime; // Time of the fastest pass in microseconds
+        size_t numFileReads; // Number of files read from the disk in one pass
+        size_t numCacheHits; // Number of parsed files reused from the cache in one pass
+    };
+
+    /**
+     * Measures the fastest pass over all shader files.
+     *
+     * @param name               Name of the mode
+     * @param clearCachePerFile  If true, cache is cleared before every file, otherwise once before every pass
+     * @param clearCachePerPass  If true, cache is cleared before every pass
+     */
+    ModeResult measurePass(const std::string& name, bool clearCachePerFile, bool clearCachePerPass) const;
+
+    /**
+     * Recursively collects shader files (.vert, .frag, .geom, .glsl) within given directory.
+     */
+    static void collectShaderFiles(const std::string& directory, std::vector<std::string>& fileNames);
+
+    /**
+     * Prints results of the benchmark as a table to standard output.
+     */
+    void printResults() const;
+
+    std::vector<std::string> shaderFileNames_; // All shader files preprocessed in one pass
+    std::vector<ModeResult> modeResults_; // Results of all benchmark modes
+};
+
+} // namespace tutorial020
+} // namespace opengl4_mbsoftworks
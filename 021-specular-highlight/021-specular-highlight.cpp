@@ -257,6 +257,7 @@ void OpenGLWindow021::releaseScene()
 
 	hud.reset();
 	heightmap.reset();
+	static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 } // namespace tutorial021
@@ -24,6 +24,8 @@ HUD021::HUD021(const OpenGLWindow& window)
 
 void HUD021::renderHUD(const shader_structs::Material& material, const glm::vec3& diffuseLightDirection) const
 {
+    FreeTypeFont::PrintBatch printBatch;
+
     printBuilder().print(10, 10, "FPS: {}", _window.getFPS());
     printBuilder().print(10, 40, "Vertical Synchronization: {} (Press F3 to toggle)", _window.isVerticalSynchronizationEnabled() ? "On" : "Off");
     
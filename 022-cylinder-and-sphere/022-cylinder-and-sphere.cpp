@@ -68,6 +68,15 @@ void OpenGLWindow022::initializeScene()
 		mainShaderProgram.addShaderToProgram(sm.getFragmentShader(ShaderKeys::diffuseLight()));
 		mainShaderProgram.addShaderToProgram(sm.getFragmentShader(ShaderKeys::specularHighlight()));
 
+        // Instanced variant of main program is compiled on demand, when instanced rendering gets turned on
+        spm.createShaderProgramVariants("main", {
+            { GL_VERTEX_SHADER, "data/shaders/tut021-specular-highlight/shader.vert" },
+            { GL_FRAGMENT_SHADER, "data/shaders/tut021-specular-highlight/shader.frag" },
+            { GL_FRAGMENT_SHADER, "data/shaders/lighting/ambientLight.frag" },
+            { GL_FRAGMENT_SHADER, "data/shaders/lighting/diffuseLight.frag" },
+            { GL_FRAGMENT_SHADER, "data/shaders/lighting/specularHighlight.frag" }
+        });
+
 		auto& normalsShaderProgram = spm.createShaderProgram("normals");
 		normalsShaderProgram.addShaderToProgram(sm.getVertexShader("normals"));
 		normalsShaderProgram.addShaderToProgram(sm.getGeometryShader("normals"));
@@ -110,6 +119,7 @@ void OpenGLWindow022::initializeScene()
 bool isDirectionLocked = true;
 bool displayNormals = false;
 bool updateSpaceEntities = true;
+bool useInstancing = false;
 
 std::vector<Planet> planets =
 {
@@ -129,7 +139,7 @@ SpaceStation spaceStation(glm::vec3(100.0f, 100.0f, -100.0f), 15.0f, 3.0f);
 
 void OpenGLWindow022::renderScene()
 {
-	const auto& spm = ShaderProgramManager::getInstance();
+	auto& spm = ShaderProgramManager::getInstance();
 	const auto& tm = TextureManager::getInstance();
 	auto& mm = MatrixManager::getInstance();
 	
@@ -172,7 +182,23 @@ void OpenGLWindow022::renderScene()
         planet.render();
     }
 
-    spaceStation.render();
+    if (useInstancing)
+    {
+        // Every planet has its own texture, so only the space station parts sharing a mesh are instanced
+        auto& instancedProgram = spm.getShaderProgramVariant("main", ShaderDefines().define("INSTANCED"));
+        instancedProgram.useProgram();
+        instancedProgram[ShaderConstants::projectionMatrix()] = getProjectionMatrix();
+        instancedProgram[ShaderConstants::viewMatrix()] = camera.getViewMatrix();
+        instancedProgram[ShaderConstants::color()] = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+        instancedProgram[ShaderConstants::sampler()] = 0;
+        instancedProgram[ShaderConstants::eyePosition()] = camera.getEye();
+        ambientLight.setUniform(instancedProgram, ShaderConstants::ambientLight());
+        diffuseLight.setUniform(instancedProgram, ShaderConstants::diffuseLight());
+        spaceStation.renderInstanced(instancedProgram);
+    }
+    else {
+        spaceStation.render();
+    }
 
 	if (displayNormals)
 	{
@@ -202,7 +228,7 @@ void OpenGLWindow022::renderScene()
     }
 
 	// Render HUD
-	hud->renderHUD(diffuseLight.direction, displayNormals, updateSpaceEntities, sphereSlices, sphereStacks);
+	hud->renderHUD(diffuseLight.direction, displayNormals, updateSpaceEntities, useInstancing, sphereSlices, sphereStacks, GLStateCache::getInstance().getLastFrameStatistics());
 }
 
 void OpenGLWindow022::updateScene()
@@ -227,6 +253,16 @@ void OpenGLWindow022::updateScene()
         updateSpaceEntities = !updateSpaceEntities;
     }
 
+    if (keyPressedOnce(GLFW_KEY_I)) {
+        useInstancing = !useInstancing;
+    }
+
+    if (keyPressedOnce(GLFW_KEY_G))
+    {
+        auto& stateCache = GLStateCache::getInstance();
+        stateCache.setCachingEnabled(!stateCache.isCachingEnabled());
+    }
+
     if (keyPressedOnce(GLFW_KEY_1))
     {
         if (sphereSlices > 3)
@@ -283,6 +319,7 @@ void OpenGLWindow022::releaseScene()
     SpaceStation::freeGeometry();
 
 	hud.reset();
+	static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 } // namespace tutorial022
@@ -22,8 +22,11 @@ HUD022::HUD022(const OpenGLWindow& window)
     });
 }
 
-void HUD022::renderHUD(const glm::vec3& diffuseLightDirection, bool displayNormals, bool updateSpaceEntities, int sphereSlices, int sphereStacks) const
+void HUD022::renderHUD(const glm::vec3& diffuseLightDirection, bool displayNormals, bool updateSpaceEntities, bool useInstancing, int sphereSlices, int sphereStacks,
+    const GLStateCache::Statistics& stateCacheStatistics) const
 {
+    FreeTypeFont::PrintBatch printBatch;
+
     // Basic information like FPS or V-Sync
     printBuilder().print(10, 10, "FPS: {}", _window.getFPS());
     printBuilder().print(10, 40, "Vertical Synchronization: {} (Press F3 to toggle)", _window.isVerticalSynchronizationEnabled() ? "On" : "Off");
@@ -35,8 +38,13 @@ void HUD022::renderHUD(const glm::vec3& diffuseLightDirection, bool displayNorma
     printBuilder().print(10, 100, "Sphere parameters:");
     printBuilder().print(40, 130, "Slices: {} (Press '1' and '2' to alter)", sphereSlices);
     printBuilder().print(40, 160, "Stacks: {} (Press '3' and '4' to alter)", sphereStacks);
+
+    // OpenGL state changes of the last frame
+    printBuilder().print(10, 190, "Redundant state changes skipping: {} (Press 'G' to toggle)", GLStateCache::getInstance().isCachingEnabled() ? "On" : "Off");
+    printBuilder().print(40, 220, "State calls issued / skipped: {} / {}", stateCacheStatistics.numIssuedCalls, stateCacheStatistics.numSkippedCalls);
     
     // Space entities
+    printBuilder().fromBottom().print(10, 70, "Instanced rendering of space station: {} (Press 'I' to toggle)", useInstancing ? "On" : "Off");
     printBuilder().fromBottom().print(10, 40, "Update space entities: {} (Press 'X' to toggle)", updateSpaceEntities ? "On" : "Off");
 
     // Normals
@@ -3,6 +3,7 @@
 // Project
 #include "../common_classes/OpenGLWindow.h"
 #include "../common_classes/HUD.h"
+#include "../common_classes/glStateCache.h"
 
 namespace opengl4_mbsoftworks {
 namespace tutorial022 {
@@ -19,7 +20,8 @@ public:
      * Renders HUD.
      */
     void renderHUD() const override {} // Don't need this, but had to override, so that class is not abstract
-    void renderHUD(const glm::vec3& diffuseLightDirection, bool displayNormals, bool updateSpaceEntities, int sphereSlices, int sphereStacks) const;
+    void renderHUD(const glm::vec3& diffuseLightDirection, bool displayNormals, bool updateSpaceEntities, bool useInstancing, int sphereSlices, int sphereStacks,
+        const GLStateCache::Statistics& stateCacheStatistics) const;
 };
 
 } // namespace tutorial022
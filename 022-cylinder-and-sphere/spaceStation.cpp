@@ -21,6 +21,8 @@ SpaceStation::SpaceStation(const glm::vec3& position, float sphereRadius, float
 shader_structs::Material SpaceStation::material(1.0f, 32.0f);
 std::unique_ptr<static_meshes_3D::Sphere> SpaceStation::sphereMesh;
 std::unique_ptr<static_meshes_3D::Cylinder> SpaceStation::cylinderMesh;
+std::unique_ptr<static_meshes_3D::InstanceBuffer> SpaceStation::sphereInstances;
+std::unique_ptr<static_meshes_3D::InstanceBuffer> SpaceStation::cylinderInstances;
 
 void SpaceStation::render() const
 {
@@ -40,6 +42,26 @@ void SpaceStation::render() const
     }
 }
 
+void SpaceStation::renderInstanced(ShaderProgram& instancedProgram) const
+{
+    TextureManager::getInstance().getTexture("scifi_metal").bind();
+    material.setUniform(instancedProgram, ShaderConstants::material());
+    instancedProgram.setModelAndNormalMatrix(glm::mat4(1.0f));
+
+    sphereInstances->clear();
+    sphereInstances->addInstance(getSphereModelMatrix());
+    sphereInstances->upload();
+    sphereMesh->renderInstanced(*sphereInstances);
+
+    cylinderInstances->clear();
+    for (const auto& cylinderMatrix : getAllCylinderMatrices()) {
+        cylinderInstances->addInstance(cylinderMatrix);
+    }
+
+    cylinderInstances->upload();
+    cylinderMesh->renderInstanced(*cylinderInstances);
+}
+
 void SpaceStation::renderPoints() const
 {
     auto& normalsProgram = ShaderProgramManager::getInstance().getShaderProgram("normals");
@@ -64,12 +86,16 @@ void SpaceStation::initializeGeometry()
 {
     sphereMesh = std::make_unique<static_meshes_3D::Sphere>(1.0f, 10, 6);
     cylinderMesh = std::make_unique<static_meshes_3D::Cylinder>(1.0f, 20, 1.0f);
+    sphereInstances = std::make_unique<static_meshes_3D::InstanceBuffer>();
+    cylinderInstances = std::make_unique<static_meshes_3D::InstanceBuffer>();
 }
 
 void SpaceStation::freeGeometry()
 {
     sphereMesh.reset();
     cylinderMesh.reset();
+    sphereInstances.reset();
+    cylinderInstances.reset();
 }
 
 glm::mat4 SpaceStation::getSphereModelMatrix() const
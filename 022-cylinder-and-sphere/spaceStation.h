@@ -6,7 +6,9 @@
 // Project
 #include "../common_classes/OpenGLWindow.h"
 
+#include "../common_classes/shaderProgram.h"
 #include "../common_classes/shader_structs/material.h"
+#include "../common_classes/static_meshes_3D/instanceBuffer.h"
 #include "../common_classes/static_meshes_3D/primitives/sphere.h"
 #include "../common_classes/static_meshes_3D/primitives/cylinder.h"
 
@@ -21,6 +23,13 @@ public:
     void render() const;
     void renderPoints() const;
 
+    /**
+     * Renders space station with instanced draw calls - all cylinders are rendered with one draw call.
+     *
+     * @param instancedProgram  Instanced variant of main program, that is in use and has the scene properties set
+     */
+    void renderInstanced(ShaderProgram& instancedProgram) const;
+
     void update();
 
     /**
@@ -37,6 +46,8 @@ private:
     static shader_structs::Material material; // Material used (shiny)
     static std::unique_ptr<static_meshes_3D::Sphere> sphereMesh; // Sphere mesh
     static std::unique_ptr<static_meshes_3D::Cylinder> cylinderMesh; // Cylinder mesh
+    static std::unique_ptr<static_meshes_3D::InstanceBuffer> sphereInstances; // Instance buffer for the sphere
+    static std::unique_ptr<static_meshes_3D::InstanceBuffer> cylinderInstances; // Instance buffer for all cylinders
 
     glm::vec3 position_; // Position of the space station
     float sphereRadius_; // Radius of sphere
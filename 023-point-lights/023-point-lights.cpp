@@ -8,6 +8,7 @@
 // Project
 #include "023-point-lights.h"
 #include "HUD023.h"
+#include "uniformSettingBenchmark.h"
 
 #include "../common_classes/flyingCamera.h"
 
@@ -67,6 +68,8 @@ std::vector<glm::vec3> barnPositions
 };
 
 float rotationAngle; // Rotation angle used to animate tori
+bool areShaderProgramsLinked = false; // Flag telling, whether all shader programs have been linked (they're linked in the background)
+UniformSettingBenchmark uniformSettingBenchmark; // Benchmark comparing uniform lookups by name strings and by shader constants
 
 void OpenGLWindow023::initializeScene()
 {
@@ -109,7 +112,8 @@ void OpenGLWindow023::initializeScene()
 
         plainGround = std::make_unique<static_meshes_3D::PlainGround>(true, true, true);
 
-		spm.linkAllPrograms();
+		// Don't wait for the shader programs, they're compiled and linked while loading progress is shown
+		spm.startLinkingAllPrograms();
 	}
 	catch (const std::runtime_error& ex)
 	{
@@ -125,9 +129,32 @@ void OpenGLWindow023::initializeScene()
 
 void OpenGLWindow023::renderScene()
 {
+	if (!areShaderProgramsLinked)
+	{
+		try
+		{
+			areShaderProgramsLinked = ShaderProgramManager::getInstance().updateLinkingPrograms();
+		}
+		catch (const std::runtime_error& ex)
+		{
+			std::cout << "Error occured during shader programs linking: " << ex.what() << std::endl;
+			closeWindow(true);
+			return;
+		}
+
+		if (!areShaderProgramsLinked)
+		{
+			renderLoadingProgress(ShaderProgramManager::getInstance().getLinkingProgress());
+			return;
+		}
+	}
+
 	const auto& spm = ShaderProgramManager::getInstance();
 	const auto& tm = TextureManager::getInstance();
 	auto& mm = MatrixManager::getInstance();
+
+	// Count uniform uploads of this frame only
+	ShaderProgram::resetUniformStatistics();
 	
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -236,7 +263,7 @@ void OpenGLWindow023::renderScene()
     }
 
 	// Render HUD
-    hud->renderHUD(ambientLight, pointLightA);
+    hud->renderHUD(ambientLight, pointLightA, ShaderProgram::getUniformStatistics());
 }
 
 void OpenGLWindow023::updateScene()
@@ -253,6 +280,14 @@ void OpenGLWindow023::updateScene()
         shinyMaterial.isEnabled = !shinyMaterial.isEnabled;
     }
 
+    if (keyPressedOnce(GLFW_KEY_U)) {
+        ShaderProgram::setUniformShadowingEnabled(!ShaderProgram::isUniformShadowingEnabled());
+    }
+
+    if (keyPressedOnce(GLFW_KEY_B) && areShaderProgramsLinked) {
+        uniformSettingBenchmark.run(ShaderProgramManager::getInstance().getShaderProgram("main"));
+    }
+
     if (keyPressed(GLFW_KEY_1))
     {
         pointLightA.constantAttenuation -= sof(0.2f);
@@ -344,6 +379,7 @@ void OpenGLWindow023::releaseScene()
 
     plainGround.reset();
 	hud.reset();
+	static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 } // namespace tutorial023
@@ -21,8 +21,11 @@ HUD023::HUD023(const OpenGLWindow& window)
     });
 }
 
-void HUD023::renderHUD(const shader_structs::AmbientLight& ambientLight, const shader_structs::PointLight& pointLight) const
+void HUD023::renderHUD(const shader_structs::AmbientLight& ambientLight, const shader_structs::PointLight& pointLight,
+    const ShaderProgram::UniformStatistics& uniformStatistics) const
 {
+    FreeTypeFont::PrintBatch printBatch;
+
     printBuilder().print(10, 10, "FPS: {}", _window.getFPS());
     printBuilder().print(10, 40, "Vertical Synchronization: {} (Press F3 to toggle)", _window.isVerticalSynchronizationEnabled() ? "On" : "Off");
     
@@ -35,6 +38,11 @@ void HUD023::renderHUD(const shader_structs::AmbientLight& ambientLight, const s
     printBuilder().print(10, 160, "   - linear attenuation: {} (press '3' and '4' to change)", pointLight.linearAttenuation);
     printBuilder().print(10, 190, "   - exponential attenuation: {} (press '5' and '6' to change)", pointLight.exponentialAttenuation);
 
+    // Print how many uniform uploads have been issued and skipped this frame
+    printBuilder().print(10, 220, "Redundant uniforms skipping: {} (Press 'U' to toggle)", ShaderProgram::isUniformShadowingEnabled() ? "On" : "Off");
+    printBuilder().print(10, 250, "   - uniform calls issued / skipped: {} / {}", uniformStatistics.numIssuedCalls, uniformStatistics.numSkippedCalls);
+    printBuilder().print(10, 280, "Uniform setting benchmark: press 'B' to run (results are printed to console)");
+
     printBuilder()
         .fromRight()
         .fromBottom()
@@ -3,6 +3,7 @@
 // Project
 #include "../common_classes/OpenGLWindow.h"
 #include "../common_classes/HUD.h"
+#include "../common_classes/shaderProgram.h"
 
 #include "../common_classes/shader_structs/ambientLight.h"
 #include "../common_classes/shader_structs/pointLight.h"
@@ -22,7 +23,8 @@ public:
      * Renders HUD.
      */
     void renderHUD() const override {} // Don't need this, but had to override, so that class is not abstract
-    void renderHUD(const shader_structs::AmbientLight& ambientLight, const shader_structs::PointLight& pointLight) const;
+    void renderHUD(const shader_structs::AmbientLight& ambientLight, const shader_structs::PointLight& pointLight,
+        const ShaderProgram::UniformStatistics& uniformStatistics) const;
 };
 
 } // namespace tutorial023
@@ -0,0 +1,90 @@
+// STL
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+// GLM
+#include <glm/gtc/matrix_transform.hpp>
+
+// Project
+#include "uniformSettingBenchmark.h"
+
+namespace opengl4_mbsoftworks {
+namespace tutorial023 {
+
+const int UniformSettingBenchmark::NUM_OBJECTS = 100000;
+const int UniformSettingBenchmark::NUM_RUNS = 5;
+
+void UniformSettingBenchmark::run(ShaderProgram& shaderProgram)
+{
+    std::cout << "Starting uniform setting benchmark, this will take a while..." << std::endl;
+
+    // Every set should issue its OpenGL call, otherwise we would measure mostly the skipping
+    const auto wasShadowingEnabled = ShaderProgram::isUniformShadowingEnabled();
+    ShaderProgram::setUniformShadowingEnabled(false);
+    shaderProgram.useProgram();
+
+    nameLookupTime_ = measureLookup(shaderProgram, false);
+    constantLookupTime_ = measureLookup(shaderProgram, true);
+
+    ShaderProgram::setUniformShadowingEnabled(wasShadowingEnabled);
+    printResults();
+}
+
+double UniformSettingBenchmark::measureLookup(ShaderProgram& shaderProgram, const bool useShaderConstants) const
+{
+    auto bestTime = 0.0;
+    for (auto run = 0; run < NUM_RUNS; run++)
+    {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+        for (auto i = 0; i < NUM_OBJECTS; i++)
+        {
+            // Values differ for every object, just like when rendering a scene
+            const auto modelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(static_cast<float>(i), 0.0f, 0.0f));
+            const auto normalMatrix = glm::mat3(modelMatrix);
+            const auto color = glm::vec4(1.0f, 1.0f, 1.0f, static_cast<float>(i % 256) / 255.0f);
+            if (useShaderConstants)
+            {
+                shaderProgram[ShaderConstants::modelMatrix()] = modelMatrix;
+                shaderProgram[ShaderConstants::normalMatrix()] = normalMatrix;
+                shaderProgram[ShaderConstants::color()] = color;
+            }
+            else
+            {
+                shaderProgram[std::string("matrices.modelMatrix")] = modelMatrix;
+                shaderProgram[std::string("matrices.normalMatrix")] = normalMatrix;
+                shaderProgram[std::string("color")] = color;
+            }
+        }
+
+        // Wait for the driver to process the calls, so that they're all part of the measured time
+        glFinish();
+        const auto runTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+        if (run == 0 || runTime < bestTime) {
+            bestTime = runTime;
+        }
+    }
+
+    return bestTime;
+}
+
+void UniformSettingBenchmark::printResults() const
+{
+    const auto previousFlags = std::cout.flags();
+    const auto previousPrecision = std::cout.precision();
+    const auto numSets = 3.0 * NUM_OBJECTS;
+    std::cout << "Uniform setting benchmark results (3 uniforms of " << NUM_OBJECTS << " objects, fastest of " << NUM_RUNS << " runs):" << std::endl;
+    std::cout << std::setw(18) << "Lookup" << std::setw(12) << "Time (ms)" << std::setw(14) << "ns per set" << std::setw(12) << "Speedup" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << std::setw(18) << "Name string" << std::setw(12) << nameLookupTime_ << std::setw(14) << nameLookupTime_ * 1000000.0 / numSets
+        << std::setw(11) << 1.0 << "x" << std::endl;
+    std::cout << std::setw(18) << "Shader constant" << std::setw(12) << constantLookupTime_ << std::setw(14) << constantLookupTime_ * 1000000.0 / numSets
+        << std::setw(11) << (constantLookupTime_ > 0.0 ? nameLookupTime_ / constantLookupTime_ : 0.0) << "x" << std::endl;
+
+    std::cout.flags(previousFlags);
+    std::cout.precision(previousPrecision);
+}
+
+} // namespace tutorial023
+} // namespace opengl4_mbsoftworks
@@ -0,0 +1,53 @@
+#pragma once
+
+// STL
+#include <vector>
+
+// Project
+#include "../common_classes/shaderProgram.h"
+
+namespace opengl4_mbsoftworks {
+namespace tutorial023 {
+
+/**
+ * Benchmark, that measures throughput of setting uniforms of one shader program - per-object uniforms (model matrix,
+ * normal matrix and color) are set many times, once looked up by name strings built for every call (as the uniforms
+ * were set before shader constants existed) and once looked up by shader constants. Redundant uniforms skipping
+ * is disabled during the benchmark, so that every set issues its OpenGL call. Benchmark runs synchronously and
+ * results are printed to standard output.
+ */
+class UniformSettingBenchmark
+{
+public:
+    static const int NUM_OBJECTS; // Number of objects, whose uniforms are set in one measured run
+    static const int NUM_RUNS; // Number of runs for every lookup kind (the fastest one is taken)
+
+    /**
+     * Runs the benchmark and prints the results.
+     *
+     * @param shaderProgram  Linked shader program with model matrix, normal matrix and color uniforms
+     */
+    void run(ShaderProgram& shaderProgram);
+
+private:
+    /**
+     * Measures the fastest run of setting uniforms of all objects.
+     *
+     * @param shaderProgram       Shader program to set uniforms of
+     * @param useShaderConstants  Whether uniforms are looked up by shader constants or by name strings
+     *
+     * @return Time of the fastest run in milliseconds.
+     */
+    double measureLookup(ShaderProgram& shaderProgram, bool useShaderConstants) const;
+
+    /**
+     * Prints results of the benchmark as a table to standard output.
+     */
+    void printResults() const;
+
+    double nameLookupTime_{ 0.0 }; // Fastest run time (ms) with uniforms looked up by name strings
+    double constantLookupTime_{ 0.0 }; // Fastest run time (ms) with uniforms looked up by shader constants
+};
+
+} // namespace tutorial023
+} // namespace opengl4_mbsoftworks
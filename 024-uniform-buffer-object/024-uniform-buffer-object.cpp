@@ -2,6 +2,8 @@
 #include <iostream>
 #include <memory>
 #include <deque>
+#include <cstring>
+#include <cmath>
 
 // GLM
 #include <glm/gtc/matrix_transform.hpp>
@@ -11,6 +13,7 @@
 #include "024-uniform-buffer-object.h"
 #include "HUD024.h"
 #include "pointLightExtended.h"
+#include "lightCountBenchmark.h"
 
 #include "../common_classes/flyingCamera.h"
 
@@ -27,6 +30,7 @@
 #include "../common_classes/static_meshes_3D/skybox.h"
 
 #include "../common_classes/static_meshes_3D/heightmap.h"
+#include "../common_classes/static_meshes_3D/instanceBuffer.h"
 #include "../common_classes/static_meshes_3D/primitives/sphere.h"
 #include "../common_classes/static_meshes_3D/primitives/torus.h"
 
@@ -78,19 +82,89 @@ std::unique_ptr<UniformBufferObject> uboMatrices; // UBO for matrices
 std::deque<PointLightExtended> pointLights; // All point lights are stored here
 std::unique_ptr<UniformBufferObject> uboPointLights; // UBO for point lights
 
+bool useShaderVariants = false; // Flag telling, whether main program variant compiled for exact number of point lights is used
+LightCountBenchmark lightCountBenchmark(MAX_POINT_LIGHTS); // Benchmark comparing generic program with program variants
+std::deque<PointLightExtended> pointLightsBeforeBenchmark; // Point lights to restore after the benchmark
+bool useShaderVariantsBeforeBenchmark = false; // Shader variants flag to restore after the benchmark
+bool isVerticalSynchronizationBeforeBenchmark = false; // Vertical synchronization to restore after the benchmark
+
+bool useInstancing = false; // Flag telling, whether copies of the same mesh are rendered with one instanced draw call
+std::unique_ptr<static_meshes_3D::InstanceBuffer> toriInstances; // Instances of all tori
+std::unique_ptr<static_meshes_3D::InstanceBuffer> barnInstances; // Instances of all barns
+std::unique_ptr<static_meshes_3D::InstanceBuffer> pointLightInstances; // Instances of spheres representing point lights
+
+/**
+ * Gets main shader program for rendering with given number of point lights - either the generic one
+ * or the variant compiled for exactly that number of point lights (and / or for instanced rendering).
+ */
+ShaderProgram& getMainShaderProgram(const int numPointLights, const bool isInstanced = false)
+{
+    auto& spm = ShaderProgramManager::getInstance();
+    if (!useShaderVariants && !isInstanced) {
+        return spm.getShaderProgram("main");
+    }
+
+    ShaderDefines defines;
+    if (useShaderVariants) {
+        defines.define("NUM_POINT_LIGHTS", numPointLights);
+    }
+
+    if (isInstanced) {
+        defines.define("INSTANCED");
+    }
+
+    return spm.getShaderProgramVariant("main", defines);
+}
+
+/**
+ * Renders copies of a mesh with given model matrices. With instancing, copies are gathered into the instance buffer
+ * and rendered with one instanced draw call (program must be the instanced variant), otherwise they're rendered one by one.
+ *
+ * @param shaderProgram   Program used for rendering
+ * @param mesh            Mesh to render
+ * @param instanceBuffer  Instance buffer for the copies of the mesh
+ * @param modelMatrices   Model matrices of all copies
+ * @param colors          Colors of the copies (if empty, color set in the program is used)
+ */
+void renderMeshCopies(ShaderProgram& shaderProgram, const static_meshes_3D::StaticMesh3D& mesh, static_meshes_3D::InstanceBuffer& instanceBuffer,
+    const std::vector<glm::mat4>& modelMatrices, const std::vector<glm::vec4>& colors = std::vector<glm::vec4>())
+{
+    if (!useInstancing)
+    {
+        for (size_t i = 0; i < modelMatrices.size(); i++)
+        {
+            shaderProgram.setModelAndNormalMatrix(modelMatrices[i]);
+            if (!colors.empty()) {
+                shaderProgram[ShaderConstants::color()] = colors[i];
+            }
+
+            mesh.render();
+        }
+
+        return;
+    }
+
+    instanceBuffer.clear();
+    for (size_t i = 0; i < modelMatrices.size(); i++) {
+        instanceBuffer.addInstance(modelMatrices[i], colors.empty() ? glm::vec4(1.0f) : colors[i]);
+    }
+
+    instanceBuffer.upload();
+    shaderProgram.setModelAndNormalMatrix(glm::mat4(1.0f));
+    mesh.renderInstanced(instanceBuffer);
+}
+
 void OpenGLWindow024::initializeScene()
 {
 	try
 	{
-		// Create UBO for matrices and bind it to the MATRICES_BLOCK_BINDING_POINT
+		// Create streaming UBO for matrices, every frame its data get bound to the MATRICES_BLOCK_BINDING_POINT
         uboMatrices = std::make_unique<UniformBufferObject>();
-        uboMatrices->createUBO(sizeof(glm::mat4) * 2);
-        uboMatrices->bindBufferBaseToBindingPoint(UniformBlockBindingPoints::MATRICES);
+        uboMatrices->createStreamingUBO(sizeof(glm::mat4) * 2);
 
-		// Create UBO for point lights and bind it to the POINT_LIGHTS_BLOCK_BINDING_POINT
+		// Create streaming UBO for point lights, every frame its data get bound to the POINT_LIGHTS_BLOCK_BINDING_POINT
         uboPointLights = std::make_unique<UniformBufferObject>();
-        uboPointLights->createUBO(MAX_POINT_LIGHTS * shader_structs::PointLight::getDataSizeStd140());
-        uboPointLights->bindBufferBaseToBindingPoint(UniformBlockBindingPoints::POINT_LIGHTS);
+        uboPointLights->createStreamingUBO(MAX_POINT_LIGHTS * shader_structs::PointLight::getDataSizeStd140());
 
 		auto& sm = ShaderManager::getInstance();
 		auto& spm = ShaderProgramManager::getInstance();
@@ -110,6 +184,16 @@ void OpenGLWindow024::initializeScene()
 		mainShaderProgram.addShaderToProgram(sm.getFragmentShader(ShaderKeys::diffuseLight()));
         mainShaderProgram.addShaderToProgram(sm.getFragmentShader(ShaderKeys::specularHighlight()));
         mainShaderProgram.addShaderToProgram(sm.getFragmentShader(ShaderKeys::pointLight()));
+
+        // Variants of main program are compiled on demand for the number of point lights being rendered
+        spm.createShaderProgramVariants("main", {
+            { GL_VERTEX_SHADER, "data/shaders/tut024-ubos/shader.vert" },
+            { GL_FRAGMENT_SHADER, "data/shaders/tut024-ubos/shader.frag" },
+            { GL_FRAGMENT_SHADER, "data/shaders/lighting/ambientLight.frag" },
+            { GL_FRAGMENT_SHADER, "data/shaders/lighting/diffuseLight.frag" },
+            { GL_FRAGMENT_SHADER, "data/shaders/lighting/specularHighlight.frag" },
+            { GL_FRAGMENT_SHADER, "data/shaders/lighting/pointLight.frag" }
+        });
         
         auto& heightmapShaderProgram = spm.createShaderProgram(static_meshes_3D::Heightmap::MULTILAYER_SHADER_PROGRAM_KEY);
         sm.loadVertexShader(static_meshes_3D::Heightmap::MULTILAYER_SHADER_PROGRAM_KEY, "data/shaders/tut024-ubos/multilayer_heightmap.vert");
@@ -142,6 +226,10 @@ void OpenGLWindow024::initializeScene()
 
         heightmap = std::make_unique<static_meshes_3D::Heightmap>("data/heightmaps/tut019.png", true, true, true);
 
+        toriInstances = std::make_unique<static_meshes_3D::InstanceBuffer>();
+        barnInstances = std::make_unique<static_meshes_3D::InstanceBuffer>();
+        pointLightInstances = std::make_unique<static_meshes_3D::InstanceBuffer>();
+
 		spm.linkAllPrograms();
 
         // Bind uniform blocks with binding points for main program
@@ -181,44 +269,65 @@ void OpenGLWindow024::renderScene()
 	mm.setOrthoProjectionMatrix(getOrthoProjectionMatrix());
 	mm.setViewMatrix(camera.getViewMatrix());
 
-    // Set matrices uniform buffer object data - we just set projection and view matrix here, they are
+    // Stream matrices uniform buffer object data - we just set projection and view matrix here, they are
     // consistent across all shader programs
-    uboMatrices->bindUBO();
-    uboMatrices->setBufferData(0, glm::value_ptr(getProjectionMatrix()), sizeof(glm::mat4));
-    uboMatrices->setBufferData(sizeof(glm::mat4), glm::value_ptr(camera.getViewMatrix()), sizeof(glm::mat4));
-
-    // Set point lights uniform buffer object data - in our case the poing lights are same across all shader programs
-    uboPointLights->bindUBO();
-    GLsizeiptr offset = 0;
-    for (const auto& pointLight : pointLights)
+    const glm::mat4 matrices[2] = { getProjectionMatrix(), camera.getViewMatrix() };
+    uboMatrices->setStreamingData(UniformBlockBindingPoints::MATRICES, matrices, sizeof(matrices));
+
+    // Stream point lights uniform buffer object data - in our case the point lights are same across all shader programs.
+    // Whole block is reserved, so that bound range covers all the lights the shader block declares (binding smaller range
+    // than the declared block isn't allowed). Unused entries are zeroed, otherwise they'd hold data of older frames
+    const auto pointLightDataSize = shader_structs::PointLight::getDataSizeStd140();
+    const auto pointLightsBlockSize = MAX_POINT_LIGHTS * pointLightDataSize;
+    size_t pointLightsOffset = 0;
+    auto ptrPointLightsData = static_cast<unsigned char*>(uboPointLights->reserveStreamingData(pointLightsBlockSize, pointLightsOffset));
+    if (ptrPointLightsData != nullptr)
     {
-        uboPointLights->setBufferData(offset, pointLight.getDataPointer(), pointLight.getDataSizeStd140());
-        offset += pointLight.getDataSizeStd140();
+        for (const auto& pointLight : pointLights)
+        {
+            memcpy(ptrPointLightsData, pointLight.getDataPointer(), pointLightDataSize);
+            ptrPointLightsData += pointLightDataSize;
+        }
+
+        memset(ptrPointLightsData, 0, (MAX_POINT_LIGHTS - pointLights.size()) * pointLightDataSize);
+        uboPointLights->bindBufferRangeToBindingPoint(UniformBlockBindingPoints::POINT_LIGHTS, pointLightsOffset, pointLightsBlockSize);
+    }
+
+	// Render skybox first with only ambient light and without point lights
+    // Btw it's a cool effect if you leave point lights here, looks like the sky is illuminated :)
+	auto& skyboxProgram = getMainShaderProgram(0);
+	skyboxProgram.useProgram();
+	skyboxProgram.setModelAndNormalMatrix(glm::mat4(1.0f));
+	skyboxProgram[ShaderConstants::color()] = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+	skyboxProgram[ShaderConstants::sampler()] = 0;
+    ambientLight.setUniform(skyboxProgram, ShaderConstants::ambientLight());
+	shader_structs::DiffuseLight::none().setUniform(skyboxProgram, ShaderConstants::diffuseLight());
+	shader_structs::Material::none().setUniform(skyboxProgram, ShaderConstants::material());
+    if (!useShaderVariants) {
+        skyboxProgram[ShaderConstants::numPointLights()] = 0;
     }
+	skybox->render(camera.getEye(), skyboxProgram);
 
-	// Set up some common properties in the main shader program
-	auto& mainProgram = spm.getShaderProgram("main");
+	// Set up common properties in the main shader program (with variants or instancing, it's a different program than the skybox one)
+	const auto numPointLights = static_cast<int>(pointLights.size());
+	auto& mainProgram = getMainShaderProgram(numPointLights, useInstancing);
 	mainProgram.useProgram();
-	mainProgram.setModelAndNormalMatrix(glm::mat4(1.0f));
 	mainProgram[ShaderConstants::color()] = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
 	mainProgram[ShaderConstants::sampler()] = 0;
-	
-	// Render skybox first with only ambient light and without point lights
-    // Btw it's a cool effect if you leave point lights here, looks like the sky is illuminated :)
     ambientLight.setUniform(mainProgram, ShaderConstants::ambientLight());
 	shader_structs::DiffuseLight::none().setUniform(mainProgram, ShaderConstants::diffuseLight());
-	shader_structs::Material::none().setUniform(mainProgram, ShaderConstants::material());
-    mainProgram[ShaderConstants::numPointLights()] = 0;
-	skybox->render(camera.getEye(), mainProgram);
 
 	// Set up material properties for specular highlights and restore point light effects
     SamplerManager::getInstance().getSampler("main").bind();
 	mainProgram[ShaderConstants::eyePosition()] = camera.getEye();
 	shinyMaterial.setUniform(mainProgram, ShaderConstants::material());
-    mainProgram[ShaderConstants::numPointLights()] = static_cast<int>(pointLights.size());
+    if (!useShaderVariants) {
+        mainProgram[ShaderConstants::numPointLights()] = numPointLights;
+    }
 	TextureManager::getInstance().getTexture("scifi_metal").bind(0);
 
 	// Render triple tori on their positions
+	std::vector<glm::mat4> toriModelMatrices;
 	int i = 0;
     for (const auto& position : tripleToriPositions)
     {
@@ -226,49 +335,49 @@ void OpenGLWindow024::renderScene()
         basicModelMatrix = glm::translate(basicModelMatrix, glm::vec3(0.0f, torus->getMainRadius() + torus->getTubeRadius(), 0.0f));
         basicModelMatrix = glm::rotate(basicModelMatrix, rotationAngle, glm::vec3(0.0f, 1.0f, 0.0f));
 
-        // Render first torus with the calculated model matrix
-        mainProgram.setModelAndNormalMatrix(basicModelMatrix);
-        torus->render();
+        // First torus uses the calculated model matrix
+        toriModelMatrices.push_back(basicModelMatrix);
 
-        // Rotate by 90 degrees around Y axis and render torus again
+        // Rotate by 90 degrees around Y axis for the second torus
         // Also scale slightly, so that the tori won't overlap
         const auto secondScaleVector = i % 2 == 0 ? glm::vec3(1.01f, 1.01f, 1.01f) : glm::vec3(0.6f, 0.6f, 0.6f);
         auto secondToriModelMatrix = glm::scale(basicModelMatrix, secondScaleVector);
         secondToriModelMatrix = glm::rotate(secondToriModelMatrix, glm::radians(90.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-        mainProgram.setModelAndNormalMatrix(secondToriModelMatrix);
-        torus->render();
+        toriModelMatrices.push_back(secondToriModelMatrix);
 
-        // Rotate by 90 degrees around X axis and render torus again
+        // Rotate by 90 degrees around X axis for the third torus
         // Also scale slightly, so that the tori won't overlap
         const auto thirdScaleVector = i % 2 == 0 ? glm::vec3(1.02f, 1.02f, 1.02f) : glm::vec3(0.36f, 0.36f, 0.36f);
         auto thirdToriModelMatrix = glm::scale(basicModelMatrix, thirdScaleVector);
         thirdToriModelMatrix = glm::rotate(thirdToriModelMatrix, glm::radians(90.0f), glm::vec3(1.0f, 0.0f, 0.0f));
-        mainProgram.setModelAndNormalMatrix(thirdToriModelMatrix);
-        torus->render();
+        toriModelMatrices.push_back(thirdToriModelMatrix);
 
         i++;
     }
 
+    renderMeshCopies(mainProgram, *torus, *toriInstances, toriModelMatrices);
+
     // Render barns with no specular reflections
     shader_structs::Material::none().setUniform(mainProgram, ShaderConstants::material());
-    for (const auto& barnPosition : barnPositions)
-    {
-        auto basicModelMatrix = glm::translate(glm::mat4(1.0f), barnPosition);
-        mainProgram.setModelAndNormalMatrix(basicModelMatrix);
-        barn->render();
+    std::vector<glm::mat4> barnModelMatrices;
+    for (const auto& barnPosition : barnPositions) {
+        barnModelMatrices.push_back(glm::translate(glm::mat4(1.0f), barnPosition));
     }
 
-    // Render all point lights
-    for (auto& pointLight : pointLights)
+    renderMeshCopies(mainProgram, *barn, *barnInstances, barnModelMatrices);
+
+    // Render all point lights, every sphere has color of its light
+    std::vector<glm::mat4> pointLightModelMatrices;
+    std::vector<glm::vec4> pointLightColors;
+    for (const auto& pointLight : pointLights)
     {
-        auto pointLightModelMatrix = glm::translate(glm::mat4(1.0f), pointLight.position);
-        mainProgram.setModelAndNormalMatrix(pointLightModelMatrix);
-        mainProgram[ShaderConstants::color()] = glm::vec4(pointLight.color, 1.0f);
-        tm.getTexture("ice").bind();
-        sphere->render();
-        pointLight.update(sof(20.0f), heightmap->getRenderedHeightAtPosition(heightMapSize, pointLight.position) + sphere->getRadius() + 1.0f);
+        pointLightModelMatrices.push_back(glm::translate(glm::mat4(1.0f), pointLight.position));
+        pointLightColors.push_back(glm::vec4(pointLight.color, 1.0f));
     }
 
+    tm.getTexture("ice").bind();
+    renderMeshCopies(mainProgram, *sphere, *pointLightInstances, pointLightModelMatrices, pointLightColors);
+
     // Render heightmap
     auto& heightmapShaderProgram = static_meshes_3D::Heightmap::getMultiLayerShaderProgram();
     heightmapShaderProgram.useProgram();
@@ -287,7 +396,11 @@ void OpenGLWindow024::renderScene()
     heightmap->renderMultilayered({ "cobblestone_mossy", "grass", "rocky_terrain" }, { 0.2f, 0.3f, 0.55f, 0.7f });
 
 	// Render HUD
-    hud->renderHUD(ambientLight, *pointLights.begin(), static_cast<int>(pointLights.size()));
+    hud->renderHUD(ambientLight, *pointLights.begin(), numPointLights, useShaderVariants, useInstancing, lightCountBenchmark.isRunning());
+
+    // Everything using this frame's uniform data has been issued, move streaming UBOs to their next regions
+    uboMatrices->finishStreamingFrame();
+    uboPointLights->finishStreamingFrame();
 }
 
 void OpenGLWindow024::updateScene()
@@ -304,6 +417,51 @@ void OpenGLWindow024::updateScene()
         shinyMaterial.isEnabled = !shinyMaterial.isEnabled;
     }
 
+    if (keyPressedOnce(GLFW_KEY_V) && !lightCountBenchmark.isRunning()) {
+        useShaderVariants = !useShaderVariants;
+    }
+
+    if (keyPressedOnce(GLFW_KEY_I)) {
+        useInstancing = !useInstancing;
+    }
+
+    if (keyPressedOnce(GLFW_KEY_B) && !lightCountBenchmark.isRunning())
+    {
+        // Remember the scene setup and measure without vertical synchronization, it would cap the frame times
+        pointLightsBeforeBenchmark = pointLights;
+        useShaderVariantsBeforeBenchmark = useShaderVariants;
+        isVerticalSynchronizationBeforeBenchmark = isVerticalSynchronizationEnabled();
+        setVerticalSynchronization(false);
+        lightCountBenchmark.start();
+    }
+    else if (lightCountBenchmark.isRunning())
+    {
+        lightCountBenchmark.update(getTimeDelta());
+        if (lightCountBenchmark.isRunning())
+        {
+            // Lights are spread on a circle, so that every step lights the scene the same way for both program kinds
+            useShaderVariants = lightCountBenchmark.isUsingShaderVariants();
+            const auto numPointLights = static_cast<size_t>(lightCountBenchmark.getNumPointLights());
+            while (pointLights.size() > numPointLights) {
+                pointLights.pop_back();
+            }
+
+            while (pointLights.size() < numPointLights)
+            {
+                const auto angle = glm::radians(360.0f) * static_cast<float>(pointLights.size()) / static_cast<float>(MAX_POINT_LIGHTS);
+                const glm::vec3 position(100.0f * std::cos(angle), 20.0f, 100.0f * std::sin(angle));
+                const glm::vec3 direction(-std::sin(angle), 0.0f, std::cos(angle));
+                pointLights.push_back(PointLightExtended::createRandomPointLight(position, direction));
+            }
+        }
+        else
+        {
+            pointLights = pointLightsBeforeBenchmark;
+            useShaderVariants = useShaderVariantsBeforeBenchmark;
+            setVerticalSynchronization(isVerticalSynchronizationBeforeBenchmark);
+        }
+    }
+
     auto& firstPointLight = *pointLights.begin();
 
     auto syncPointLightsAttenuations = [this, &firstPointLight]()
@@ -409,6 +567,17 @@ void OpenGLWindow024::updateScene()
 
     // Update variables
     rotationAngle += sof(glm::radians(30.0f));
+
+    // Point lights only read the heightmap, so they can move in parallel (they are rendered only after all of them are done)
+    const auto pointLightSpeed = sof(20.0f);
+    submitParallelUpdate(pointLights.size(), 0, [pointLightSpeed](const size_t firstPointLight, const size_t lastPointLight)
+    {
+        for (auto i = firstPointLight; i < lastPointLight; i++)
+        {
+            auto& pointLight = pointLights[i];
+            pointLight.update(pointLightSpeed, heightmap->getRenderedHeightAtPosition(heightMapSize, pointLight.position) + sphere->getRadius() + 1.0f);
+        }
+    });
 }
 
 void OpenGLWindow024::releaseScene()
@@ -425,8 +594,13 @@ void OpenGLWindow024::releaseScene()
     uboMatrices.reset();
     uboPointLights.reset();
 
+    toriInstances.reset();
+    barnInstances.reset();
+    pointLightInstances.reset();
+
     heightmap.reset();
 	hud.reset();
+	static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 } // namespace tutorial024
@@ -21,8 +21,11 @@ HUD024::HUD024(const OpenGLWindow& window)
     });
 }
 
-void HUD024::renderHUD(const shader_structs::AmbientLight& ambientLight, const shader_structs::PointLight& pointLight, const int numPointLights) const
+void HUD024::renderHUD(const shader_structs::AmbientLight& ambientLight, const shader_structs::PointLight& pointLight, const int numPointLights,
+    const bool useShaderVariants, const bool useInstancing, const bool isBenchmarkRunning) const
 {
+    FreeTypeFont::PrintBatch printBatch;
+
     printBuilder().print(10, 10, "FPS: {}", _window.getFPS());
     printBuilder().print(10, 40, "Vertical Synchronization: {} (Press F3 to toggle)", _window.isVerticalSynchronizationEnabled() ? "On" : "Off");
     
@@ -36,6 +39,11 @@ void HUD024::renderHUD(const shader_structs::AmbientLight& ambientLight, const s
     printBuilder().print(10, 190, "   - linear attenuation: {} (press '3' and '4' to change)", pointLight.linearAttenuation);
     printBuilder().print(10, 220, "   - exponential attenuation: {} (press '5' and '6' to change)", pointLight.exponentialAttenuation);
 
+    // Print information about used shader program and the benchmark
+    printBuilder().print(10, 250, "Shader program: {} (Press 'V' to toggle)", useShaderVariants ? "variant for exact point lights count" : "generic");
+    printBuilder().print(10, 280, "Instanced rendering: {} (Press 'I' to toggle)", useInstancing ? "On" : "Off");
+    printBuilder().print(10, 310, "Point lights count benchmark: {}", isBenchmarkRunning ? "running, results will be printed to console" : "press 'B' to run");
+
     printBuilder()
         .fromRight()
         .fromBottom()
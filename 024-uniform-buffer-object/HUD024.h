@@ -22,7 +22,8 @@ public:
      * Renders HUD.
      */
     void renderHUD() const override {} // Don't need this, but had to override, so that class is not abstract
-    void renderHUD(const shader_structs::AmbientLight& ambientLight, const shader_structs::PointLight& pointLight, const int numPointLights) const;
+    void renderHUD(const shader_structs::AmbientLight& ambientLight, const shader_structs::PointLight& pointLight, const int numPointLights,
+        bool useShaderVariants, bool useInstancing, bool isBenchmarkRunning) const;
 };
 
 } // namespace tutorial024
@@ -0,0 +1,96 @@
+// STL
+#include <iostream>
+#include <iomanip>
+
+// Project
+#include "lightCountBenchmark.h"
+
+namespace opengl4_mbsoftworks {
+namespace tutorial024 {
+
+const int LightCountBenchmark::WARMUP_FRAMES = 30;
+const int LightCountBenchmark::MEASURED_FRAMES = 120;
+
+LightCountBenchmark::LightCountBenchmark(const int maxPointLights)
+    : maxPointLights_(maxPointLights)
+{
+}
+
+void LightCountBenchmark::start()
+{
+    isRunning_ = true;
+    numPointLights_ = 1;
+    useShaderVariants_ = false;
+    frameIndex_ = 0;
+    measuredTime_ = 0.0;
+    genericProgramFrameTimes_.assign(maxPointLights_, 0.0);
+    programVariantFrameTimes_.assign(maxPointLights_, 0.0);
+    std::cout << "Starting point lights count benchmark, this will take a while..." << std::endl;
+}
+
+bool LightCountBenchmark::isRunning() const
+{
+    return isRunning_;
+}
+
+void LightCountBenchmark::update(const double frameTime)
+{
+    if (!isRunning_) {
+        return;
+    }
+
+    // Warmup frames are not measured, they let the new program variant compile and frame times settle
+    if (frameIndex_++ >= WARMUP_FRAMES) {
+        measuredTime_ += frameTime;
+    }
+
+    if (frameIndex_ < WARMUP_FRAMES + MEASURED_FRAMES) {
+        return;
+    }
+
+    auto& frameTimes = useShaderVariants_ ? programVariantFrameTimes_ : genericProgramFrameTimes_;
+    frameTimes[numPointLights_ - 1] = measuredTime_ * 1000.0 / MEASURED_FRAMES;
+    frameIndex_ = 0;
+    measuredTime_ = 0.0;
+
+    // Every lights count is measured with generic program first and then with the variant
+    useShaderVariants_ = !useShaderVariants_;
+    if (!useShaderVariants_ && ++numPointLights_ > maxPointLights_)
+    {
+        isRunning_ = false;
+        numPointLights_ = 1;
+        printResults();
+    }
+}
+
+int LightCountBenchmark::getNumPointLights() const
+{
+    return numPointLights_;
+}
+
+bool LightCountBenchmark::isUsingShaderVariants() const
+{
+    return useShaderVariants_;
+}
+
+void LightCountBenchmark::printResults() const
+{
+    const auto previousFlags = std::cout.flags();
+    const auto previousPrecision = std::cout.precision();
+    std::cout << "Point lights count benchmark results (average frame time in milliseconds):" << std::endl;
+    std::cout << std::setw(8) << "Lights" << std::setw(12) << "Generic" << std::setw(12) << "Variant" << std::setw(12) << "Speedup" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    for (auto i = 0; i < maxPointLights_; i++)
+    {
+        const auto genericTime = genericProgramFrameTimes_[i];
+        const auto variantTime = programVariantFrameTimes_[i];
+        std::cout << std::setw(8) << i + 1 << std::setw(12) << genericTime << std::setw(12) << variantTime
+            << std::setw(11) << (variantTime > 0.0 ? genericTime / variantTime : 0.0) << "x" << std::endl;
+    }
+
+    std::cout.flags(previousFlags);
+    std::cout.precision(previousPrecision);
+}
+
+} // namespace tutorial024
+} // namespace opengl4_mbsoftworks
@@ -0,0 +1,70 @@
+#pragma once
+
+// STL
+#include <vector>
+
+namespace opengl4_mbsoftworks {
+namespace tutorial024 {
+
+/**
+ * Benchmark, that sweeps number of point lights from 1 to maximum and for every count measures
+ * average frame time with the generic shader program (looping over lights count set by uniform)
+ * and with the shader program variant compiled for exactly that number of lights.
+ * Results are printed to standard output once the benchmark finishes.
+ */
+class LightCountBenchmark
+{
+public:
+    static const int WARMUP_FRAMES; // Frames rendered before measuring (new variants get compiled here)
+    static const int MEASURED_FRAMES; // Frames measured for every light count and shader program kind
+
+    /**
+     * Creates benchmark sweeping point lights count up to given maximum.
+     */
+    LightCountBenchmark(int maxPointLights);
+
+    /**
+     * Starts (or restarts) the benchmark from one point light.
+     */
+    void start();
+
+    /**
+     * Checks, if the benchmark is running.
+     */
+    bool isRunning() const;
+
+    /**
+     * Advances the benchmark by one frame. Once the benchmark finishes, results are printed.
+     *
+     * @param frameTime  Duration of the last frame in seconds
+     */
+    void update(double frameTime);
+
+    /**
+     * Gets number of point lights, that should be rendered in the current benchmark step.
+     */
+    int getNumPointLights() const;
+
+    /**
+     * Checks, if shader program variants should be used in the current benchmark step.
+     */
+    bool isUsingShaderVariants() const;
+
+private:
+    /**
+     * Prints results of the benchmark as a table to standard output.
+     */
+    void printResults() const;
+
+    int maxPointLights_; // Maximal number of point lights to sweep up to
+    bool isRunning_{ false }; // Flag telling, whether the benchmark is running
+    int numPointLights_{ 1 }; // Number of point lights in the current step
+    bool useShaderVariants_{ false }; // Whether shader program variants are used in the current step
+    int frameIndex_{ 0 }; // Index of frame within the current step
+    double measuredTime_{ 0.0 }; // Time of measured frames within the current step
+    std::vector<double> genericProgramFrameTimes_; // Average frame times (ms) with generic program, indexed with lights count - 1
+    std::vector<double> programVariantFrameTimes_; // Average frame times (ms) with program variants, indexed with lights count - 1
+};
+
+} // namespace tutorial024
+} // namespace opengl4_mbsoftworks
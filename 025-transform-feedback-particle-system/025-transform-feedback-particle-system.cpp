@@ -18,6 +18,7 @@
 #include "../common_classes/textureManager.h"
 #include "../common_classes/samplerManager.h"
 #include "../common_classes/freeTypeFontManager.h"
+#include "../common_classes/glStateCache.h"
 #include "../common_classes/matrixManager.h"
 #include "../common_classes/uniformBufferObject.h"
 
@@ -195,7 +196,7 @@ void OpenGLWindow025::renderScene()
     snowCoveredPlainGround->render();
 
     // Enable blending to render particles and disable writing to depth buffer
-    glEnable(GL_BLEND);
+    GLStateCache::getInstance().enable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE);
     glDepthMask(GL_FALSE);
 
@@ -214,7 +215,7 @@ void OpenGLWindow025::renderScene()
 
     // Re-enable writing to depth buffer and disable blending
     glDepthMask(GL_TRUE);
-    glDisable(GL_BLEND);
+    GLStateCache::getInstance().disable(GL_BLEND);
 
     // Render HUD
     hud->renderHUD(fireParticleSystem->getNumParticles(), snowParticleSystem->getNumParticles(), fogParameters.isEnabled, isFireDragged);
@@ -290,6 +291,7 @@ void OpenGLWindow025::releaseScene()
     TextureManager::getInstance().clearTextureCache();
     SamplerManager::getInstance().clearSamplerCache();
     FreeTypeFontManager::getInstance().clearFreeTypeFontCache();
+    static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 } // namespace tutorial025
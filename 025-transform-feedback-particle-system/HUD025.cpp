@@ -24,6 +24,8 @@ HUD025::HUD025(const OpenGLWindow& window, const shader_structs::AmbientLight& a
 
 void HUD025::renderHUD(int numFireParticlesOnScene, int numSnowParticlesOnScene, bool isFogEnabled, bool isFireDragged) const
 {
+    FreeTypeFont::PrintBatch printBatch;
+
     printBuilder().print(10, 10, "FPS: {}", _window.getFPS());
     printBuilder().print(10, 40, "Vertical Synchronization: {} (Press F3 to toggle)", _window.isVerticalSynchronizationEnabled() ? "On" : "Off");
     
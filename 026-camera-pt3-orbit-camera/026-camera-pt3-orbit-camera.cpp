@@ -193,6 +193,7 @@ void OpenGLWindow026::releaseScene()
 	FreeTypeFontManager::getInstance().clearFreeTypeFontCache();
 
 	hud.reset();
+	static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 void OpenGLWindow026::updateScene()
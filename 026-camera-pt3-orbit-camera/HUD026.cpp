@@ -24,6 +24,8 @@ HUD026::HUD026(const OpenGLWindow& window)
 
 void HUD026::renderHUD(const OrbitCamera& orbitCamera, bool isWireframeModeOn) const
 {
+    FreeTypeFont::PrintBatch printBatch;
+
     printBuilder().print(10, 10, "FPS: {}", _window.getFPS());
     printBuilder().print(10, 40, "Vertical Synchronization: {} (Press F3 to toggle)", _window.isVerticalSynchronizationEnabled() ? "On" : "Off");
 
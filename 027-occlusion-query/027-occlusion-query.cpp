@@ -1,5 +1,6 @@
 // STL
 #include <iostream>
+#include <iterator>
 #include <memory>
 
 // GLM
@@ -10,6 +11,8 @@
 #include "027-occlusion-query.h"
 #include "HUD027.h"
 #include "objectsWithOccluderManager.h"
+#include "frustumCullingBenchmark.h"
+#include "spatialHashGridBenchmark.h"
 
 #include "../common_classes/flyingCamera.h"
 
@@ -42,6 +45,10 @@ shader_structs::DiffuseLight diffuseLight(glm::vec3(1.0f, 1.0f, 1.0f), glm::vec3
 
 bool visualizeOccluders = false;
 bool isWireframeModeOn = false;
+bool useInstancing = false;
+bool useCommandBuffers = false;
+FrustumCullingBenchmark frustumCullingBenchmark; // Benchmark comparing frustum culling methods on many objects
+SpatialHashGridBenchmark spatialHashGridBenchmark; // Benchmark of spatial hash grid with many moving objects
 
 void OpenGLWindow027::initializeScene()
 {
@@ -66,9 +73,24 @@ void OpenGLWindow027::initializeScene()
 		mainShaderProgram.addShaderToProgram(sm.getFragmentShader(ShaderKeys::diffuseLight()));
         mainShaderProgram.addShaderToProgram(sm.getFragmentShader(ShaderKeys::specularHighlight()));
 
+        // Instanced variant of main program is compiled on demand, when instanced rendering gets turned on
+        spm.createShaderProgramVariants("main", {
+            { GL_VERTEX_SHADER, "data/shaders/tut021-specular-highlight/shader.vert" },
+            { GL_FRAGMENT_SHADER, "data/shaders/tut021-specular-highlight/shader.frag" },
+            { GL_FRAGMENT_SHADER, "data/shaders/lighting/ambientLight.frag" },
+            { GL_FRAGMENT_SHADER, "data/shaders/lighting/diffuseLight.frag" },
+            { GL_FRAGMENT_SHADER, "data/shaders/lighting/specularHighlight.frag" }
+        });
+
         auto& singleColorShaderProgram = spm.createShaderProgram("single-color");
         singleColorShaderProgram.addShaderToProgram(sm.getVertexShader("single-color"));
         singleColorShaderProgram.addShaderToProgram(sm.getFragmentShader("single-color"));
+
+        // Instanced variant of single color program renders many occluder boxes at once
+        spm.createShaderProgramVariants("single-color", {
+            { GL_VERTEX_SHADER, "data/shaders/single-color/shader.vert" },
+            { GL_FRAGMENT_SHADER, "data/shaders/single-color/shader.frag" }
+        });
 		
         skybox = std::make_unique<static_meshes_3D::Skybox>("data/skyboxes/jajlands1", "jpg");
 		hud = std::make_unique<HUD027>(*this);
@@ -82,6 +104,10 @@ void OpenGLWindow027::initializeScene()
         plainGround = std::make_unique<static_meshes_3D::PlainGround>(true, true, true);
         ObjectsWithOccludersManager::getInstance().initialize();
 
+        // Ground hides objects emerging from below it, its triangle strip is split into two triangles (objects themselves are registered by the manager)
+        const std::vector<glm::vec3> groundPositions(std::begin(static_meshes_3D::PlainGround::vertices), std::end(static_meshes_3D::PlainGround::vertices));
+        ObjectsWithOccludersManager::getInstance().getSoftwareOcclusionCuller().addOccluder(groundPositions, { 0, 1, 2, 2, 1, 3 });
+
 		spm.linkAllPrograms();
 	}
 	catch (const std::runtime_error& ex)
@@ -98,7 +124,7 @@ void OpenGLWindow027::initializeScene()
 
 void OpenGLWindow027::renderScene()
 {
-	const auto& spm = ShaderProgramManager::getInstance();
+	auto& spm = ShaderProgramManager::getInstance();
 	const auto& tm = TextureManager::getInstance();
 	auto& mm = MatrixManager::getInstance();
 	
@@ -138,6 +164,7 @@ void OpenGLWindow027::renderScene()
     plainGround->render();
 
     // Now before rendering, let's update all objects (generate new, remove some that flew high) and perform occlusion query
+    // (objects have been moved by update jobs already)
     auto& objectsWithOccludersManager = ObjectsWithOccludersManager::getInstance();
     objectsWithOccludersManager.updateAndPerformOcclusionQuery(sof(1.0f));
 
@@ -146,8 +173,30 @@ void OpenGLWindow027::renderScene()
         glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
     }
 
-    // Render all objects, that passed the occlusion test
-    objectsWithOccludersManager.renderAllVisibleObjects();
+    // Render all objects, that passed the occlusion test - either one by one (sorted or recorded in parallel) or one instanced draw per mesh.
+    // With conditional rendering, all objects in the frustum are rendered and GPU itself skips the ones, whose occluders weren't visible
+    if (objectsWithOccludersManager.isConditionalRenderingActive()) {
+        objectsWithOccludersManager.renderAllObjectsConditionally();
+    }
+    else if (useInstancing)
+    {
+        auto& instancedProgram = spm.getShaderProgramVariant("main", ShaderDefines().define("INSTANCED"));
+        instancedProgram.useProgram();
+        instancedProgram[ShaderConstants::projectionMatrix()] = getProjectionMatrix();
+        instancedProgram[ShaderConstants::viewMatrix()] = flyingCamera.getViewMatrix();
+        instancedProgram[ShaderConstants::color()] = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+        instancedProgram[ShaderConstants::sampler()] = 0;
+        instancedProgram[ShaderConstants::eyePosition()] = flyingCamera.getEye();
+        ambientLight.setUniform(instancedProgram, ShaderConstants::ambientLight());
+        diffuseLight.setUniform(instancedProgram, ShaderConstants::diffuseLight());
+        objectsWithOccludersManager.renderAllVisibleObjectsInstanced(instancedProgram);
+    }
+    else if (useCommandBuffers) {
+        objectsWithOccludersManager.renderAllVisibleObjectsRecorded();
+    }
+    else {
+        objectsWithOccludersManager.renderAllVisibleObjects();
+    }
 
     // Restore normal drawing mode
     glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
@@ -158,7 +207,13 @@ void OpenGLWindow027::renderScene()
     }
 
 	// Render HUD
-    hud->renderHUD(objectsWithOccludersManager.getNumObjects(), objectsWithOccludersManager.getNumVisibleObjects(), isWireframeModeOn, visualizeOccluders);
+    const auto& renderQueue = objectsWithOccludersManager.getRenderQueue();
+    hud->renderHUD(objectsWithOccludersManager.getNumObjects(), objectsWithOccludersManager.getNumVisibleObjects(), isWireframeModeOn, visualizeOccluders,
+        renderQueue.isSortingEnabled(), renderQueue.getStatistics(), useInstancing, useCommandBuffers, objectsWithOccludersManager.getCommandRecorder(),
+        objectsWithOccludersManager.isFrustumCullingEnabled(), objectsWithOccludersManager.getNumFrustumCulledObjects(),
+        ObjectsWithOccludersManager::getOcclusionQueryModeName(objectsWithOccludersManager.getOcclusionQueryMode()),
+        objectsWithOccludersManager.getNumIssuedQueries(), objectsWithOccludersManager.getNumPendingQueries(),
+        objectsWithOccludersManager.isConditionalRenderingEnabled(), objectsWithOccludersManager.getObjectGrid().getNumCells());
 }
 
 void OpenGLWindow027::releaseScene()
@@ -175,6 +230,7 @@ void OpenGLWindow027::releaseScene()
 	FreeTypeFontManager::getInstance().clearFreeTypeFontCache();
 
 	hud.reset();
+	static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 void OpenGLWindow027::updateScene()
@@ -195,7 +251,59 @@ void OpenGLWindow027::updateScene()
         visualizeOccluders = !visualizeOccluders;
     }
 
-    // Update camera
+    if (keyPressedOnce(GLFW_KEY_O))
+    {
+        auto& renderQueue = ObjectsWithOccludersManager::getInstance().getRenderQueue();
+        renderQueue.setSortingEnabled(!renderQueue.isSortingEnabled());
+    }
+
+    if (keyPressedOnce(GLFW_KEY_I)) {
+        useInstancing = !useInstancing;
+    }
+
+    if (keyPressedOnce(GLFW_KEY_P)) {
+        useCommandBuffers = !useCommandBuffers;
+    }
+
+    if (keyPressedOnce(GLFW_KEY_F))
+    {
+        auto& manager = ObjectsWithOccludersManager::getInstance();
+        manager.setFrustumCullingEnabled(!manager.isFrustumCullingEnabled());
+    }
+
+    // Cycle through occlusion query modes - blocking, asynchronous, batched and software
+    if (keyPressedOnce(GLFW_KEY_M))
+    {
+        auto& manager = ObjectsWithOccludersManager::getInstance();
+        const auto nextMode = (static_cast<int>(manager.getOcclusionQueryMode()) + 1) % ObjectsWithOccludersManager::NUM_OCCLUSION_QUERY_MODES;
+        manager.setOcclusionQueryMode(static_cast<ObjectsWithOccludersManager::OcclusionQueryMode>(nextMode));
+    }
+
+    if (keyPressedOnce(GLFW_KEY_G))
+    {
+        auto& manager = ObjectsWithOccludersManager::getInstance();
+        manager.setConditionalRenderingEnabled(!manager.isConditionalRenderingEnabled());
+    }
+
+    // Benchmark uses the camera of the last rendered frame
+    if (keyPressedOnce(GLFW_KEY_B))
+    {
+        const auto& mm = MatrixManager::getInstance();
+        frustumCullingBenchmark.run(mm.getProjectionMatrix() * mm.getViewMatrix());
+    }
+
+    if (keyPressedOnce(GLFW_KEY_H)) {
+        spatialHashGridBenchmark.run();
+    }
+
+    // Objects move independently of each other, so they are moved in parallel with the camera update below
+    auto& objectsWithOccludersManager = ObjectsWithOccludersManager::getInstance();
+    const auto deltaTime = sof(1.0f);
+    submitParallelUpdate(objectsWithOccludersManager.getNumObjects(), 256, [&objectsWithOccludersManager, deltaTime](const size_t firstObject, const size_t lastObject) {
+        objectsWithOccludersManager.moveObjects(deltaTime, firstObject, lastObject);
+    });
+
+    // Update camera (it calls GLFW, so it must stay on the main thread)
     int posX, posY, width, height;
     glfwGetWindowPos(getWindow(), &posX, &posY);
     glfwGetWindowSize(getWindow(), &width, &height);
@@ -21,8 +21,14 @@ HUD027::HUD027(const OpenGLWindow& window)
     });
 }
 
-void HUD027::renderHUD(size_t numObjects, size_t numVisibleObjects, bool isWireframeModeOn, bool visualizeOccluders) const
+void HUD027::renderHUD(size_t numObjects, size_t numVisibleObjects, bool isWireframeModeOn, bool visualizeOccluders,
+    bool isSortingEnabled, const RenderQueue::Statistics& renderQueueStatistics, bool useInstancing,
+    bool useCommandBuffers, const ParallelCommandRecorder& commandRecorder, bool isFrustumCullingEnabled, size_t numFrustumCulledObjects,
+    const char* occlusionQueryModeName, size_t numIssuedQueries, size_t numPendingQueries, bool isConditionalRenderingEnabled,
+    size_t numObjectGridCells) const
 {
+    FreeTypeFont::PrintBatch printBatch;
+
     printBuilder().print(10, 10, "FPS: {}", _window.getFPS());
     printBuilder().print(10, 40, "Vertical Synchronization: {} (Press F3 to toggle)", _window.isVerticalSynchronizationEnabled() ? "On" : "Off");
 
@@ -38,6 +44,26 @@ void HUD027::renderHUD(size_t numObjects, size_t numVisibleObjects, bool isWiref
     printBuilder().print(10, 100, "Visualize occluders: {} (Press 'C' to toggle)", visualizeOccluders ? "On" : "Off");
     printBuilder().print(10, 130, "  - Visible / total objects: {} / {} ({}%)", numVisibleObjects, numObjects, visiblePercentage);
 
+    // Print how many state switches did rendering of visible objects take
+    printBuilder().print(10, 160, "Sort objects by state: {} (Press 'O' to toggle)", isSortingEnabled ? "On" : "Off");
+    printBuilder().print(10, 190, "  - Texture / material / mesh switches: {} / {} / {}", renderQueueStatistics.numTextureSwitches,
+        renderQueueStatistics.numMaterialSwitches, renderQueueStatistics.numMeshSwitches);
+    printBuilder().print(10, 220, "Instanced rendering: {} (Press 'I' to toggle)", useInstancing ? "On" : "Off");
+    printBuilder().print(10, 250, "Parallel command recording: {} (Press 'P' to toggle)", useCommandBuffers ? "On" : "Off");
+    if (useCommandBuffers) {
+        printBuilder().print(10, 280, "  - Commands / buffers: {} / {}", commandRecorder.getNumCommands(), commandRecorder.getNumUsedBuffers());
+    }
+
+    // Print how many objects didn't even need the occlusion query
+    printBuilder().print(10, 310, "Frustum culling: {} (Press 'F' to toggle)", isFrustumCullingEnabled ? "On" : "Off");
+    printBuilder().print(10, 340, "  - Objects culled by frustum: {} (Press 'B' to run culling benchmark, results are printed to console)", numFrustumCulledObjects);
+
+    // Print how occlusion queries are performed and how many of them are still waiting for the GPU
+    printBuilder().print(10, 370, "Occlusion queries: {} (Press 'M' to change)", occlusionQueryModeName);
+    printBuilder().print(10, 400, "  - Issued / pending queries: {} / {}", numIssuedQueries, numPendingQueries);
+    printBuilder().print(10, 430, "Conditional rendering: {} (Press 'G' to toggle, needs asynchronous or batched queries)", isConditionalRenderingEnabled ? "On" : "Off");
+    printBuilder().print(10, 460, "Spatial grid cells: {} (Press 'H' to run grid benchmark with 1M moving objects, results are printed to console)", numObjectGridCells);
+
     printBuilder()
         .fromRight()
         .fromBottom()
@@ -3,6 +3,8 @@
 // Project
 #include "../common_classes/OpenGLWindow.h"
 #include "../common_classes/HUD.h"
+#include "../common_classes/commandBuffer.h"
+#include "../common_classes/renderQueue.h"
 
 namespace opengl4_mbsoftworks {
 namespace tutorial027 {
@@ -19,7 +21,11 @@ public:
      * Renders HUD.
      */
     void renderHUD() const override {} // Don't need this, but had to override, so that class is not abstract
-    void renderHUD(size_t numObjects, size_t numVisibleObjects, bool isWireframeModeOn, bool visualizeOccluders) const;
+    void renderHUD(size_t numObjects, size_t numVisibleObjects, bool isWireframeModeOn, bool visualizeOccluders,
+        bool isSortingEnabled, const RenderQueue::Statistics& renderQueueStatistics, bool useInstancing,
+        bool useCommandBuffers, const ParallelCommandRecorder& commandRecorder, bool isFrustumCullingEnabled, size_t numFrustumCulledObjects,
+        const char* occlusionQueryModeName, size_t numIssuedQueries, size_t numPendingQueries, bool isConditionalRenderingEnabled,
+        size_t numObjectGridCells) const;
 };
 
 } // namespace tutorial027
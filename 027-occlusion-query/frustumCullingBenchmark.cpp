@@ -0,0 +1,147 @@
+// STL
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+// Project
+#include "frustumCullingBenchmark.h"
+#include "../common_classes/boundingVolumeHierarchy.h"
+#include "../common_classes/frustumCuller.h"
+#include "../common_classes/softwareOcclusionCuller.h"
+
+namespace opengl4_mbsoftworks {
+namespace tutorial027 {
+
+const size_t FrustumCullingBenchmark::NUM_OBJECTS = 100000;
+const int FrustumCullingBenchmark::NUM_RUNS = 20;
+const float FrustumCullingBenchmark::GROUND_HALF_SIZE = 2000.0f;
+
+namespace {
+
+/**
+ * Runs the function multiple times and returns time of the fastest run in milliseconds.
+ */
+double measureFastestRun(const int numRuns, const std::function<void()>& function)
+{
+    auto bestTime = 0.0;
+    for (auto run = 0; run < numRuns; run++)
+    {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+        function();
+        const auto runTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+        if (run == 0 || runTime < bestTime) {
+            bestTime = runTime;
+        }
+    }
+
+    return bestTime;
+}
+
+} // namespace
+
+void FrustumCullingBenchmark::run(const glm::mat4& projectionViewMatrix)
+{
+    const Frustum frustum(projectionViewMatrix);
+    std::cout << "Starting frustum culling benchmark with " << NUM_OBJECTS << " objects..." << std::endl;
+    generateObjects();
+    results_.clear();
+
+    FrustumCuller frustumCuller;
+    frustumCuller.reserve(objectBoxes_.size());
+    for (const auto& objectBox : objectBoxes_) {
+        frustumCuller.addAABB(objectBox);
+    }
+
+    // Baseline is the simplest loop over the objects, as one would write it without any culling structure
+    size_t numVisibleObjects = 0;
+    const auto loopTime = measureFastestRun(NUM_RUNS, [this, &frustum, &numVisibleObjects]()
+    {
+        numVisibleObjects = 0;
+        for (const auto& objectBox : objectBoxes_)
+        {
+            if (frustum.isAABBVisible(objectBox)) {
+                numVisibleObjects++;
+            }
+        }
+    });
+    results_.push_back({ "Object by object", loopTime, numVisibleObjects });
+
+    std::vector<uint32_t> visibleIndices;
+    frustumCuller.setSIMDEnabled(false);
+    const auto soaTime = measureFastestRun(NUM_RUNS, [&frustumCuller, &frustum, &visibleIndices]() { frustumCuller.cull(frustum, visibleIndices); });
+    results_.push_back({ "SoA scalar", soaTime, visibleIndices.size() });
+
+    frustumCuller.setSIMDEnabled(true);
+    const auto simdTime = measureFastestRun(NUM_RUNS, [&frustumCuller, &frustum, &visibleIndices]() { frustumCuller.cull(frustum, visibleIndices); });
+    results_.push_back({ std::string("SoA ") + FrustumCuller::getSIMDInstructionSet(), simdTime, visibleIndices.size() });
+
+    BoundingVolumeHierarchy bvh;
+    const auto bvhBuildTime = measureFastestRun(1, [this, &bvh]() { bvh.build(objectBoxes_); });
+    const auto bvhTime = measureFastestRun(NUM_RUNS, [&bvh, &frustum, &visibleIndices]() { bvh.query(frustum, visibleIndices); });
+    results_.push_back({ "BVH", bvhTime, visibleIndices.size() });
+
+    // Occluders are rasterized in every run, as they would be every frame
+    SoftwareOcclusionCuller occlusionCuller;
+    occlusionCuller.addOccluder({ glm::vec3(-GROUND_HALF_SIZE, 0.0f, -GROUND_HALF_SIZE), glm::vec3(-GROUND_HALF_SIZE, 0.0f, GROUND_HALF_SIZE),
+        glm::vec3(GROUND_HALF_SIZE, 0.0f, -GROUND_HALF_SIZE), glm::vec3(GROUND_HALF_SIZE, 0.0f, GROUND_HALF_SIZE) }, { 0, 1, 2, 2, 1, 3 });
+    size_t numUnoccludedObjects = 0;
+    const auto occlusionTime = measureFastestRun(NUM_RUNS, [this, &bvh, &frustum, &visibleIndices, &occlusionCuller, &projectionViewMatrix, &numUnoccludedObjects]()
+    {
+        occlusionCuller.renderOccluders(projectionViewMatrix);
+        bvh.query(frustum, visibleIndices);
+        numUnoccludedObjects = 0;
+        for (const auto objectIndex : visibleIndices)
+        {
+            if (occlusionCuller.isAABBVisible(objectBoxes_[objectIndex])) {
+                numUnoccludedObjects++;
+            }
+        }
+    });
+    results_.push_back({ std::string("BVH + SW occl. ") + SoftwareOcclusionCuller::getSIMDInstructionSet(), occlusionTime, numUnoccludedObjects });
+
+    objectBoxes_.clear();
+    objectBoxes_.shrink_to_fit();
+    printResults(bvhBuildTime);
+}
+
+void FrustumCullingBenchmark::generateObjects()
+{
+    // Fixed seed, so that the runs are comparable
+    std::mt19937 generator(27);
+    std::uniform_real_distribution<float> positionDistribution(-2000.0f, 2000.0f);
+    std::uniform_real_distribution<float> heightDistribution(-50.0f, 150.0f);
+    std::uniform_real_distribution<float> extentDistribution(0.5f, 5.0f);
+
+    objectBoxes_.clear();
+    objectBoxes_.reserve(NUM_OBJECTS);
+    for (size_t i = 0; i < NUM_OBJECTS; i++)
+    {
+        const glm::vec3 center(positionDistribution(generator), heightDistribution(generator), positionDistribution(generator));
+        const glm::vec3 extents(extentDistribution(generator), extentDistribution(generator), extentDistribution(generator));
+        objectBoxes_.push_back(AABB::fromCenterAndExtents(center, extents));
+    }
+}
+
+void FrustumCullingBenchmark::printResults(const double bvhBuildTime) const
+{
+    const auto previousFlags = std::cout.flags();
+    const auto previousPrecision = std::cout.precision();
+    std::cout << "Frustum culling benchmark results (fastest of " << NUM_RUNS << " runs, BVH built once in " << bvhBuildTime << " ms):" << std::endl;
+    std::cout << std::setw(22) << "Method" << std::setw(12) << "Time (ms)" << std::setw(12) << "Visible" << std::setw(12) << "Speedup" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    for (const auto& result : results_)
+    {
+        const auto speedup = result.time > 0.0 ? results_[0].time / result.time : 0.0;
+        std::cout << std::setw(22) << result.name << std::setw(12) << result.time << std::setw(12) << result.numVisibleObjects
+            << std::setw(11) << speedup << "x" << std::endl;
+    }
+
+    std::cout.flags(previousFlags);
+    std::cout.precision(previousPrecision);
+}
+
+} // namespace tutorial027
+} // namespace opengl4_mbsoftworks
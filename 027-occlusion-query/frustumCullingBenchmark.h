@@ -0,0 +1,61 @@
+#pragma once
+
+// STL
+#include <string>
+#include <vector>
+
+// Project
+#include "../common_classes/boundingVolumes.h"
+#include "../common_classes/frustum.h"
+
+namespace opengl4_mbsoftworks {
+namespace tutorial027 {
+
+/**
+ * Benchmark, that culls many randomly placed objects against the given frustum. It compares testing objects
+ * one by one, SIMD culling kernel and querying the bounding volume hierarchy. Objects found by the hierarchy
+ * are then tested against the ground rasterized by the software occlusion culler. Benchmark runs synchronously
+ * and results are printed to standard output.
+ */
+class FrustumCullingBenchmark
+{
+public:
+    static const size_t NUM_OBJECTS; // Number of culled objects
+    static const int NUM_RUNS; // Number of runs of every method (the fastest one is taken)
+
+    static const float GROUND_HALF_SIZE; // Half size of the ground occluder at height 0 (objects below it are occluded)
+
+    /**
+     * Runs the benchmark and prints the results.
+     *
+     * @param projectionViewMatrix  Camera to cull objects against (e.g. the current camera)
+     */
+    void run(const glm::mat4& projectionViewMatrix);
+
+private:
+    /**
+     * Result of one culling method.
+     */
+    struct MethodResult
+    {
+        std::string name;
+        double time;
+        size_t numVisibleObjects;
+    };
+
+    /**
+     * Generates random object boxes around the origin.
+     */
+    void generateObjects();
+
+    /**
+     * Prints results of the benchmark as a table to standard output.
+     */
+    void printResults(double bvhBuildTime) const;
+
+    std::vector<AABB> objectBoxes_; // Bounding boxes of the culled objects
+    std::vector<MethodResult> results_; // Results of all methods, the first one is the baseline
+};
+
+} // namespace tutorial027
+} // namespace opengl4_mbsoftworks
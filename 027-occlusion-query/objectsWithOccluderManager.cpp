@@ -1,7 +1,13 @@
+// STL
+#include <algorithm>
+#include <cfloat>
+#include <functional>
+
 // GLM
 #include <glm/gtc/matrix_transform.hpp>
 
 // Project
+#include "../common_classes/glStateCache.h"
 #include "../common_classes/matrixManager.h"
 #include "../common_classes/random.h"
 #include "../common_classes/shaderProgramManager.h"
@@ -12,6 +18,8 @@
 
 #include "objectsWithOccluderManager.h"
 
+const size_t ObjectsWithOccludersManager::NO_SOFTWARE_OCCLUDER = static_cast<size_t>(-1);
+
 ObjectsWithOccludersManager& ObjectsWithOccludersManager::getInstance()
 {
     static ObjectsWithOccludersManager manager;
@@ -23,25 +31,65 @@ void ObjectsWithOccludersManager::initialize()
     // Create occluder cube - we only need vertices positions here, no texture coordinates or normals
     occluderCube_ = std::make_unique<static_meshes_3D::Cube>(true, false, false);
     occlusionQuery_ = std::make_unique<OcclusionQuery>();
+    occlusionQueryPool_ = std::make_unique<OcclusionQueryPool>();
+    occluderInstanceBuffer_ = std::make_unique<static_meshes_3D::InstanceBuffer>();
+    visualizedOccluderInstanceBuffer_ = std::make_unique<static_meshes_3D::InstanceBuffer>();
+    const auto& tm = TextureManager::getInstance();
 
     // Add cylinder mesh
     meshes_.push_back(std::make_unique<static_meshes_3D::Cylinder>(2.0f, 20, 4.0f, true, true, true));
     occlusionBoxSizes_.emplace_back(4.01f, 4.01f, 4.01f);
+    meshTextures_.push_back(&tm.getTexture("crate"));
+    meshMaterials_.push_back(&dimMaterial_);
+    meshSoftwareOccluders_.push_back(addSoftwareBoxOccluder(glm::vec3(1.39f, 1.99f, 1.39f))); // Square inscribed into 20-sided base
 
-    // Add sphere mesh
-    meshes_.push_back(std::make_unique<static_meshes_3D::Sphere>(2.0f, 20, 20));
+    // Add sphere mesh - sphere and torus have texture coordinates within [0, 2] and unit normals, so they're stored
+    // packed (half float texture coordinates and 10-bit normals), that makes their vertices 20 bytes instead of 32
+    const auto packedVertexEncoding = static_meshes_3D::GeometryArena::HALF_TEXTURE_COORDINATES_FLAG | static_meshes_3D::GeometryArena::PACKED_NORMALS_FLAG;
+    meshes_.push_back(std::make_unique<static_meshes_3D::Sphere>(2.0f, 20, 20, true, true, true, packedVertexEncoding));
     occlusionBoxSizes_.emplace_back(4.01f, 4.01f, 4.01f);
+    meshTextures_.push_back(&tm.getTexture("white_marble"));
+    meshMaterials_.push_back(&shinyMaterial_);
+    meshSoftwareOccluders_.push_back(addSoftwareBoxOccluder(glm::vec3(1.1f))); // Cube inscribed into tessellated sphere
 
     // Add torus mesh
-    meshes_.push_back(std::make_unique<static_meshes_3D::Torus>(20, 20, 1.5f, 0.75f, true, true, true));
+    meshes_.push_back(std::make_unique<static_meshes_3D::Torus>(20, 20, 1.5f, 0.75f, true, true, true, packedVertexEncoding));
     occlusionBoxSizes_.emplace_back(4.51f, 4.51f, 2.26f);
+    meshTextures_.push_back(&tm.getTexture("scifi_metal"));
+    meshMaterials_.push_back(&shinyMaterial_);
+    meshSoftwareOccluders_.push_back(NO_SOFTWARE_OCCLUDER); // Torus has a hole and its thin tube wouldn't hide much anyway
+    meshSoftwareOccluderMatrices_.resize(meshes_.size());
+
+    // Every mesh has its own instance buffer for instanced rendering
+    for (size_t i = 0; i < meshes_.size(); i++) {
+        meshInstanceBuffers_.push_back(std::make_unique<static_meshes_3D::InstanceBuffer>());
+    }
+
+    // Every grid cell has its own query for batched occlusion queries
+    for (auto i = 0; i < NUM_BATCH_CELLS_PER_AXIS * NUM_BATCH_CELLS_PER_AXIS; i++) {
+        batchCellQueryHandles_.push_back(occlusionQueryPool_->acquireQuery());
+    }
 }
 
 void ObjectsWithOccludersManager::release()
 {
     occluderCube_.reset();
     occlusionQuery_.reset();
+    occlusionQueryPool_.reset();
+    batchCellQueryHandles_.clear();
+    occluderInstanceBuffer_.reset();
+    visualizedOccluderInstanceBuffer_.reset();
     meshes_.clear();
+    occlusionBoxSizes_.clear();
+    meshTextures_.clear();
+    meshInstanceBuffers_.clear();
+    meshMaterials_.clear();
+    objects_.clear();
+    objectGrid_.clear();
+    gridHandleObjectIndices_.clear();
+    softwareOcclusionCuller_.clearOccluders();
+    meshSoftwareOccluders_.clear();
+    meshSoftwareOccluderMatrices_.clear();
 }
 
 void ObjectsWithOccludersManager::updateAndPerformOcclusionQuery(float deltaTime)
@@ -50,12 +98,67 @@ void ObjectsWithOccludersManager::updateAndPerformOcclusionQuery(float deltaTime
     {
         timePassedSinceLastGeneration_ -= GENERATE_OBJECT_EVERY_SECONDS;
         const auto randomIndex = Random::nextInt(static_cast<int>(meshes_.size()));
-        const ObjectWithOccluder object{ Random::getRandomVectorFromRectangleXZ(glm::vec3(-150.0f, -10.0f, -150.0f), glm::vec3(150.0f, -10.0f, 150.0f)), meshes_[randomIndex].get(), occlusionBoxSizes_[randomIndex], true };
+        const auto position = Random::getRandomVectorFromRectangleXZ(glm::vec3(-OBJECTS_AREA_HALF_SIZE, -10.0f, -OBJECTS_AREA_HALF_SIZE),
+            glm::vec3(OBJECTS_AREA_HALF_SIZE, -10.0f, OBJECTS_AREA_HALF_SIZE));
+        ObjectWithOccluder object{ position, meshes_[randomIndex].get(), static_cast<size_t>(randomIndex), occlusionBoxSizes_[randomIndex], true,
+            occlusionQueryPool_->acquireQuery(), getBatchCellIndex(position), SpatialHashGrid::INVALID_HANDLE };
+        object.gridHandle = objectGrid_.insert(getObjectBox(object));
+        if (object.gridHandle >= gridHandleObjectIndices_.size()) {
+            gridHandleObjectIndices_.resize(object.gridHandle + 1);
+        }
+
+        gridHandleObjectIndices_[object.gridHandle] = objects_.size();
         objects_.push_back(object);
     }
 
     timePassedSinceLastGeneration_ += deltaTime;
 
+    // Objects have been moved by the update jobs, the grid isn't thread-safe, so it's synchronized here (mostly just boxes within cells are updated)
+    for (const auto& object : objects_) {
+        objectGrid_.move(object.gridHandle, getObjectBox(object));
+    }
+
+    // Remove objects, that flew too high - only the cells above the height limit are visited. Objects are removed from the highest index,
+    // so that the last object swapped into the place of the removed one is never the one to be removed later
+    AABB removalRegion;
+    removalRegion.min = glm::vec3(-FLT_MAX, REMOVE_OBJECTS_ABOVE_HEIGHT, -FLT_MAX);
+    removalRegion.max = glm::vec3(FLT_MAX, FLT_MAX, FLT_MAX);
+    objectGrid_.queryAABB(removalRegion, gridQueryHandles_);
+    std::vector<size_t> removedObjectIndices;
+    for (const auto gridHandle : gridQueryHandles_)
+    {
+        const auto objectIndex = gridHandleObjectIndices_[gridHandle];
+        if (objects_[objectIndex].position.y > REMOVE_OBJECTS_ABOVE_HEIGHT) {
+            removedObjectIndices.push_back(objectIndex);
+        }
+    }
+
+    std::sort(removedObjectIndices.begin(), removedObjectIndices.end(), std::greater<size_t>());
+    for (const auto objectIndex : removedObjectIndices)
+    {
+        occlusionQueryPool_->releaseQuery(objects_[objectIndex].queryHandle);
+        objectGrid_.remove(objects_[objectIndex].gridHandle);
+        std::swap(objects_[objectIndex], objects_[objects_.size() - 1]);
+        objects_.pop_back();
+        if (objectIndex < objects_.size()) {
+            gridHandleObjectIndices_[objects_[objectIndex].gridHandle] = objectIndex;
+        }
+    }
+
+    // Objects outside of the view frustum can't be visible, so they don't need occlusion query at all. Grid tests whole cells first,
+    // so objects in cells completely outside (or completely inside) of the frustum aren't tested one by one
+    if (isFrustumCullingEnabled_)
+    {
+        frustumVisibility_.assign(objects_.size(), 0);
+        objectGrid_.queryFrustum(Frustum::fromMatrixManager(), gridQueryHandles_);
+        for (const auto gridHandle : gridQueryHandles_) {
+            frustumVisibility_[gridHandleObjectIndices_[gridHandle]] = 1;
+        }
+    }
+    else {
+        frustumVisibility_.assign(objects_.size(), 1);
+    }
+
     const auto& mm = MatrixManager::getInstance();
     auto& singleColorShaderProgram = ShaderProgramManager::getInstance().getShaderProgram("single-color");
     singleColorShaderProgram.useProgram();
@@ -66,19 +169,55 @@ void ObjectsWithOccludersManager::updateAndPerformOcclusionQuery(float deltaTime
     glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
     glDepthMask(GL_FALSE);
 
-    size_t i = 0;
+    numFrustumCulledObjects_ = 0;
+    numIssuedQueries_ = 0;
+    for (size_t i = 0; i < objects_.size(); i++)
+    {
+        if (frustumVisibility_[i] == 0)
+        {
+            objects_[i].isVisible = false;
+            numFrustumCulledObjects_++;
+        }
+    }
+
+    switch (occlusionQueryMode_)
+    {
+        case OcclusionQueryMode::Blocking:
+            performBlockingOcclusionQueries(singleColorShaderProgram);
+            break;
+        case OcclusionQueryMode::Asynchronous:
+            performAsynchronousOcclusionQueries(singleColorShaderProgram);
+            break;
+        case OcclusionQueryMode::Batched:
+            performBatchedOcclusionQueries();
+            break;
+        case OcclusionQueryMode::Software:
+            performSoftwareOcclusionCulling();
+            break;
+    }
+
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glDepthMask(GL_TRUE);
+
     numVisibleObjects_ = 0;
-    while (i < objects_.size())
+    for (const auto& object : objects_)
     {
-        auto& object = objects_[i];
-        if (object.position.y > 100.0f)
+        if (object.isVisible)
         {
-            std::swap(objects_[i], objects_[objects_.size() - 1]);
-            objects_.pop_back();
+            numVisibleObjects_++;
+        }
+    }
+}
+
+void ObjectsWithOccludersManager::performBlockingOcclusionQueries(ShaderProgram& singleColorShaderProgram)
+{
+    for (size_t i = 0; i < objects_.size(); i++)
+    {
+        if (frustumVisibility_[i] == 0) {
             continue;
         }
 
-        object.position.y += 10.0f * deltaTime;
+        auto& object = objects_[i];
         auto modelMatrix = glm::translate(glm::mat4(1.0f), object.position);
         modelMatrix = glm::scale(modelMatrix, object.occlusionBoxSize);
         singleColorShaderProgram[ShaderConstants::modelMatrix()] = modelMatrix;
@@ -86,23 +225,185 @@ void ObjectsWithOccludersManager::updateAndPerformOcclusionQuery(float deltaTime
         occluderCube_->render();
         occlusionQuery_->endQuery();
         object.isVisible = occlusionQuery_->anySamplesPassed();
-        if (object.isVisible)
+        numIssuedQueries_++;
+    }
+}
+
+void ObjectsWithOccludersManager::performAsynchronousOcclusionQueries(ShaderProgram& singleColorShaderProgram)
+{
+    occlusionQueryPool_->collectResults();
+    for (size_t i = 0; i < objects_.size(); i++)
+    {
+        if (frustumVisibility_[i] == 0) {
+            continue;
+        }
+
+        // Query is issued again only when its previous result has arrived, until then the object keeps its last known visibility
+        auto& object = objects_[i];
+        if (occlusionQueryPool_->beginQuery(object.queryHandle))
         {
-            numVisibleObjects_++;
+            auto modelMatrix = glm::translate(glm::mat4(1.0f), object.position);
+            modelMatrix = glm::scale(modelMatrix, object.occlusionBoxSize);
+            singleColorShaderProgram[ShaderConstants::modelMatrix()] = modelMatrix;
+            occluderCube_->render();
+            occlusionQueryPool_->endQuery();
+            numIssuedQueries_++;
         }
 
-        i++;
+        object.isVisible = occlusionQueryPool_->isVisible(object.queryHandle);
     }
+}
 
-    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-    glDepthMask(GL_TRUE);
+void ObjectsWithOccludersManager::performBatchedOcclusionQueries()
+{
+    occlusionQueryPool_->collectResults();
+
+    // Sort queried objects by grid cells (counting sort), so that occluders of every cell are contiguous in the instance buffer
+    const auto numCells = batchCellQueryHandles_.size();
+    batchCellNumInstances_.assign(numCells, 0);
+    for (size_t i = 0; i < objects_.size(); i++)
+    {
+        if (frustumVisibility_[i] != 0) {
+            batchCellNumInstances_[objects_[i].batchCellIndex]++;
+        }
+    }
+
+    batchCellFirstInstances_.assign(numCells, 0);
+    for (size_t cell = 1; cell < numCells; cell++) {
+        batchCellFirstInstances_[cell] = batchCellFirstInstances_[cell - 1] + batchCellNumInstances_[cell - 1];
+    }
+
+    auto nextInstances = batchCellFirstInstances_;
+    batchedObjectIndices_.resize(objects_.size() - numFrustumCulledObjects_);
+    for (size_t i = 0; i < objects_.size(); i++)
+    {
+        if (frustumVisibility_[i] != 0) {
+            batchedObjectIndices_[nextInstances[objects_[i].batchCellIndex]++] = i;
+        }
+    }
+
+    occluderInstanceBuffer_->clear();
+    for (const auto objectIndex : batchedObjectIndices_)
+    {
+        const auto& object = objects_[objectIndex];
+        auto modelMatrix = glm::translate(glm::mat4(1.0f), object.position);
+        occluderInstanceBuffer_->addInstance(glm::scale(modelMatrix, object.occlusionBoxSize));
+    }
+
+    occluderInstanceBuffer_->upload();
+
+    // One instanced draw of all occluders within the cell per query
+    const auto& mm = MatrixManager::getInstance();
+    auto& instancedProgram = ShaderProgramManager::getInstance().getShaderProgramVariant("single-color", ShaderDefines().define("INSTANCED"));
+    instancedProgram.useProgram();
+    instancedProgram[ShaderConstants::projectionMatrix()] = mm.getProjectionMatrix();
+    instancedProgram[ShaderConstants::viewMatrix()] = mm.getViewMatrix();
+    instancedProgram[ShaderConstants::modelMatrix()] = glm::mat4(1.0f);
+    for (size_t cell = 0; cell < numCells; cell++)
+    {
+        if (batchCellNumInstances_[cell] == 0 || !occlusionQueryPool_->beginQuery(batchCellQueryHandles_[cell])) {
+            continue;
+        }
+
+        occluderCube_->renderInstanced(*occluderInstanceBuffer_, static_cast<GLuint>(batchCellFirstInstances_[cell]),
+            static_cast<GLsizei>(batchCellNumInstances_[cell]));
+        occlusionQueryPool_->endQuery();
+        numIssuedQueries_++;
+    }
+
+    for (const auto objectIndex : batchedObjectIndices_)
+    {
+        auto& object = objects_[objectIndex];
+        object.isVisible = occlusionQueryPool_->isVisible(batchCellQueryHandles_[object.batchCellIndex]);
+    }
+}
+
+void ObjectsWithOccludersManager::performSoftwareOcclusionCulling()
+{
+    // Objects occlude each other too, so boxes inscribed into them are rasterized along with the static occluders (only for objects within the frustum)
+    for (auto& modelMatrices : meshSoftwareOccluderMatrices_) {
+        modelMatrices.clear();
+    }
+
+    for (size_t i = 0; i < objects_.size(); i++)
+    {
+        const auto& object = objects_[i];
+        if (frustumVisibility_[i] != 0 && meshSoftwareOccluders_[object.meshIndex] != NO_SOFTWARE_OCCLUDER) {
+            meshSoftwareOccluderMatrices_[object.meshIndex].push_back(glm::translate(glm::mat4(1.0f), object.position));
+        }
+    }
+
+    for (size_t meshIndex = 0; meshIndex < meshes_.size(); meshIndex++)
+    {
+        if (meshSoftwareOccluders_[meshIndex] != NO_SOFTWARE_OCCLUDER) {
+            softwareOcclusionCuller_.setOccluderModelMatrices(meshSoftwareOccluders_[meshIndex], meshSoftwareOccluderMatrices_[meshIndex]);
+        }
+    }
+
+    // Occlusion boxes are tested against the occluders right away, GPU isn't involved at all
+    const auto& mm = MatrixManager::getInstance();
+    softwareOcclusionCuller_.renderOccluders(mm.getProjectionMatrix() * mm.getViewMatrix());
+    for (size_t i = 0; i < objects_.size(); i++)
+    {
+        if (frustumVisibility_[i] == 0) {
+            continue;
+        }
+
+        auto& object = objects_[i];
+        object.isVisible = softwareOcclusionCuller_.isAABBVisible(getObjectBox(object));
+    }
+}
+
+size_t ObjectsWithOccludersManager::getBatchCellIndex(const glm::vec3& position) const
+{
+    const auto cellX = glm::clamp(static_cast<int>((position.x + OBJECTS_AREA_HALF_SIZE) / BATCH_CELL_SIZE), 0, NUM_BATCH_CELLS_PER_AXIS - 1);
+    const auto cellZ = glm::clamp(static_cast<int>((position.z + OBJECTS_AREA_HALF_SIZE) / BATCH_CELL_SIZE), 0, NUM_BATCH_CELLS_PER_AXIS - 1);
+    return static_cast<size_t>(cellZ * NUM_BATCH_CELLS_PER_AXIS + cellX);
+}
+
+AABB ObjectsWithOccludersManager::getObjectBox(const ObjectWithOccluder& object)
+{
+    return AABB::fromCenterAndExtents(object.position, object.occlusionBoxSize * 0.5f);
+}
+
+size_t ObjectsWithOccludersManager::addSoftwareBoxOccluder(const glm::vec3& halfExtents)
+{
+    std::vector<glm::vec3> positions;
+    for (auto i = 0; i < 8; i++) {
+        positions.emplace_back(i & 1 ? halfExtents.x : -halfExtents.x, i & 2 ? halfExtents.y : -halfExtents.y, i & 4 ? halfExtents.z : -halfExtents.z);
+    }
+
+    // Two triangles per face, corner index bits are X, Y and Z (culler rasterizes both windings)
+    const std::vector<uint32_t> indices = {
+        0, 2, 4, 4, 2, 6, // -X
+        1, 3, 5, 5, 3, 7, // +X
+        0, 1, 4, 4, 1, 5, // -Y
+        2, 3, 6, 6, 3, 7, // +Y
+        0, 1, 2, 2, 1, 3, // -Z
+        4, 5, 6, 6, 5, 7 // +Z
+    };
+
+    const auto occluderIndex = softwareOcclusionCuller_.addOccluder(positions, indices);
+    softwareOcclusionCuller_.setOccluderModelMatrices(occluderIndex, {});
+    return occluderIndex;
+}
+
+size_t ObjectsWithOccludersManager::getObjectQueryHandle(const ObjectWithOccluder& object) const
+{
+    return occlusionQueryMode_ == OcclusionQueryMode::Batched ? batchCellQueryHandles_[object.batchCellIndex] : object.queryHandle;
+}
+
+void ObjectsWithOccludersManager::moveObjects(const float deltaTime, const size_t firstObject, const size_t lastObject)
+{
+    for (auto i = firstObject; i < lastObject; i++) {
+        objects_[i].position.y += 10.0f * deltaTime;
+    }
 }
 
 void ObjectsWithOccludersManager::renderAllVisibleObjects()
 {
-    const auto& tm = TextureManager::getInstance();
     auto& mainProgram = ShaderProgramManager::getInstance().getShaderProgram("main");
-    mainProgram.useProgram();
+    renderQueue_.begin(MatrixManager::getInstance().getViewMatrix(), 500.0f);
 
     for (auto& object : objects_)
     {
@@ -111,25 +412,93 @@ void ObjectsWithOccludersManager::renderAllVisibleObjects()
             continue;
         }
 
-        auto modelMatrix = glm::translate(glm::mat4(1.0f), object.position);
-        mainProgram.setModelAndNormalMatrix(modelMatrix);
-        if (dynamic_cast<static_meshes_3D::Cylinder*>(object.meshPtr))
-        {
-            dimMaterial_.setUniform(mainProgram, ShaderConstants::material());
-            tm.getTexture("crate").bind();
+        RenderQueue::DrawItem drawItem;
+        drawItem.shaderProgram = &mainProgram;
+        drawItem.material = meshMaterials_[object.meshIndex];
+        drawItem.texture = meshTextures_[object.meshIndex];
+        drawItem.mesh = object.meshPtr;
+        drawItem.modelMatrix = glm::translate(glm::mat4(1.0f), object.position);
+        renderQueue_.submit(drawItem);
+    }
+
+    // Objects are replayed grouped by texture and material and front to back
+    renderQueue_.replay();
+}
+
+void ObjectsWithOccludersManager::renderAllVisibleObjectsInstanced(ShaderProgram& instancedProgram)
+{
+    for (auto& instanceBuffer : meshInstanceBuffers_) {
+        instanceBuffer->clear();
+    }
+
+    for (const auto& object : objects_)
+    {
+        if (object.isVisible) {
+            meshInstanceBuffers_[object.meshIndex]->addInstance(glm::translate(glm::mat4(1.0f), object.position));
         }
-        else if (dynamic_cast<static_meshes_3D::Sphere*>(object.meshPtr))
-        {
-            shinyMaterial_.setUniform(mainProgram, ShaderConstants::material());
-            tm.getTexture("white_marble").bind();
+    }
+
+    // Whole placement is in the instance data, so the model matrix uniform stays identity
+    instancedProgram.useProgram();
+    for (size_t i = 0; i < meshes_.size(); i++)
+    {
+        auto& instanceBuffer = *meshInstanceBuffers_[i];
+        instanceBuffer.upload();
+        if (instanceBuffer.getNumInstances() == 0) {
+            continue;
         }
-        else if (dynamic_cast<static_meshes_3D::Torus*>(object.meshPtr))
+
+        instancedProgram.setModelAndNormalMatrix(glm::mat4(1.0f));
+        meshMaterials_[i]->setUniform(instancedProgram, ShaderConstants::material());
+        meshTextures_[i]->bind();
+        meshes_[i]->renderInstanced(instanceBuffer);
+    }
+}
+
+void ObjectsWithOccludersManager::renderAllVisibleObjectsRecorded()
+{
+    auto& mainProgram = ShaderProgramManager::getInstance().getShaderProgram("main");
+    commandRecorder_.record(objects_.size(), [this, &mainProgram](CommandBuffer& commandBuffer, const size_t firstObject, const size_t lastObject)
+    {
+        // Every chunk is recorded into separate buffer, so it has to set the program on its own
+        commandBuffer.useProgram(mainProgram);
+        for (auto i = firstObject; i < lastObject; i++)
         {
-            shinyMaterial_.setUniform(mainProgram, ShaderConstants::material());
-            tm.getTexture("scifi_metal").bind();
+            const auto& object = objects_[i];
+            if (!object.isVisible) {
+                continue;
+            }
+
+            commandBuffer.setMaterial(*meshMaterials_[object.meshIndex]);
+            commandBuffer.bindTexture(*meshTextures_[object.meshIndex]);
+            commandBuffer.setModelAndNormalMatrix(glm::translate(glm::mat4(1.0f), object.position));
+            commandBuffer.renderMesh(*object.meshPtr);
         }
+    });
 
+    commandRecorder_.replay();
+}
+
+void ObjectsWithOccludersManager::renderAllObjectsConditionally()
+{
+    auto& mainProgram = ShaderProgramManager::getInstance().getShaderProgram("main");
+    mainProgram.useProgram();
+    for (size_t i = 0; i < objects_.size(); i++)
+    {
+        if (frustumVisibility_[i] == 0) {
+            continue;
+        }
+
+        // Object without any issued query yet is simply rendered
+        const auto& object = objects_[i];
+        meshMaterials_[object.meshIndex]->setUniform(mainProgram, ShaderConstants::material());
+        meshTextures_[object.meshIndex]->bind();
+        mainProgram.setModelAndNormalMatrix(glm::translate(glm::mat4(1.0f), object.position));
+        const auto isRenderedConditionally = occlusionQueryPool_->beginConditionalRender(getObjectQueryHandle(object));
         object.meshPtr->render();
+        if (isRenderedConditionally) {
+            occlusionQueryPool_->endConditionalRender();
+        }
     }
 }
 
@@ -138,15 +507,18 @@ void ObjectsWithOccludersManager::renderOccluders()
     const auto& mm = MatrixManager::getInstance();
 
     glDepthMask(GL_FALSE);
-    glEnable(GL_BLEND);
+    GLStateCache::getInstance().enable(GL_BLEND);
     glBlendFunc(GL_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    auto& singleColorShaderProgram = ShaderProgramManager::getInstance().getShaderProgram("single-color");
-    singleColorShaderProgram.useProgram();
-    singleColorShaderProgram[ShaderConstants::projectionMatrix()] = mm.getProjectionMatrix();
-    singleColorShaderProgram[ShaderConstants::viewMatrix()] = mm.getViewMatrix();
-    singleColorShaderProgram[ShaderConstants::color()] = glm::vec4(1.0f, 0.0f, 0.0f, 0.4f);
+    auto& instancedProgram = ShaderProgramManager::getInstance().getShaderProgramVariant("single-color", ShaderDefines().define("INSTANCED"));
+    instancedProgram.useProgram();
+    instancedProgram[ShaderConstants::projectionMatrix()] = mm.getProjectionMatrix();
+    instancedProgram[ShaderConstants::viewMatrix()] = mm.getViewMatrix();
+    instancedProgram[ShaderConstants::modelMatrix()] = glm::mat4(1.0f);
+    instancedProgram[ShaderConstants::color()] = glm::vec4(1.0f, 0.0f, 0.0f, 0.4f);
 
-    for (auto& object : objects_)
+    // All visible occluders are rendered with one instanced draw
+    visualizedOccluderInstanceBuffer_->clear();
+    for (const auto& object : objects_)
     {
         if (!object.isVisible)
         {
@@ -154,12 +526,13 @@ void ObjectsWithOccludersManager::renderOccluders()
         }
 
         auto modelMatrix = glm::translate(glm::mat4(1.0f), object.position);
-        modelMatrix = glm::scale(modelMatrix, object.occlusionBoxSize);
-        singleColorShaderProgram[ShaderConstants::modelMatrix()] = modelMatrix;
-        occluderCube_->render();
+        visualizedOccluderInstanceBuffer_->addInstance(glm::scale(modelMatrix, object.occlusionBoxSize));
     }
 
-    glDisable(GL_BLEND);
+    visualizedOccluderInstanceBuffer_->upload();
+    occluderCube_->renderInstanced(*visualizedOccluderInstanceBuffer_);
+
+    GLStateCache::getInstance().disable(GL_BLEND);
     glDepthMask(GL_TRUE);
 }
 
@@ -172,3 +545,90 @@ size_t ObjectsWithOccludersManager::getNumVisibleObjects() const
 {
     return numVisibleObjects_;
 }
+
+size_t ObjectsWithOccludersManager::getNumFrustumCulledObjects() const
+{
+    return numFrustumCulledObjects_;
+}
+
+void ObjectsWithOccludersManager::setFrustumCullingEnabled(const bool enabled)
+{
+    isFrustumCullingEnabled_ = enabled;
+}
+
+bool ObjectsWithOccludersManager::isFrustumCullingEnabled() const
+{
+    return isFrustumCullingEnabled_;
+}
+
+void ObjectsWithOccludersManager::setOcclusionQueryMode(const OcclusionQueryMode occlusionQueryMode)
+{
+    occlusionQueryMode_ = occlusionQueryMode;
+}
+
+ObjectsWithOccludersManager::OcclusionQueryMode ObjectsWithOccludersManager::getOcclusionQueryMode() const
+{
+    return occlusionQueryMode_;
+}
+
+const char* ObjectsWithOccludersManager::getOcclusionQueryModeName(const OcclusionQueryMode occlusionQueryMode)
+{
+    switch (occlusionQueryMode)
+    {
+        case OcclusionQueryMode::Blocking:
+            return "Blocking";
+        case OcclusionQueryMode::Asynchronous:
+            return "Asynchronous";
+        case OcclusionQueryMode::Batched:
+            return "Batched";
+        case OcclusionQueryMode::Software:
+            return "Software (CPU)";
+    }
+
+    return "Unknown";
+}
+
+void ObjectsWithOccludersManager::setConditionalRenderingEnabled(const bool enabled)
+{
+    isConditionalRenderingEnabled_ = enabled;
+}
+
+bool ObjectsWithOccludersManager::isConditionalRenderingActive() const
+{
+    return isConditionalRenderingEnabled_ && (occlusionQueryMode_ == OcclusionQueryMode::Asynchronous || occlusionQueryMode_ == OcclusionQueryMode::Batched);
+}
+
+bool ObjectsWithOccludersManager::isConditionalRenderingEnabled() const
+{
+    return isConditionalRenderingEnabled_;
+}
+
+size_t ObjectsWithOccludersManager::getNumIssuedQueries() const
+{
+    return numIssuedQueries_;
+}
+
+size_t ObjectsWithOccludersManager::getNumPendingQueries() const
+{
+    return occlusionQueryPool_->getNumPendingQueries();
+}
+
+SoftwareOcclusionCuller& ObjectsWithOccludersManager::getSoftwareOcclusionCuller()
+{
+    return softwareOcclusionCuller_;
+}
+
+const SpatialHashGrid& ObjectsWithOccludersManager::getObjectGrid() const
+{
+    return objectGrid_;
+}
+
+RenderQueue& ObjectsWithOccludersManager::getRenderQueue()
+{
+    return renderQueue_;
+}
+
+ParallelCommandRecorder& ObjectsWithOccludersManager::getCommandRecorder()
+{
+    return commandRecorder_;
+}
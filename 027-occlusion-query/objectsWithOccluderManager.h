@@ -7,8 +7,14 @@
 #include <glm/vec3.hpp>
 
 // Project
+#include "../common_classes/commandBuffer.h"
 #include "../common_classes/occlusionQuery.h"
+#include "../common_classes/occlusionQueryPool.h"
+#include "../common_classes/renderQueue.h"
+#include "../common_classes/softwareOcclusionCuller.h"
+#include "../common_classes/spatialHashGrid.h"
 #include "../common_classes/shader_structs/material.h"
+#include "../common_classes/static_meshes_3D/instanceBuffer.h"
 #include "../common_classes/static_meshes_3D/primitives/cube.h"
 #include "../common_classes/static_meshes_3D/staticMesh3D.h"
 
@@ -18,6 +24,19 @@
 class ObjectsWithOccludersManager
 {
 public:
+    /**
+     * How occlusion queries of objects are performed.
+     */
+    enum class OcclusionQueryMode
+    {
+        Blocking, // One query per object, its result is waited for right away (stalls CPU once per object)
+        Asynchronous, // One pooled query per object, results are collected in later frames without waiting
+        Batched, // One pooled query per grid cell, occluders of all objects within the cell are rendered with one instanced draw
+        Software, // No queries at all, occlusion boxes are tested against occluders rasterized on the CPU
+    };
+
+    static const int NUM_OCCLUSION_QUERY_MODES = 4; // Number of occlusion query modes (for cycling through them)
+
     static ObjectsWithOccludersManager& getInstance();
 
     /**
@@ -31,11 +50,17 @@ public:
     void release();
 
     /**
-     * Updates objects - generates new, moves them upwards, removes ones that flew too high 
+     * Updates objects - generates new, removes ones that flew too high, culls the ones outside of the view frustum
      * and then performs occlusion test on the remaining objects.
      */
     void updateAndPerformOcclusionQuery(float deltaTime);
 
+    /**
+     * Moves objects [firstObject, lastObject) upwards. It doesn't call OpenGL, so different ranges
+     * can be moved on different threads.
+     */
+    void moveObjects(float deltaTime, size_t firstObject, size_t lastObject);
+
     /**
      * Renders all objects, but skips objects, that are not visible
      * (that haven't passed the occlusion test).
@@ -43,7 +68,26 @@ public:
     void renderAllVisibleObjects();
 
     /**
-     * Renders occluders (helps to visualize how occlusion query works).
+     * Renders all visible objects as well, but all objects with the same mesh are rendered with one instanced draw.
+     *
+     * @param instancedProgram  Main shader program compiled with INSTANCED define, its common uniforms must be already set
+     */
+    void renderAllVisibleObjectsInstanced(ShaderProgram& instancedProgram);
+
+    /**
+     * Renders all visible objects as well, but the draw commands are recorded into command buffers on multiple threads first
+     * and then they are replayed in the original order.
+     */
+    void renderAllVisibleObjectsRecorded();
+
+    /**
+     * Renders all objects, that passed the frustum culling, each within conditional rendering of its latest occlusion query,
+     * so GPU decides about the visibility and results don't need to be read at all. Works with pooled queries only.
+     */
+    void renderAllObjectsConditionally();
+
+    /**
+     * Renders occluders of visible objects with one instanced draw (helps to visualize how occlusion query works).
      */
     void renderOccluders();
 
@@ -56,6 +100,81 @@ public:
      * Gets number of only visible objects on the scene.
      */
     size_t getNumVisibleObjects() const;
+
+    /**
+     * Gets number of objects culled by the view frustum (they didn't need occlusion query).
+     */
+    size_t getNumFrustumCulledObjects() const;
+
+    /**
+     * Enables or disables frustum culling before occlusion queries.
+     */
+    void setFrustumCullingEnabled(bool enabled);
+
+    /**
+     * Checks, if frustum culling is enabled.
+     */
+    bool isFrustumCullingEnabled() const;
+
+    /**
+     * Sets how occlusion queries are performed.
+     */
+    void setOcclusionQueryMode(OcclusionQueryMode occlusionQueryMode);
+
+    /**
+     * Gets how occlusion queries are performed.
+     */
+    OcclusionQueryMode getOcclusionQueryMode() const;
+
+    /**
+     * Gets name of the occlusion query mode (for HUD).
+     */
+    static const char* getOcclusionQueryModeName(OcclusionQueryMode occlusionQueryMode);
+
+    /**
+     * Enables or disables conditional rendering of objects (see renderAllObjectsConditionally).
+     */
+    void setConditionalRenderingEnabled(bool enabled);
+
+    /**
+     * Checks, if conditional rendering is enabled and if it can be used with the current occlusion query mode.
+     */
+    bool isConditionalRenderingActive() const;
+
+    /**
+     * Checks, if conditional rendering is enabled (regardless of the occlusion query mode).
+     */
+    bool isConditionalRenderingEnabled() const;
+
+    /**
+     * Gets number of occlusion queries issued during the last update.
+     */
+    size_t getNumIssuedQueries() const;
+
+    /**
+     * Gets number of pooled occlusion queries, whose results are still pending.
+     */
+    size_t getNumPendingQueries() const;
+
+    /**
+     * Gets CPU occlusion culler used in software mode. Occluders of the scene should be added to it.
+     */
+    SoftwareOcclusionCuller& getSoftwareOcclusionCuller();
+
+    /**
+     * Gets spatial grid with boxes of all objects (frustum culling and removal of objects query it).
+     */
+    const SpatialHashGrid& getObjectGrid() const;
+
+    /**
+     * Gets render queue, that visible objects are rendered with.
+     */
+    RenderQueue& getRenderQueue();
+
+    /**
+     * Gets command recorder, that visible objects are recorded with.
+     */
+    ParallelCommandRecorder& getCommandRecorder();
     
 private:
     ObjectsWithOccludersManager() = default; // Private constructor to make class truly singleton
@@ -63,6 +182,11 @@ private:
     void operator=(const ObjectsWithOccludersManager&) = delete; // No copy assignment allowed
 
     const float GENERATE_OBJECT_EVERY_SECONDS{ 0.2f }; // How often should new objects be generated
+    const float OBJECTS_AREA_HALF_SIZE{ 150.0f }; // Objects are generated within square of this half size around the origin
+    const float BATCH_CELL_SIZE{ 50.0f }; // Size of one grid cell - occluders of objects within the cell are queried as one batch
+    const int NUM_BATCH_CELLS_PER_AXIS{ 6 }; // Number of grid cells along X and Z axes (they cover the whole area)
+    const float OBJECT_GRID_CELL_SIZE{ 10.0f }; // Size of one cell of the spatial grid (about twice the size of objects)
+    const float REMOVE_OBJECTS_ABOVE_HEIGHT{ 100.0f }; // Objects, that flew higher than this, are removed
 
     /**
      * Helper struct that holds object on the scene with information
@@ -72,15 +196,64 @@ private:
     {
         glm::vec3 position;
         static_meshes_3D::StaticMesh3D* meshPtr;
+        size_t meshIndex;
         glm::vec3 occlusionBoxSize;
         bool isVisible;
+        size_t queryHandle; // Handle of pooled occlusion query of this object (objects are swapped, so the query goes with them)
+        size_t batchCellIndex; // Index of the grid cell the object is in
+        uint32_t gridHandle; // Handle of the object in the spatial grid
     };
 
+    /**
+     * Performs occlusion queries in the current mode and sets visibility of objects, that passed the frustum culling.
+     */
+    void performBlockingOcclusionQueries(ShaderProgram& singleColorShaderProgram);
+    void performAsynchronousOcclusionQueries(ShaderProgram& singleColorShaderProgram);
+    void performBatchedOcclusionQueries();
+    void performSoftwareOcclusionCulling();
+
+    /**
+     * Gets index of the grid cell, that the position is in.
+     */
+    size_t getBatchCellIndex(const glm::vec3& position) const;
+
+    /**
+     * Gets handle of the pooled query, that the object's visibility is taken from in the current mode.
+     */
+    size_t getObjectQueryHandle(const ObjectWithOccluder& object) const;
+
+    /**
+     * Gets bounding box of the object (its occlusion box), that is stored in the spatial grid.
+     */
+    static AABB getObjectBox(const ObjectWithOccluder& object);
+
+    /**
+     * Adds box occluder to the software occlusion culler. Box has no model matrices yet, they're set every frame.
+     *
+     * @param halfExtents  Half extents of the box (box has to fit inside of the mesh, so that it never hides anything the mesh doesn't)
+     *
+     * @return Index of the occluder within the software occlusion culler.
+     */
+    size_t addSoftwareBoxOccluder(const glm::vec3& halfExtents);
+
     std::unique_ptr<static_meshes_3D::Cube> occluderCube_; // Mesh serving as occluder (cube)
     std::unique_ptr<OcclusionQuery> occlusionQuery_; // Occlusion query object
+    std::unique_ptr<OcclusionQueryPool> occlusionQueryPool_; // Pool of queries for asynchronous and batched modes
+    std::vector<size_t> batchCellQueryHandles_; // Pooled query handle of every grid cell
+    std::vector<size_t> batchCellFirstInstances_; // First occluder instance of every grid cell in the occluders instance buffer
+    std::vector<size_t> batchCellNumInstances_; // Number of occluder instances of every grid cell
+    std::vector<size_t> batchedObjectIndices_; // Indices of queried objects sorted by grid cells
+    std::unique_ptr<static_meshes_3D::InstanceBuffer> occluderInstanceBuffer_; // Occluder boxes of batched queries
+    std::unique_ptr<static_meshes_3D::InstanceBuffer> visualizedOccluderInstanceBuffer_; // Occluder boxes of visible objects for visualization
+    OcclusionQueryMode occlusionQueryMode_{ OcclusionQueryMode::Asynchronous }; // How occlusion queries are performed
+    bool isConditionalRenderingEnabled_{ false }; // Flag telling, whether GPU decides about visibility with conditional rendering
+    size_t numIssuedQueries_{ 0 }; // Number of occlusion queries issued during the last update
+    SoftwareOcclusionCuller softwareOcclusionCuller_; // Tests occlusion boxes against occluders rasterized on the CPU
 
     std::vector<std::unique_ptr<static_meshes_3D::StaticMesh3D>> meshes_; // Available meshes
     std::vector<glm::vec3> occlusionBoxSizes_; // With their corresponding occlusion box sizes
+    std::vector<const Texture*> meshTextures_; // Textures to render meshes with
+    std::vector<const shader_structs::Material*> meshMaterials_; // Materials to render meshes with
 
     shader_structs::Material shinyMaterial_{ 1.0f, 32.0f }; // Shiny material to render objects with
     shader_structs::Material dimMaterial_{0.1f, 64.0f}; // Dim material to render objects with
@@ -88,4 +261,16 @@ private:
     std::vector<ObjectWithOccluder> objects_; // All objects on the scene
     float timePassedSinceLastGeneration_{ 0.0f }; // Tracks the time of objects generation
     size_t numVisibleObjects_{ 0 }; // Number of visible objects since the last update
+    SpatialHashGrid objectGrid_{ OBJECT_GRID_CELL_SIZE }; // Boxes of all objects, frustum culling visits only the cells within the frustum
+    std::vector<size_t> gridHandleObjectIndices_; // Index of the object for every grid handle (objects are swapped on removal)
+    std::vector<uint32_t> gridQueryHandles_; // Handles found by the last grid query
+    std::vector<uint8_t> frustumVisibility_; // Result of frustum culling per object
+    bool isFrustumCullingEnabled_{ true }; // Flag telling, whether objects are culled by the view frustum
+    size_t numFrustumCulledObjects_{ 0 }; // Number of objects culled by the view frustum since the last update
+    RenderQueue renderQueue_; // Render queue sorting visible objects by their state
+    std::vector<std::unique_ptr<static_meshes_3D::InstanceBuffer>> meshInstanceBuffers_; // Instances of visible objects, one buffer per mesh
+    ParallelCommandRecorder commandRecorder_; // Records draw commands of visible objects on multiple threads
+    std::vector<size_t> meshSoftwareOccluders_; // Index of software occluder of every mesh (NO_SOFTWARE_OCCLUDER, if mesh doesn't occlude)
+    std::vector<std::vector<glm::mat4>> meshSoftwareOccluderMatrices_; // Model matrices of software occluders of every mesh, gathered every frame
+    static const size_t NO_SOFTWARE_OCCLUDER; // Marks meshes without software occluder
 };
\ No newline at end of file
@@ -0,0 +1,261 @@
+// STL
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <iomanip>
+#include <random>
+
+// Project
+#include "spatialHashGridBenchmark.h"
+#include "../common_classes/spatialHashGrid.h"
+
+namespace opengl4_mbsoftworks {
+namespace tutorial027 {
+
+const size_t SpatialHashGridBenchmark::NUM_OBJECTS = 1000000;
+const int SpatialHashGridBenchmark::NUM_QUERIES = 100;
+const int SpatialHashGridBenchmark::NUM_MOVE_STEPS = 5;
+const int SpatialHashGridBenchmark::NUM_RUNS = 3;
+const float SpatialHashGridBenchmark::AREA_HALF_SIZE = 5000.0f;
+const float SpatialHashGridBenchmark::CELL_SIZE = 20.0f;
+const float SpatialHashGridBenchmark::QUERY_RADIUS = 50.0f;
+const float SpatialHashGridBenchmark::RAY_LENGTH = 1000.0f;
+
+namespace {
+
+/**
+ * Runs the function multiple times and returns time of the fastest run in milliseconds.
+ */
+double measureFastestRun(const int numRuns, const std::function<void()>& function)
+{
+    auto bestTime = 0.0;
+    for (auto run = 0; run < numRuns; run++)
+    {
+        const auto startTime = std::chrono::high_resolution_clock::now();
+        function();
+        const auto runTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+        if (run == 0 || runTime < bestTime) {
+            bestTime = runTime;
+        }
+    }
+
+    return bestTime;
+}
+
+/**
+ * Checks, if the box intersects the sphere.
+ */
+bool doesBoxIntersectSphere(const AABB& box, const glm::vec3& center, const float radius)
+{
+    const auto offset = glm::max(box.min - center, glm::vec3(0.0f)) + glm::max(center - box.max, glm::vec3(0.0f));
+    return glm::dot(offset, offset) <= radius * radius;
+}
+
+/**
+ * Intersects ray with the box (slab test), returns true, if the box is hit within [0, maxDistance].
+ */
+bool intersectRayWithBox(const glm::vec3& origin, const glm::vec3& inverseDirection, const AABB& box, const float maxDistance, float& outDistance)
+{
+    auto nearDistance = 0.0f;
+    auto farDistance = maxDistance;
+    for (auto axis = 0; axis < 3; axis++)
+    {
+        auto t0 = (box.min[axis] - origin[axis]) * inverseDirection[axis];
+        auto t1 = (box.max[axis] - origin[axis]) * inverseDirection[axis];
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+
+        nearDistance = t0 > nearDistance ? t0 : nearDistance;
+        farDistance = t1 < farDistance ? t1 : farDistance;
+        if (nearDistance > farDistance) {
+            return false;
+        }
+    }
+
+    outDistance = nearDistance;
+    return true;
+}
+
+} // namespace
+
+void SpatialHashGridBenchmark::run()
+{
+    std::cout << "Starting spatial hash grid benchmark with " << NUM_OBJECTS << " moving objects..." << std::endl;
+    generateObjects();
+    results_.clear();
+
+    // Objects are inserted in order into the empty grid, so handles are the same as indices
+    SpatialHashGrid grid(CELL_SIZE);
+    const auto insertTime = measureFastestRun(1, [this, &grid]()
+    {
+        for (const auto& objectBox : objectBoxes_) {
+            grid.insert(objectBox);
+        }
+    });
+
+    // Moving objects within the flat array is the baseline, grid moves the objects between cells on top of that
+    const auto moveObjects = [this](const size_t objectIndex)
+    {
+        auto& objectBox = objectBoxes_[objectIndex];
+        objectBox.min += objectVelocities_[objectIndex];
+        objectBox.max += objectVelocities_[objectIndex];
+    };
+
+    const auto arrayMoveTime = measureFastestRun(NUM_RUNS, [this, &moveObjects]()
+    {
+        for (auto step = 0; step < NUM_MOVE_STEPS; step++)
+        {
+            for (size_t i = 0; i < objectBoxes_.size(); i++) {
+                moveObjects(i);
+            }
+        }
+    });
+
+    const auto gridMoveTime = measureFastestRun(NUM_RUNS, [this, &grid, &moveObjects]()
+    {
+        for (auto step = 0; step < NUM_MOVE_STEPS; step++)
+        {
+            for (size_t i = 0; i < objectBoxes_.size(); i++)
+            {
+                moveObjects(i);
+                grid.move(static_cast<uint32_t>(i), objectBoxes_[i]);
+            }
+        }
+    });
+    results_.push_back({ "Move (per step)", arrayMoveTime / NUM_MOVE_STEPS, gridMoveTime / NUM_MOVE_STEPS, NUM_OBJECTS, grid.getNumObjects() });
+
+    // Queries are made at random places within the area (with fixed seed, so both methods get the same ones)
+    std::mt19937 generator(22);
+    std::uniform_real_distribution<float> positionDistribution(-AREA_HALF_SIZE, AREA_HALF_SIZE);
+    std::uniform_real_distribution<float> angleDistribution(0.0f, 6.2831853f);
+    std::vector<glm::vec3> queryPoints;
+    std::vector<glm::vec3> rayDirections;
+    for (auto i = 0; i < NUM_QUERIES; i++)
+    {
+        queryPoints.emplace_back(positionDistribution(generator), 10.0f, positionDistribution(generator));
+        const auto angle = angleDistribution(generator);
+        rayDirections.emplace_back(std::cos(angle), -0.01f, std::sin(angle));
+        rayDirections.back() = glm::normalize(rayDirections.back());
+    }
+
+    size_t numFoundBruteForce = 0;
+    const auto bruteForceSphereTime = measureFastestRun(NUM_RUNS, [this, &queryPoints, &numFoundBruteForce]()
+    {
+        numFoundBruteForce = 0;
+        for (const auto& queryPoint : queryPoints)
+        {
+            for (const auto& objectBox : objectBoxes_)
+            {
+                if (doesBoxIntersectSphere(objectBox, queryPoint, QUERY_RADIUS)) {
+                    numFoundBruteForce++;
+                }
+            }
+        }
+    });
+
+    size_t numFoundGrid = 0;
+    std::vector<uint32_t> foundHandles;
+    const auto gridSphereTime = measureFastestRun(NUM_RUNS, [&grid, &queryPoints, &foundHandles, &numFoundGrid]()
+    {
+        numFoundGrid = 0;
+        for (const auto& queryPoint : queryPoints)
+        {
+            grid.querySphere(queryPoint, QUERY_RADIUS, foundHandles);
+            numFoundGrid += foundHandles.size();
+        }
+    });
+    results_.push_back({ "Proximity queries", bruteForceSphereTime, gridSphereTime, numFoundBruteForce, numFoundGrid });
+
+    // Raycasts find the nearest hit object, number of rays, that hit something, is compared
+    const auto bruteForceRayTime = measureFastestRun(NUM_RUNS, [this, &queryPoints, &rayDirections, &numFoundBruteForce]()
+    {
+        numFoundBruteForce = 0;
+        for (auto i = 0; i < NUM_QUERIES; i++)
+        {
+            const auto& direction = rayDirections[i];
+            const glm::vec3 inverseDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+            auto nearestDistance = RAY_LENGTH;
+            auto isHit = false;
+            for (const auto& objectBox : objectBoxes_)
+            {
+                auto hitDistance = 0.0f;
+                if (intersectRayWithBox(queryPoints[i], inverseDirection, objectBox, nearestDistance, hitDistance))
+                {
+                    nearestDistance = hitDistance;
+                    isHit = true;
+                }
+            }
+
+            if (isHit) {
+                numFoundBruteForce++;
+            }
+        }
+    });
+
+    const auto gridRayTime = measureFastestRun(NUM_RUNS, [&grid, &queryPoints, &rayDirections, &numFoundGrid]()
+    {
+        numFoundGrid = 0;
+        for (auto i = 0; i < NUM_QUERIES; i++)
+        {
+            if (grid.raycast(queryPoints[i], rayDirections[i], RAY_LENGTH) != SpatialHashGrid::INVALID_HANDLE) {
+                numFoundGrid++;
+            }
+        }
+    });
+    results_.push_back({ "Raycasts", bruteForceRayTime, gridRayTime, numFoundBruteForce, numFoundGrid });
+
+    const auto numCells = grid.getNumCells();
+    objectBoxes_.clear();
+    objectBoxes_.shrink_to_fit();
+    objectVelocities_.clear();
+    objectVelocities_.shrink_to_fit();
+    printResults(insertTime, numCells);
+}
+
+void SpatialHashGridBenchmark::generateObjects()
+{
+    // Fixed seed, so that the runs are comparable
+    std::mt19937 generator(22);
+    std::uniform_real_distribution<float> positionDistribution(-AREA_HALF_SIZE, AREA_HALF_SIZE);
+    std::uniform_real_distribution<float> heightDistribution(0.0f, 20.0f);
+    std::uniform_real_distribution<float> extentDistribution(0.5f, 3.0f);
+    std::uniform_real_distribution<float> velocityDistribution(-2.0f, 2.0f);
+
+    objectBoxes_.clear();
+    objectBoxes_.reserve(NUM_OBJECTS);
+    objectVelocities_.clear();
+    objectVelocities_.reserve(NUM_OBJECTS);
+    for (size_t i = 0; i < NUM_OBJECTS; i++)
+    {
+        const glm::vec3 center(positionDistribution(generator), heightDistribution(generator), positionDistribution(generator));
+        const glm::vec3 extents(extentDistribution(generator), extentDistribution(generator), extentDistribution(generator));
+        objectBoxes_.push_back(AABB::fromCenterAndExtents(center, extents));
+        objectVelocities_.emplace_back(velocityDistribution(generator), 0.0f, velocityDistribution(generator));
+    }
+}
+
+void SpatialHashGridBenchmark::printResults(const double insertTime, const size_t numCells) const
+{
+    const auto previousFlags = std::cout.flags();
+    const auto previousPrecision = std::cout.precision();
+    std::cout << "Spatial hash grid benchmark results (fastest of " << NUM_RUNS << " runs, " << NUM_QUERIES << " queries of every kind, "
+        << NUM_OBJECTS << " objects inserted in " << insertTime << " ms into " << numCells << " cells):" << std::endl;
+    std::cout << std::setw(20) << "Operation" << std::setw(16) << "Brute force (ms)" << std::setw(12) << "Grid (ms)" << std::setw(12) << "Speedup"
+        << std::setw(22) << "Found (brute / grid)" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    for (const auto& result : results_)
+    {
+        const auto speedup = result.gridTime > 0.0 ? result.bruteForceTime / result.gridTime : 0.0;
+        std::cout << std::setw(20) << result.name << std::setw(16) << result.bruteForceTime << std::setw(12) << result.gridTime
+            << std::setw(11) << speedup << "x" << std::setw(22) << std::to_string(result.numFoundBruteForce) + " / " + std::to_string(result.numFoundGrid) << std::endl;
+    }
+
+    std::cout.flags(previousFlags);
+    std::cout.precision(previousPrecision);
+}
+
+} // namespace tutorial027
+} // namespace opengl4_mbsoftworks
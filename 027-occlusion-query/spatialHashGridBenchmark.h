@@ -0,0 +1,65 @@
+#pragma once
+
+// STL
+#include <string>
+#include <vector>
+
+// Project
+#include "../common_classes/boundingVolumes.h"
+
+namespace opengl4_mbsoftworks {
+namespace tutorial027 {
+
+/**
+ * Benchmark, that moves many objects around and queries them through the spatial hash grid. Every operation is compared
+ * with the brute force loop over the flat array of boxes - updating the array is the cheapest possible move, but then
+ * every query has to go through all objects. Benchmark runs synchronously and results are printed to standard output.
+ */
+class SpatialHashGridBenchmark
+{
+public:
+    static const size_t NUM_OBJECTS; // Number of moving objects
+    static const int NUM_QUERIES; // Number of queries of every kind
+    static const int NUM_MOVE_STEPS; // Number of steps, that all objects are moved in
+    static const int NUM_RUNS; // Number of runs of every operation (the fastest one is taken)
+
+    static const float AREA_HALF_SIZE; // Objects are generated within square of this half size around the origin
+    static const float CELL_SIZE; // Size of one cell of the benchmarked grid
+    static const float QUERY_RADIUS; // Radius of proximity queries
+    static const float RAY_LENGTH; // Maximal distance of raycasts
+
+    /**
+     * Runs the benchmark and prints the results.
+     */
+    void run();
+
+private:
+    /**
+     * Result of one operation done both by brute force and with the grid.
+     */
+    struct OperationResult
+    {
+        std::string name;
+        double bruteForceTime;
+        double gridTime;
+        size_t numFoundBruteForce;
+        size_t numFoundGrid;
+    };
+
+    /**
+     * Generates random object boxes and their velocities.
+     */
+    void generateObjects();
+
+    /**
+     * Prints results of the benchmark as a table to standard output.
+     */
+    void printResults(double insertTime, size_t numCells) const;
+
+    std::vector<AABB> objectBoxes_; // Bounding boxes of the objects
+    std::vector<glm::vec3> objectVelocities_; // Movement of every object in one step
+    std::vector<OperationResult> results_; // Results of all operations
+};
+
+} // namespace tutorial027
+} // namespace opengl4_mbsoftworks
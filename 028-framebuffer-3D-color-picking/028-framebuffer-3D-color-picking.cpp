@@ -66,9 +66,24 @@ void OpenGLWindow028::initializeScene()
 		mainShaderProgram.addShaderToProgram(sm.getFragmentShader(ShaderKeys::diffuseLight()));
         mainShaderProgram.addShaderToProgram(sm.getFragmentShader(ShaderKeys::specularHighlight()));
 
+        // Instanced variant of main program is compiled on demand, when instanced rendering gets turned on
+        spm.createShaderProgramVariants("main", {
+            { GL_VERTEX_SHADER, "data/shaders/tut021-specular-highlight/shader.vert" },
+            { GL_FRAGMENT_SHADER, "data/shaders/tut021-specular-highlight/shader.frag" },
+            { GL_FRAGMENT_SHADER, "data/shaders/lighting/ambientLight.frag" },
+            { GL_FRAGMENT_SHADER, "data/shaders/lighting/diffuseLight.frag" },
+            { GL_FRAGMENT_SHADER, "data/shaders/lighting/specularHighlight.frag" }
+        });
+
         auto& singleColorShaderProgram = spm.createShaderProgram("single-color");
         singleColorShaderProgram.addShaderToProgram(sm.getVertexShader("single-color"));
         singleColorShaderProgram.addShaderToProgram(sm.getFragmentShader("single-color"));
+
+        // Instanced variant of single color program renders crates and objects in color picking mode
+        spm.createShaderProgramVariants("single-color", {
+            { GL_VERTEX_SHADER, "data/shaders/single-color/shader.vert" },
+            { GL_FRAGMENT_SHADER, "data/shaders/single-color/shader.frag" }
+        });
 		
         skybox = std::make_unique<static_meshes_3D::Skybox>("data/skyboxes/jajlake1", "jpg");
 		hud = std::make_unique<HUD028>(*this);
@@ -99,7 +114,7 @@ void OpenGLWindow028::initializeScene()
 
 void OpenGLWindow028::renderScene()
 {
-	const auto& spm = ShaderProgramManager::getInstance();
+	auto& spm = ShaderProgramManager::getInstance();
 	const auto& tm = TextureManager::getInstance();
 	auto& mm = MatrixManager::getInstance();
 
@@ -138,12 +153,28 @@ void OpenGLWindow028::renderScene()
     tm.getTexture("grass").bind(0);
     World::getInstance().renderGround(mainProgram);
 
-    // Render mini-maze made out of crates
+    // Render mini-maze made out of crates and all pickable objects - either one by one or with instanced draw calls
+    auto& objectPicker = ObjectPicker::getInstance();
     tm.getTexture("crate").bind();
-    World::getInstance().renderCratesMaze(mainProgram);
+    if (objectPicker.isInstancedRenderingMode())
+    {
+        // Instanced variant of main program needs the same setup as the main program
+        auto& instancedProgram = spm.getShaderProgramVariant("main", ShaderDefines().define("INSTANCED"));
+        instancedProgram.useProgram();
+        instancedProgram[ShaderConstants::projectionMatrix()] = getProjectionMatrix();
+        instancedProgram[ShaderConstants::viewMatrix()] = flyingCamera.getViewMatrix();
+        instancedProgram[ShaderConstants::color()] = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+        instancedProgram[ShaderConstants::sampler()] = 0;
+        instancedProgram[ShaderConstants::eyePosition()] = flyingCamera.getEye();
+        ambientLight.setUniform(instancedProgram, ShaderConstants::ambientLight());
+        diffuseLight.setUniform(instancedProgram, ShaderConstants::diffuseLight());
+        shader_structs::Material::none().setUniform(instancedProgram, ShaderConstants::material());
+        World::getInstance().renderCratesMazeInstanced(instancedProgram);
+    }
+    else {
+        World::getInstance().renderCratesMaze(mainProgram);
+    }
 
-    // Render all pickable objects
-    auto& objectPicker = ObjectPicker::getInstance();
     objectPicker.renderAllPickableObjects();
 
     // Visualize frame buffer only if it's enabled
@@ -159,7 +190,8 @@ void OpenGLWindow028::renderScene()
     FrameBuffer::Default::setFullViewport();
 
 	// Render HUD
-    hud->renderHUD(objectPicker.isPixelPerfectSelectionMode(), visualizeColorFrameBuffer, objectPicker.getSelectedObjectDescription(), updateCamera);
+    hud->renderHUD(objectPicker.isPixelPerfectSelectionMode(), visualizeColorFrameBuffer, objectPicker.getSelectedObjectDescription(), updateCamera,
+        objectPicker.isRayPickingMode(), objectPicker.isInstancedRenderingMode());
 }
 
 void OpenGLWindow028::releaseScene()
@@ -176,6 +208,7 @@ void OpenGLWindow028::releaseScene()
 	FreeTypeFontManager::getInstance().clearFreeTypeFontCache();
 
 	hud.reset();
+	static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 void OpenGLWindow028::onWindowSizeChanged(int width, int height)
@@ -217,6 +250,14 @@ void OpenGLWindow028::updateScene()
         visualizeColorFrameBuffer = !visualizeColorFrameBuffer;
     }
 
+    if (keyPressedOnce(GLFW_KEY_R)) {
+        ObjectPicker::getInstance().toggleRayPickingMode();
+    }
+
+    if (keyPressedOnce(GLFW_KEY_I)) {
+        ObjectPicker::getInstance().toggleInstancedRenderingMode();
+    }
+
     if(keyPressedOnce(GLFW_KEY_U)) {
         updateCamera = !updateCamera;
     }
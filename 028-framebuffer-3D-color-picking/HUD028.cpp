@@ -21,8 +21,11 @@ HUD028::HUD028(const OpenGLWindow& window)
     });
 }
 
-void HUD028::renderHUD(bool isPixelPerfectSelectionMode, bool visualizeColorFrameBuffer, const std::string& selectedObjectDescription, bool updateCamera) const
+void HUD028::renderHUD(bool isPixelPerfectSelectionMode, bool visualizeColorFrameBuffer, const std::string& selectedObjectDescription, bool updateCamera,
+    bool isRayPickingMode, bool isInstancedRenderingMode) const
 {
+    FreeTypeFont::PrintBatch printBatch;
+
     printBuilder().print(10, 10, "FPS: {}", _window.getFPS());
     printBuilder().print(10, 40, "Vertical Synchronization: {} (Press F3 to toggle)", _window.isVerticalSynchronizationEnabled() ? "On" : "Off");
 
@@ -31,6 +34,8 @@ void HUD028::renderHUD(bool isPixelPerfectSelectionMode, bool visualizeColorFram
     printBuilder().print(10, 130, "Visualize color frame buffer: {} (Press 'C' to toggle)", visualizeColorFrameBuffer ? "On" : "Off");
     printBuilder().print(10, 160, "Selected object: {}", selectedObjectDescription);
     printBuilder().print(10, 190, "Update camera: {} (Press 'U' to toggle)", updateCamera ? "Yes" : "No");
+    printBuilder().print(10, 220, "Picking method: {} (Press 'R' to toggle)", isRayPickingMode ? "Ray cast through spatial grid" : "Color frame buffer");
+    printBuilder().print(10, 250, "Instanced rendering: {} (Press 'I' to toggle)", isInstancedRenderingMode ? "On" : "Off");
 
     printBuilder()
         .fromRight()
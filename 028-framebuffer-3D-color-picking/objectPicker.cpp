@@ -7,6 +7,7 @@
 
 #include "../common_classes/frameBuffer.h"
 #include "../common_classes/matrixManager.h"
+#include "../common_classes/shaderDefines.h"
 #include "../common_classes/shaderProgramManager.h"
 #include "../common_classes/textureManager.h"
 #include "../common_classes/static_meshes_3D/primitives/cylinder.h"
@@ -42,26 +43,58 @@ void ObjectPicker::initialize()
     meshes_.push_back(std::make_unique<static_meshes_3D::Torus>(20, 20, 4.0f, 2.0f, true, true, true));
     const glm::vec3 torusOcclusionBoxSize{ 12.0f, 12.0f, 4.0f };
 
+    // Every mesh is rendered with its own texture
+    const auto& tm = TextureManager::getInstance();
+    const auto cylinderTexture = &tm.getTexture("diamond");
+    const auto sphereTexture = &tm.getTexture("white_marble");
+    const auto torusTexture = &tm.getTexture("scifi_metal");
+
+    // Every mesh has its own instance buffer for instanced rendering
+    for (size_t i = 0; i < meshes_.size(); i++) {
+        meshInstanceBuffers_.push_back(std::make_unique<static_meshes_3D::InstanceBuffer>());
+    }
+
+    occluderInstanceBuffer_ = std::make_unique<static_meshes_3D::InstanceBuffer>();
+
     // Create several pickable objects on the scene
-    objects_.push_back(PickableObject{ glm::vec3(-75.0f, 6.0f, 120.0f), meshes_[0].get(), cylinderOcclusionBoxSize });
-    objects_.push_back(PickableObject{ glm::vec3(-75.0f, 6.0f, -75.0f), meshes_[1].get(), sphereOcclusionBoxSize });
-    objects_.push_back(PickableObject{ glm::vec3(75.0f, 6.0f, -75.0f), meshes_[2].get(), torusOcclusionBoxSize });
-    objects_.push_back(PickableObject{ glm::vec3(75.0f, 6.0f, 55.0f), meshes_[2].get(), torusOcclusionBoxSize });
-    objects_.push_back(PickableObject{ glm::vec3(-35.0f, 6.0f, 55.0f), meshes_[1].get(), sphereOcclusionBoxSize });
-    objects_.push_back(PickableObject{ glm::vec3(-35.0f, 6.0f, -30.0f), meshes_[0].get(), cylinderOcclusionBoxSize });
-    objects_.push_back(PickableObject{ glm::vec3(30.0f, 6.0f, -30.0f), meshes_[1].get(), sphereOcclusionBoxSize });
-    objects_.push_back(PickableObject{ glm::vec3(30.0f, 6.0f, 10.0f), meshes_[0].get(), cylinderOcclusionBoxSize });
-    objects_.push_back(PickableObject{ glm::vec3(10.0f, 6.0f, 10.0f), meshes_[2].get(), torusOcclusionBoxSize });
+    objects_.push_back(PickableObject{ glm::vec3(-75.0f, 6.0f, 120.0f), meshes_[0].get(), cylinderTexture, cylinderOcclusionBoxSize });
+    objects_.push_back(PickableObject{ glm::vec3(-75.0f, 6.0f, -75.0f), meshes_[1].get(), sphereTexture, sphereOcclusionBoxSize });
+    objects_.push_back(PickableObject{ glm::vec3(75.0f, 6.0f, -75.0f), meshes_[2].get(), torusTexture, torusOcclusionBoxSize });
+    objects_.push_back(PickableObject{ glm::vec3(75.0f, 6.0f, 55.0f), meshes_[2].get(), torusTexture, torusOcclusionBoxSize });
+    objects_.push_back(PickableObject{ glm::vec3(-35.0f, 6.0f, 55.0f), meshes_[1].get(), sphereTexture, sphereOcclusionBoxSize });
+    objects_.push_back(PickableObject{ glm::vec3(-35.0f, 6.0f, -30.0f), meshes_[0].get(), cylinderTexture, cylinderOcclusionBoxSize });
+    objects_.push_back(PickableObject{ glm::vec3(30.0f, 6.0f, -30.0f), meshes_[1].get(), sphereTexture, sphereOcclusionBoxSize });
+    objects_.push_back(PickableObject{ glm::vec3(30.0f, 6.0f, 10.0f), meshes_[0].get(), cylinderTexture, cylinderOcclusionBoxSize });
+    objects_.push_back(PickableObject{ glm::vec3(10.0f, 6.0f, 10.0f), meshes_[2].get(), torusTexture, torusOcclusionBoxSize });
+
+    // Objects and crates are put into the spatial grid for ray picking, crates are static, so their handles don't need to be kept
+    for (auto& object : objects_) {
+        object.gridHandle = objectGrid_.insert(object.getBoundingBox());
+    }
+
+    for (const auto& crateBox : World::getInstance().getCratesMazeBoxes()) {
+        objectGrid_.insert(crateBox);
+    }
 }
 
 void ObjectPicker::release()
 {
     occluderCube_.reset();
     meshes_.clear();
+    meshInstanceBuffers_.clear();
+    occluderInstanceBuffer_.reset();
+    objects_.clear();
+    objectGrid_.clear();
 }
 
 void ObjectPicker::renderAllPickableObjects()
 {
+    if (instancedRenderingMode_)
+    {
+        renderAllPickableObjectsInstanced();
+        return;
+    }
+
     const auto& mm = MatrixManager::getInstance();
     auto& singleColorShaderProgram = ShaderProgramManager::getInstance().getShaderProgram("single-color");
     singleColorShaderProgram.useProgram();
@@ -69,37 +102,64 @@ void ObjectPicker::renderAllPickableObjects()
     singleColorShaderProgram[ShaderConstants::viewMatrix()] = mm.getViewMatrix();
     singleColorShaderProgram[ShaderConstants::color()] = glm::vec4(1.0f, 0.0f, 0.0f, 0.4f);
 
-    const auto& tm = TextureManager::getInstance();
     auto& mainProgram = ShaderProgramManager::getInstance().getShaderProgram("main");
-    mainProgram.useProgram();
+    renderQueue_.begin(mm.getViewMatrix(), 500.0f);
 
     for(auto i = 0; i < static_cast<int>(objects_.size()); i++)
     {
         const auto& object = objects_.at(i);
 
-        auto modelMatrix = glm::translate(glm::mat4(1.0f), object.position);
-        modelMatrix = glm::rotate(modelMatrix, object.rotationAngleRad, glm::vec3(0.0f, 1.0f, 0.0f));
-        modelMatrix = glm::scale(modelMatrix, object.getRenderScale());
-        mainProgram.setModelAndNormalMatrix(modelMatrix);
+        RenderQueue::DrawItem drawItem;
+        drawItem.shaderProgram = &mainProgram;
+        drawItem.material = &shinyMaterial_;
+        drawItem.texture = object.texturePtr;
+        drawItem.mesh = object.meshPtr;
+        drawItem.modelMatrix = object.getModelMatrix();
 
         const auto color = selectedIndex_ == i ? glm::vec4(0.0f, 0.5f, 1.0f, 1.0f) : glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
-        mainProgram[ShaderConstants::color()] = color;
-        shinyMaterial_.setUniform(mainProgram, ShaderConstants::material());
+        drawItem.setupFunction = [color](ShaderProgram& shaderProgram) {
+            shaderProgram[ShaderConstants::color()] = color;
+        };
 
-        if (dynamic_cast<static_meshes_3D::Cylinder*>(object.meshPtr))
-        {
-            tm.getTexture("diamond").bind();
-        }
-        else if (dynamic_cast<static_meshes_3D::Sphere*>(object.meshPtr))
+        renderQueue_.submit(drawItem);
+    }
+
+    renderQueue_.replay();
+}
+
+void ObjectPicker::renderAllPickableObjectsInstanced()
+{
+    auto& instancedProgram = ShaderProgramManager::getInstance().getShaderProgramVariant("main", ShaderDefines().define("INSTANCED"));
+    instancedProgram.useProgram();
+    instancedProgram.setModelAndNormalMatrix(glm::mat4(1.0f));
+    instancedProgram[ShaderConstants::color()] = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+    shinyMaterial_.setUniform(instancedProgram, ShaderConstants::material());
+
+    for (size_t meshIndex = 0; meshIndex < meshes_.size(); meshIndex++)
+    {
+        auto& instanceBuffer = *meshInstanceBuffers_[meshIndex];
+        instanceBuffer.clear();
+
+        const Texture* texturePtr = nullptr;
+        for (auto i = 0; i < static_cast<int>(objects_.size()); i++)
         {
-            tm.getTexture("white_marble").bind();
+            const auto& object = objects_[i];
+            if (object.meshPtr != meshes_[meshIndex].get()) {
+                continue;
+            }
+
+            // Selected object is highlighted with instance color
+            texturePtr = object.texturePtr;
+            instanceBuffer.addInstance(object.getModelMatrix(), selectedIndex_ == i ? glm::vec4(0.0f, 0.5f, 1.0f, 1.0f) : glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
         }
-        else if (dynamic_cast<static_meshes_3D::Torus*>(object.meshPtr))
-        {
-            tm.getTexture("scifi_metal").bind();
+
+        if (texturePtr == nullptr) {
+            continue;
         }
 
-        object.meshPtr->render();
+        instanceBuffer.upload();
+        texturePtr->bind();
+        meshes_[meshIndex]->renderInstanced(instanceBuffer);
     }
 }
 
@@ -116,11 +176,19 @@ void ObjectPicker::updateAllPickableObjects(float deltaTime)
             object.rotationAngleRad += deltaTime;
             object.renderScaleAngleRad = 0.0f;
         }
+
+        objectGrid_.move(object.gridHandle, object.getBoundingBox());
     }
 }
 
 void ObjectPicker::renderInColorMode()
 {
+    if (instancedRenderingMode_)
+    {
+        renderInColorModeInstanced();
+        return;
+    }
+
     const auto& mm = MatrixManager::getInstance();
 
     auto& singleColorShaderProgram = ShaderProgramManager::getInstance().getShaderProgram("single-color");
@@ -136,18 +204,9 @@ void ObjectPicker::renderInColorMode()
     for (auto i = 0; i < static_cast<int>(objects_.size()); i++)
     {
         const auto& object = objects_.at(i);
-
-        const auto r = i & 0xFF;
-        const auto g = (i >> 8) & 0xFF;
-        const auto b = (i >> 16) & 0xFF;
-        const auto fr = static_cast<float>(r) / 255.0f;
-        const auto fg = static_cast<float>(g) / 255.0f;
-        const auto fb = static_cast<float>(b) / 255.0f;
-        singleColorShaderProgram[ShaderConstants::color()] = glm::vec4(fr, fg, fb, 1.0f);
+        singleColorShaderProgram[ShaderConstants::color()] = getPickingColor(i);
         
-        auto modelMatrix = glm::translate(glm::mat4(1.0f), object.position);
-        modelMatrix = glm::rotate(modelMatrix, object.rotationAngleRad, glm::vec3(0.0f, 1.0f, 0.0f));
-        modelMatrix = glm::scale(modelMatrix, object.getRenderScale());
+        auto modelMatrix = object.getModelMatrix();
         if (!pixelPerfectSelectionMode_)
         {
             modelMatrix = glm::scale(modelMatrix, object.occlusionBoxSize);
@@ -162,6 +221,80 @@ void ObjectPicker::renderInColorMode()
     }
 }
 
+void ObjectPicker::renderInColorModeInstanced()
+{
+    const auto& mm = MatrixManager::getInstance();
+
+    // Ground is just one mesh, it's rendered with the regular single color program
+    auto& singleColorShaderProgram = ShaderProgramManager::getInstance().getShaderProgram("single-color");
+    singleColorShaderProgram.useProgram();
+    singleColorShaderProgram[ShaderConstants::projectionMatrix()] = mm.getProjectionMatrix();
+    singleColorShaderProgram[ShaderConstants::viewMatrix()] = mm.getViewMatrix();
+    singleColorShaderProgram[ShaderConstants::color()] = glm::vec4(0.5f, 0.5f, 0.5f, 1.0f);
+    World::getInstance().renderGround(singleColorShaderProgram);
+
+    auto& instancedProgram = ShaderProgramManager::getInstance().getShaderProgramVariant("single-color", ShaderDefines().define("INSTANCED"));
+    instancedProgram.useProgram();
+    instancedProgram[ShaderConstants::projectionMatrix()] = mm.getProjectionMatrix();
+    instancedProgram[ShaderConstants::viewMatrix()] = mm.getViewMatrix();
+    instancedProgram[ShaderConstants::color()] = glm::vec4(0.75f, 0.75f, 0.75f, 1.0f);
+    World::getInstance().renderCratesMazeInstanced(instancedProgram);
+
+    // Objects have their picking colors as instance colors
+    instancedProgram[ShaderConstants::color()] = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+    if (!pixelPerfectSelectionMode_)
+    {
+        occluderInstanceBuffer_->clear();
+        for (auto i = 0; i < static_cast<int>(objects_.size()); i++)
+        {
+            const auto& object = objects_[i];
+            occluderInstanceBuffer_->addInstance(glm::scale(object.getModelMatrix(), object.occlusionBoxSize), getPickingColor(i));
+        }
+
+        occluderInstanceBuffer_->upload();
+        occluderCube_->renderInstanced(*occluderInstanceBuffer_);
+        return;
+    }
+
+    for (size_t meshIndex = 0; meshIndex < meshes_.size(); meshIndex++)
+    {
+        auto& instanceBuffer = *meshInstanceBuffers_[meshIndex];
+        instanceBuffer.clear();
+        for (auto i = 0; i < static_cast<int>(objects_.size()); i++)
+        {
+            if (objects_[i].meshPtr == meshes_[meshIndex].get()) {
+                instanceBuffer.addInstance(objects_[i].getModelMatrix(), getPickingColor(i));
+            }
+        }
+
+        instanceBuffer.upload();
+        meshes_[meshIndex]->renderInstanced(instanceBuffer);
+    }
+}
+
+glm::vec4 ObjectPicker::getPickingColor(const int objectIndex)
+{
+    const auto r = objectIndex & 0xFF;
+    const auto g = (objectIndex >> 8) & 0xFF;
+    const auto b = (objectIndex >> 16) & 0xFF;
+    const auto fr = static_cast<float>(r) / 255.0f;
+    const auto fg = static_cast<float>(g) / 255.0f;
+    const auto fb = static_cast<float>(b) / 255.0f;
+    return glm::vec4(fr, fg, fb, 1.0f);
+}
+
+glm::mat4 ObjectPicker::PickableObject::getModelMatrix() const
+{
+    auto modelMatrix = glm::translate(glm::mat4(1.0f), position);
+    modelMatrix = glm::rotate(modelMatrix, rotationAngleRad, glm::vec3(0.0f, 1.0f, 0.0f));
+    return glm::scale(modelMatrix, getRenderScale());
+}
+
+AABB ObjectPicker::PickableObject::getBoundingBox() const
+{
+    return AABB::fromCenterAndExtents(glm::vec3(0.0f), occlusionBoxSize * 0.5f).transformed(getModelMatrix());
+}
+
 bool ObjectPicker::isPixelPerfectSelectionMode() const
 {
     return pixelPerfectSelectionMode_;
@@ -172,6 +305,26 @@ void ObjectPicker::togglePixelPerfectSelectionMode()
     pixelPerfectSelectionMode_ = !pixelPerfectSelectionMode_;
 }
 
+bool ObjectPicker::isRayPickingMode() const
+{
+    return rayPickingMode_;
+}
+
+void ObjectPicker::toggleRayPickingMode()
+{
+    rayPickingMode_ = !rayPickingMode_;
+}
+
+bool ObjectPicker::isInstancedRenderingMode() const
+{
+    return instancedRenderingMode_;
+}
+
+void ObjectPicker::toggleInstancedRenderingMode()
+{
+    instancedRenderingMode_ = !instancedRenderingMode_;
+}
+
 std::string ObjectPicker::getSelectedObjectDescription() const
 {
     if(selectedIndex_ >= static_cast<int>(objects_.size())) {
@@ -202,6 +355,12 @@ void ObjectPicker::resizePickingFrameBuffer(int width, int height)
 
 void ObjectPicker::performObjectPicking(int x, int y)
 {
+    if (rayPickingMode_)
+    {
+        performRayPicking(x, y);
+        return;
+    }
+
     pickingFrameBuffer_.bindAsBothReadAndDraw();
     pickingFrameBuffer_.setFullViewport();
 
@@ -217,6 +376,33 @@ void ObjectPicker::performObjectPicking(int x, int y)
     selectedIndex_ = r | (g << 8) | (b << 16);
 }
 
+void ObjectPicker::performRayPicking(int x, int y)
+{
+    // Unproject the point on the near and far plane (picking framebuffer has always the size of the screen)
+    const auto& mm = MatrixManager::getInstance();
+    const auto inverseProjectionViewMatrix = glm::inverse(mm.getProjectionMatrix() * mm.getViewMatrix());
+    const auto ndcX = 2.0f * (static_cast<float>(x) + 0.5f) / static_cast<float>(pickingFrameBuffer_.getWidth()) - 1.0f;
+    const auto ndcY = 2.0f * (static_cast<float>(y) + 0.5f) / static_cast<float>(pickingFrameBuffer_.getHeight()) - 1.0f;
+    auto nearPoint = inverseProjectionViewMatrix * glm::vec4(ndcX, ndcY, -1.0f, 1.0f);
+    auto farPoint = inverseProjectionViewMatrix * glm::vec4(ndcX, ndcY, 1.0f, 1.0f);
+    nearPoint /= nearPoint.w;
+    farPoint /= farPoint.w;
+
+    const auto rayOrigin = glm::vec3(nearPoint);
+    const auto rayVector = glm::vec3(farPoint) - rayOrigin;
+    const auto rayLength = glm::length(rayVector);
+    const auto hitHandle = objectGrid_.raycast(rayOrigin, rayVector / rayLength, rayLength);
+
+    // Crate or nothing hit means nothing is selected
+    selectedIndex_ = std::numeric_limits<int>::max();
+    for (auto i = 0; i < static_cast<int>(objects_.size()); i++)
+    {
+        if (objects_[i].gridHandle == hitHandle) {
+            selectedIndex_ = i;
+        }
+    }
+}
+
 void ObjectPicker::copyColorToDefaultFrameBuffer() const
 {
     pickingFrameBuffer_.copyColorToDefaultFrameBuffer();
@@ -8,7 +8,10 @@
 
 // Project
 #include "../common_classes/frameBuffer.h"
+#include "../common_classes/renderQueue.h"
+#include "../common_classes/spatialHashGrid.h"
 #include "../common_classes/shader_structs/material.h"
+#include "../common_classes/static_meshes_3D/instanceBuffer.h"
 #include "../common_classes/static_meshes_3D/primitives/cube.h"
 #include "../common_classes/static_meshes_3D/staticMesh3D.h"
 
@@ -34,7 +37,8 @@ public:
     void release();
 
     /**
-     * Renders all pickable objects.
+     * Renders all pickable objects. In instanced rendering mode, instanced variant of main program
+     * must have the scene properties (matrices, lights) set.
      */
     void renderAllPickableObjects();
 
@@ -55,6 +59,26 @@ public:
      */
     void togglePixelPerfectSelectionMode();
 
+    /**
+     * Returns true if objects are picked by casting ray through the spatial grid or false if they're picked with color framebuffer.
+     */
+    bool isRayPickingMode() const;
+
+    /**
+     * Toggles between ray picking and color framebuffer picking.
+     */
+    void toggleRayPickingMode();
+
+    /**
+     * Returns true if objects sharing a mesh (and crates) are rendered with one instanced draw call or false otherwise.
+     */
+    bool isInstancedRenderingMode() const;
+
+    /**
+     * Toggles instanced rendering of objects.
+     */
+    void toggleInstancedRenderingMode();
+
     /**
      * Performs object picking at certain point.
      *
@@ -84,11 +108,35 @@ private:
     ObjectPicker(const ObjectPicker&) = delete; // No copy constructor allowed
     void operator=(const ObjectPicker&) = delete; // No copy assignment allowed
 
+    /**
+     * Renders all objects sharing a mesh with one instanced draw call (every mesh has its own texture).
+     */
+    void renderAllPickableObjectsInstanced();
+
     /**
      * Renders all pickable objects in color picking mode.
      */
     void renderInColorMode();
 
+    /**
+     * Renders all pickable objects in color picking mode with instanced draw calls - object IDs are per-instance colors.
+     */
+    void renderInColorModeInstanced();
+
+    /**
+     * Gets color, that encodes index of the object in color picking mode.
+     */
+    static glm::vec4 getPickingColor(int objectIndex);
+
+    /**
+     * Picks the object by casting ray from the camera through the point on the screen. Ray is tested against boxes
+     * of objects and crates in the spatial grid, so nothing has to be rendered and read back from the GPU.
+     *
+     * @param x  X coordinate of the pick (in OpenGL window coordinates)
+     * @param y  Y coordinate of the pick (in OpenGL window coordinates)
+     */
+    void performRayPicking(int x, int y);
+
     /**
      * Helper struct that holds all information about pickable object.
      */
@@ -96,9 +144,11 @@ private:
     {
         glm::vec3 position; // Position of the object
         static_meshes_3D::StaticMesh3D* meshPtr; // Pointer to a mesh to be rendered
+        const Texture* texturePtr; // Pointer to a texture to render mesh with
         glm::vec3 occlusionBoxSize; // Size of occlusion box in case we don't render mesh
         float rotationAngleRad{ 0.0f }; // Rotation angle for cool effect
         float renderScaleAngleRad{ 0.0f }; // Angle used to calculate scale and create nice pulsing effect when object is selected 
+        uint32_t gridHandle{ SpatialHashGrid::INVALID_HANDLE }; // Handle of the object's box in the spatial grid
 
         /**
          * Calculates rendering scale from the renderScaleAngleRad with sine method. Creates nice pulsing effect.
@@ -109,17 +159,33 @@ private:
             const auto scaleFactor = 1.0f + sine * 0.1f;
             return glm::vec3{ scaleFactor };
         }
+
+        /**
+         * Gets model matrix of the object, as it's rendered (rotated and scaled).
+         */
+        glm::mat4 getModelMatrix() const;
+
+        /**
+         * Gets bounding box of the rotated and scaled occlusion box.
+         */
+        AABB getBoundingBox() const;
     };
 
     std::unique_ptr<static_meshes_3D::Cube> occluderCube_; // Mesh serving as occluder (cube)
     std::vector<std::unique_ptr<static_meshes_3D::StaticMesh3D>> meshes_; // Available meshes
     std::vector<PickableObject> objects_; // All pickable objects on the scene
+    std::vector<std::unique_ptr<static_meshes_3D::InstanceBuffer>> meshInstanceBuffers_; // Instance buffer for every mesh (same indices as meshes)
+    std::unique_ptr<static_meshes_3D::InstanceBuffer> occluderInstanceBuffer_; // Instances of occlusion boxes in color picking mode
 
     FrameBuffer pickingFrameBuffer_; // Framebuffer used for 3D color picking
     bool pixelPerfectSelectionMode_{ true }; // Are we rendering objects exactly as they are or just their occlusion boxes?
+    bool rayPickingMode_{ false }; // Are we picking objects with rays through the spatial grid instead of color framebuffer?
+    bool instancedRenderingMode_{ false }; // Are objects sharing a mesh rendered with one instanced draw call?
+    SpatialHashGrid objectGrid_{ 20.0f }; // Boxes of pickable objects and crates (crates block the rays, but can't be picked)
     int selectedIndex_{ std::numeric_limits<int>::max() }; // Index of selected object - if greater or equal than number of objects, nothing is selected
 
     shader_structs::Material shinyMaterial_{ 1.0f, 32.0f }; // Shiny material to render objects with
+    RenderQueue renderQueue_; // Render queue sorting pickable objects by their state
 };
 
 } // namespace tutorial028
@@ -18,12 +18,20 @@ void World::initialize()
 {
     plainGround_ = std::make_unique<static_meshes_3D::PlainGround>(true, true, true);
     cube_ = std::make_unique<static_meshes_3D::Cube>();
+
+    crateInstances_ = std::make_unique<static_meshes_3D::InstanceBuffer>();
+    for (const auto& crateBox : getCratesMazeBoxes()) {
+        crateInstances_->addInstance(getCrateModelMatrix(crateBox));
+    }
+
+    crateInstances_->upload();
 }
 
 void World::release()
 {
     plainGround_.reset();
     cube_.reset();
+    crateInstances_.reset();
 }
 
 void World::renderGround(ShaderProgram& shaderProgram) const
@@ -33,10 +41,27 @@ void World::renderGround(ShaderProgram& shaderProgram) const
 }
 
 void World::renderCratesMaze(ShaderProgram& shaderProgram) const
+{
+    for (const auto& crateBox : getCratesMazeBoxes())
+    {
+        shaderProgram.setModelAndNormalMatrix(getCrateModelMatrix(crateBox));
+        cube_->render();
+    }
+}
+
+void World::renderCratesMazeInstanced(ShaderProgram& instancedProgram) const
+{
+    instancedProgram.setModelAndNormalMatrix(glm::mat4(1.0f));
+    cube_->renderInstanced(*crateInstances_);
+}
+
+std::vector<AABB> World::getCratesMazeBoxes() const
 {
     const auto crateSize = 20.0f;
     const auto crateOffset = 2.0f;
 
+    std::vector<AABB> result;
+
     glm::vec3 currentPosition{ -100.0f, crateSize / 2.0f + 0.01f, 100.0f };
     glm::vec3 direction{ 0.0f, 0.0f, -1.0f };
 
@@ -48,15 +73,20 @@ void World::renderCratesMaze(ShaderProgram& shaderProgram) const
                 currentPosition += direction * (crateSize + crateOffset);
             }
 
-            auto modelMatrix = glm::translate(glm::mat4(1.0f), currentPosition);
-            modelMatrix = glm::scale(modelMatrix, glm::vec3(crateSize, crateSize, crateSize));
-            shaderProgram.setModelAndNormalMatrix(modelMatrix);
-            cube_->render();
+            result.push_back(AABB::fromCenterAndExtents(currentPosition, glm::vec3(crateSize / 2.0f)));
         }
 
         direction = glm::rotateY(direction, glm::radians(-90.0f));
         currentPosition += direction * (crateSize + crateOffset);
     }
+
+    return result;
+}
+
+glm::mat4 World::getCrateModelMatrix(const AABB& crateBox)
+{
+    const auto modelMatrix = glm::translate(glm::mat4(1.0f), crateBox.getCenter());
+    return glm::scale(modelMatrix, crateBox.max - crateBox.min);
 }
 
 } // namespace tutorial028
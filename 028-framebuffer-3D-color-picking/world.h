@@ -2,9 +2,12 @@
 
 // STL
 #include <memory>
+#include <vector>
 
 // Project
+#include "../common_classes/boundingVolumes.h"
 #include "../common_classes/shaderProgram.h"
+#include "../common_classes/static_meshes_3D/instanceBuffer.h"
 #include "../common_classes/static_meshes_3D/primitives/cube.h"
 #include "../common_classes/static_meshes_3D/plainGround.h"
 
@@ -40,13 +43,31 @@ public:
      */
     void renderCratesMaze(ShaderProgram& shaderProgram) const;
 
+    /**
+     * Renders crates maze with one instanced draw call (crates never move, so their instances are uploaded only once).
+     *
+     * @param instancedProgram  Instanced variant of shader program to render crates maze with
+     */
+    void renderCratesMazeInstanced(ShaderProgram& instancedProgram) const;
+
+    /**
+     * Gets bounding boxes of all crates of the maze (crates are axis aligned, so they're exact).
+     */
+    std::vector<AABB> getCratesMazeBoxes() const;
+
 private:
+    /**
+     * Gets model matrix of the crate with given bounding box.
+     */
+    static glm::mat4 getCrateModelMatrix(const AABB& crateBox);
+
     World() = default; // Private constructor to make class truly singleton
     World(const World&) = delete; // No copy constructor allowed
     void operator=(const World&) = delete; // No copy assignment allowed
 
     std::unique_ptr<static_meshes_3D::PlainGround> plainGround_; // Plain ground used to render ground
     std::unique_ptr<static_meshes_3D::Cube> cube_; // Cube used to render crates maze
+    std::unique_ptr<static_meshes_3D::InstanceBuffer> crateInstances_; // Instances of all crates of the maze
 };
 
 } // namespace tutorial028
@@ -44,6 +44,7 @@ shader_structs::DiffuseLight diffuseLight(glm::vec3(1.0f, 1.0f, 1.0f), glm::vec3
 #include "../common_classes/frameBuffer.h"
 
 std::unique_ptr<static_meshes_3D::Torus> torus;
+bool useInstancing = false;
 
 void OpenGLWindow029::initializeScene()
 {
@@ -68,6 +69,15 @@ void OpenGLWindow029::initializeScene()
 		mainShaderProgram.addShaderToProgram(sm.getFragmentShader(ShaderKeys::diffuseLight()));
         mainShaderProgram.addShaderToProgram(sm.getFragmentShader(ShaderKeys::specularHighlight()));
 
+        // Instanced variant of main program is compiled on demand, when instanced rendering gets turned on
+        spm.createShaderProgramVariants("main", {
+            { GL_VERTEX_SHADER, "data/shaders/tut021-specular-highlight/shader.vert" },
+            { GL_FRAGMENT_SHADER, "data/shaders/tut021-specular-highlight/shader.frag" },
+            { GL_FRAGMENT_SHADER, "data/shaders/lighting/ambientLight.frag" },
+            { GL_FRAGMENT_SHADER, "data/shaders/lighting/diffuseLight.frag" },
+            { GL_FRAGMENT_SHADER, "data/shaders/lighting/specularHighlight.frag" }
+        });
+
         auto& singleColorShaderProgram = spm.createShaderProgram("single-color");
         singleColorShaderProgram.addShaderToProgram(sm.getVertexShader("single-color"));
         singleColorShaderProgram.addShaderToProgram(sm.getFragmentShader("single-color"));
@@ -104,7 +114,7 @@ void OpenGLWindow029::initializeScene()
 
 void OpenGLWindow029::renderScene()
 {
-    const auto& spm = ShaderProgramManager::getInstance();
+    auto& spm = ShaderProgramManager::getInstance();
 	auto& mm = MatrixManager::getInstance();
     auto& world = World::getInstance();
 
@@ -143,13 +153,28 @@ void OpenGLWindow029::renderScene()
     world.renderGround(mainProgram);
 
     // Render all screens with primitives rendered on them
-    world.renderScreensWithPrimitives(mainProgram);
+    if (useInstancing)
+    {
+        // Screens have textures of their own, so only their frames can be instanced
+        auto& instancedProgram = spm.getShaderProgramVariant("main", ShaderDefines().define("INSTANCED"));
+        instancedProgram.useProgram();
+        instancedProgram[ShaderConstants::color()] = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+        instancedProgram[ShaderConstants::sampler()] = 0;
+        instancedProgram[ShaderConstants::eyePosition()] = flyingCamera.getEye();
+        shader_structs::Material::none().setUniform(instancedProgram, ShaderConstants::material());
+
+        mainProgram.useProgram();
+        world.renderScreensWithPrimitives(mainProgram, &instancedProgram);
+    }
+    else {
+        world.renderScreensWithPrimitives(mainProgram);
+    }
 
     // Reset to our main sampler
     SamplerManager::getInstance().getSampler("main").bind();
 
 	// Render HUD
-    hud->renderHUD(world.getCurrentTextureSize());
+    hud->renderHUD(world.getCurrentTextureSize(), useInstancing);
 }
 
 void OpenGLWindow029::releaseScene()
@@ -165,6 +190,7 @@ void OpenGLWindow029::releaseScene()
 	FreeTypeFontManager::getInstance().clearFreeTypeFontCache();
 
 	hud.reset();
+	static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 void OpenGLWindow029::updateScene()
@@ -195,6 +221,10 @@ void OpenGLWindow029::updateScene()
         world.reshuffleScreenTextures();
     }
 
+    if (keyPressedOnce(GLFW_KEY_I)) {
+        useInstancing = !useInstancing;
+    }
+
     world.updateWorld(sof(1.0f));
 
     if (updateCamera)
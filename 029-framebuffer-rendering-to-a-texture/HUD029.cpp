@@ -21,8 +21,10 @@ HUD029::HUD029(const OpenGLWindow& window)
     });
 }
 
-void HUD029::renderHUD(GLsizei currentTextureSize) const
+void HUD029::renderHUD(GLsizei currentTextureSize, bool useInstancing) const
 {
+    FreeTypeFont::PrintBatch printBatch;
+
     printBuilder().print(10, 10, "FPS: {}", _window.getFPS());
     printBuilder().print(10, 40, "Vertical Synchronization: {} (Press F3 to toggle)", _window.isVerticalSynchronizationEnabled() ? "On" : "Off");
 
@@ -30,6 +32,7 @@ void HUD029::renderHUD(GLsizei currentTextureSize) const
     printBuilder().print(10, 100, "Current texture size: {}x{} (Press '+' and '-' to change)", currentTextureSize, currentTextureSize);
     printBuilder().print(10, 130, "Press 'X' to re-shuffle meshes on screens");
     printBuilder().print(10, 160, "Press 'C' to re-shuffle textures on screens");
+    printBuilder().print(10, 190, "Instanced rendering of screen frames: {} (Press 'I' to toggle)", useInstancing ? "On" : "Off");
 
     printBuilder()
         .fromRight()
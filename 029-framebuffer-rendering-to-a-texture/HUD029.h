@@ -19,7 +19,7 @@ public:
      * Renders HUD.
      */
     void renderHUD() const override {} // Don't need this, but had to override, so that class is not abstract
-    void renderHUD(GLsizei currentTextureSize) const;
+    void renderHUD(GLsizei currentTextureSize, bool useInstancing) const;
 };
 
 } // namespace tutorial029
@@ -1,3 +1,6 @@
+// STL
+#include <algorithm>
+
 // GLM
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/rotate_vector.hpp>
@@ -76,6 +79,7 @@ void World::initialize()
 
     reshuffleScreenMeshes();
     reshuffleScreenTextures();
+    prepareFrameInstances();
 }
 
 void World::release()
@@ -84,6 +88,8 @@ void World::release()
     plainGround_.reset();
     cube_.reset();
     meshes_.clear();
+    frameInstances_.reset();
+    frameInstancesGroups_.clear();
 }
 
 void World::renderGround(ShaderProgram& shaderProgram) const
@@ -93,7 +99,7 @@ void World::renderGround(ShaderProgram& shaderProgram) const
     plainGround_->render();
 }
 
-void World::renderScreensWithPrimitives(ShaderProgram& shaderProgram) const
+void World::renderScreensWithPrimitives(ShaderProgram& shaderProgram, ShaderProgram* instancedFramesProgram)
 {
     const auto& tm = TextureManager::getInstance();
     const auto& mm = MatrixManager::getInstance();
@@ -128,21 +134,88 @@ void World::renderScreensWithPrimitives(ShaderProgram& shaderProgram) const
     FrameBuffer::Default::setFullViewport();
     shaderProgram[ShaderConstants::projectionMatrix()] = mm.getProjectionMatrix();
     shaderProgram[ShaderConstants::viewMatrix()] = mm.getViewMatrix();
-    
+
+    // Frames of all screens share the same texture, so let render queue group them together
+    const auto cube = cube_.get();
+    renderQueue_.begin(mm.getViewMatrix(), 500.0f);
     for (const auto& screen : screens_)
     {
-        auto modelMatrix = glm::translate(glm::mat4(1.0f), screen.position);
-        modelMatrix = glm::scale(modelMatrix, screen.scale);
-        shaderProgram.setModelAndNormalMatrix(modelMatrix);
+        RenderQueue::DrawItem drawItem;
+        drawItem.shaderProgram = &shaderProgram;
+        drawItem.mesh = cube;
+        drawItem.modelMatrix = getScreenModelMatrix(screen);
+
+        // First the frame of the screen (unless frames are instanced)
+        if (instancedFramesProgram == nullptr)
+        {
+            const auto frameFacesBitmask = static_meshes_3D::CUBE_ALLFACES & ~screen.textureFaceBitmask;
+            drawItem.texture = &tm.getTexture("wood");
+            drawItem.renderFunction = [cube, frameFacesBitmask]() { cube->renderFaces(frameFacesBitmask); };
+            renderQueue_.submit(drawItem);
+        }
+
+        // Then the screen itself
+        const auto screenFacesBitmask = screen.textureFaceBitmask;
+        drawItem.texture = screen.frameBuffer->getTexture();
+        drawItem.renderFunction = [cube, screenFacesBitmask]() { cube->renderFaces(screenFacesBitmask); };
+        renderQueue_.submit(drawItem);
+    }
+
+    renderQueue_.replay();
+
+    if (instancedFramesProgram == nullptr) {
+        return;
+    }
+
+    // Every screen has a texture of its own, but frames differ only in the faces rendered, so one draw per group is enough
+    auto& framesProgram = *instancedFramesProgram;
+    framesProgram.useProgram();
+    framesProgram[ShaderConstants::projectionMatrix()] = mm.getProjectionMatrix();
+    framesProgram[ShaderConstants::viewMatrix()] = mm.getViewMatrix();
+    framesProgram.setModelAndNormalMatrix(glm::mat4(1.0f));
+    ambientLight.setUniform(framesProgram, ShaderConstants::ambientLight());
+    shader_structs::DiffuseLight::none().setUniform(framesProgram, ShaderConstants::diffuseLight());
+
+    tm.getTexture("wood").bind(0);
+    for (const auto& group : frameInstancesGroups_) {
+        cube_->renderFacesInstanced(*frameInstances_, group.firstInstance, group.numInstances, group.facesBitmask);
+    }
+}
+
+glm::mat4 World::getScreenModelMatrix(const ScreenWithMesh& screen)
+{
+    const auto modelMatrix = glm::translate(glm::mat4(1.0f), screen.position);
+    return glm::scale(modelMatrix, screen.scale);
+}
+
+void World::prepareFrameInstances()
+{
+    // Sort screens by their frame faces, so that every group occupies a continuous range of instances
+    std::vector<const ScreenWithMesh*> sortedScreens;
+    for (const auto& screen : screens_) {
+        sortedScreens.push_back(&screen);
+    }
+
+    std::stable_sort(sortedScreens.begin(), sortedScreens.end(), [](const ScreenWithMesh* a, const ScreenWithMesh* b) {
+        return a->textureFaceBitmask < b->textureFaceBitmask;
+    });
 
-        // Draw first the frame of the screen
-        tm.getTexture("wood").bind();
-        cube_->renderFaces(static_meshes_3D::CUBE_ALLFACES & ~screen.textureFaceBitmask);
+    frameInstances_ = std::make_unique<static_meshes_3D::InstanceBuffer>();
+    frameInstancesGroups_.clear();
+    for (const auto screen : sortedScreens)
+    {
+        const auto frameFacesBitmask = static_meshes_3D::CUBE_ALLFACES & ~screen->textureFaceBitmask;
+        if (frameInstancesGroups_.empty() || frameInstancesGroups_.back().facesBitmask != frameFacesBitmask)
+        {
+            const auto firstInstance = static_cast<GLuint>(frameInstances_->getNumGatheredInstances());
+            frameInstancesGroups_.push_back({ frameFacesBitmask, firstInstance, 0 });
+        }
 
-        // Then draw the screen itself
-        screen.frameBuffer->getTexture()->bind();
-        cube_->renderFaces(screen.textureFaceBitmask);
+        frameInstances_->addInstance(getScreenModelMatrix(*screen));
+        frameInstancesGroups_.back().numInstances++;
     }
+
+    frameInstances_->upload();
 }
 
 void World::decreaseTextureSize()
@@ -2,9 +2,11 @@
 
 // STL
 #include <memory>
+#include <vector>
 
 // Project
 #include "../common_classes/frameBuffer.h"
+#include "../common_classes/renderQueue.h"
 #include "../common_classes/shaderProgram.h"
 #include "../common_classes/static_meshes_3D/primitives/cube.h"
 #include "../common_classes/static_meshes_3D/plainGround.h"
@@ -36,7 +38,14 @@ public:
      */
     void renderGround(ShaderProgram& shaderProgram) const;
 
-    void renderScreensWithPrimitives(ShaderProgram& shaderProgram) const;
+    /**
+     * Renders meshes into the textures of screens and then the screens with their frames.
+     *
+     * @param shaderProgram           Shader program to render everything with
+     * @param instancedFramesProgram  If not nullptr, frames of all screens are rendered with this instanced
+     *                                shader program (one instanced draw per group of frames with the same faces)
+     */
+    void renderScreensWithPrimitives(ShaderProgram& shaderProgram, ShaderProgram* instancedFramesProgram = nullptr);
 
     void decreaseTextureSize();
     void increaseTextureSize();
@@ -63,6 +72,26 @@ private:
     World(const World&) = delete; // No copy constructor allowed
     void operator=(const World&) = delete; // No copy assignment allowed
 
+    /**
+     * Range of frame instances, that have the same faces rendered.
+     */
+    struct FrameInstancesGroup
+    {
+        int facesBitmask; // Faces of the cube rendered for all frames of the group
+        GLuint firstInstance; // Index of the first instance of the group
+        GLsizei numInstances; // Number of instances of the group
+    };
+
+    /**
+     * Gets model matrix of the cube representing the screen with its frame.
+     */
+    static glm::mat4 getScreenModelMatrix(const ScreenWithMesh& screen);
+
+    /**
+     * Uploads frames of all screens into the instance buffer, grouped by their rendered faces.
+     */
+    void prepareFrameInstances();
+
     std::vector<ScreenWithMesh> screens_;
     GLsizei currentTextureSize_{512};
     float meshesRotationAngle_{ 0.0f };
@@ -70,6 +99,9 @@ private:
     std::unique_ptr<static_meshes_3D::PlainGround> plainGround_; // Plain ground used to render ground
     std::shared_ptr<static_meshes_3D::Cube> cube_; // Cube used to render picture frames
     std::vector<std::shared_ptr<static_meshes_3D::StaticMesh3D>> meshes_; // Meshes rendered on the screens
+    RenderQueue renderQueue_; // Render queue used to render screens grouped by texture
+    std::unique_ptr<static_meshes_3D::InstanceBuffer> frameInstances_; // Instances of screen frames (screens don't move, so they're uploaded once)
+    std::vector<FrameInstancesGroup> frameInstancesGroups_; // Groups of frame instances with the same rendered faces
 };
 
 } // namespace tutorial029
@@ -11,6 +11,7 @@
 #include "030-animation-pt1-keyframe-md2.h"
 #include "HUD030.h"
 #include "modelCollection.h"
+#include "jobSystemBenchmark.h"
 
 #include "../common_classes/flyingCamera.h"
 
@@ -40,6 +41,7 @@ shader_structs::AmbientLight ambientLight(glm::vec3(0.5f, 0.5f, 0.5f));
 shader_structs::DiffuseLight diffuseLight(glm::vec3(1.0f, 1.0f, 1.0f), glm::vec3(0.0f, -sqrtf(2.0f) / 2.0f, -sqrtf(2.0f) / 2.0f), 0.5f);
 
 std::unique_ptr<static_meshes_3D::PlainGround> plainGround; // Plain ground used to render ground
+JobSystemBenchmark jobSystemBenchmark; // Benchmark measuring scaling of animation updates with job system threads
 
 void OpenGLWindow030::initializeScene()
 {
@@ -166,6 +168,7 @@ void OpenGLWindow030::releaseScene()
 	FreeTypeFontManager::getInstance().clearFreeTypeFontCache();
 
 	hud.reset();
+	static_meshes_3D::GeometryArena::getInstance().clearArena();
 }
 
 void OpenGLWindow030::updateScene()
@@ -201,9 +204,16 @@ void OpenGLWindow030::updateScene()
        ModelCollection::getInstance().previousModel();
     }
 
-    world.updateAnimations(deltaTime);
+    if (keyPressedOnce(GLFW_KEY_J)) {
+        jobSystemBenchmark.run(world.startCurrentAnimation());
+    }
+
+    // Models are independent, so their animations are updated in parallel with the camera update below
+    submitParallelUpdate(world.getNumModels(), 1, [&world, deltaTime](const size_t firstModel, const size_t lastModel) {
+        world.updateAnimations(deltaTime, firstModel, lastModel);
+    });
 
-    // Update camera
+    // Update camera (it calls GLFW, so it must stay on the main thread)
     int width, height;
     glfwGetWindowSize(getWindow(), &width, &height);
     flyingCamera.setWindowCenterPosition(glm::i32vec2(width / 2, height / 2));
@@ -23,6 +23,8 @@ HUD030::HUD030(const OpenGLWindow& window)
 
 void HUD030::renderHUD() const
 {
+    FreeTypeFont::PrintBatch printBatch;
+
     const auto& modelCollection = ModelCollection::getInstance();
     printBuilder().print(10, 10, "FPS: {}", _window.getFPS());
     printBuilder().print(10, 40, "Vertical Synchronization: {} (Press F3 to toggle)", _window.isVerticalSynchronizationEnabled() ? "On" : "Off");
@@ -32,6 +34,12 @@ void HUD030::renderHUD() const
     printBuilder().print(10, 130, "Selected animation: {} ({} / {}) ", modelCollection.getCurrentAnimationName(), modelCollection.getCurrentAnimationIndex() + 1, modelCollection.getNumModelAnimations());
     printBuilder().print(10, 160, "Loop animation: {} (Press 'Q' to toggle)", modelCollection.isAnimationLooping() ? "Yes" : "No");
 
+    // Print information about the job system
+    printBuilder().print(10, 220, "Job system threads: {} (Press 'J' to run scaling benchmark, results are printed to console)", JobSystem::getInstance().getNumThreads());
+
+    // Print where the GPU memory goes
+    renderGPUResourcesPanel(10, 10);
+
     printBuilder()
         .fromRight()
         .fromBottom()
@@ -0,0 +1,85 @@
+// STL
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <thread>
+
+// Project
+#include "jobSystemBenchmark.h"
+#include "../common_classes/jobSystem.h"
+
+namespace opengl4_mbsoftworks {
+namespace tutorial030 {
+
+const size_t JobSystemBenchmark::NUM_ANIMATION_STATES = 100000;
+const int JobSystemBenchmark::NUM_UPDATES = 100;
+const int JobSystemBenchmark::NUM_RUNS = 3;
+
+void JobSystemBenchmark::run(const MD2Model::AnimationState& animationState)
+{
+    const auto maxThreads = static_cast<size_t>(std::max(std::thread::hardware_concurrency(), 1u));
+    std::cout << "Starting job system benchmark with up to " << maxThreads << " threads, this will take a while..." << std::endl;
+
+    runTimes_.clear();
+    for (size_t numThreads = 1; numThreads <= maxThreads; numThreads++) {
+        runTimes_.push_back(measureThreadCount(numThreads, animationState));
+    }
+
+    animationStates_.clear();
+    animationStates_.shrink_to_fit();
+    printResults();
+}
+
+double JobSystemBenchmark::measureThreadCount(const size_t numThreads, const MD2Model::AnimationState& animationState)
+{
+    // Calling thread executes jobs as well, so it's one worker less
+    JobSystem jobSystem(numThreads - 1);
+    const auto deltaTime = 1.0f / 60.0f;
+
+    auto bestTime = 0.0;
+    for (auto run = 0; run < NUM_RUNS; run++)
+    {
+        animationStates_.assign(NUM_ANIMATION_STATES, animationState);
+
+        const auto startTime = std::chrono::high_resolution_clock::now();
+        for (auto update = 0; update < NUM_UPDATES; update++)
+        {
+            jobSystem.parallelFor(0, animationStates_.size(), 0, [this, deltaTime](const size_t firstState, const size_t lastState)
+            {
+                for (auto i = firstState; i < lastState; i++) {
+                    animationStates_[i].updateAnimation(deltaTime);
+                }
+            });
+        }
+
+        const auto runTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - startTime).count();
+        if (run == 0 || runTime < bestTime) {
+            bestTime = runTime;
+        }
+    }
+
+    return bestTime;
+}
+
+void JobSystemBenchmark::printResults() const
+{
+    const auto previousFlags = std::cout.flags();
+    const auto previousPrecision = std::cout.precision();
+    std::cout << "Job system benchmark results (" << NUM_UPDATES << " updates of " << NUM_ANIMATION_STATES << " animation states, fastest of " << NUM_RUNS << " runs):" << std::endl;
+    std::cout << std::setw(8) << "Threads" << std::setw(12) << "Time (ms)" << std::setw(12) << "Speedup" << std::setw(12) << "Efficiency" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    for (size_t i = 0; i < runTimes_.size(); i++)
+    {
+        const auto numThreads = i + 1;
+        const auto speedup = runTimes_[i] > 0.0 ? runTimes_[0] / runTimes_[i] : 0.0;
+        std::cout << std::setw(8) << numThreads << std::setw(12) << runTimes_[i] << std::setw(11) << speedup << "x"
+            << std::setw(11) << speedup * 100.0 / numThreads << "%" << std::endl;
+    }
+
+    std::cout.flags(previousFlags);
+    std::cout.precision(previousPrecision);
+}
+
+} // namespace tutorial030
+} // namespace opengl4_mbsoftworks
@@ -0,0 +1,51 @@
+#pragma once
+
+// STL
+#include <vector>
+
+// Project
+#include "../common_classes/animated_meshes_3D/md2model.h"
+
+namespace opengl4_mbsoftworks {
+namespace tutorial030 {
+
+using namespace common_classes::animated_meshes_3D;
+
+/**
+ * Benchmark, that measures how animation updates scale with the number of threads of the job system.
+ * For every thread count from 1 up to the number of hardware threads, it updates many copies of one animation
+ * state in parallel. Benchmark runs synchronously and results are printed to standard output.
+ */
+class JobSystemBenchmark
+{
+public:
+    static const size_t NUM_ANIMATION_STATES; // Number of animation states updated in one update
+    static const int NUM_UPDATES; // Number of updates of all animation states in one measured run
+    static const int NUM_RUNS; // Number of runs for every thread count (the fastest one is taken)
+
+    /**
+     * Runs the benchmark and prints the results.
+     *
+     * @param animationState  Running animation state, that gets copied and updated
+     */
+    void run(const MD2Model::AnimationState& animationState);
+
+private:
+    /**
+     * Measures the fastest run of updates using given number of threads.
+     *
+     * @return Time of the fastest run in milliseconds.
+     */
+    double measureThreadCount(size_t numThreads, const MD2Model::AnimationState& animationState);
+
+    /**
+     * Prints results of the benchmark as a table to standard output.
+     */
+    void printResults() const;
+
+    std::vector<MD2Model::AnimationState> animationStates_; // Animation states updated by the benchmark
+    std::vector<double> runTimes_; // Fastest run times (ms), indexed with threads count - 1
+};
+
+} // namespace tutorial030
+} // namespace opengl4_mbsoftworks
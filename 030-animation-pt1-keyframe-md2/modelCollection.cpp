@@ -79,10 +79,27 @@ size_t ModelCollection::getNumModelAnimations() const
     return displayedModels_.at(selectedModelIndex_).md2Model->getAnimationNames().size();
 }
 
+size_t ModelCollection::getNumModels() const
+{
+    return displayedModels_.size();
+}
+
+MD2Model::AnimationState ModelCollection::startCurrentAnimation() const
+{
+    const auto& displayedModel = displayedModels_.at(selectedModelIndex_);
+    return displayedModel.md2Model->startAnimation(displayedModel.md2Model->getAnimationNames().at(displayedModel.currentAnimationIndex), true);
+}
+
 void ModelCollection::updateAnimations(float deltaTime)
 {
-    for (auto& displayedModel : displayedModels_)
+    updateAnimations(deltaTime, 0, displayedModels_.size());
+}
+
+void ModelCollection::updateAnimations(const float deltaTime, const size_t firstModel, const size_t lastModel)
+{
+    for (auto i = firstModel; i < lastModel; i++)
     {
+        auto& displayedModel = displayedModels_[i];
         if (!displayedModel.animationState.isRunning())
         {
             displayedModel.startCurrentAnimation();
@@ -35,8 +35,19 @@ public:
     const std::string& getCurrentAnimationName() const;
     size_t getCurrentAnimationIndex() const;
     size_t getNumModelAnimations() const;
+    size_t getNumModels() const;
+
+    /**
+     * Starts current animation of the selected model and returns its state (without affecting the displayed model).
+     */
+    MD2Model::AnimationState startCurrentAnimation() const;
 
     void updateAnimations(float deltaTime);
+
+    /**
+     * Updates animations of models [firstModel, lastModel) only. Different ranges can be updated on different threads.
+     */
+    void updateAnimations(float deltaTime, size_t firstModel, size_t lastModel);
     void nextAnimation();
     void previousAnimation();
     void toggleAnimationLooping();
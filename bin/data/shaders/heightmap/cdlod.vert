@@ -0,0 +1,63 @@
+#version 440 core
+
+uniform struct
+{
+    mat4 projectionMatrix;
+    mat4 viewMatrix;
+    mat4 modelMatrix;
+    mat3 normalMatrix;
+} matrices;
+
+uniform sampler2D heightSampler; // Height values, one texel per heightmap vertex
+uniform vec2 nodeOffset; // Column and row of the first heightmap vertex of the node
+uniform float nodeScale; // Number of heightmap quads per one grid quad
+uniform vec2 morphRange; // Distances, where morphing into the coarser grid starts and ends
+uniform vec3 cameraPosition; // Camera position in world space
+uniform vec2 heightmapOrigin; // Column and row of the first vertex within the bigger heightmap (for texture coordinates of tiles)
+
+layout(location = 0) in vec2 gridPosition;
+
+smooth out vec2 ioVertexTexCoord;
+smooth out vec3 ioVertexNormal;
+smooth out float ioHeight;
+
+float getHeight(vec2 heightmapPosition)
+{
+    vec2 heightmapSize = vec2(textureSize(heightSampler, 0));
+    return textureLod(heightSampler, (heightmapPosition + 0.5) / heightmapSize, 0.0).r;
+}
+
+vec3 getPosition(vec2 heightmapPosition)
+{
+    vec2 heightmapSize = vec2(textureSize(heightSampler, 0));
+    vec2 positionXZ = -0.5 + heightmapPosition / (heightmapSize - 1.0);
+    return vec3(positionXZ.x, getHeight(heightmapPosition), positionXZ.y);
+}
+
+void main()
+{
+    // Morph factor depends on distance of the unmorphed vertex from the camera
+    vec2 heightmapSize = vec2(textureSize(heightSampler, 0));
+    vec2 heightmapPosition = min(nodeOffset + gridPosition * nodeScale, heightmapSize - 1.0);
+    vec3 worldPosition = (matrices.modelMatrix * vec4(getPosition(heightmapPosition), 1.0)).xyz;
+    float morphFactor = clamp((distance(worldPosition, cameraPosition) - morphRange.x) / (morphRange.y - morphRange.x), 0.0, 1.0);
+
+    // Odd vertices of the grid slide towards the even ones, fully morphed grid is the same as the grid of the parent node
+    vec2 oddFraction = fract(gridPosition * 0.5) * 2.0;
+    heightmapPosition = min(nodeOffset + (gridPosition - oddFraction * morphFactor) * nodeScale, heightmapSize - 1.0);
+    vec3 position = getPosition(heightmapPosition);
+
+    // Normal is calculated from the height differences of neighbouring heightmap vertices
+    float heightLeft = getHeight(heightmapPosition - vec2(1.0, 0.0));
+    float heightRight = getHeight(heightmapPosition + vec2(1.0, 0.0));
+    float heightUp = getHeight(heightmapPosition - vec2(0.0, 1.0));
+    float heightDown = getHeight(heightmapPosition + vec2(0.0, 1.0));
+    vec3 normal = vec3((heightLeft - heightRight) * (heightmapSize.x - 1.0) * 0.5, 1.0, (heightUp - heightDown) * (heightmapSize.y - 1.0) * 0.5);
+
+    mat4 mvpMatrix = matrices.projectionMatrix * matrices.viewMatrix * matrices.modelMatrix;
+    gl_Position = mvpMatrix * vec4(position, 1.0);
+
+    ioVertexTexCoord = (heightmapOrigin + heightmapPosition) * 0.1;
+    ioVertexNormal = matrices.normalMatrix * normalize(normal);
+    ioHeight = position.y;
+}
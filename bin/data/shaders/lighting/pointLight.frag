@@ -22,9 +22,12 @@ vec3 getPointLightColor(const PointLight pointLight, const vec3 worldPosition, c
 
 vec3 getPointLightColor(const PointLight pointLight, const vec3 worldPosition, const vec3 normal)
 {
+#ifndef NUM_POINT_LIGHTS
+	// Variants compiled for exact number of point lights get only lights that are on
 	if(!pointLight.isOn) {
 		return vec3(0.0);
 	}
+#endif
 	
 	vec3 positionToLightVector = worldPosition - pointLight.position;
 	float distance = length(positionToLightVector);
@@ -2,9 +2,17 @@
 
 layout(location = 0) out vec4 outputColor;
 
+#ifdef INSTANCED
+flat in vec4 ioInstanceColor;
+#endif
+
 uniform vec4 color;
 
 void main()
 {
+#ifdef INSTANCED
+    outputColor = color * ioInstanceColor;
+#else
     outputColor = color;
+#endif
 }
\ No newline at end of file
@@ -9,8 +9,22 @@ uniform struct
 
 layout(location = 0) in vec3 vertexPosition;
 
+#ifdef INSTANCED
+// Per-instance model matrix and color (see static_meshes_3D::InstanceBuffer), uniform model matrix is applied before the instance one
+layout(location = 3) in mat4 instanceModelMatrix;
+layout(location = 10) in vec4 instanceColor;
+
+flat out vec4 ioInstanceColor;
+#endif
+
 void main()
 {
-    mat4 mvpMatrix = matrices.projectionMatrix * matrices.viewMatrix * matrices.modelMatrix;
+#ifdef INSTANCED
+    mat4 modelMatrix = instanceModelMatrix * matrices.modelMatrix;
+    ioInstanceColor = instanceColor;
+#else
+    mat4 modelMatrix = matrices.modelMatrix;
+#endif
+    mat4 mvpMatrix = matrices.projectionMatrix * matrices.viewMatrix * modelMatrix;
     gl_Position = mvpMatrix * vec4(vertexPosition, 1.0);
 }
\ No newline at end of file
@@ -10,6 +10,9 @@ smooth in vec2 ioVertexTexCoord;
 smooth in vec3 ioVertexNormal;
 smooth in vec4 ioWorldPosition;
 smooth in vec4 ioEyeSpacePosition;
+#ifdef INSTANCED
+flat in vec4 ioInstanceColor;
+#endif
 
 uniform sampler2D sampler;
 uniform vec4 color;
@@ -24,6 +27,9 @@ void main()
     vec3 normal = normalize(ioVertexNormal);
     vec4 textureColor = texture(sampler, ioVertexTexCoord);
     vec4 objectColor = textureColor*color;
+#ifdef INSTANCED
+    objectColor *= ioInstanceColor;
+#endif
     vec3 ambientColor = getAmbientLightColor(ambientLight);
     vec3 diffuseColor = getDiffuseLightColor(diffuseLight, normal);
     vec3 specularHighlightColor = getSpecularHighlightColor(ioWorldPosition.xyz, normal, eyePosition, material, diffuseLight);
@@ -12,6 +12,15 @@ layout(location = 0) in vec3 vertexPosition;
 layout(location = 1) in vec2 vertexTexCoord;
 layout(location = 2) in vec3 vertexNormal;
 
+#ifdef INSTANCED
+// Per-instance attributes (see static_meshes_3D::InstanceBuffer), uniform model matrix is applied before them
+layout(location = 3) in mat4 instanceModelMatrix;
+layout(location = 7) in mat3 instanceNormalMatrix;
+layout(location = 10) in vec4 instanceColor;
+
+flat out vec4 ioInstanceColor;
+#endif
+
 smooth out vec2 ioVertexTexCoord;
 smooth out vec3 ioVertexNormal;
 smooth out vec4 ioWorldPosition;
@@ -19,13 +28,21 @@ smooth out vec4 ioEyeSpacePosition;
 
 void main()
 {
-    mat4 mvMatrix = matrices.viewMatrix * matrices.modelMatrix;
+#ifdef INSTANCED
+    mat4 modelMatrix = instanceModelMatrix * matrices.modelMatrix;
+    mat3 normalMatrix = instanceNormalMatrix * matrices.normalMatrix;
+    ioInstanceColor = instanceColor;
+#else
+    mat4 modelMatrix = matrices.modelMatrix;
+    mat3 normalMatrix = matrices.normalMatrix;
+#endif
+    mat4 mvMatrix = matrices.viewMatrix * modelMatrix;
     mat4 mvpMatrix = matrices.projectionMatrix * mvMatrix;
     gl_Position = mvpMatrix * vec4(vertexPosition, 1.0);
     
     // Output all out variables
     ioVertexTexCoord = vertexTexCoord;
-    ioVertexNormal = matrices.normalMatrix * vertexNormal;
-    ioWorldPosition = matrices.modelMatrix * vec4(vertexPosition, 1.0);
+    ioVertexNormal = normalMatrix * vertexNormal;
+    ioWorldPosition = modelMatrix * vec4(vertexPosition, 1.0);
     ioEyeSpacePosition = mvMatrix * vec4(vertexPosition, 1.0);
 }
\ No newline at end of file
@@ -11,6 +11,9 @@ smooth in vec2 ioVertexTexCoord;
 smooth in vec3 ioVertexNormal;
 smooth in vec4 ioWorldPosition;
 smooth in vec4 ioEyeSpacePosition;
+#ifdef INSTANCED
+flat in vec4 ioInstanceColor;
+#endif
 
 uniform sampler2D sampler;
 uniform vec4 color;
@@ -31,13 +34,23 @@ void main()
     vec3 normal = normalize(ioVertexNormal);
     vec4 textureColor = texture(sampler, ioVertexTexCoord);
     vec4 objectColor = textureColor*color;
+#ifdef INSTANCED
+    objectColor *= ioInstanceColor;
+#endif
     vec3 ambientColor = getAmbientLightColor(ambientLight);
     vec3 diffuseColor = getDiffuseLightColor(diffuseLight, normal);
 	vec3 specularHighlightColor = getSpecularHighlightColor(ioWorldPosition.xyz, normal, eyePosition, material, diffuseLight);
 	vec3 lightColor = ambientColor + diffuseColor + specularHighlightColor;
+#ifdef NUM_POINT_LIGHTS
+	// Shader variant with number of point lights known at compile time
+	for(int i = 0; i < NUM_POINT_LIGHTS; i++) {
+		lightColor += getPointLightColor(block_pointLights.lights[i], ioWorldPosition.xyz, normal);
+	}
+#else
 	for(int i = 0; i < numPointLights; i++) {
 		lightColor += getPointLightColor(block_pointLights.lights[i], ioWorldPosition.xyz, normal);
 	}
+#endif
     
     outputColor = objectColor * vec4(lightColor, 1.0);
 }
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include "shaderManager.h"
 #include "shaderProgramManager.h"
 #include "samplerManager.h"
+#include "gpuResourceRegistry.h"
 
 const std::string HUD::DEFAULT_FONT_KEY = "default";
 const std::string HUD::ORTHO_2D_PROGRAM_KEY = "ortho_2D";
@@ -76,3 +77,34 @@ const Sampler& HUD::getHUDSampler() const
 {
     return SamplerManager::getInstance().getSampler(HUD_SAMPLER_KEY);
 }
+
+void HUD::renderGPUResourcesPanel(int x, int y) const
+{
+    const auto& registry = GPUResourceRegistry::getInstance();
+    const auto lineHeight = 25;
+
+    printBuilder().fromRight().withPixelSize(18).print(x, y, "GPU resources: {} objects, {} KiB",
+        registry.getTotalLiveCount(), registry.getTotalBytes() / 1024);
+    y += lineHeight;
+
+    for (auto i = 0; i < static_cast<int>(GPUResourceType::Count); i++)
+    {
+        const auto type = static_cast<GPUResourceType>(i);
+        const auto statistics = registry.getStatistics(type);
+        if (statistics.liveCount == 0) {
+            continue;
+        }
+
+        printBuilder().fromRight().withPixelSize(18).print(x, y, "{}: {} x, {} KiB",
+            GPUResourceRegistry::getResourceTypeName(type), statistics.liveCount, statistics.totalBytes / 1024);
+        y += lineHeight;
+    }
+
+    for (const auto& tagStatisticsPair : registry.getStatisticsPerTag())
+    {
+        const auto& statistics = tagStatisticsPair.second;
+        printBuilder().fromRight().withPixelSize(18).withColor(glm::vec4(0.7f, 0.85f, 1.0f, 1.0f)).print(x, y, "[{}]: {} x, {} KiB",
+            tagStatisticsPair.first, statistics.liveCount, statistics.totalBytes / 1024);
+        y += lineHeight;
+    }
+}
@@ -56,6 +56,15 @@ protected:
      */
     void renderTexturedQuad2D(int x, int y, int renderedWidth, int renderedHeight, bool fromRight = false, bool fromTop = false) const;
 
+    /**
+     * Renders panel with statistics of live GPU resources (per resource type and per owning tag),
+     * as they are tracked by GPU resource registry. Panel is rendered from the right top corner.
+     *
+     * @param x  Rendering position from right edge
+     * @param y  Rendering position from top edge
+     */
+    void renderGPUResourcesPanel(int x, int y) const;
+
     class PrintBuilder
     {
     public:
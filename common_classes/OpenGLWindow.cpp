@@ -1,8 +1,15 @@
+// STL
+#include <iostream>
+#include <algorithm>
+
 // GLM
 #include <glm/gtc/matrix_transform.hpp>
 
 // Project
 #include "OpenGLWindow.h"
+#include "gpuResourceRegistry.h"
+#include "programBinaryCache.h"
+#include "glStateCache.h"
 
 std::map<GLFWwindow*, OpenGLWindow*> OpenGLWindow::_windows;
 
@@ -79,7 +86,12 @@ void OpenGLWindow::runApp()
 {
     setVerticalSynchronization(true);
     recalculateProjectionMatrix();
+
+    // Measure how long the initialization takes, shader programs are usually the biggest part of it
+    const auto initializationStartTime = glfwGetTime();
     initializeScene();
+    std::cout << "Scene initialized in " << glfwGetTime() - initializationStartTime << " seconds" << std::endl;
+    ProgramBinaryCache::getInstance().printStatistics();
     
     // Update time at the beginning, so that calculations are correct
     _lastFrameTime = _lastFrameTimeFPS = glfwGetTime();
@@ -87,6 +99,10 @@ void OpenGLWindow::runApp()
     while (glfwWindowShouldClose(_window) == 0)
     {
         updateDeltaTimeAndFPS();
+        GLStateCache::getInstance().beginFrame();
+
+        // Scene can't be rendered, while it's being updated
+        waitForUpdateJobs();
         renderScene();
 
         glfwSwapBuffers(_window);
@@ -94,8 +110,12 @@ void OpenGLWindow::runApp()
         updateScene();
     }
 
+    waitForUpdateJobs();
     releaseScene();
 
+    // Everything should have been released by now, so report all GPU resources that are still alive
+    GPUResourceRegistry::getInstance().dumpLeaks();
+
     glfwDestroyWindow(_window);
     _windows.erase(_windows.find(_window));
     
@@ -105,6 +125,21 @@ void OpenGLWindow::runApp()
     }
 }
 
+void OpenGLWindow::submitUpdateJob(std::function<void()> job)
+{
+    JobSystem::getInstance().submit(std::move(job), &updateJobsCounter_);
+}
+
+void OpenGLWindow::submitParallelUpdate(const size_t numItems, const size_t itemsPerJob, const std::function<void(size_t, size_t)>& rangeJob)
+{
+    JobSystem::getInstance().parallelFor(0, numItems, itemsPerJob, rangeJob, updateJobsCounter_);
+}
+
+void OpenGLWindow::waitForUpdateJobs()
+{
+    JobSystem::getInstance().wait(updateJobsCounter_);
+}
+
 GLFWwindow* OpenGLWindow::getWindow() const
 {
     return _window;
@@ -179,6 +214,36 @@ glm::ivec2 OpenGLWindow::getOpenGLCursorPosition() const
     return glm::ivec2(static_cast<int>(posX), screenHeight_ - static_cast<int>(posY));
 }
 
+void OpenGLWindow::renderLoadingProgress(const float progress) const
+{
+    const auto barWidth = screenWidth_ / 2;
+    const auto barHeight = std::max(screenHeight_ / 40, 4);
+    const auto barX = (screenWidth_ - barWidth) / 2;
+    const auto barY = (screenHeight_ - barHeight) / 2;
+    const auto progressWidth = static_cast<int>(static_cast<float>(barWidth) * glm::clamp(progress, 0.0f, 1.0f));
+
+    // Remember clear color of the scene, so that it can be restored afterwards
+    GLfloat sceneClearColor[4];
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, sceneClearColor);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // Draw background of the bar and then the progress over it
+    auto& stateCache = GLStateCache::getInstance();
+    stateCache.enable(GL_SCISSOR_TEST);
+    glScissor(barX, barY, barWidth, barHeight);
+    glClearColor(0.25f, 0.25f, 0.25f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    if (progressWidth > 0)
+    {
+        glScissor(barX, barY, progressWidth, barHeight);
+        glClearColor(0.0f, 0.75f, 0.25f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+    stateCache.disable(GL_SCISSOR_TEST);
+    glClearColor(sceneClearColor[0], sceneClearColor[1], sceneClearColor[2], sceneClearColor[3]);
+}
+
 OpenGLWindow* OpenGLWindow::getDefaultWindow()
 {
     return _windows.size() == 0 ? nullptr : (*_windows.begin()).second;
@@ -1,6 +1,7 @@
 #pragma once
 
 // STL
+#include <functional>
 #include <string>
 #include <map>
 
@@ -13,6 +14,9 @@
 // GLM
 #include <glm/glm.hpp>
 
+// Project
+#include "jobSystem.h"
+
 /**
  * Provides easy and convenient way to handle OpenGL Window creation and basic scene management (init, render and release).
  */
@@ -208,6 +212,37 @@ protected:
      */
     virtual void onMouseWheelScroll(double scrollOffsetX, double scrollOffsetY) {}
 
+    /**
+     * Renders simple loading progress bar in the middle of the screen. It uses scissor test and clearing only,
+     * so it can be rendered before any shader program is ready (e.g. while shaders are compiled in the background).
+     *
+     * @param progress  Progress to show (0.0 to 1.0)
+     */
+    void renderLoadingProgress(float progress) const;
+
+    /**
+     * Submits job updating the scene to the shared job system. Update jobs run in parallel with the rest
+     * of updateScene and all of them are finished before the scene is rendered again.
+     *
+     * @param job  Job to submit (must not call OpenGL)
+     */
+    void submitUpdateJob(std::function<void()> job);
+
+    /**
+     * Submits update of items [0, numItems) split into multiple jobs, that run in parallel.
+     *
+     * @param numItems     Number of items to update
+     * @param itemsPerJob  Number of items updated by one job (0 lets the job system decide)
+     * @param rangeJob     Function updating items [firstItem, lastItem) (must not call OpenGL)
+     */
+    void submitParallelUpdate(size_t numItems, size_t itemsPerJob, const std::function<void(size_t, size_t)>& rangeJob);
+
+    /**
+     * Waits until all submitted update jobs have finished. It's called automatically before rendering
+     * and releasing the scene, but it can be called earlier, if the updated data are needed.
+     */
+    void waitForUpdateJobs();
+
 private:
     GLFWwindow* _window = nullptr; // Pointer to GLFWwindow, nullptr by default
     bool _keyWasPressed[512]; // Array of bools, used by keyPressedOnce function
@@ -231,6 +266,8 @@ private:
     int screenWidth_{ 0 }; // Cached screen width
     int screenHeight_{ 0 }; // Cached screen height
 
+    JobCounter updateJobsCounter_; // Counts unfinished update jobs
+
     /**
      * Updates frame times and FPS counters.
      */
@@ -1,10 +1,14 @@
 // STL
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <fstream>
 
 // Project
 #include "md2model.h"
 #include "../../common_classes/shaderProgramManager.h"
+#include "../../common_classes/gpuResourceRegistry.h"
+#include "../../common_classes/glStateCache.h"
 
 namespace opengl4_mbsoftworks {
 namespace common_classes {
@@ -214,6 +218,7 @@ MD2Model::~MD2Model()
 
 void MD2Model::loadModel(const std::string& filePath, const glm::mat4& modelTransformMatrix)
 {
+    GPUResourceRegistry::ScopedTag registryTag("md2");
     std::ifstream in(filePath, std::ios::binary);
     if(!in.is_open())
     {
@@ -249,6 +254,24 @@ void MD2Model::loadModel(const std::string& filePath, const glm::mat4& modelTran
         }
     }
 
+    // Bounding volumes are union over all frames, so that they don't have to be recalculated while animating
+    boundingBox_ = AABB();
+    for (const auto& frameVertices : perFrameVertices) {
+        boundingBox_.extend(AABB::fromPoints(frameVertices.data(), frameVertices.size()));
+    }
+
+    auto maxDistanceSquared = 0.0f;
+    boundingSphere_.center = boundingBox_.getCenter();
+    for (const auto& frameVertices : perFrameVertices)
+    {
+        for (const auto& vertex : frameVertices)
+        {
+            const auto offset = vertex - boundingSphere_.center;
+            maxDistanceSquared = std::max(maxDistanceSquared, glm::dot(offset, offset));
+        }
+    }
+    boundingSphere_.radius = std::sqrt(maxDistanceSquared);
+
     // Now try to determine all different animations in the file based on frame names
     Animation* activeAnimation = nullptr;
     for(size_t frameIndex = 0; frameIndex < static_cast<size_t>(header_.numFrames); frameIndex++)
@@ -290,9 +313,6 @@ void MD2Model::loadModel(const std::string& filePath, const glm::mat4& modelTran
         // Store render mode and all of the associated drawing commands here
         RenderCommandOpenGL glCommandRender;
         glCommandRender.renderMode = renderMode;
-
-        renderModes.push_back(renderMode); // Remember the values
-        numRenderVertices.push_back(numVertices);
         for(auto j = 0; j < numVertices; j++)
         {
             const auto u = *reinterpret_cast<float*>(&rawGlCommands[i++]); // Extract texture coordinates
@@ -306,6 +326,40 @@ void MD2Model::loadModel(const std::string& filePath, const glm::mat4& modelTran
         renderCommands.push_back(glCommandRender);
     }
 
+    // Convert all triangle strips and fans to one indexed triangle list, so that whole frame is rendered with a single draw call
+    // instead of one draw call per command (there are usually hundreds of them). Indices point to vertices of a frame as they are stored below
+    vboIndices_.createVBO();
+    GLuint commandFirstVertex = 0;
+    numRenderIndices_ = 0;
+    for(const auto& glCommand : renderCommands)
+    {
+        const auto numCommandVertices = static_cast<GLuint>(glCommand.vertexIndex.size());
+        for(GLuint j = 2; j < numCommandVertices; j++)
+        {
+            if(glCommand.renderMode == GL_TRIANGLE_FAN)
+            {
+                vboIndices_.addData(commandFirstVertex);
+                vboIndices_.addData(commandFirstVertex + j - 1);
+            }
+            else if(j % 2 == 0)
+            {
+                vboIndices_.addData(commandFirstVertex + j - 2);
+                vboIndices_.addData(commandFirstVertex + j - 1);
+            }
+            else
+            {
+                // Every odd triangle of a strip has reversed winding, so swap first two vertices to keep it consistent
+                vboIndices_.addData(commandFirstVertex + j - 1);
+                vboIndices_.addData(commandFirstVertex + j - 2);
+            }
+
+            vboIndices_.addData(commandFirstVertex + j);
+            numRenderIndices_ += 3;
+        }
+
+        commandFirstVertex += numCommandVertices;
+    }
+
     // Now that we have all the information (per-frame vertices, texture coordinates and per-frame normals), we can construct the VBOs
     vboFrameVertices_.createVBO();
     vboTextureCoordinates_.createVBO();
@@ -324,8 +378,14 @@ void MD2Model::loadModel(const std::string& filePath, const glm::mat4& modelTran
         }
     }
 
-    // Now all necessary data are extracted, let's create VAO for rendering MD2 model. Don't set it up though, it is always setup dynamically
+    // Now all necessary data are extracted, let's create VAO for rendering MD2 model. Don't set up vertex attributes though, they are always setup dynamically
+    // Only index buffer is bound to it right away, because it's same for every frame
     glGenVertexArrays(1, &vao_);
+    GLStateCache::getInstance().bindVertexArray(vao_);
+    vboIndices_.bindVBO(GL_ELEMENT_ARRAY_BUFFER);
+    vboIndices_.uploadDataToGPU(GL_STATIC_DRAW);
+    GLStateCache::getInstance().bindVertexArray(0);
+
     vboFrameVertices_.bindVBO();
     vboFrameVertices_.uploadDataToGPU(GL_STATIC_DRAW);
     vboTextureCoordinates_.bindVBO();
@@ -360,6 +420,16 @@ void MD2Model::loadModel(const std::string& filePath, const glm::mat4& modelTran
     in.close();
 }
 
+const AABB& MD2Model::getBoundingBox() const
+{
+    return boundingBox_;
+}
+
+const BoundingSphere& MD2Model::getBoundingSphere() const
+{
+    return boundingSphere_;
+}
+
 bool MD2Model::isLoaded() const
 {
     return vao_ != 0;
@@ -406,12 +476,7 @@ void MD2Model::renderModelAnimated(const AnimationState& animationState)
     setupVAO(animationState.currentFrameIndex, animationState.nextFrameIndex);
 
     shaderProgram[ShaderConstants::interpolationFactor()] = animationState.interpolationFactor;
-    GLint totalOffset = 0;
-    for (size_t i = 0; i < renderModes.size(); i++)
-    {
-        glDrawArrays(renderModes[i], totalOffset, numRenderVertices[i]);
-        totalOffset += numRenderVertices[i];
-    } 
+    renderFrameTriangles();
 }
 
 void MD2Model::renderModelStatic()
@@ -426,12 +491,7 @@ void MD2Model::renderModelStatic()
     setupVAO(0, 0);
 
     ShaderProgramManager::getInstance().getShaderProgram("md2")[ShaderConstants::interpolationFactor()] = 0;
-    GLint totalOffset = 0;
-    for (size_t i = 0; i < renderModes.size(); i++) // Just render using previously extracted render modes
-    {
-        glDrawArrays(renderModes[i], totalOffset, numRenderVertices[i]);
-        totalOffset += numRenderVertices[i];
-    }
+    renderFrameTriangles();
 }
 
 const std::vector<std::string>& MD2Model::getAnimationNames()
@@ -472,12 +532,15 @@ void MD2Model::deleteModel()
 
     std::cout << "Deleting MD2 model '" << filePath_ << "':" << std::endl;
     std::cout << "Deleting VAO #" << vao_ << std::endl;
+    GLStateCache::getInstance().onVertexArrayDeleted(vao_);
     glDeleteVertexArrays(1, &vao_);
     vao_ = 0;
 
     vboFrameVertices_.deleteVBO();
     vboTextureCoordinates_.deleteVBO();
     vboNormals_.deleteVBO();
+    vboIndices_.deleteVBO();
+    numRenderIndices_ = 0;
 
     skinTexture_.deleteTexture();
 }
@@ -508,7 +571,7 @@ void MD2Model::setupVAO(size_t currentFrame, size_t nextFrame)
         return;
     }
 
-    glBindVertexArray(vao_);
+    GLStateCache::getInstance().bindVertexArray(vao_);
     const auto currentFrameByteOffset = currentFrame * verticesPerFrame_ * sizeof(glm::vec3);
     const auto nextFrameByteOffset = nextFrame < static_cast<size_t>(header_.numFrames) ? nextFrame * verticesPerFrame_ * sizeof(glm::vec3) : currentFrameByteOffset;
 
@@ -534,6 +597,13 @@ void MD2Model::setupVAO(size_t currentFrame, size_t nextFrame)
     glVertexAttribPointer(NEXT_NORMAL_ATTRIBUTE_INDEX, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), reinterpret_cast<void*>(nextFrameByteOffset));
 }
 
+void MD2Model::renderFrameTriangles() const
+{
+    // Index buffer is part of VAO state, so just render whole frame at once (without restart left enabled by other meshes)
+    GLStateCache::getInstance().disable(GL_PRIMITIVE_RESTART);
+    glDrawElements(GL_TRIANGLES, numRenderIndices_, GL_UNSIGNED_INT, nullptr);
+}
+
 } // namespace animated_meshes_3D
 } // namespace common_classes
 } // namespace opengl4_mbsoftworks
\ No newline at end of file
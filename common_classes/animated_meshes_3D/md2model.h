@@ -12,6 +12,7 @@
 #include <glad/glad.h>
 
 // Project
+#include "../../common_classes/boundingVolumes.h"
 #include "../../common_classes/vertexBufferObject.h"
 #include "../../common_classes/texture.h"
 
@@ -63,6 +64,16 @@ public:
     
     AnimationState startAnimation(const std::string& animationName, bool loop = true, size_t fps = 0) const;
 
+    /**
+     * Gets bounding box of the model, that contains the model in all frames (so it's valid whichever animation runs).
+     */
+    const AABB& getBoundingBox() const;
+
+    /**
+     * Gets bounding sphere of the model, that contains the model in all frames.
+     */
+    const BoundingSphere& getBoundingSphere() const;
+
     void deleteModel();
 
 private:
@@ -143,10 +154,12 @@ private:
     VertexBufferObject vboFrameVertices_;
     VertexBufferObject vboTextureCoordinates_;
     VertexBufferObject vboNormals_;
+    VertexBufferObject vboIndices_; // Indices of triangle list converted from OpenGL commands (same for every frame)
 
-    std::vector<GLenum> renderModes; // Rendering modes
-    std::vector<GLsizei> numRenderVertices; // with number of vertices
+    GLsizei numRenderIndices_ { 0 }; // Number of indices to render one frame as a triangle list
     size_t verticesPerFrame_ { 0 }; // Number of vertices stored per frame that cover whole rendering process
+    AABB boundingBox_; // Bounding box over all frames
+    BoundingSphere boundingSphere_; // Bounding sphere over all frames
 
     Texture skinTexture_;
 
@@ -154,6 +167,7 @@ private:
     std::vector<std::string> animationNamesCached_;
 
     void setupVAO(size_t currentFrame, size_t nextFrame);
+    void renderFrameTriangles() const;
 
     Animation& addNewAnimation(const std::string& animationName, size_t firstFrame, size_t lastFrame, size_t fps);
     static std::string getAnimationBaseName(const std::string& frameName);
@@ -0,0 +1,141 @@
+// STL
+#include <algorithm>
+
+// Project
+#include "boundingVolumeHierarchy.h"
+
+const size_t BoundingVolumeHierarchy::MAX_OBJECTS_IN_LEAF = 4;
+
+void BoundingVolumeHierarchy::build(const std::vector<AABB>& objectBoxes)
+{
+    clear();
+    if (objectBoxes.empty()) {
+        return;
+    }
+
+    objectIndices_.resize(objectBoxes.size());
+    for (size_t i = 0; i < objectIndices_.size(); i++) {
+        objectIndices_[i] = static_cast<uint32_t>(i);
+    }
+
+    // Balanced binary tree with small leaves has less than 2 * (objects / (leaf size / 2)) nodes
+    nodes_.reserve(4 * objectBoxes.size() / MAX_OBJECTS_IN_LEAF + 1);
+    buildNode(objectBoxes, 0, objectIndices_.size());
+
+    leafObjectBoxes_.reserve(objectIndices_.size());
+    for (const auto objectIndex : objectIndices_) {
+        leafObjectBoxes_.push_back(objectBoxes[objectIndex]);
+    }
+}
+
+void BoundingVolumeHierarchy::clear()
+{
+    nodes_.clear();
+    objectIndices_.clear();
+    leafObjectBoxes_.clear();
+}
+
+void BoundingVolumeHierarchy::query(const Frustum& frustum, std::vector<uint32_t>& outVisibleIndices) const
+{
+    outVisibleIndices.clear();
+    if (nodes_.empty()) {
+        return;
+    }
+
+    // Explicit stack instead of recursion, every entry remembers planes its node still has to be tested against
+    struct StackEntry
+    {
+        uint32_t nodeIndex;
+        int planeMask;
+    };
+
+    std::vector<StackEntry> stack;
+    stack.push_back({ 0, Frustum::ALL_PLANES_MASK });
+    while (!stack.empty())
+    {
+        auto entry = stack.back();
+        stack.pop_back();
+
+        const auto& node = nodes_[entry.nodeIndex];
+        const auto containment = frustum.classifyAABB(node.box, entry.planeMask);
+        if (containment == Frustum::Containment::Outside) {
+            continue;
+        }
+
+        // Whole subtree inside the frustum - just take all objects, they're stored contiguously
+        if (containment == Frustum::Containment::Inside)
+        {
+            outVisibleIndices.insert(outVisibleIndices.end(), objectIndices_.begin() + node.firstObject,
+                objectIndices_.begin() + node.firstObject + node.numObjects);
+            continue;
+        }
+
+        // Leaf intersecting the frustum - test its objects against the planes, that are still intersected
+        if (node.rightChild == 0)
+        {
+            for (auto i = node.firstObject; i < node.firstObject + node.numObjects; i++)
+            {
+                auto objectPlaneMask = entry.planeMask;
+                if (frustum.classifyAABB(leafObjectBoxes_[i], objectPlaneMask) != Frustum::Containment::Outside) {
+                    outVisibleIndices.push_back(objectIndices_[i]);
+                }
+            }
+
+            continue;
+        }
+
+        stack.push_back({ node.rightChild, entry.planeMask });
+        stack.push_back({ entry.nodeIndex + 1, entry.planeMask });
+    }
+}
+
+size_t BoundingVolumeHierarchy::getNumNodes() const
+{
+    return nodes_.size();
+}
+
+size_t BoundingVolumeHierarchy::getNumObjects() const
+{
+    return objectIndices_.size();
+}
+
+void BoundingVolumeHierarchy::buildNode(const std::vector<AABB>& objectBoxes, const size_t firstObject, const size_t lastObject)
+{
+    const auto nodeIndex = nodes_.size();
+    nodes_.push_back({ AABB(), static_cast<uint32_t>(firstObject), static_cast<uint32_t>(lastObject - firstObject), 0 });
+
+    // Calculate bounds of objects and bounds of their centers (centers tell better, along which axis to split)
+    AABB nodeBox, centersBox;
+    for (auto i = firstObject; i < lastObject; i++)
+    {
+        const auto& objectBox = objectBoxes[objectIndices_[i]];
+        nodeBox.extend(objectBox);
+        centersBox.extend(objectBox.getCenter());
+    }
+
+    nodes_[nodeIndex].box = nodeBox;
+    if (lastObject - firstObject <= MAX_OBJECTS_IN_LEAF) {
+        return;
+    }
+
+    // Split objects in half along the longest axis of their centers
+    const auto centersSize = centersBox.max - centersBox.min;
+    auto axis = 0;
+    if (centersSize.y > centersSize[axis]) {
+        axis = 1;
+    }
+    if (centersSize.z > centersSize[axis]) {
+        axis = 2;
+    }
+
+    const auto middleObject = firstObject + (lastObject - firstObject) / 2;
+    std::nth_element(objectIndices_.begin() + firstObject, objectIndices_.begin() + middleObject, objectIndices_.begin() + lastObject,
+        [&objectBoxes, axis](const uint32_t a, const uint32_t b) {
+            return objectBoxes[a].min[axis] + objectBoxes[a].max[axis] < objectBoxes[b].min[axis] + objectBoxes[b].max[axis];
+        });
+
+    // Left child directly follows, right child goes after the whole left subtree
+    buildNode(objectBoxes, firstObject, middleObject);
+    nodes_[nodeIndex].rightChild = static_cast<uint32_t>(nodes_.size());
+    buildNode(objectBoxes, middleObject, lastObject);
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <vector>
+
+// Project
+#include "boundingVolumes.h"
+#include "frustum.h"
+
+/**
+ * Bounding volume hierarchy of boxes for static scenes. It's built once from bounding boxes of objects
+ * and then whole subtrees outside of the frustum are skipped with one test. Subtrees completely inside
+ * the frustum are accepted without testing the objects within.
+ */
+class BoundingVolumeHierarchy
+{
+public:
+    static const size_t MAX_OBJECTS_IN_LEAF; // Nodes with at most this number of objects are not split anymore
+
+    /**
+     * Builds hierarchy from bounding boxes of objects. Objects are referred to by their indices in the vector.
+     * Nodes are split in the middle of their longest axis (by object count, so the tree is always balanced).
+     */
+    void build(const std::vector<AABB>& objectBoxes);
+
+    /**
+     * Removes the whole hierarchy.
+     */
+    void clear();
+
+    /**
+     * Gathers indices of objects, whose boxes are at least partially inside of the frustum.
+     *
+     * @param frustum            Frustum to query
+     * @param outVisibleIndices  Indices of visible objects (cleared first, order is given by the tree, not ascending)
+     */
+    void query(const Frustum& frustum, std::vector<uint32_t>& outVisibleIndices) const;
+
+    /**
+     * Gets number of nodes of the hierarchy.
+     */
+    size_t getNumNodes() const;
+
+    /**
+     * Gets number of objects in the hierarchy.
+     */
+    size_t getNumObjects() const;
+
+private:
+    /**
+     * Node of the hierarchy. Nodes are stored in depth-first order, so left child always directly follows
+     * its parent. Objects of every subtree are contiguous in objectIndices_.
+     */
+    struct Node
+    {
+        AABB box; // Box bounding all objects of the subtree
+        uint32_t firstObject; // Index of the first object of the subtree within objectIndices_
+        uint32_t numObjects; // Number of objects of the subtree
+        uint32_t rightChild; // Index of the right child (0 for leaves, because root can't be anyone's child)
+    };
+
+    /**
+     * Builds subtree from objects [firstObject, lastObject) of objectIndices_.
+     */
+    void buildNode(const std::vector<AABB>& objectBoxes, size_t firstObject, size_t lastObject);
+
+    std::vector<Node> nodes_; // All nodes of the hierarchy, root is the first one
+    std::vector<uint32_t> objectIndices_; // Object indices ordered, so that every subtree has contiguous range
+    std::vector<AABB> leafObjectBoxes_; // Boxes of objects in the same order, so that objects of intersecting leaves can be tested
+};
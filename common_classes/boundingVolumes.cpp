@@ -0,0 +1,99 @@
+// STL
+#include <algorithm>
+#include <cmath>
+
+// Project
+#include "boundingVolumes.h"
+
+AABB AABB::fromPoints(const glm::vec3* points, const size_t numPoints)
+{
+    AABB result;
+    for (size_t i = 0; i < numPoints; i++) {
+        result.extend(points[i]);
+    }
+
+    return result;
+}
+
+AABB AABB::fromCenterAndExtents(const glm::vec3& center, const glm::vec3& extents)
+{
+    AABB result;
+    result.min = center - extents;
+    result.max = center + extents;
+    return result;
+}
+
+bool AABB::isEmpty() const
+{
+    return min.x > max.x || min.y > max.y || min.z > max.z;
+}
+
+void AABB::extend(const glm::vec3& point)
+{
+    min = glm::min(min, point);
+    max = glm::max(max, point);
+}
+
+void AABB::extend(const AABB& other)
+{
+    min = glm::min(min, other.min);
+    max = glm::max(max, other.max);
+}
+
+glm::vec3 AABB::getCenter() const
+{
+    return (min + max) * 0.5f;
+}
+
+glm::vec3 AABB::getExtents() const
+{
+    return (max - min) * 0.5f;
+}
+
+AABB AABB::transformed(const glm::mat4& matrix) const
+{
+    if (isEmpty()) {
+        return *this;
+    }
+
+    // Transformed extents are sums of absolute values of rotated extents, no need to transform all 8 corners
+    const auto center = glm::vec3(matrix * glm::vec4(getCenter(), 1.0f));
+    const auto extents = getExtents();
+    glm::vec3 newExtents(0.0f);
+    for (auto i = 0; i < 3; i++) {
+        newExtents += glm::abs(glm::vec3(matrix[i])) * extents[i];
+    }
+
+    return fromCenterAndExtents(center, newExtents);
+}
+
+BoundingSphere BoundingSphere::fromPoints(const glm::vec3* points, const size_t numPoints)
+{
+    BoundingSphere result;
+    if (numPoints == 0) {
+        return result;
+    }
+
+    result.center = AABB::fromPoints(points, numPoints).getCenter();
+    auto maxDistanceSquared = 0.0f;
+    for (size_t i = 0; i < numPoints; i++)
+    {
+        const auto offset = points[i] - result.center;
+        maxDistanceSquared = std::max(maxDistanceSquared, glm::dot(offset, offset));
+    }
+
+    result.radius = std::sqrt(maxDistanceSquared);
+    return result;
+}
+
+BoundingSphere BoundingSphere::transformed(const glm::mat4& matrix) const
+{
+    const auto scaleX = glm::length(glm::vec3(matrix[0]));
+    const auto scaleY = glm::length(glm::vec3(matrix[1]));
+    const auto scaleZ = glm::length(glm::vec3(matrix[2]));
+
+    BoundingSphere result;
+    result.center = glm::vec3(matrix * glm::vec4(center, 1.0f));
+    result.radius = radius * std::max(scaleX, std::max(scaleY, scaleZ));
+    return result;
+}
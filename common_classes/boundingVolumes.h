@@ -0,0 +1,77 @@
+#pragma once
+
+// STL
+#include <cstddef>
+
+// GLM
+#include <glm/glm.hpp>
+
+/**
+ * Axis aligned bounding box. Default constructed box is empty (minimal corner is greater than the maximal one),
+ * so that it can be grown by extending it with points or other boxes.
+ */
+struct AABB
+{
+    glm::vec3 min{ 1e30f }; // Minimal corner of the box
+    glm::vec3 max{ -1e30f }; // Maximal corner of the box
+
+    /**
+     * Calculates bounding box of given points.
+     */
+    static AABB fromPoints(const glm::vec3* points, size_t numPoints);
+
+    /**
+     * Creates bounding box from its center and half-sizes.
+     */
+    static AABB fromCenterAndExtents(const glm::vec3& center, const glm::vec3& extents);
+
+    /**
+     * Checks, if the box contains anything (empty box has nothing added to it yet).
+     */
+    bool isEmpty() const;
+
+    /**
+     * Grows the box, so that it contains given point.
+     */
+    void extend(const glm::vec3& point);
+
+    /**
+     * Grows the box, so that it contains given box.
+     */
+    void extend(const AABB& other);
+
+    /**
+     * Gets center of the box.
+     */
+    glm::vec3 getCenter() const;
+
+    /**
+     * Gets half-sizes of the box.
+     */
+    glm::vec3 getExtents() const;
+
+    /**
+     * Gets box, that bounds this box transformed with given matrix (it's axis aligned again, so it might be bigger).
+     */
+    AABB transformed(const glm::mat4& matrix) const;
+};
+
+/**
+ * Bounding sphere.
+ */
+struct BoundingSphere
+{
+    glm::vec3 center{ 0.0f }; // Center of the sphere
+    float radius{ 0.0f }; // Radius of the sphere
+
+    /**
+     * Calculates bounding sphere of given points. Sphere is centered in the middle of points bounding box,
+     * which isn't the tightest sphere possible, but it's good enough and it's calculated in linear time.
+     */
+    static BoundingSphere fromPoints(const glm::vec3* points, size_t numPoints);
+
+    /**
+     * Gets sphere, that bounds this sphere transformed with given matrix (radius is scaled by the largest axis scale).
+     */
+    BoundingSphere transformed(const glm::mat4& matrix) const;
+};
@@ -0,0 +1,125 @@
+// Project
+#include "bufferStreamingRing.h"
+
+bool BufferStreamingRing::create(const GLenum bufferType, const size_t regionSizeBytes, const size_t numRegions, const size_t alignment)
+{
+    if (isMapped() || regionSizeBytes == 0 || numRegions == 0 || alignment == 0) {
+        return false;
+    }
+
+    // Round region size up, so that every region starts at nicely aligned offset
+    alignment_ = alignment;
+    regionSize_ = (regionSizeBytes + alignment_ - 1) / alignment_ * alignment_;
+    const auto totalSizeBytes = regionSize_ * numRegions;
+    const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glBufferStorage(bufferType, totalSizeBytes, nullptr, flags);
+    mappedData_ = static_cast<unsigned char*>(glMapBufferRange(bufferType, 0, totalSizeBytes, flags));
+    if (mappedData_ == nullptr)
+    {
+        regionSize_ = 0;
+        return false;
+    }
+
+    currentRegion_ = 0;
+    regionBytesUsed_ = 0;
+    regionFences_.assign(numRegions, nullptr);
+    return true;
+}
+
+void BufferStreamingRing::release(const GLenum bufferType)
+{
+    if (mappedData_ != nullptr)
+    {
+        glUnmapBuffer(bufferType);
+        mappedData_ = nullptr;
+    }
+
+    for (auto& fence : regionFences_)
+    {
+        if (fence != nullptr) {
+            glDeleteSync(fence);
+        }
+    }
+
+    regionFences_.clear();
+    regionSize_ = 0;
+    currentRegion_ = 0;
+    regionBytesUsed_ = 0;
+}
+
+bool BufferStreamingRing::isMapped() const
+{
+    return mappedData_ != nullptr;
+}
+
+size_t BufferStreamingRing::getTotalSize() const
+{
+    return regionSize_ * regionFences_.size();
+}
+
+size_t BufferStreamingRing::getRegionSize() const
+{
+    return regionSize_;
+}
+
+size_t BufferStreamingRing::getRegionBytesLeft() const
+{
+    const auto alignedOffset = getAlignedRegionOffset();
+    return alignedOffset < regionSize_ ? regionSize_ - alignedOffset : 0;
+}
+
+void* BufferStreamingRing::reserve(const size_t dataSizeBytes, size_t& outByteOffset)
+{
+    const auto alignedOffset = getAlignedRegionOffset();
+    if (!isMapped() || alignedOffset + dataSizeBytes > regionSize_) {
+        return nullptr;
+    }
+
+    // First reservation in the region means we're about to overwrite it, so GPU must be done reading from it
+    if (regionBytesUsed_ == 0) {
+        waitForRegion(currentRegion_);
+    }
+
+    outByteOffset = currentRegion_ * regionSize_ + alignedOffset;
+    regionBytesUsed_ = alignedOffset + dataSizeBytes;
+    return mappedData_ + outByteOffset;
+}
+
+void BufferStreamingRing::finishRegion()
+{
+    if (!isMapped() || regionBytesUsed_ == 0) {
+        return;
+    }
+
+    regionFences_[currentRegion_] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    currentRegion_ = (currentRegion_ + 1) % regionFences_.size();
+    regionBytesUsed_ = 0;
+}
+
+size_t BufferStreamingRing::getAlignedRegionOffset() const
+{
+    return (regionBytesUsed_ + alignment_ - 1) / alignment_ * alignment_;
+}
+
+void BufferStreamingRing::waitForRegion(const size_t regionIndex)
+{
+    auto& fence = regionFences_[regionIndex];
+    if (fence == nullptr) {
+        return;
+    }
+
+    // Flush commands on the first wait so that the fence gets signaled at all, then keep waiting with one second timeouts
+    GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while (true)
+    {
+        const auto result = glClientWaitSync(fence, waitFlags, 1000000000);
+        if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED) {
+            break;
+        }
+
+        waitFlags = 0;
+    }
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+// STL
+#include <vector>
+
+// GLAD
+#include <glad/glad.h>
+
+/**
+ * Persistently mapped ring of buffer regions, used by streaming modes of buffer wrappers (VertexBufferObject,
+ * UniformBufferObject). Buffer storage is allocated once and split into several regions - one region is filled
+ * per frame, then it's guarded by a fence and the ring moves on. Region is waited for only when the ring wraps
+ * around to it and GPU is still reading it. Ring doesn't own the buffer, the wrapper creates it and calls release before deleting it.
+ */
+class BufferStreamingRing
+{
+public:
+    /**
+     * Allocates immutable storage for the bound buffer and maps it persistently.
+     *
+     * @param bufferType       Target, that the buffer is bound to (e.g. GL_ARRAY_BUFFER)
+     * @param regionSizeBytes  Size of one region in bytes (it's rounded up to the alignment)
+     * @param numRegions       Number of regions in the ring
+     * @param alignment        Alignment of regions and data chunks within them (in bytes)
+     *
+     * @return True, if the storage has been mapped successfully or false otherwise.
+     */
+    bool create(GLenum bufferType, size_t regionSizeBytes, size_t numRegions, size_t alignment);
+
+    /**
+     * Unmaps the storage (buffer must be bound to the same target) and deletes all fences.
+     *
+     * @param bufferType  Target, that the buffer is bound to
+     */
+    void release(GLenum bufferType);
+
+    /**
+     * Checks, if the ring has been created and its storage is mapped.
+     */
+    bool isMapped() const;
+
+    /**
+     * Gets total size of the storage (all regions) in bytes.
+     */
+    size_t getTotalSize() const;
+
+    /**
+     * Gets size of one region in bytes.
+     */
+    size_t getRegionSize() const;
+
+    /**
+     * Gets how many bytes can still be reserved in the current region (with respect to the alignment).
+     */
+    size_t getRegionBytesLeft() const;
+
+    /**
+     * Reserves aligned chunk of the current region. If the region is still being read by the GPU,
+     * this function waits for it first.
+     *
+     * @param dataSizeBytes  Size of the data to be written (in bytes)
+     * @param outByteOffset  Here the byte offset of the chunk within the whole buffer is returned
+     *
+     * @return Pointer, where caller can write the data directly, or nullptr, if the data don't fit into the region.
+     */
+    void* reserve(size_t dataSizeBytes, size_t& outByteOffset);
+
+    /**
+     * Places a fence after all commands, that have used the current region, and moves on to the next region.
+     * Does nothing, if nothing has been reserved in the current region.
+     */
+    void finishRegion();
+
+private:
+    /**
+     * Gets offset within the current region, where next chunk would start.
+     */
+    size_t getAlignedRegionOffset() const;
+
+    /**
+     * Waits until GPU has finished reading from the given region and deletes its fence.
+     */
+    void waitForRegion(size_t regionIndex);
+
+    unsigned char* mappedData_{ nullptr }; // Persistently mapped pointer to the whole buffer
+    size_t regionSize_{ 0 }; // Size of one region (in bytes)
+    size_t alignment_{ 1 }; // Alignment of regions and chunks (in bytes)
+    size_t currentRegion_{ 0 }; // Index of the region, that is currently written to
+    size_t regionBytesUsed_{ 0 }; // How many bytes of the current region have been reserved already
+    std::vector<GLsync> regionFences_; // Fences guarding the regions, so that we don't overwrite data, that GPU still reads
+};
@@ -0,0 +1,206 @@
+// STL
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+// Project
+#include "commandBuffer.h"
+#include "jobSystem.h"
+
+void CommandBuffer::reset()
+{
+    commands_.clear();
+    modelMatrices_.clear();
+    normalMatrices_.clear();
+    uniformBlockRanges_.clear();
+    uniformData_.clear();
+
+    lastProgram_ = nullptr;
+    lastMaterial_ = nullptr;
+    lastTextures_.clear();
+}
+
+void CommandBuffer::useProgram(ShaderProgram& shaderProgram)
+{
+    if (lastProgram_ == &shaderProgram) {
+        return;
+    }
+
+    commands_.push_back({ CommandType::UseProgram, 0, &shaderProgram });
+    lastProgram_ = &shaderProgram;
+    lastMaterial_ = nullptr; // Material is a uniform, so it's per program
+}
+
+void CommandBuffer::bindTexture(const Texture& texture, const GLenum textureUnit)
+{
+    if (textureUnit >= lastTextures_.size()) {
+        lastTextures_.resize(textureUnit + 1, nullptr);
+    }
+
+    if (lastTextures_[textureUnit] == &texture) {
+        return;
+    }
+
+    commands_.push_back({ CommandType::BindTexture, static_cast<uint32_t>(textureUnit), &texture });
+    lastTextures_[textureUnit] = &texture;
+}
+
+void CommandBuffer::setMaterial(const shader_structs::Material& material)
+{
+    if (lastMaterial_ == &material) {
+        return;
+    }
+
+    commands_.push_back({ CommandType::SetMaterial, 0, &material });
+    lastMaterial_ = &material;
+}
+
+void CommandBuffer::setModelAndNormalMatrix(const glm::mat4& modelMatrix)
+{
+    commands_.push_back({ CommandType::SetModelAndNormalMatrix, static_cast<uint32_t>(modelMatrices_.size()), nullptr });
+    modelMatrices_.push_back(modelMatrix);
+    normalMatrices_.push_back(glm::transpose(glm::inverse(glm::mat3(modelMatrix))));
+}
+
+void CommandBuffer::setUniformBlockData(const GLuint bindingPoint, const void* ptrData, const size_t dataSize)
+{
+    commands_.push_back({ CommandType::SetUniformBlockData, static_cast<uint32_t>(uniformBlockRanges_.size()), nullptr });
+    uniformBlockRanges_.push_back({ bindingPoint, uniformData_.size(), dataSize });
+
+    const auto offset = uniformData_.size();
+    uniformData_.resize(offset + dataSize);
+    memcpy(uniformData_.data() + offset, ptrData, dataSize);
+}
+
+void CommandBuffer::renderMesh(const static_meshes_3D::StaticMesh3D& mesh)
+{
+    commands_.push_back({ CommandType::RenderMesh, 0, &mesh });
+}
+
+void CommandBuffer::replay(UniformBufferObject* streamingUBO) const
+{
+    ShaderProgram* currentProgram = nullptr;
+    for (const auto& command : commands_)
+    {
+        switch (command.type)
+        {
+            case CommandType::UseProgram:
+                // Program is stored as const pointer only to keep the command small, it's recorded from non-const reference
+                currentProgram = const_cast<ShaderProgram*>(static_cast<const ShaderProgram*>(command.object));
+                currentProgram->useProgram();
+                break;
+
+            case CommandType::BindTexture:
+                static_cast<const Texture*>(command.object)->bind(static_cast<GLenum>(command.index));
+                break;
+
+            case CommandType::SetMaterial:
+                if (currentProgram != nullptr) {
+                    static_cast<const shader_structs::Material*>(command.object)->setUniform(*currentProgram, ShaderConstants::material());
+                }
+                break;
+
+            case CommandType::SetModelAndNormalMatrix:
+                if (currentProgram != nullptr)
+                {
+                    (*currentProgram)[ShaderConstants::modelMatrix()] = modelMatrices_[command.index];
+                    (*currentProgram)[ShaderConstants::normalMatrix()] = normalMatrices_[command.index];
+                }
+                break;
+
+            case CommandType::SetUniformBlockData:
+            {
+                if (streamingUBO == nullptr) {
+                    throw std::runtime_error("Attempting to replay uniform block data without streaming UBO!");
+                }
+
+                // Streaming UBO reports itself, if it's not in streaming mode or the data don't fit
+                const auto& range = uniformBlockRanges_[command.index];
+                streamingUBO->setStreamingData(range.bindingPoint, uniformData_.data() + range.offset, range.dataSize);
+                break;
+            }
+
+            case CommandType::RenderMesh:
+                static_cast<const static_meshes_3D::StaticMesh3D*>(command.object)->render();
+                break;
+        }
+    }
+}
+
+size_t CommandBuffer::getNumCommands() const
+{
+    return commands_.size();
+}
+
+ParallelCommandRecorder::ParallelCommandRecorder(const size_t maxThreads)
+    : maxThreads_(maxThreads > 0 ? maxThreads : JobSystem::getInstance().getNumThreads())
+{
+}
+
+void ParallelCommandRecorder::record(const size_t numItems, const RecordFunction& recordFunction, const size_t minItemsPerBuffer)
+{
+    // Don't use more buffers than threads and don't make chunks smaller than requested
+    const auto maxBuffers = isParallelRecordingEnabled_ ? maxThreads_ : 1;
+    const auto minItems = std::max(minItemsPerBuffer, static_cast<size_t>(1));
+    numUsedBuffers_ = std::max(std::min(maxBuffers, (numItems + minItems - 1) / minItems), static_cast<size_t>(1));
+    while (commandBuffers_.size() < numUsedBuffers_) {
+        commandBuffers_.push_back(std::make_unique<CommandBuffer>());
+    }
+
+    const auto itemsPerBuffer = (numItems + numUsedBuffers_ - 1) / numUsedBuffers_;
+    auto recordChunk = [this, &recordFunction, numItems, itemsPerBuffer](const size_t bufferIndex)
+    {
+        auto& commandBuffer = *commandBuffers_[bufferIndex];
+        commandBuffer.reset();
+
+        const auto firstItem = std::min(bufferIndex * itemsPerBuffer, numItems);
+        const auto lastItem = std::min(firstItem + itemsPerBuffer, numItems);
+        recordFunction(commandBuffer, firstItem, lastItem);
+    };
+
+    if (numUsedBuffers_ == 1)
+    {
+        recordChunk(0);
+        return;
+    }
+
+    // One job per buffer, calling thread records chunks as well while it waits
+    JobSystem::getInstance().parallelFor(0, numUsedBuffers_, 1, [&recordChunk](const size_t firstBuffer, const size_t lastBuffer)
+    {
+        for (auto i = firstBuffer; i < lastBuffer; i++) {
+            recordChunk(i);
+        }
+    });
+}
+
+void ParallelCommandRecorder::replay(UniformBufferObject* streamingUBO) const
+{
+    for (size_t i = 0; i < numUsedBuffers_; i++) {
+        commandBuffers_[i]->replay(streamingUBO);
+    }
+}
+
+void ParallelCommandRecorder::setParallelRecordingEnabled(const bool enabled)
+{
+    isParallelRecordingEnabled_ = enabled;
+}
+
+bool ParallelCommandRecorder::isParallelRecordingEnabled() const
+{
+    return isParallelRecordingEnabled_;
+}
+
+size_t ParallelCommandRecorder::getNumUsedBuffers() const
+{
+    return numUsedBuffers_;
+}
+
+size_t ParallelCommandRecorder::getNumCommands() const
+{
+    size_t numCommands = 0;
+    for (size_t i = 0; i < numUsedBuffers_; i++) {
+        numCommands += commandBuffers_[i]->getNumCommands();
+    }
+
+    return numCommands;
+}
@@ -0,0 +1,195 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+// GLAD
+#include <glad/glad.h>
+
+// Project
+#include "shaderProgram.h"
+#include "texture.h"
+#include "uniformBufferObject.h"
+#include "shader_structs/material.h"
+#include "static_meshes_3D/staticMesh3D.h"
+
+/**
+ * Buffer of lightweight draw commands. Recording does not call OpenGL at all, so it can be done on any thread
+ * (matrices are calculated and uniform data are packed during recording already). The render thread then replays
+ * the commands, which is the only place where OpenGL calls are actually made.
+ */
+class CommandBuffer
+{
+public:
+    /**
+     * Removes all recorded commands, so that the buffer can be recorded again.
+     */
+    void reset();
+
+    /**
+     * Records switch of shader program. Subsequent uniform commands are applied to this program.
+     */
+    void useProgram(ShaderProgram& shaderProgram);
+
+    /**
+     * Records binding of texture to the given texture unit. Binding the same texture again is not recorded.
+     */
+    void bindTexture(const Texture& texture, GLenum textureUnit = 0);
+
+    /**
+     * Records setting of the material uniform. Setting the same material again is not recorded.
+     */
+    void setMaterial(const shader_structs::Material& material);
+
+    /**
+     * Records setting of model and normal matrix uniforms. Normal matrix is calculated right away.
+     *
+     * @param modelMatrix  Model matrix to set
+     */
+    void setModelAndNormalMatrix(const glm::mat4& modelMatrix);
+
+    /**
+     * Records data for the uniform block. Data are copied now and during replay, they are streamed to the UBO
+     * passed to replay() and the range is bound to the given binding point.
+     *
+     * @param bindingPoint  Binding point of the uniform block
+     * @param ptrData       Pointer to data (already in the layout the block expects, e.g. std140)
+     * @param dataSize      Size of data in bytes
+     */
+    void setUniformBlockData(GLuint bindingPoint, const void* ptrData, size_t dataSize);
+
+    /**
+     * Records rendering of the mesh.
+     */
+    void renderMesh(const static_meshes_3D::StaticMesh3D& mesh);
+
+    /**
+     * Replays all recorded commands. Must be called from the thread with the OpenGL context.
+     *
+     * @param streamingUBO  Streaming UBO to upload uniform block data to (only needed, if some were recorded,
+     *                      otherwise std::runtime_error is thrown)
+     */
+    void replay(UniformBufferObject* streamingUBO = nullptr) const;
+
+    /**
+     * Gets number of recorded commands.
+     */
+    size_t getNumCommands() const;
+
+private:
+    /**
+     * Type of recorded command.
+     */
+    enum class CommandType : uint8_t
+    {
+        UseProgram,
+        BindTexture,
+        SetMaterial,
+        SetModelAndNormalMatrix,
+        SetUniformBlockData,
+        RenderMesh
+    };
+
+    /**
+     * One recorded command. Depending on the type, object points to a program, texture, material or mesh
+     * and index is a texture unit or an index into the matrices / uniform blocks arrays.
+     */
+    struct Command
+    {
+        CommandType type;
+        uint32_t index;
+        const void* object;
+    };
+
+    /**
+     * Where the data of recorded uniform block are stored within uniformData_.
+     */
+    struct UniformBlockRange
+    {
+        GLuint bindingPoint;
+        size_t offset;
+        size_t dataSize;
+    };
+
+    std::vector<Command> commands_; // All recorded commands
+    std::vector<glm::mat4> modelMatrices_; // Model matrices of SetModelAndNormalMatrix commands
+    std::vector<glm::mat3> normalMatrices_; // With their corresponding normal matrices
+    std::vector<UniformBlockRange> uniformBlockRanges_; // Ranges of SetUniformBlockData commands
+    std::vector<unsigned char> uniformData_; // Packed data of all uniform blocks
+
+    const void* lastProgram_{ nullptr }; // Last recorded program, so that redundant switches are skipped
+    const void* lastMaterial_{ nullptr }; // Last recorded material
+    std::vector<const void*> lastTextures_; // Last recorded texture per texture unit
+};
+
+/**
+ * Records command buffers on multiple threads. Items (e.g. objects of the scene) are split into contiguous chunks,
+ * every chunk is recorded into its own command buffer and buffers are replayed in the order of chunks,
+ * so the result is the same as if everything was recorded on a single thread.
+ */
+class ParallelCommandRecorder
+{
+public:
+    /**
+     * Function recording items [firstItem, lastItem) into the given command buffer. It's called from
+     * multiple threads at once, so it must not call OpenGL or modify anything shared.
+     */
+    using RecordFunction = std::function<void(CommandBuffer& commandBuffer, size_t firstItem, size_t lastItem)>;
+
+    /**
+     * Creates recorder.
+     *
+     * @param maxThreads  Maximal number of recording threads (0 means all threads of the shared job system)
+     */
+    explicit ParallelCommandRecorder(size_t maxThreads = 0);
+
+    /**
+     * Records all items into command buffers using the shared job system. Calling thread records chunks as well and returns,
+     * when all of them are recorded.
+     *
+     * @param numItems           Number of items to record
+     * @param recordFunction     Function recording a chunk of items
+     * @param minItemsPerBuffer  Minimal number of items per chunk, so that small workloads don't pay for threads
+     */
+    void record(size_t numItems, const RecordFunction& recordFunction, size_t minItemsPerBuffer = 64);
+
+    /**
+     * Replays all buffers recorded by the last record() call in order.
+     *
+     * @param streamingUBO  Streaming UBO to upload uniform block data to (only needed, if some were recorded,
+     *                      otherwise std::runtime_error is thrown)
+     */
+    void replay(UniformBufferObject* streamingUBO = nullptr) const;
+
+    /**
+     * Enables or disables recording on multiple threads (when disabled, everything is recorded on the calling thread).
+     */
+    void setParallelRecordingEnabled(bool enabled);
+
+    /**
+     * Checks, if recording on multiple threads is enabled.
+     */
+    bool isParallelRecordingEnabled() const;
+
+    /**
+     * Gets number of command buffers used by the last record() call.
+     */
+    size_t getNumUsedBuffers() const;
+
+    /**
+     * Gets total number of commands recorded by the last record() call.
+     */
+    size_t getNumCommands() const;
+
+private:
+    size_t maxThreads_; // Maximal number of recording threads
+    bool isParallelRecordingEnabled_{ true }; // Flag telling, whether multiple threads are used
+    std::vector<std::unique_ptr<CommandBuffer>> commandBuffers_; // Command buffers (they are kept between frames to reuse memory)
+    size_t numUsedBuffers_{ 0 }; // Number of buffers used by the last recording
+};
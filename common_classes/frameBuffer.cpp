@@ -4,6 +4,7 @@
 // Project
 #include "OpenGLWindow.h"
 #include "frameBuffer.h"
+#include "gpuResourceRegistry.h"
 
 FrameBuffer::~FrameBuffer()
 {
@@ -32,6 +33,8 @@ bool FrameBuffer::createFrameBufferWithColorAndDepth(const GLsizei width, const
         return false;
     }
 
+    // Framebuffer itself holds no storage, its attachments are accounted for as renderbuffers / textures
+    GPUResourceRegistry::getInstance().registerResource(GPUResourceType::FrameBuffer, frameBufferID_);
     glBindFramebuffer(GL_FRAMEBUFFER, frameBufferID_);
     std::cout << "Created framebuffer with ID #" << frameBufferID_ << ", its dimensions will be [" << width << ", " << height << "]" << std::endl;
 
@@ -102,6 +105,8 @@ bool FrameBuffer::resize(GLsizei newWidth, GLsizei newHeight)
         return false;
     }
 
+    // Framebuffer itself holds no storage, its attachments are accounted for as renderbuffers / textures
+    GPUResourceRegistry::getInstance().registerResource(GPUResourceType::FrameBuffer, frameBufferID_);
     glBindFramebuffer(GL_FRAMEBUFFER, frameBufferID_);
     std::cout << "Resizing framebuffer with ID #" << frameBufferID_ << ", its dimensions will be [" << newWidth << ", " << newHeight << "]" << std::endl;
 
@@ -348,6 +353,8 @@ bool FrameBuffer::createAndBind(GLsizei width, GLsizei height)
         return false;
     }
 
+    // Framebuffer itself holds no storage, its attachments are accounted for as renderbuffers / textures
+    GPUResourceRegistry::getInstance().registerResource(GPUResourceType::FrameBuffer, frameBufferID_);
     glBindFramebuffer(GL_FRAMEBUFFER, frameBufferID_);
     std::cout << "Created framebuffer with ID #" << frameBufferID_ << ", its dimensions will be [" << width << ", " << height << "]" << std::endl;
     width_ = width;
@@ -428,6 +435,7 @@ void FrameBuffer::deleteOnlyFrameBuffer()
     }
 
     std::cout << "Deleting framebuffer with ID #" << frameBufferID_ << std::endl;
+    GPUResourceRegistry::getInstance().unregisterResource(GPUResourceType::FrameBuffer, frameBufferID_);
     glDeleteFramebuffers(1, &frameBufferID_);
     frameBufferID_ = 0;
     width_ = 0;
@@ -18,12 +18,53 @@
 #include "samplerManager.h"
 #include "matrixManager.h"
 #include "textureManager.h"
+#include "gpuResourceRegistry.h"
+#include "glStateCache.h"
 
 using namespace std;
 
 const int FreeTypeFont::CHARACTERS_TEXTURE_SIZE = 512;
 const std::string FreeTypeFont::FREETYPE_FONT_PROGRAM_KEY = "freetype_font";
 const std::string FreeTypeFont::FREETYPE_FONT_SAMPLER_KEY = "freetype_font";
+const size_t FreeTypeFont::TEXT_STREAMING_REGION_SIZE = 1024 * 1024;
+int FreeTypeFont::printBatchDepth_ = 0;
+int FreeTypeFont::numLoadedFonts_ = 0;
+bool FreeTypeFont::isStreamingEnabled_ = true;
+GLuint FreeTypeFont::textVAO_ = 0;
+VertexBufferObject FreeTypeFont::textStreamingVBO_;
+VertexBufferObject FreeTypeFont::textUploadVBO_;
+std::vector<FreeTypeFont::TextVertex> FreeTypeFont::textVertices_;
+std::vector<FreeTypeFont::TextureRun> FreeTypeFont::textureRuns_;
+
+FreeTypeFont::PrintBatch::PrintBatch()
+{
+    if (printBatchDepth_++ > 0) {
+        return;
+    }
+
+    auto& stateCache = GLStateCache::getInstance();
+    stateCache.disable(GL_DEPTH_TEST);
+    glDepthMask(0);
+    stateCache.enable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+}
+
+FreeTypeFont::PrintBatch::~PrintBatch()
+{
+    if (--printBatchDepth_ > 0) {
+        return;
+    }
+
+    auto& stateCache = GLStateCache::getInstance();
+    stateCache.disable(GL_BLEND);
+    glDepthMask(1);
+    stateCache.enable(GL_DEPTH_TEST);
+
+    // All text of the batch has been drawn, so the streamed region can be fenced
+    if (textStreamingVBO_.isStreaming()) {
+        textStreamingVBO_.finishStreamingRegion();
+    }
+}
 
 FreeTypeFont::FreeTypeFont()
 {
@@ -53,6 +94,16 @@ FreeTypeFont::~FreeTypeFont()
     deleteFont();
 }
 
+void FreeTypeFont::setStreamingEnabled(const bool enabled)
+{
+    isStreamingEnabled_ = enabled;
+}
+
+bool FreeTypeFont::isStreamingEnabled()
+{
+    return isStreamingEnabled_;
+}
+
 void FreeTypeFont::addCharacterRange(unsigned int characterFrom, unsigned int characterTo)
 {
     _characterRanges.push_back(CharacterRange(characterFrom, characterTo));
@@ -65,6 +116,8 @@ bool FreeTypeFont::loadFont(const std::string& fontFilePath, int pixelSize)
         throw std::runtime_error(string_utils::formatString("Cannot load font, because of invalid texture size (must be between 1 and {})", CHARACTERS_TEXTURE_SIZE));
     }
 
+    GPUResourceRegistry::ScopedTag registryTag("font");
+
     FT_Library freeTypeLibrary;
     FT_Face freeTypeFace;
 
@@ -85,14 +138,8 @@ bool FreeTypeFont::loadFont(const std::string& fontFilePath, int pixelSize)
     auto currentPixelPositionRow = 0;
     auto currentPixelPositionCol = 0;
     auto rowHeight = 0;
-    auto currentRenderIndex = 0;
     std::unique_ptr<Texture> texture = std::make_unique<Texture>();
 
-    glGenVertexArrays(1, &_vao);
-    glBindVertexArray(_vao);
-    _vbo.createVBO();
-    _vbo.bindVBO();
-
     auto finalizeTexture = [this, &texture, &textureData](bool createNext)
     {
         texture->createFromData(textureData.data(), CHARACTERS_TEXTURE_SIZE, CHARACTERS_TEXTURE_SIZE, GL_DEPTH_COMPONENT, true);
@@ -146,7 +193,6 @@ bool FreeTypeFont::loadFont(const std::string& fontFilePath, int pixelSize)
 
             // If character is not renderable, e.g. space, then don't prepare rendering data for it
             if (bmpWidth == 0 && bmpHeight == 0) {
-                charProps.renderIndex = -1;
                 charProps.textureIndex = -1;
                 c++;
                 continue;
@@ -159,34 +205,14 @@ bool FreeTypeFont::loadFont(const std::string& fontFilePath, int pixelSize)
                 memcpy(textureData.data() + globalRow * CHARACTERS_TEXTURE_SIZE + currentPixelPositionCol, ptrBitmap->buffer + reversedRow * bmpWidth, bmpWidth);
             }
 
-            // Setup vertices according to FreeType glyph metrics
+            // Setup quad according to FreeType glyph metrics, its vertices are generated when printing
             // You can find it here: https://www.freetype.org/freetype2/docs/glyphs/glyphs-3.html
-            glm::vec2 vertices[] =
-            {
-                glm::vec2(static_cast<float>(charProps.bearingX), static_cast<float>(charProps.bearingY)),
-                glm::vec2(static_cast<float>(charProps.bearingX), static_cast<float>(charProps.bearingY - charProps.height)),
-                glm::vec2(static_cast<float>(bmpWidth + charProps.bearingX), static_cast<float>(charProps.bearingY)),
-                glm::vec2(static_cast<float>(bmpWidth + charProps.bearingX), static_cast<float>(charProps.bearingY - charProps.height))
-            };
-
-            glm::vec2 textureCoordinates[] =
-            {
-                glm::vec2(static_cast<float>(currentPixelPositionCol) / static_cast<float>(CHARACTERS_TEXTURE_SIZE), static_cast<float>(currentPixelPositionRow + bmpHeight) / static_cast<float>(CHARACTERS_TEXTURE_SIZE)),
-                glm::vec2(static_cast<float>(currentPixelPositionCol) / static_cast<float>(CHARACTERS_TEXTURE_SIZE), static_cast<float>(currentPixelPositionRow) / static_cast<float>(CHARACTERS_TEXTURE_SIZE)),
-                glm::vec2(static_cast<float>(currentPixelPositionCol + bmpWidth) / static_cast<float>(CHARACTERS_TEXTURE_SIZE), static_cast<float>(currentPixelPositionRow + bmpHeight) / static_cast<float>(CHARACTERS_TEXTURE_SIZE)),
-                glm::vec2(static_cast<float>(currentPixelPositionCol + bmpWidth) / static_cast<float>(CHARACTERS_TEXTURE_SIZE), static_cast<float>(currentPixelPositionRow) / static_cast<float>(CHARACTERS_TEXTURE_SIZE))
-            };
-
-            for (int i = 0; i < 4; i++)
-            {
-                _vbo.addRawData(&vertices[i], sizeof(glm::vec2));
-                _vbo.addRawData(&textureCoordinates[i], sizeof(glm::vec2));
-            }
-
-            charProps.renderIndex = currentRenderIndex;
+            charProps.quadMin = glm::vec2(static_cast<float>(charProps.bearingX), static_cast<float>(charProps.bearingY - charProps.height));
+            charProps.quadMax = glm::vec2(static_cast<float>(bmpWidth + charProps.bearingX), static_cast<float>(charProps.bearingY));
+            charProps.textureCoordinatesMin = glm::vec2(static_cast<float>(currentPixelPositionCol), static_cast<float>(currentPixelPositionRow)) / static_cast<float>(CHARACTERS_TEXTURE_SIZE);
+            charProps.textureCoordinatesMax = glm::vec2(static_cast<float>(currentPixelPositionCol + bmpWidth), static_cast<float>(currentPixelPositionRow + bmpHeight)) / static_cast<float>(CHARACTERS_TEXTURE_SIZE);
             charProps.textureIndex = static_cast<int>(_textures.size());
             currentPixelPositionCol += bmpWidth + 1;
-            currentRenderIndex += 4;
             c++;
         }
     }
@@ -196,14 +222,9 @@ bool FreeTypeFont::loadFont(const std::string& fontFilePath, int pixelSize)
         finalizeTexture(false);
     }
 
-    _vbo.uploadDataToGPU(GL_STATIC_DRAW);
-    // Setup vertex positions pointers
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2)*2, reinterpret_cast<void*>(0));
-
-    // Setup texture coordinates pointers
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2)*2, reinterpret_cast<void*>(sizeof(glm::vec2)));
+    if (numLoadedFonts_++ == 0) {
+        createSharedTextBuffers();
+    }
 
     // Now we're done with loading, release FreeType structures
     FT_Done_Face(freeTypeFace);
@@ -220,26 +241,52 @@ void FreeTypeFont::printInternal(int x, int y, const std::string& text, int pixe
         return;
     }
 
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(0);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    // Sets up the text rendering state, unless some print batch has done it already
+    PrintBatch printBatch;
 
-    auto& shaderProgram = getFreetypeFontShaderProgram();
-    shaderProgram.useProgram();
-    shaderProgram[ShaderConstants::projectionMatrix()] = MatrixManager::getInstance().getOrthoProjectionMatrix();
-    shaderProgram[ShaderConstants::color()] = _color;
+    // Every renderable character is one quad made of two triangles
+    size_t numVertices = 0;
+    for (const auto& c : text)
+    {
+        const auto it = _characterProperties.find(c);
+        if (it != _characterProperties.end() && it->second.textureIndex != -1) {
+            numVertices += 6;
+        }
+    }
 
-    getFreetypeFontSampler().bind();
-    shaderProgram[ShaderConstants::sampler()] = 0;
+    if (numVertices == 0) {
+        return;
+    }
+
+    // Stream the quads into the mapped ring, when the current region is full, fence it and move on to the next one.
+    // Text, that doesn't fit even into a whole region, is re-specified into the upload buffer as usual
+    const auto dataSizeBytes = numVertices * sizeof(TextVertex);
+    size_t byteOffset = 0;
+    TextVertex* vertices = nullptr;
+    if (isStreamingEnabled_ && textStreamingVBO_.isStreaming())
+    {
+        if (textStreamingVBO_.getStreamingRegionBytesLeft() < dataSizeBytes) {
+            textStreamingVBO_.finishStreamingRegion();
+        }
+
+        if (textStreamingVBO_.getStreamingRegionBytesLeft() >= dataSizeBytes) {
+            vertices = static_cast<TextVertex*>(textStreamingVBO_.reserveStreamingData(dataSizeBytes, byteOffset));
+        }
+    }
+
+    const auto isStreamed = vertices != nullptr;
+    if (!isStreamed)
+    {
+        textVertices_.resize(numVertices);
+        vertices = textVertices_.data();
+    }
 
+    // Generate the quads in screen space, consecutive characters from the same atlas are drawn together
     glm::vec2 currentPos(x, y);
     const auto usedPixelSize = pixelSize == -1 ? _pixelSize : pixelSize;
-    auto lastBoundTextureIndex = -1;
     const auto scale = static_cast<float>(usedPixelSize) / static_cast<float>(_pixelSize);
-
-    glBindVertexArray(_vao);
-    for(const auto& c : text)
+    textureRuns_.clear();
+    for (const auto& c : text)
     {
         if (c == '\n' || c == '\r')
         {
@@ -249,31 +296,65 @@ void FreeTypeFont::printInternal(int x, int y, const std::string& text, int pixe
         }
 
         // If we somehow stumble upon unknown character, ignore it
-        if (_characterProperties.count(c) == 0) {
+        const auto it = _characterProperties.find(c);
+        if (it == _characterProperties.end()) {
             continue;
         }
 
-        const auto& props = _characterProperties.at(c);
-        if (props.renderIndex != -1)
+        const auto& props = it->second;
+        if (props.textureIndex != -1)
         {
-            if (lastBoundTextureIndex != props.textureIndex)
-            {
-                lastBoundTextureIndex = props.textureIndex;
-                _textures.at(props.textureIndex)->bind();
+            if (textureRuns_.empty() || textureRuns_.back().textureIndex != props.textureIndex) {
+                textureRuns_.push_back(TextureRun{ props.textureIndex, 0 });
             }
 
-            glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(currentPos.x, currentPos.y, 0.0f));
-            model = glm::scale(model, glm::vec3(scale, scale, 1.0f));
-            shaderProgram[ShaderConstants::modelMatrix()] = model;
-            glDrawArrays(GL_TRIANGLE_STRIP, props.renderIndex, 4);
+            const auto quadMin = currentPos + props.quadMin*scale;
+            const auto quadMax = currentPos + props.quadMax*scale;
+            const auto& texMin = props.textureCoordinatesMin;
+            const auto& texMax = props.textureCoordinatesMax;
+            *vertices++ = TextVertex{ quadMin, texMin };
+            *vertices++ = TextVertex{ glm::vec2(quadMax.x, quadMin.y), glm::vec2(texMax.x, texMin.y) };
+            *vertices++ = TextVertex{ quadMax, texMax };
+            *vertices++ = TextVertex{ quadMin, texMin };
+            *vertices++ = TextVertex{ quadMax, texMax };
+            *vertices++ = TextVertex{ glm::vec2(quadMin.x, quadMax.y), glm::vec2(texMin.x, texMax.y) };
+            textureRuns_.back().numVertices += 6;
         }
 
         currentPos.x += props.advanceX*scale;
     }
 
-    glDisable(GL_BLEND);
-    glDepthMask(1);
-    glEnable(GL_DEPTH_TEST);
+    auto& shaderProgram = getFreetypeFontShaderProgram();
+    shaderProgram.useProgram();
+    shaderProgram[ShaderConstants::projectionMatrix()] = MatrixManager::getInstance().getOrthoProjectionMatrix();
+    shaderProgram[ShaderConstants::modelMatrix()] = glm::mat4(1.0f);
+    shaderProgram[ShaderConstants::color()] = _color;
+
+    getFreetypeFontSampler().bind();
+    shaderProgram[ShaderConstants::sampler()] = 0;
+
+    GLStateCache::getInstance().bindVertexArray(textVAO_);
+    if (isStreamed) {
+        textStreamingVBO_.bindVBO();
+    }
+    else
+    {
+        textUploadVBO_.bindVBO();
+        textUploadVBO_.addRawData(textVertices_.data(), dataSizeBytes);
+        textUploadVBO_.uploadDataToGPU(GL_STREAM_DRAW);
+    }
+
+    // Streamed quads start somewhere within the ring, so the pointers are set up for every print
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(TextVertex), reinterpret_cast<void*>(byteOffset));
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(TextVertex), reinterpret_cast<void*>(byteOffset + sizeof(glm::vec2)));
+
+    GLint firstVertex = 0;
+    for (const auto& textureRun : textureRuns_)
+    {
+        _textures.at(textureRun.textureIndex)->bind();
+        glDrawArrays(GL_TRIANGLES, firstVertex, textureRun.numVertices);
+        firstVertex += textureRun.numVertices;
+    }
 }
 
 int FreeTypeFont::getTextWidth(const std::string& text, int pixelSize) const
@@ -341,8 +422,30 @@ void FreeTypeFont::deleteFont()
     _characterProperties.clear();
     _characterRanges.clear();
 
-    _vbo.deleteVBO();
-    glDeleteVertexArrays(1, &_vao);
-    
+    if (--numLoadedFonts_ == 0) {
+        deleteSharedTextBuffers();
+    }
+
     _isLoaded = false;
 }
+
+void FreeTypeFont::createSharedTextBuffers()
+{
+    glGenVertexArrays(1, &textVAO_);
+    GLStateCache::getInstance().bindVertexArray(textVAO_);
+    glEnableVertexAttribArray(0);
+    glEnableVertexAttribArray(1);
+
+    // Streaming buffer needs buffer storage, without it all text is re-specified into the upload buffer
+    textStreamingVBO_.createStreamingVBO(TEXT_STREAMING_REGION_SIZE);
+    textUploadVBO_.createVBO();
+}
+
+void FreeTypeFont::deleteSharedTextBuffers()
+{
+    textStreamingVBO_.deleteVBO();
+    textUploadVBO_.deleteVBO();
+    GLStateCache::getInstance().onVertexArrayDeleted(textVAO_);
+    glDeleteVertexArrays(1, &textVAO_);
+    textVAO_ = 0;
+}
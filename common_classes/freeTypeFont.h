@@ -23,9 +23,35 @@ public:
     static const std::string FREETYPE_FONT_PROGRAM_KEY; // Key for shader program for rendering fonts in 2D
     static const std::string FREETYPE_FONT_SAMPLER_KEY; // Key for sampler used for rendering fonts
 
+    /**
+     * RAII helper, that sets up rendering state for text (no depth test, alpha blending) once for all prints
+     * made during its lifetime and restores the scene state at its end. Prints made outside of any batch
+     * set up and restore the state on their own.
+     */
+    class PrintBatch
+    {
+    public:
+        PrintBatch();
+        ~PrintBatch();
+
+        PrintBatch(const PrintBatch&) = delete; // No copy constructor allowed
+        void operator=(const PrintBatch&) = delete; // No copy assignment allowed
+    };
+
     FreeTypeFont();
     ~FreeTypeFont();
 
+    /**
+     * Chooses, how are the quads of printed text uploaded - streamed into persistently mapped ring buffer (default)
+     * or re-specified with glBufferData for every print. Applies to all fonts.
+     */
+    static void setStreamingEnabled(bool enabled);
+
+    /**
+     * Checks, if the quads of printed text are streamed into persistently mapped ring buffer.
+     */
+    static bool isStreamingEnabled();
+
     /**
      * Adds character range to load from the fonts.
      *
@@ -126,6 +152,34 @@ private:
      */
     const Sampler& getFreetypeFontSampler() const;
 
+    /**
+     * Vertex of a character quad, as it's streamed to the GPU.
+     */
+    struct TextVertex
+    {
+        glm::vec2 position; // Position in screen space
+        glm::vec2 textureCoordinate; // Texture coordinate within the texture atlas
+    };
+
+    /**
+     * Run of consecutive character quads, that use the same texture atlas.
+     */
+    struct TextureRun
+    {
+        int textureIndex; // Index of the texture atlas
+        GLsizei numVertices; // Number of vertices of the run
+    };
+
+    /**
+     * Creates vertex array object and buffers shared by all fonts for rendering text.
+     */
+    static void createSharedTextBuffers();
+
+    /**
+     * Deletes vertex array object and buffers shared by all fonts.
+     */
+    static void deleteSharedTextBuffers();
+
     /**
      * Helper struct that holds properties of one character.
      */
@@ -141,8 +195,11 @@ private:
         int bearingY;
 
         // These are our properties used for rendering
-        int renderIndex;
-        int textureIndex;
+        glm::vec2 quadMin; // Bottom-left corner of the character quad (relative to the pen position)
+        glm::vec2 quadMax; // Top-right corner of the character quad (relative to the pen position)
+        glm::vec2 textureCoordinatesMin; // Texture coordinates of the bottom-left corner
+        glm::vec2 textureCoordinatesMax; // Texture coordinates of the top-right corner
+        int textureIndex; // Index of the texture atlas (-1, if the character isn't renderable, e.g. space)
     };
 
     /**
@@ -167,6 +224,14 @@ private:
 
     std::vector<std::unique_ptr<Texture>> _textures; // Vector holding all texture atlases
     std::map<int, CharacterProperties> _characterProperties; // Map holding properties of each loaded character
-    GLuint _vao; // VAO for characters rendering
-    VertexBufferObject _vbo; // VBO holding characters rendering data
+
+    static const size_t TEXT_STREAMING_REGION_SIZE; // Size of one region of the text streaming buffer (maximal text data per frame)
+    static int printBatchDepth_; // Number of currently alive print batches
+    static int numLoadedFonts_; // Number of loaded fonts sharing text rendering buffers
+    static bool isStreamingEnabled_; // Whether text quads are streamed or re-specified for every print
+    static GLuint textVAO_; // VAO for text rendering, shared by all fonts
+    static VertexBufferObject textStreamingVBO_; // Persistently mapped ring buffer, where text quads are streamed
+    static VertexBufferObject textUploadVBO_; // Buffer re-specified with text quads for every print (when not streaming)
+    static std::vector<TextVertex> textVertices_; // Scratch memory for text quads uploaded with re-specification
+    static std::vector<TextureRun> textureRuns_; // Scratch memory for texture runs of the printed text
 };
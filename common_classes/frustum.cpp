@@ -0,0 +1,91 @@
+// Project
+#include "frustum.h"
+#include "matrixManager.h"
+
+Frustum::Frustum()
+{
+    for (auto& plane : planes_) {
+        plane = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+}
+
+Frustum::Frustum(const glm::mat4& projectionViewMatrix)
+{
+    // Gribb-Hartmann plane extraction - every plane is the fourth row of the matrix plus / minus one of the other rows
+    const auto& m = projectionViewMatrix;
+    const glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    const glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    const glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    const glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    planes_[0] = row3 + row0;
+    planes_[1] = row3 - row0;
+    planes_[2] = row3 + row1;
+    planes_[3] = row3 - row1;
+    planes_[4] = row3 + row2;
+    planes_[5] = row3 - row2;
+
+    // Normalize the planes, so that the plane equation gives real distance and spheres can be tested
+    for (auto& plane : planes_)
+    {
+        const auto normalLength = glm::length(glm::vec3(plane));
+        if (normalLength > 0.0f) {
+            plane /= normalLength;
+        }
+    }
+}
+
+Frustum Frustum::fromMatrixManager()
+{
+    const auto& mm = MatrixManager::getInstance();
+    return Frustum(mm.getProjectionMatrix() * mm.getViewMatrix());
+}
+
+const glm::vec4& Frustum::getPlane(const int index) const
+{
+    return planes_[index];
+}
+
+bool Frustum::isSphereVisible(const BoundingSphere& sphere) const
+{
+    for (const auto& plane : planes_)
+    {
+        if (glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Frustum::isAABBVisible(const AABB& box) const
+{
+    auto planeMask = ALL_PLANES_MASK;
+    return classifyAABB(box, planeMask) != Containment::Outside;
+}
+
+Frustum::Containment Frustum::classifyAABB(const AABB& box, int& planeMask) const
+{
+    const auto center = box.getCenter();
+    const auto extents = box.getExtents();
+    for (auto i = 0; i < NUM_PLANES; i++)
+    {
+        if ((planeMask & (1 << i)) == 0) {
+            continue;
+        }
+
+        // Projected radius of the box onto the plane normal
+        const auto& plane = planes_[i];
+        const auto distance = glm::dot(glm::vec3(plane), center) + plane.w;
+        const auto radius = glm::dot(glm::abs(glm::vec3(plane)), extents);
+        if (distance < -radius) {
+            return Containment::Outside;
+        }
+
+        if (distance >= radius) {
+            planeMask &= ~(1 << i);
+        }
+    }
+
+    return planeMask == 0 ? Containment::Inside : Containment::Intersecting;
+}
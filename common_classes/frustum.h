@@ -0,0 +1,75 @@
+#pragma once
+
+// GLM
+#include <glm/glm.hpp>
+
+// Project
+#include "boundingVolumes.h"
+
+/**
+ * View frustum represented by six planes with normals pointing inside. Point p is inside of the plane,
+ * if dot(plane.xyz, p) + plane.w >= 0.
+ */
+class Frustum
+{
+public:
+    static const int NUM_PLANES = 6; // Left, right, bottom, top, near and far plane
+    static const int ALL_PLANES_MASK = (1 << NUM_PLANES) - 1; // Plane mask with all planes to be tested
+
+    /**
+     * Result of testing bounding volume against the frustum.
+     */
+    enum class Containment
+    {
+        Outside, // Volume is completely outside
+        Intersecting, // Volume intersects some planes
+        Inside // Volume is completely inside
+    };
+
+    /**
+     * Creates frustum, that contains everything (all planes are degenerate).
+     */
+    Frustum();
+
+    /**
+     * Extracts frustum planes from the combined projection and view matrix (planes are in world space then).
+     *
+     * @param projectionViewMatrix  Projection matrix multiplied with view matrix
+     */
+    explicit Frustum(const glm::mat4& projectionViewMatrix);
+
+    /**
+     * Extracts frustum from the current projection and view matrix of the MatrixManager.
+     */
+    static Frustum fromMatrixManager();
+
+    /**
+     * Gets plane with given index (normalized, normal pointing inside).
+     */
+    const glm::vec4& getPlane(int index) const;
+
+    /**
+     * Checks, if the sphere is at least partially inside the frustum.
+     */
+    bool isSphereVisible(const BoundingSphere& sphere) const;
+
+    /**
+     * Checks, if the box is at least partially inside the frustum. Test is conservative - box near the frustum
+     * corner might be reported as visible, even though it's not.
+     */
+    bool isAABBVisible(const AABB& box) const;
+
+    /**
+     * Classifies the box against the planes in the plane mask. Planes, that the box is completely inside of,
+     * are removed from the mask, so that children of hierarchy don't have to test them again.
+     *
+     * @param box        Box to test
+     * @param planeMask  Bit mask of planes to test, it's updated by the test
+     *
+     * @return Whether the box is outside, intersecting or inside the tested planes.
+     */
+    Containment classifyAABB(const AABB& box, int& planeMask) const;
+
+private:
+    glm::vec4 planes_[NUM_PLANES]; // Frustum planes
+};
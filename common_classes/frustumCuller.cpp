@@ -0,0 +1,266 @@
+// STL
+#include <cmath>
+
+// SIMD intrinsics (AVX when the compiler targets it, SSE on every x86-64 compiler, plain C++ otherwise)
+#if defined(__AVX__)
+#define FRUSTUM_CULLER_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRUSTUM_CULLER_SSE
+#include <emmintrin.h>
+#endif
+
+// Project
+#include "frustumCuller.h"
+
+void FrustumCuller::clear()
+{
+    centersX_.clear();
+    centersY_.clear();
+    centersZ_.clear();
+    extentsX_.clear();
+    extentsY_.clear();
+    extentsZ_.clear();
+    radii_.clear();
+}
+
+void FrustumCuller::reserve(const size_t numVolumes)
+{
+    centersX_.reserve(numVolumes);
+    centersY_.reserve(numVolumes);
+    centersZ_.reserve(numVolumes);
+    extentsX_.reserve(numVolumes);
+    extentsY_.reserve(numVolumes);
+    extentsZ_.reserve(numVolumes);
+    radii_.reserve(numVolumes);
+}
+
+size_t FrustumCuller::addAABB(const AABB& box)
+{
+    const auto index = getNumVolumes();
+    centersX_.push_back(0.0f);
+    centersY_.push_back(0.0f);
+    centersZ_.push_back(0.0f);
+    extentsX_.push_back(0.0f);
+    extentsY_.push_back(0.0f);
+    extentsZ_.push_back(0.0f);
+    radii_.push_back(0.0f);
+    setAABB(index, box);
+    return index;
+}
+
+size_t FrustumCuller::addSphere(const BoundingSphere& sphere)
+{
+    const auto index = addAABB(AABB::fromCenterAndExtents(sphere.center, glm::vec3(0.0f)));
+    radii_[index] = sphere.radius;
+    return index;
+}
+
+void FrustumCuller::setAABB(const size_t index, const AABB& box)
+{
+    const auto center = box.getCenter();
+    const auto extents = box.getExtents();
+    centersX_[index] = center.x;
+    centersY_[index] = center.y;
+    centersZ_[index] = center.z;
+    extentsX_[index] = extents.x;
+    extentsY_[index] = extents.y;
+    extentsZ_[index] = extents.z;
+    radii_[index] = 0.0f;
+}
+
+void FrustumCuller::setSphere(const size_t index, const BoundingSphere& sphere)
+{
+    setAABB(index, AABB::fromCenterAndExtents(sphere.center, glm::vec3(0.0f)));
+    radii_[index] = sphere.radius;
+}
+
+size_t FrustumCuller::getNumVolumes() const
+{
+    return radii_.size();
+}
+
+void FrustumCuller::cull(const Frustum& frustum, std::vector<uint8_t>& outVisibility) const
+{
+    const auto planes = preparePlanes(frustum);
+    const auto numVolumes = getNumVolumes();
+    const auto batchSize = getBatchSize();
+    outVisibility.resize(numVolumes);
+
+    size_t i = 0;
+    if (batchSize > 1)
+    {
+        for (; i + batchSize <= numVolumes; i += batchSize)
+        {
+            const auto visibleMask = testBatch(planes, i);
+            for (size_t j = 0; j < batchSize; j++) {
+                outVisibility[i + j] = static_cast<uint8_t>((visibleMask >> j) & 1);
+            }
+        }
+    }
+
+    // Remaining volumes, that don't fill the whole batch
+    for (; i < numVolumes; i++) {
+        outVisibility[i] = testSingle(planes, i) ? 1 : 0;
+    }
+}
+
+void FrustumCuller::cull(const Frustum& frustum, std::vector<uint32_t>& outVisibleIndices) const
+{
+    const auto planes = preparePlanes(frustum);
+    const auto numVolumes = getNumVolumes();
+    const auto batchSize = getBatchSize();
+    outVisibleIndices.clear();
+
+    size_t i = 0;
+    if (batchSize > 1)
+    {
+        for (; i + batchSize <= numVolumes; i += batchSize)
+        {
+            // Go only through the set bits, whole batches are usually either visible or culled
+            auto visibleMask = testBatch(planes, i);
+            while (visibleMask != 0)
+            {
+                auto bitIndex = 0u;
+                while ((visibleMask & (1u << bitIndex)) == 0) {
+                    bitIndex++;
+                }
+
+                outVisibleIndices.push_back(static_cast<uint32_t>(i + bitIndex));
+                visibleMask &= visibleMask - 1;
+            }
+        }
+    }
+
+    for (; i < numVolumes; i++)
+    {
+        if (testSingle(planes, i)) {
+            outVisibleIndices.push_back(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+void FrustumCuller::setSIMDEnabled(const bool enabled)
+{
+    isSIMDEnabled_ = enabled;
+}
+
+bool FrustumCuller::isSIMDEnabled() const
+{
+    return isSIMDEnabled_;
+}
+
+const char* FrustumCuller::getSIMDInstructionSet()
+{
+#if defined(FRUSTUM_CULLER_AVX)
+    return "AVX";
+#elif defined(FRUSTUM_CULLER_SSE)
+    return "SSE";
+#else
+    return "none";
+#endif
+}
+
+FrustumCuller::PreparedPlanes FrustumCuller::preparePlanes(const Frustum& frustum)
+{
+    PreparedPlanes result;
+    for (auto i = 0; i < Frustum::NUM_PLANES; i++)
+    {
+        const auto& plane = frustum.getPlane(i);
+        result.normalX[i] = plane.x;
+        result.normalY[i] = plane.y;
+        result.normalZ[i] = plane.z;
+        result.absNormalX[i] = std::fabs(plane.x);
+        result.absNormalY[i] = std::fabs(plane.y);
+        result.absNormalZ[i] = std::fabs(plane.z);
+        result.distance[i] = plane.w;
+    }
+
+    return result;
+}
+
+size_t FrustumCuller::getBatchSize() const
+{
+    if (!isSIMDEnabled_) {
+        return 1;
+    }
+
+#if defined(FRUSTUM_CULLER_AVX)
+    return 8;
+#elif defined(FRUSTUM_CULLER_SSE)
+    return 4;
+#else
+    return 1;
+#endif
+}
+
+uint32_t FrustumCuller::testBatch(const PreparedPlanes& planes, const size_t firstIndex) const
+{
+    // Volume is outside, if it's completely behind any plane: dot(n, c) + d < -(dot(|n|, e) + r)
+#if defined(FRUSTUM_CULLER_AVX)
+    const auto centerX = _mm256_loadu_ps(centersX_.data() + firstIndex);
+    const auto centerY = _mm256_loadu_ps(centersY_.data() + firstIndex);
+    const auto centerZ = _mm256_loadu_ps(centersZ_.data() + firstIndex);
+    const auto extentX = _mm256_loadu_ps(extentsX_.data() + firstIndex);
+    const auto extentY = _mm256_loadu_ps(extentsY_.data() + firstIndex);
+    const auto extentZ = _mm256_loadu_ps(extentsZ_.data() + firstIndex);
+    const auto radius = _mm256_loadu_ps(radii_.data() + firstIndex);
+
+    auto outside = _mm256_setzero_ps();
+    for (auto i = 0; i < Frustum::NUM_PLANES; i++)
+    {
+        auto distance = _mm256_add_ps(_mm256_mul_ps(centerX, _mm256_set1_ps(planes.normalX[i])), _mm256_set1_ps(planes.distance[i]));
+        distance = _mm256_add_ps(distance, _mm256_mul_ps(centerY, _mm256_set1_ps(planes.normalY[i])));
+        distance = _mm256_add_ps(distance, _mm256_mul_ps(centerZ, _mm256_set1_ps(planes.normalZ[i])));
+
+        auto projectedRadius = _mm256_add_ps(_mm256_mul_ps(extentX, _mm256_set1_ps(planes.absNormalX[i])), radius);
+        projectedRadius = _mm256_add_ps(projectedRadius, _mm256_mul_ps(extentY, _mm256_set1_ps(planes.absNormalY[i])));
+        projectedRadius = _mm256_add_ps(projectedRadius, _mm256_mul_ps(extentZ, _mm256_set1_ps(planes.absNormalZ[i])));
+
+        // distance + radius < 0 means outside of this plane
+        outside = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, projectedRadius), _mm256_setzero_ps(), _CMP_LT_OQ));
+    }
+
+    return static_cast<uint32_t>(~_mm256_movemask_ps(outside)) & 0xFFu;
+#elif defined(FRUSTUM_CULLER_SSE)
+    const auto centerX = _mm_loadu_ps(centersX_.data() + firstIndex);
+    const auto centerY = _mm_loadu_ps(centersY_.data() + firstIndex);
+    const auto centerZ = _mm_loadu_ps(centersZ_.data() + firstIndex);
+    const auto extentX = _mm_loadu_ps(extentsX_.data() + firstIndex);
+    const auto extentY = _mm_loadu_ps(extentsY_.data() + firstIndex);
+    const auto extentZ = _mm_loadu_ps(extentsZ_.data() + firstIndex);
+    const auto radius = _mm_loadu_ps(radii_.data() + firstIndex);
+
+    auto outside = _mm_setzero_ps();
+    for (auto i = 0; i < Frustum::NUM_PLANES; i++)
+    {
+        auto distance = _mm_add_ps(_mm_mul_ps(centerX, _mm_set1_ps(planes.normalX[i])), _mm_set1_ps(planes.distance[i]));
+        distance = _mm_add_ps(distance, _mm_mul_ps(centerY, _mm_set1_ps(planes.normalY[i])));
+        distance = _mm_add_ps(distance, _mm_mul_ps(centerZ, _mm_set1_ps(planes.normalZ[i])));
+
+        auto projectedRadius = _mm_add_ps(_mm_mul_ps(extentX, _mm_set1_ps(planes.absNormalX[i])), radius);
+        projectedRadius = _mm_add_ps(projectedRadius, _mm_mul_ps(extentY, _mm_set1_ps(planes.absNormalY[i])));
+        projectedRadius = _mm_add_ps(projectedRadius, _mm_mul_ps(extentZ, _mm_set1_ps(planes.absNormalZ[i])));
+
+        outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, projectedRadius), _mm_setzero_ps()));
+    }
+
+    return static_cast<uint32_t>(~_mm_movemask_ps(outside)) & 0xFu;
+#else
+    return testSingle(planes, firstIndex) ? 1u : 0u;
+#endif
+}
+
+bool FrustumCuller::testSingle(const PreparedPlanes& planes, const size_t index) const
+{
+    for (auto i = 0; i < Frustum::NUM_PLANES; i++)
+    {
+        const auto distance = planes.normalX[i] * centersX_[index] + planes.normalY[i] * centersY_[index] + planes.normalZ[i] * centersZ_[index] + planes.distance[i];
+        const auto projectedRadius = planes.absNormalX[i] * extentsX_[index] + planes.absNormalY[i] * extentsY_[index] + planes.absNormalZ[i] * extentsZ_[index] + radii_[index];
+        if (distance + projectedRadius < 0.0f) {
+            return false;
+        }
+    }
+
+    return true;
+}
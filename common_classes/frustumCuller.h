@@ -0,0 +1,134 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <vector>
+
+// Project
+#include "boundingVolumes.h"
+#include "frustum.h"
+
+/**
+ * Culls many bounding volumes against the frustum at once. Volumes are stored as structure of arrays (all centers X,
+ * then all centers Y etc.), so that SSE tests 4 and AVX tests 8 volumes with one instruction. Every volume is a box
+ * (center + extents) grown by a radius, so boxes (radius 0) and spheres (extents 0) share the same kernel.
+ */
+class FrustumCuller
+{
+public:
+    /**
+     * Removes all bounding volumes.
+     */
+    void clear();
+
+    /**
+     * Reserves memory for given number of bounding volumes.
+     */
+    void reserve(size_t numVolumes);
+
+    /**
+     * Adds bounding box.
+     *
+     * @return Index of the added volume.
+     */
+    size_t addAABB(const AABB& box);
+
+    /**
+     * Adds bounding sphere.
+     *
+     * @return Index of the added volume.
+     */
+    size_t addSphere(const BoundingSphere& sphere);
+
+    /**
+     * Replaces volume with given index by the bounding box (e.g. when the object moves).
+     */
+    void setAABB(size_t index, const AABB& box);
+
+    /**
+     * Replaces volume with given index by the bounding sphere.
+     */
+    void setSphere(size_t index, const BoundingSphere& sphere);
+
+    /**
+     * Gets number of stored bounding volumes.
+     */
+    size_t getNumVolumes() const;
+
+    /**
+     * Tests all volumes against the frustum and writes 1 for visible and 0 for culled volume.
+     *
+     * @param frustum        Frustum to cull against
+     * @param outVisibility  Visibility per volume (resized to number of volumes)
+     */
+    void cull(const Frustum& frustum, std::vector<uint8_t>& outVisibility) const;
+
+    /**
+     * Tests all volumes against the frustum and gathers indices of visible volumes.
+     *
+     * @param frustum            Frustum to cull against
+     * @param outVisibleIndices  Indices of visible volumes in ascending order (cleared first)
+     */
+    void cull(const Frustum& frustum, std::vector<uint32_t>& outVisibleIndices) const;
+
+    /**
+     * Enables or disables SIMD kernel (when disabled, volumes are tested one by one, e.g. for comparison).
+     */
+    void setSIMDEnabled(bool enabled);
+
+    /**
+     * Checks, if SIMD kernel is enabled.
+     */
+    bool isSIMDEnabled() const;
+
+    /**
+     * Gets name of the instruction set the SIMD kernel has been compiled with ("AVX", "SSE" or "none").
+     */
+    static const char* getSIMDInstructionSet();
+
+private:
+    /**
+     * Frustum planes prepared for testing (normals, their absolute values and distances).
+     */
+    struct PreparedPlanes
+    {
+        float normalX[Frustum::NUM_PLANES];
+        float normalY[Frustum::NUM_PLANES];
+        float normalZ[Frustum::NUM_PLANES];
+        float absNormalX[Frustum::NUM_PLANES];
+        float absNormalY[Frustum::NUM_PLANES];
+        float absNormalZ[Frustum::NUM_PLANES];
+        float distance[Frustum::NUM_PLANES];
+    };
+
+    /**
+     * Prepares planes of the frustum for testing.
+     */
+    static PreparedPlanes preparePlanes(const Frustum& frustum);
+
+    /**
+     * Gets number of volumes tested by SIMD kernel at once (1 if SIMD is disabled or not available).
+     */
+    size_t getBatchSize() const;
+
+    /**
+     * Tests one batch of volumes starting at given index with the SIMD kernel.
+     *
+     * @return Bit mask, where i-th bit is set if volume (firstIndex + i) is visible.
+     */
+    uint32_t testBatch(const PreparedPlanes& planes, size_t firstIndex) const;
+
+    /**
+     * Tests one volume without SIMD.
+     */
+    bool testSingle(const PreparedPlanes& planes, size_t index) const;
+
+    std::vector<float> centersX_; // X coordinates of volume centers
+    std::vector<float> centersY_; // Y coordinates of volume centers
+    std::vector<float> centersZ_; // Z coordinates of volume centers
+    std::vector<float> extentsX_; // Box half-sizes along X
+    std::vector<float> extentsY_; // Box half-sizes along Y
+    std::vector<float> extentsZ_; // Box half-sizes along Z
+    std::vector<float> radii_; // Radii, that the boxes are grown by
+    bool isSIMDEnabled_{ true }; // Flag telling, whether SIMD kernel is used
+};
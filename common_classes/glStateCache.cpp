@@ -0,0 +1,271 @@
+// STL
+#include <algorithm>
+#include <iterator>
+
+// Project
+#include "glStateCache.h"
+
+const GLuint GLStateCache::UNKNOWN;
+
+namespace {
+
+const GLenum TRACKED_BUFFER_TARGETS[] = {
+    GL_ARRAY_BUFFER,
+    GL_ELEMENT_ARRAY_BUFFER,
+    GL_UNIFORM_BUFFER,
+    GL_COPY_READ_BUFFER,
+    GL_COPY_WRITE_BUFFER,
+    GL_TRANSFORM_FEEDBACK_BUFFER,
+    GL_PIXEL_PACK_BUFFER,
+    GL_PIXEL_UNPACK_BUFFER
+};
+
+} // namespace
+
+GLStateCache::GLStateCache()
+{
+    static_assert(sizeof(TRACKED_BUFFER_TARGETS) / sizeof(GLenum) == NUM_TRACKED_BUFFER_TARGETS, "Tracked buffer targets count mismatch!");
+    invalidate();
+}
+
+GLStateCache& GLStateCache::getInstance()
+{
+    static GLStateCache cache;
+    return cache;
+}
+
+void GLStateCache::useProgram(const GLuint programID)
+{
+    if (updateValue(boundProgram_, programID)) {
+        glUseProgram(programID);
+    }
+}
+
+void GLStateCache::bindVertexArray(const GLuint vertexArrayID)
+{
+    if (updateValue(boundVertexArray_, vertexArrayID))
+    {
+        glBindVertexArray(vertexArrayID);
+        boundBuffers_[getBufferTargetIndex(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+    }
+}
+
+void GLStateCache::bindBuffer(const GLenum target, const GLuint bufferID)
+{
+    const auto targetIndex = getBufferTargetIndex(target);
+    if (targetIndex == -1)
+    {
+        currentFrameStatistics_.numIssuedCalls++;
+        glBindBuffer(target, bufferID);
+        return;
+    }
+
+    if (updateValue(boundBuffers_[targetIndex], bufferID)) {
+        glBindBuffer(target, bufferID);
+    }
+}
+
+void GLStateCache::bindBufferBase(const GLenum target, const GLuint index, const GLuint bufferID)
+{
+    currentFrameStatistics_.numIssuedCalls++;
+    glBindBufferBase(target, index, bufferID);
+
+    const auto targetIndex = getBufferTargetIndex(target);
+    if (targetIndex != -1) {
+        boundBuffers_[targetIndex] = bufferID;
+    }
+}
+
+void GLStateCache::bindBufferRange(const GLenum target, const GLuint index, const GLuint bufferID, const GLintptr offset, const GLsizeiptr size)
+{
+    currentFrameStatistics_.numIssuedCalls++;
+    glBindBufferRange(target, index, bufferID, offset, size);
+
+    const auto targetIndex = getBufferTargetIndex(target);
+    if (targetIndex != -1) {
+        boundBuffers_[targetIndex] = bufferID;
+    }
+}
+
+void GLStateCache::bindTexture2D(const GLuint textureUnit, const GLuint textureID)
+{
+    auto& boundTexture = getUnitValue(boundTextures2D_, textureUnit);
+    if (isCachingEnabled_ && boundTexture == textureID)
+    {
+        currentFrameStatistics_.numSkippedCalls++;
+        return;
+    }
+
+    // Texture is bound to the active unit, so switch it first if necessary
+    if (updateValue(activeTextureUnit_, textureUnit)) {
+        glActiveTexture(GL_TEXTURE0 + textureUnit);
+    }
+
+    boundTexture = textureID;
+    currentFrameStatistics_.numIssuedCalls++;
+    glBindTexture(GL_TEXTURE_2D, textureID);
+}
+
+void GLStateCache::bindSampler(const GLuint textureUnit, const GLuint samplerID)
+{
+    if (updateValue(getUnitValue(boundSamplers_, textureUnit), samplerID)) {
+        glBindSampler(textureUnit, samplerID);
+    }
+}
+
+void GLStateCache::enable(const GLenum capability)
+{
+    setCapability(capability, true);
+}
+
+void GLStateCache::disable(const GLenum capability)
+{
+    setCapability(capability, false);
+}
+
+void GLStateCache::setCapability(const GLenum capability, const bool enabled)
+{
+    if (!updateValue(getCapabilityState(capability), enabled ? 1 : 0)) {
+        return;
+    }
+
+    if (enabled) {
+        glEnable(capability);
+    }
+    else {
+        glDisable(capability);
+    }
+}
+
+void GLStateCache::setPrimitiveRestartIndex(const GLuint index)
+{
+    if (isCachingEnabled_ && isPrimitiveRestartIndexKnown_ && primitiveRestartIndex_ == index)
+    {
+        currentFrameStatistics_.numSkippedCalls++;
+        return;
+    }
+
+    primitiveRestartIndex_ = index;
+    isPrimitiveRestartIndexKnown_ = true;
+    currentFrameStatistics_.numIssuedCalls++;
+    glPrimitiveRestartIndex(index);
+}
+
+void GLStateCache::onProgramDeleted(const GLuint programID)
+{
+    // Program in use is only flagged for deletion, so we can't tell, what is current anymore
+    if (boundProgram_ == programID) {
+        boundProgram_ = UNKNOWN;
+    }
+}
+
+void GLStateCache::onVertexArrayDeleted(const GLuint vertexArrayID)
+{
+    // Deleting bound VAO reverts binding to zero
+    if (boundVertexArray_ == vertexArrayID)
+    {
+        boundVertexArray_ = 0;
+        boundBuffers_[getBufferTargetIndex(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+    }
+}
+
+void GLStateCache::onBufferDeleted(const GLuint bufferID)
+{
+    for (auto& boundBuffer : boundBuffers_)
+    {
+        if (boundBuffer == bufferID) {
+            boundBuffer = 0;
+        }
+    }
+}
+
+void GLStateCache::onTextureDeleted(const GLuint textureID)
+{
+    std::replace(boundTextures2D_.begin(), boundTextures2D_.end(), textureID, static_cast<GLuint>(0));
+}
+
+void GLStateCache::onSamplerDeleted(const GLuint samplerID)
+{
+    std::replace(boundSamplers_.begin(), boundSamplers_.end(), samplerID, static_cast<GLuint>(0));
+}
+
+void GLStateCache::invalidate()
+{
+    boundProgram_ = UNKNOWN;
+    boundVertexArray_ = UNKNOWN;
+    std::fill(std::begin(boundBuffers_), std::end(boundBuffers_), UNKNOWN);
+    activeTextureUnit_ = UNKNOWN;
+    boundTextures2D_.clear();
+    boundSamplers_.clear();
+    capabilityStates_.clear();
+    primitiveRestartIndex_ = 0;
+    isPrimitiveRestartIndexKnown_ = false;
+}
+
+void GLStateCache::setCachingEnabled(const bool enabled)
+{
+    isCachingEnabled_ = enabled;
+}
+
+bool GLStateCache::isCachingEnabled() const
+{
+    return isCachingEnabled_;
+}
+
+void GLStateCache::beginFrame()
+{
+    lastFrameStatistics_ = currentFrameStatistics_;
+    currentFrameStatistics_ = Statistics();
+}
+
+const GLStateCache::Statistics& GLStateCache::getLastFrameStatistics() const
+{
+    return lastFrameStatistics_;
+}
+
+bool GLStateCache::updateValue(GLuint& cachedValue, const GLuint newValue)
+{
+    if (isCachingEnabled_ && cachedValue == newValue)
+    {
+        currentFrameStatistics_.numSkippedCalls++;
+        return false;
+    }
+
+    cachedValue = newValue;
+    currentFrameStatistics_.numIssuedCalls++;
+    return true;
+}
+
+int GLStateCache::getBufferTargetIndex(const GLenum target)
+{
+    for (size_t i = 0; i < NUM_TRACKED_BUFFER_TARGETS; i++)
+    {
+        if (TRACKED_BUFFER_TARGETS[i] == target) {
+            return static_cast<int>(i);
+        }
+    }
+
+    return -1;
+}
+
+GLuint& GLStateCache::getCapabilityState(const GLenum capability)
+{
+    for (auto& capabilityState : capabilityStates_)
+    {
+        if (capabilityState.capability == capability) {
+            return capabilityState.state;
+        }
+    }
+
+    capabilityStates_.push_back({ capability, UNKNOWN });
+    return capabilityStates_.back().state;
+}
+
+GLuint& GLStateCache::getUnitValue(std::vector<GLuint>& unitValues, const GLuint textureUnit)
+{
+    if (textureUnit >= unitValues.size()) {
+        unitValues.resize(textureUnit + 1, UNKNOWN);
+    }
+
+    return unitValues[textureUnit];
+}
@@ -0,0 +1,219 @@
+#pragma once
+
+// STL
+#include <vector>
+
+// GLAD
+#include <glad/glad.h>
+
+/**
+ * Singleton class, that shadows the most frequently changed OpenGL state - bound program, vertex array object,
+ * buffers per target, textures and samplers per texture unit and enabled capabilities. Wrapper classes route their
+ * binds through it and calls, that would not change anything, are skipped. Every piece of state is unknown
+ * at the beginning, so the first call always reaches OpenGL. Code, that changes the same state directly,
+ * must call invalidate() afterwards.
+ */
+class GLStateCache
+{
+public:
+    /**
+     * Statistics of state changing calls - how many of them have been issued and how many have been skipped,
+     * because they would set the state, that is already set.
+     */
+    struct Statistics
+    {
+        size_t numIssuedCalls{ 0 }; // Number of issued OpenGL calls
+        size_t numSkippedCalls{ 0 }; // Number of skipped redundant OpenGL calls
+    };
+
+    /**
+     * Gets the one and only instance of the OpenGL state cache.
+     */
+    static GLStateCache& getInstance();
+
+    /**
+     * Makes given shader program current (glUseProgram).
+     */
+    void useProgram(GLuint programID);
+
+    /**
+     * Binds given vertex array object. Because element array buffer binding is part of VAO state,
+     * it becomes unknown whenever bound VAO changes.
+     */
+    void bindVertexArray(GLuint vertexArrayID);
+
+    /**
+     * Binds buffer to the given target. Only common targets are tracked, binds to other targets are always issued.
+     *
+     * @param target    Buffer target (e.g. GL_ARRAY_BUFFER)
+     * @param bufferID  OpenGL-assigned buffer ID
+     */
+    void bindBuffer(GLenum target, GLuint bufferID);
+
+    /**
+     * Binds whole buffer to an indexed binding point (glBindBufferBase). Indexed bindings are not tracked, so the call
+     * is always issued, but it binds the buffer to the generic target as well, which is remembered.
+     *
+     * @param target    Indexed buffer target (e.g. GL_UNIFORM_BUFFER)
+     * @param index     Binding point index
+     * @param bufferID  OpenGL-assigned buffer ID
+     */
+    void bindBufferBase(GLenum target, GLuint index, GLuint bufferID);
+
+    /**
+     * Binds buffer range to an indexed binding point (glBindBufferRange). Same as with bindBufferBase,
+     * the call is always issued and only generic target binding is remembered.
+     *
+     * @param target    Indexed buffer target (e.g. GL_UNIFORM_BUFFER)
+     * @param index     Binding point index
+     * @param bufferID  OpenGL-assigned buffer ID
+     * @param offset    Offset of the range in bytes
+     * @param size      Size of the range in bytes
+     */
+    void bindBufferRange(GLenum target, GLuint index, GLuint bufferID, GLintptr offset, GLsizeiptr size);
+
+    /**
+     * Binds 2D texture to the given texture unit. Active texture unit is switched only if necessary.
+     *
+     * @param textureUnit  Texture unit index
+     * @param textureID    OpenGL-assigned texture ID
+     */
+    void bindTexture2D(GLuint textureUnit, GLuint textureID);
+
+    /**
+     * Binds sampler object to the given texture unit.
+     *
+     * @param textureUnit  Texture unit index
+     * @param samplerID    OpenGL-assigned sampler ID
+     */
+    void bindSampler(GLuint textureUnit, GLuint samplerID);
+
+    /**
+     * Enables OpenGL capability (glEnable).
+     */
+    void enable(GLenum capability);
+
+    /**
+     * Disables OpenGL capability (glDisable).
+     */
+    void disable(GLenum capability);
+
+    /**
+     * Enables or disables OpenGL capability.
+     *
+     * @param capability  Capability to change (e.g. GL_BLEND)
+     * @param enabled     True, if the capability should be enabled or false otherwise
+     */
+    void setCapability(GLenum capability, bool enabled);
+
+    /**
+     * Sets primitive restart index (glPrimitiveRestartIndex).
+     */
+    void setPrimitiveRestartIndex(GLuint index);
+
+    /**
+     * Forgets bound program, if it's the one being deleted. Must be called when shader program is deleted.
+     */
+    void onProgramDeleted(GLuint programID);
+
+    /**
+     * Forgets bound vertex array object, if it's the one being deleted. Must be called when VAO is deleted.
+     */
+    void onVertexArrayDeleted(GLuint vertexArrayID);
+
+    /**
+     * Forgets all bindings of given buffer. Must be called when buffer is deleted.
+     */
+    void onBufferDeleted(GLuint bufferID);
+
+    /**
+     * Forgets all bindings of given texture. Must be called when texture is deleted.
+     */
+    void onTextureDeleted(GLuint textureID);
+
+    /**
+     * Forgets all bindings of given sampler. Must be called when sampler is deleted.
+     */
+    void onSamplerDeleted(GLuint samplerID);
+
+    /**
+     * Marks the whole cached state as unknown, so that next calls are issued again.
+     */
+    void invalidate();
+
+    /**
+     * Enables or disables skipping of redundant calls (enabled by default). The state is tracked in both cases.
+     */
+    void setCachingEnabled(bool enabled);
+
+    /**
+     * Checks, if skipping of redundant calls is enabled.
+     */
+    bool isCachingEnabled() const;
+
+    /**
+     * Marks beginning of a new frame - statistics gathered so far are kept as the last frame statistics and counting starts over.
+     */
+    void beginFrame();
+
+    /**
+     * Gets statistics of the last finished frame.
+     */
+    const Statistics& getLastFrameStatistics() const;
+
+private:
+    GLStateCache(); // Private constructor to make class singleton
+    GLStateCache(const GLStateCache&) = delete; // No copy constructor allowed
+    void operator=(const GLStateCache&) = delete; // No copy assignment allowed
+
+    static const GLuint UNKNOWN = 0xFFFFFFFF; // Value of state, that is not known
+    static const size_t NUM_TRACKED_BUFFER_TARGETS = 8; // Number of tracked buffer targets
+
+    /**
+     * Tracked state of one capability.
+     */
+    struct CapabilityState
+    {
+        GLenum capability; // Capability (e.g. GL_BLEND)
+        GLuint state; // 1 if enabled, 0 if disabled or UNKNOWN
+    };
+
+    /**
+     * Compares cached value with the new one and updates the statistics.
+     *
+     * @param cachedValue  Cached value, it is updated to the new value
+     * @param newValue     New value to be set
+     *
+     * @return True, if the OpenGL call has to be issued or false, if it is redundant.
+     */
+    bool updateValue(GLuint& cachedValue, GLuint newValue);
+
+    /**
+     * Gets index of buffer target among tracked targets or -1, if the target is not tracked.
+     */
+    static int getBufferTargetIndex(GLenum target);
+
+    /**
+     * Gets cached state of the given capability (it starts tracking it if necessary).
+     */
+    GLuint& getCapabilityState(GLenum capability);
+
+    /**
+     * Gets cached value at given unit of per unit state, enlarging the table if necessary.
+     */
+    static GLuint& getUnitValue(std::vector<GLuint>& unitValues, GLuint textureUnit);
+
+    GLuint boundProgram_; // Currently used shader program
+    GLuint boundVertexArray_; // Currently bound vertex array object
+    GLuint boundBuffers_[NUM_TRACKED_BUFFER_TARGETS]; // Currently bound buffers, indexed with tracked buffer target index
+    GLuint activeTextureUnit_; // Currently active texture unit
+    std::vector<GLuint> boundTextures2D_; // Currently bound 2D textures, indexed with texture unit
+    std::vector<GLuint> boundSamplers_; // Currently bound samplers, indexed with texture unit
+    std::vector<CapabilityState> capabilityStates_; // States of all capabilities changed so far
+    GLuint primitiveRestartIndex_; // Current primitive restart index
+    bool isPrimitiveRestartIndexKnown_; // Flag telling, whether primitive restart index is known (every value is valid index)
+
+    bool isCachingEnabled_ = true; // Flag telling, whether redundant calls are skipped
+    Statistics currentFrameStatistics_; // Statistics of the frame being rendered
+    Statistics lastFrameStatistics_; // Statistics of the last finished frame
+};
@@ -0,0 +1,165 @@
+// STL
+#include <iostream>
+
+// Project
+#include "gpuResourceRegistry.h"
+
+const std::string GPUResourceRegistry::DEFAULT_TAG = "untagged";
+
+GPUResourceRegistry::ScopedTag::ScopedTag(const std::string& tag)
+{
+    GPUResourceRegistry::getInstance().tagStack_.push_back(tag);
+}
+
+GPUResourceRegistry::ScopedTag::~ScopedTag()
+{
+    GPUResourceRegistry::getInstance().tagStack_.pop_back();
+}
+
+GPUResourceRegistry& GPUResourceRegistry::getInstance()
+{
+    static GPUResourceRegistry registry;
+    return registry;
+}
+
+void GPUResourceRegistry::registerResource(GPUResourceType type, GLuint id, size_t byteSize)
+{
+    const auto typeIndex = static_cast<size_t>(type);
+    auto& entries = entries_[typeIndex];
+    if (entries.count(id) > 0)
+    {
+        std::cerr << "GPU resource " << getResourceTypeName(type) << " #" << id << " is already registered!" << std::endl;
+        return;
+    }
+
+    Entry entry;
+    entry.byteSize = byteSize;
+    entry.tag = getCurrentTag();
+    entries[id] = entry;
+
+    auto& statistics = typeStatistics_[typeIndex];
+    statistics.liveCount++;
+    statistics.totalBytes += byteSize;
+}
+
+void GPUResourceRegistry::updateResourceSize(GPUResourceType type, GLuint id, size_t byteSize)
+{
+    const auto typeIndex = static_cast<size_t>(type);
+    auto& entries = entries_[typeIndex];
+    const auto itEntry = entries.find(id);
+    if (itEntry == entries.end())
+    {
+        std::cerr << "Cannot update size of unregistered GPU resource " << getResourceTypeName(type) << " #" << id << "!" << std::endl;
+        return;
+    }
+
+    auto& statistics = typeStatistics_[typeIndex];
+    statistics.totalBytes -= itEntry->second.byteSize;
+    statistics.totalBytes += byteSize;
+    itEntry->second.byteSize = byteSize;
+}
+
+void GPUResourceRegistry::unregisterResource(GPUResourceType type, GLuint id)
+{
+    const auto typeIndex = static_cast<size_t>(type);
+    auto& entries = entries_[typeIndex];
+    const auto itEntry = entries.find(id);
+    if (itEntry == entries.end())
+    {
+        std::cerr << "Cannot unregister unregistered GPU resource " << getResourceTypeName(type) << " #" << id << "!" << std::endl;
+        return;
+    }
+
+    auto& statistics = typeStatistics_[typeIndex];
+    statistics.liveCount--;
+    statistics.totalBytes -= itEntry->second.byteSize;
+    entries.erase(itEntry);
+}
+
+GPUResourceRegistry::Statistics GPUResourceRegistry::getStatistics(GPUResourceType type) const
+{
+    return typeStatistics_[static_cast<size_t>(type)];
+}
+
+std::map<std::string, GPUResourceRegistry::Statistics> GPUResourceRegistry::getStatisticsPerTag() const
+{
+    std::map<std::string, Statistics> result;
+    for (const auto& entries : entries_)
+    {
+        for (const auto& idEntryPair : entries)
+        {
+            auto& statistics = result[idEntryPair.second.tag];
+            statistics.liveCount++;
+            statistics.totalBytes += idEntryPair.second.byteSize;
+        }
+    }
+
+    return result;
+}
+
+size_t GPUResourceRegistry::getTotalBytes() const
+{
+    size_t result = 0;
+    for (size_t i = 0; i < NUM_RESOURCE_TYPES; i++)
+    {
+        if (i != static_cast<size_t>(GPUResourceType::GeometryArenaRange)) {
+            result += typeStatistics_[i].totalBytes;
+        }
+    }
+
+    return result;
+}
+
+size_t GPUResourceRegistry::getTotalLiveCount() const
+{
+    size_t result = 0;
+    for (size_t i = 0; i < NUM_RESOURCE_TYPES; i++)
+    {
+        if (i != static_cast<size_t>(GPUResourceType::GeometryArenaRange)) {
+            result += typeStatistics_[i].liveCount;
+        }
+    }
+
+    return result;
+}
+
+size_t GPUResourceRegistry::dumpLeaks() const
+{
+    size_t numLeaks = 0;
+    for (size_t i = 0; i < NUM_RESOURCE_TYPES; i++)
+    {
+        const auto type = static_cast<GPUResourceType>(i);
+        for (const auto& idEntryPair : entries_[i])
+        {
+            std::cerr << "Leaked GPU resource " << getResourceTypeName(type) << " #" << idEntryPair.first
+                << " (" << idEntryPair.second.byteSize << " bytes, tag '" << idEntryPair.second.tag << "')" << std::endl;
+            numLeaks++;
+        }
+    }
+
+    if (numLeaks > 0) {
+        std::cerr << "Total " << numLeaks << " GPU resources have not been released!" << std::endl;
+    }
+
+    return numLeaks;
+}
+
+const char* GPUResourceRegistry::getResourceTypeName(GPUResourceType type)
+{
+    switch (type)
+    {
+        case GPUResourceType::VertexBuffer: return "vertex buffer";
+        case GPUResourceType::UniformBuffer: return "uniform buffer";
+        case GPUResourceType::Texture: return "texture";
+        case GPUResourceType::RenderBuffer: return "renderbuffer";
+        case GPUResourceType::FrameBuffer: return "framebuffer";
+        case GPUResourceType::TransformFeedbackBuffer: return "transform feedback buffer";
+        case GPUResourceType::GeometryArenaRange: return "geometry arena range";
+        default: return "unknown";
+    }
+}
+
+const std::string& GPUResourceRegistry::getCurrentTag() const
+{
+    return tagStack_.empty() ? DEFAULT_TAG : tagStack_.back();
+}
@@ -0,0 +1,147 @@
+#pragma once
+
+// STL
+#include <string>
+#include <vector>
+#include <map>
+
+// GLAD
+#include <glad/glad.h>
+
+/**
+ * Types of GPU resources, that are tracked by the GPU resource registry.
+ */
+enum class GPUResourceType
+{
+    VertexBuffer,
+    UniformBuffer,
+    Texture,
+    RenderBuffer,
+    FrameBuffer,
+    TransformFeedbackBuffer,
+    GeometryArenaRange, // Suballocated range within geometry arena buffer (its bytes are already counted in the arena buffers)
+    Count
+};
+
+/**
+ * Singleton class, that keeps track of all live GPU resources - their count, byte size and owning tag.
+ * Wrapper classes report here when they create, resize and delete their OpenGL objects. Tag is taken from
+ * the innermost active ScopedTag at the time of resource registration.
+ */
+class GPUResourceRegistry
+{
+public:
+    static const std::string DEFAULT_TAG; // Tag of resources created outside of any tag scope
+
+    /**
+     * Aggregated statistics of a group of resources.
+     */
+    struct Statistics
+    {
+        size_t liveCount{ 0 }; // Number of live resources
+        size_t totalBytes{ 0 }; // Total byte size of live resources
+    };
+
+    /**
+     * RAII helper, that sets owning tag of all resources registered during its lifetime.
+     */
+    class ScopedTag
+    {
+    public:
+        ScopedTag(const std::string& tag);
+        ~ScopedTag();
+
+        ScopedTag(const ScopedTag&) = delete; // No copy constructor allowed
+        void operator=(const ScopedTag&) = delete; // No copy assignment allowed
+    };
+
+    /**
+     * Gets the one and only instance of the GPU resource registry.
+     */
+    static GPUResourceRegistry& getInstance();
+
+    /**
+     * Registers newly created GPU resource. It gets the currently active tag.
+     *
+     * @param type      Type of the resource
+     * @param id        OpenGL name of the resource (or any unique ID within given type)
+     * @param byteSize  Byte size of the resource (can be 0 if storage is not allocated yet)
+     */
+    void registerResource(GPUResourceType type, GLuint id, size_t byteSize = 0);
+
+    /**
+     * Updates byte size of already registered GPU resource (e.g. after its storage has been (re)allocated).
+     *
+     * @param type      Type of the resource
+     * @param id        OpenGL name of the resource
+     * @param byteSize  New byte size of the resource
+     */
+    void updateResourceSize(GPUResourceType type, GLuint id, size_t byteSize);
+
+    /**
+     * Unregisters GPU resource, that is being deleted.
+     *
+     * @param type  Type of the resource
+     * @param id    OpenGL name of the resource
+     */
+    void unregisterResource(GPUResourceType type, GLuint id);
+
+    /**
+     * Gets statistics of all live resources of given type.
+     */
+    Statistics getStatistics(GPUResourceType type) const;
+
+    /**
+     * Gets statistics of all live resources grouped by their owning tag.
+     */
+    std::map<std::string, Statistics> getStatisticsPerTag() const;
+
+    /**
+     * Gets total byte size of all live resources. Geometry arena ranges are not counted,
+     * because they live within geometry arena buffers.
+     */
+    size_t getTotalBytes() const;
+
+    /**
+     * Gets total number of live resources (without geometry arena ranges).
+     */
+    size_t getTotalLiveCount() const;
+
+    /**
+     * Prints all live resources to the standard error output. Meant to be called at application shutdown,
+     * when every resource should have already been released.
+     *
+     * @return Number of leaked resources.
+     */
+    size_t dumpLeaks() const;
+
+    /**
+     * Gets human readable name of the resource type.
+     */
+    static const char* getResourceTypeName(GPUResourceType type);
+
+private:
+    GPUResourceRegistry() {} // Private constructor to make class singleton
+    GPUResourceRegistry(const GPUResourceRegistry&) = delete; // No copy constructor allowed
+    void operator=(const GPUResourceRegistry&) = delete; // No copy assignment allowed
+
+    /**
+     * Holds information about one live resource.
+     */
+    struct Entry
+    {
+        size_t byteSize{ 0 }; // Byte size of the resource
+        std::string tag; // Owning tag of the resource
+    };
+
+    /**
+     * Gets currently active tag.
+     */
+    const std::string& getCurrentTag() const;
+
+    static const size_t NUM_RESOURCE_TYPES = static_cast<size_t>(GPUResourceType::Count);
+
+    std::map<GLuint, Entry> entries_[NUM_RESOURCE_TYPES]; // Live resources of every type, maps OpenGL name to the entry
+    Statistics typeStatistics_[NUM_RESOURCE_TYPES]; // Running statistics of every resource type
+    std::vector<std::string> tagStack_; // Stack of tags pushed by scoped tags
+};
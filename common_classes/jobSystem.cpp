@@ -0,0 +1,237 @@
+// STL
+#include <algorithm>
+
+// Project
+#include "jobSystem.h"
+
+namespace {
+
+thread_local const JobSystem* currentThreadJobSystem = nullptr; // Job system owning the current thread (if it's a worker)
+thread_local size_t currentThreadQueueIndex = 0; // Index of the deque of the current thread within its job system
+
+} // namespace
+
+bool JobCounter::isDone() const
+{
+    return numPendingJobs_.load(std::memory_order_acquire) == 0;
+}
+
+int JobCounter::getNumPendingJobs() const
+{
+    return numPendingJobs_.load(std::memory_order_acquire);
+}
+
+JobSystem::JobSystem(const size_t numWorkerThreads)
+{
+    for (size_t i = 0; i <= numWorkerThreads; i++) {
+        queues_.push_back(std::make_unique<JobQueue>());
+    }
+
+    for (size_t i = 1; i <= numWorkerThreads; i++) {
+        workerThreads_.emplace_back(&JobSystem::workerThreadMain, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        isRunning_ = false;
+    }
+
+    wakeCondition_.notify_all();
+    for (auto& workerThread : workerThreads_) {
+        workerThread.join();
+    }
+}
+
+JobSystem& JobSystem::getInstance()
+{
+    static JobSystem jobSystem(std::max(std::thread::hardware_concurrency(), 2u) - 1);
+    return jobSystem;
+}
+
+void JobSystem::submit(std::function<void()> job, JobCounter* counter)
+{
+    if (counter != nullptr) {
+        counter->numPendingJobs_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    pushJob({ std::move(job), counter });
+}
+
+void JobSystem::submitAfter(JobCounter& dependency, std::function<void()> job, JobCounter* counter)
+{
+    if (counter != nullptr) {
+        counter->numPendingJobs_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        // Last finishing job of the dependency takes continuations under the same lock, so the job can't get lost
+        std::lock_guard<std::mutex> lock(dependency.continuationsMutex_);
+        if (!dependency.isDone())
+        {
+            dependency.continuations_.push_back(std::move(job));
+            dependency.continuationCounters_.push_back(counter);
+            return;
+        }
+    }
+
+    pushJob({ std::move(job), counter });
+}
+
+void JobSystem::parallelFor(const size_t first, const size_t last, const size_t itemsPerJob, const std::function<void(size_t, size_t)>& rangeJob, JobCounter& counter)
+{
+    if (first >= last) {
+        return;
+    }
+
+    // By default create few jobs per thread, so that stealing can balance uneven chunks
+    const auto numItems = last - first;
+    const auto chunkSize = itemsPerJob > 0 ? itemsPerJob : std::max(numItems / (getNumThreads() * 4), static_cast<size_t>(1));
+
+    // Caller doesn't have to keep the function alive, all chunks share one copy of it
+    const auto sharedRangeJob = std::make_shared<std::function<void(size_t, size_t)>>(rangeJob);
+    for (auto chunkFirst = first; chunkFirst < last; chunkFirst += chunkSize)
+    {
+        const auto chunkLast = std::min(chunkFirst + chunkSize, last);
+        submit([sharedRangeJob, chunkFirst, chunkLast]() { (*sharedRangeJob)(chunkFirst, chunkLast); }, &counter);
+    }
+}
+
+void JobSystem::parallelFor(const size_t first, const size_t last, const size_t itemsPerJob, const std::function<void(size_t, size_t)>& rangeJob)
+{
+    JobCounter counter;
+    parallelFor(first, last, itemsPerJob, rangeJob, counter);
+    wait(counter);
+}
+
+void JobSystem::wait(const JobCounter& counter)
+{
+    const auto queueIndex = getCurrentQueueIndex();
+    while (!counter.isDone())
+    {
+        if (!executeOneJob(queueIndex)) {
+            std::this_thread::yield();
+        }
+    }
+
+    // The last job reaches zero while holding the mutex, so once we get it, nobody touches the counter anymore
+    std::lock_guard<std::mutex> lock(counter.continuationsMutex_);
+}
+
+size_t JobSystem::getNumWorkerThreads() const
+{
+    return workerThreads_.size();
+}
+
+size_t JobSystem::getNumThreads() const
+{
+    return workerThreads_.size() + 1;
+}
+
+void JobSystem::pushJob(Job&& job)
+{
+    auto& queue = *queues_[getCurrentQueueIndex()];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+
+    // Increment under wake mutex, otherwise worker could check for jobs and fall asleep right after that, missing the notification
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        numQueuedJobs_++;
+    }
+
+    wakeCondition_.notify_one();
+}
+
+bool JobSystem::executeOneJob(const size_t queueIndex)
+{
+    Job job;
+    if (!acquireJob(queueIndex, job)) {
+        return false;
+    }
+
+    job.function();
+    finishJob(job.counter);
+    return true;
+}
+
+bool JobSystem::acquireJob(const size_t queueIndex, Job& outJob)
+{
+    // Own deque is used as a stack - the most recently pushed job probably has its data in cache
+    {
+        auto& ownQueue = *queues_[queueIndex];
+        std::lock_guard<std::mutex> lock(ownQueue.mutex);
+        if (!ownQueue.jobs.empty())
+        {
+            outJob = std::move(ownQueue.jobs.back());
+            ownQueue.jobs.pop_back();
+            numQueuedJobs_--;
+            return true;
+        }
+    }
+
+    // Others are stolen from the front, so that the owner and the thief don't fight over the same end
+    for (size_t i = 1; i < queues_.size(); i++)
+    {
+        auto& victimQueue = *queues_[(queueIndex + i) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victimQueue.mutex);
+        if (!victimQueue.jobs.empty())
+        {
+            outJob = std::move(victimQueue.jobs.front());
+            victimQueue.jobs.pop_front();
+            numQueuedJobs_--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::finishJob(JobCounter* counter)
+{
+    if (counter == nullptr) {
+        return;
+    }
+
+    std::vector<std::function<void()>> continuations;
+    std::vector<JobCounter*> continuationCounters;
+    {
+        std::lock_guard<std::mutex> lock(counter->continuationsMutex_);
+        if (counter->numPendingJobs_.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+
+        continuations.swap(counter->continuations_);
+        continuationCounters.swap(counter->continuationCounters_);
+    }
+
+    // Counters of continuations have been incremented already in submitAfter
+    for (size_t i = 0; i < continuations.size(); i++) {
+        pushJob({ std::move(continuations[i]), continuationCounters[i] });
+    }
+}
+
+size_t JobSystem::getCurrentQueueIndex() const
+{
+    return currentThreadJobSystem == this ? currentThreadQueueIndex : 0;
+}
+
+void JobSystem::workerThreadMain(const size_t queueIndex)
+{
+    currentThreadJobSystem = this;
+    currentThreadQueueIndex = queueIndex;
+
+    while (isRunning_)
+    {
+        if (executeOneJob(queueIndex)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        wakeCondition_.wait(lock, [this]() { return !isRunning_ || numQueuedJobs_ > 0; });
+    }
+}
@@ -0,0 +1,176 @@
+#pragma once
+
+// STL
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobSystem;
+
+/**
+ * Counts unfinished jobs, so that one can wait for them or chain other jobs after them. Every job submitted
+ * with the counter increments it and decrements it once it's done. Counter must outlive all jobs it counts.
+ */
+class JobCounter
+{
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete; // No copy constructor allowed
+    void operator=(const JobCounter&) = delete; // No copy assignment allowed
+
+    /**
+     * Checks, if all counted jobs have finished. Use JobSystem::wait before destroying the counter,
+     * the last job might still be finishing with it even though it's done already.
+     */
+    bool isDone() const;
+
+    /**
+     * Gets number of unfinished counted jobs.
+     */
+    int getNumPendingJobs() const;
+
+private:
+    friend class JobSystem;
+
+    std::atomic<int> numPendingJobs_{ 0 }; // Number of unfinished jobs
+    mutable std::mutex continuationsMutex_; // Guards continuations (and the moment the counter reaches zero)
+    std::vector<std::function<void()>> continuations_; // Jobs to submit once the counter reaches zero
+    std::vector<JobCounter*> continuationCounters_; // With their corresponding counters
+};
+
+/**
+ * Job system with one job deque per thread. Thread takes jobs from the back of its own deque (the most recent,
+ * cache-hot ones) and when it runs out of jobs, it steals from the front of other deques. Threads waiting for
+ * a counter don't block, they help executing jobs in the meantime.
+ */
+class JobSystem
+{
+public:
+    /**
+     * Creates job system with given number of worker threads. Thread, that waits for jobs, executes jobs
+     * as well, so e.g. 3 workers use 4 cores in total.
+     *
+     * @param numWorkerThreads  Number of worker threads
+     */
+    explicit JobSystem(size_t numWorkerThreads);
+    JobSystem(const JobSystem&) = delete; // No copy constructor allowed
+    void operator=(const JobSystem&) = delete; // No copy assignment allowed
+    ~JobSystem();
+
+    /**
+     * Gets shared job system with one worker thread less than the number of hardware threads.
+     */
+    static JobSystem& getInstance();
+
+    /**
+     * Submits job for execution.
+     *
+     * @param job      Job to execute
+     * @param counter  Optional counter to count the job with
+     */
+    void submit(std::function<void()> job, JobCounter* counter = nullptr);
+
+    /**
+     * Submits job, that is executed only after all jobs counted by dependency have finished.
+     *
+     * @param dependency  Counter of jobs, that must finish first
+     * @param job         Job to execute
+     * @param counter     Optional counter to count the job with (it's counted right away, not only when it gets submitted)
+     */
+    void submitAfter(JobCounter& dependency, std::function<void()> job, JobCounter* counter = nullptr);
+
+    /**
+     * Splits range [first, last) into chunks and submits a job for every chunk.
+     *
+     * @param first         First item of the range
+     * @param last          One past the last item of the range
+     * @param itemsPerJob   Number of items processed by one job (0 lets the system decide)
+     * @param rangeJob      Function processing the chunk [chunkFirst, chunkLast)
+     * @param counter       Counter to count the jobs with (wait on it to know, when the whole range is done)
+     */
+    void parallelFor(size_t first, size_t last, size_t itemsPerJob, const std::function<void(size_t, size_t)>& rangeJob, JobCounter& counter);
+
+    /**
+     * Processes range [first, last) in parallel and waits until it's done.
+     */
+    void parallelFor(size_t first, size_t last, size_t itemsPerJob, const std::function<void(size_t, size_t)>& rangeJob);
+
+    /**
+     * Waits until all jobs counted by the counter have finished. Calling thread executes jobs while waiting.
+     */
+    void wait(const JobCounter& counter);
+
+    /**
+     * Gets number of worker threads.
+     */
+    size_t getNumWorkerThreads() const;
+
+    /**
+     * Gets number of threads, that execute jobs (worker threads plus the waiting thread).
+     */
+    size_t getNumThreads() const;
+
+private:
+    /**
+     * Job together with its counter.
+     */
+    struct Job
+    {
+        std::function<void()> function;
+        JobCounter* counter;
+    };
+
+    /**
+     * Job deque of one thread.
+     */
+    struct JobQueue
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    /**
+     * Pushes already counted job to the deque of the calling thread and wakes up a worker.
+     */
+    void pushJob(Job&& job);
+
+    /**
+     * Executes one job from own deque or stolen from other deques.
+     *
+     * @return True, if a job has been executed, false if there was nothing to do.
+     */
+    bool executeOneJob(size_t queueIndex);
+
+    /**
+     * Pops job from the back of own deque or steals it from the front of other deques.
+     */
+    bool acquireJob(size_t queueIndex, Job& outJob);
+
+    /**
+     * Marks job as finished and submits continuations of its counter, if it was the last one.
+     */
+    void finishJob(JobCounter* counter);
+
+    /**
+     * Gets index of the deque belonging to the calling thread (threads not owned by this system share deque 0).
+     */
+    size_t getCurrentQueueIndex() const;
+
+    /**
+     * Main function of worker thread.
+     */
+    void workerThreadMain(size_t queueIndex);
+
+    std::vector<std::unique_ptr<JobQueue>> queues_; // Job deques, deque 0 is for the external threads, rest are for workers
+    std::vector<std::thread> workerThreads_; // Worker threads
+    std::atomic<bool> isRunning_{ true }; // Flag telling workers to keep running
+
+    std::mutex wakeMutex_; // Mutex for sleeping workers
+    std::condition_variable wakeCondition_; // Wakes up workers, when there are new jobs
+    std::atomic<size_t> numQueuedJobs_{ 0 }; // Number of jobs sitting in the deques
+};
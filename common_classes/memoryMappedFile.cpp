@@ -0,0 +1,152 @@
+// STL
+#include <algorithm>
+#include <iostream>
+
+// Platform specific memory mapping
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Project
+#include "memoryMappedFile.h"
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    close();
+}
+
+bool MemoryMappedFile::open(const std::string& filePath)
+{
+    close();
+
+#ifdef _WIN32
+    const auto fileHandle = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+    {
+        std::cout << "Could not open file " << filePath << " for memory mapping!" << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(fileHandle, &fileSize) || fileSize.QuadPart == 0)
+    {
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    const auto mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const auto data = mappingHandle != nullptr ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (data == nullptr)
+    {
+        std::cout << "Could not map file " << filePath << " into memory!" << std::endl;
+        if (mappingHandle != nullptr) {
+            CloseHandle(mappingHandle);
+        }
+        CloseHandle(fileHandle);
+        return false;
+    }
+
+    fileHandle_ = fileHandle;
+    mappingHandle_ = mappingHandle;
+    data_ = static_cast<const unsigned char*>(data);
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+#else
+    const auto fileDescriptor = ::open(filePath.c_str(), O_RDONLY);
+    if (fileDescriptor == -1)
+    {
+        std::cout << "Could not open file " << filePath << " for memory mapping!" << std::endl;
+        return false;
+    }
+
+    struct stat fileStatus;
+    if (fstat(fileDescriptor, &fileStatus) != 0 || fileStatus.st_size == 0)
+    {
+        ::close(fileDescriptor);
+        return false;
+    }
+
+    // Mapping stays valid after closing the file descriptor
+    const auto size = static_cast<size_t>(fileStatus.st_size);
+    const auto data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fileDescriptor, 0);
+    ::close(fileDescriptor);
+    if (data == MAP_FAILED)
+    {
+        std::cout << "Could not map file " << filePath << " into memory!" << std::endl;
+        return false;
+    }
+
+    data_ = static_cast<const unsigned char*>(data);
+    size_ = size;
+#endif
+
+    return true;
+}
+
+void MemoryMappedFile::close()
+{
+    if (!isOpen()) {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+    CloseHandle(mappingHandle_);
+    CloseHandle(fileHandle_);
+    mappingHandle_ = fileHandle_ = nullptr;
+#else
+    munmap(const_cast<unsigned char*>(data_), size_);
+#endif
+
+    data_ = nullptr;
+    size_ = 0;
+}
+
+bool MemoryMappedFile::isOpen() const
+{
+    return data_ != nullptr;
+}
+
+const unsigned char* MemoryMappedFile::getData() const
+{
+    return data_;
+}
+
+size_t MemoryMappedFile::getSize() const
+{
+    return size_;
+}
+
+void MemoryMappedFile::releasePages(const size_t offset, const size_t size) const
+{
+    if (!isOpen() || offset >= size_) {
+        return;
+    }
+
+    // Only whole pages can be released - range is shrunk to the pages, that are completely inside of it
+#ifdef _WIN32
+    SYSTEM_INFO systemInfo;
+    GetSystemInfo(&systemInfo);
+    const auto pageSize = static_cast<size_t>(systemInfo.dwPageSize);
+#else
+    const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    const auto firstPageOffset = (offset + pageSize - 1) / pageSize * pageSize;
+    const auto endOffset = std::min(offset + size, size_) / pageSize * pageSize;
+    if (firstPageOffset >= endOffset) {
+        return;
+    }
+
+#ifdef _WIN32
+    // Unlocking pages, that aren't locked, removes them from the working set of the process
+    VirtualUnlock(const_cast<unsigned char*>(data_ + firstPageOffset), endOffset - firstPageOffset);
+#else
+    madvise(const_cast<unsigned char*>(data_ + firstPageOffset), endOffset - firstPageOffset, MADV_DONTNEED);
+#endif
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+// STL
+#include <cstddef>
+#include <string>
+
+/**
+ * Read-only view of the whole file mapped into memory. Nothing is read up front - pages are loaded by the OS when
+ * they're touched for the first time, so even files larger than RAM can be mapped and only their parts, that are
+ * actually accessed, occupy memory. Those can be released again with releasePages.
+ */
+class MemoryMappedFile
+{
+public:
+    MemoryMappedFile() = default;
+    MemoryMappedFile(const MemoryMappedFile&) = delete; // No copy constructor allowed
+    void operator=(const MemoryMappedFile&) = delete; // No copy assignment allowed
+    ~MemoryMappedFile();
+
+    /**
+     * Maps the file into memory (previously mapped file is closed first).
+     *
+     * @param filePath  Path to the file
+     *
+     * @return True, if the file has been mapped successfully or false otherwise.
+     */
+    bool open(const std::string& filePath);
+
+    /**
+     * Unmaps the file and closes it.
+     */
+    void close();
+
+    /**
+     * Checks, if the file is mapped.
+     */
+    bool isOpen() const;
+
+    /**
+     * Gets pointer to the beginning of the mapped file (nullptr, if nothing is mapped).
+     */
+    const unsigned char* getData() const;
+
+    /**
+     * Gets size of the mapped file (in bytes).
+     */
+    size_t getSize() const;
+
+    /**
+     * Tells the OS, that the range won't be needed for a while, so that its pages are dropped from the resident memory
+     * of the process. Data stay valid, they're just loaded from the file again, if they're accessed later.
+     *
+     * @param offset  Byte offset of the range
+     * @param size    Byte size of the range
+     */
+    void releasePages(size_t offset, size_t size) const;
+
+private:
+    const unsigned char* data_{ nullptr }; // Pointer to the mapped file data
+    size_t size_{ 0 }; // Size of the mapped file
+#ifdef _WIN32
+    void* fileHandle_{ nullptr }; // Handle of the opened file
+    void* mappingHandle_{ nullptr }; // Handle of the file mapping object
+#endif
+};
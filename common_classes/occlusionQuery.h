@@ -20,7 +20,9 @@ public:
 
     /**
      * Ends occlusion query and caches the result - number
-     * of samples that passed the rendering pipeline.
+     * of samples that passed the rendering pipeline. It waits
+     * until GPU renders everything issued so far, so it stalls
+     * the CPU (see OcclusionQueryPool for queries, that don't).
      */
     void endQuery();
 
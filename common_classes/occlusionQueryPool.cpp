@@ -0,0 +1,152 @@
+// STL
+#include <algorithm>
+#include <iostream>
+
+// Project
+#include "occlusionQueryPool.h"
+
+OcclusionQueryPool::OcclusionQueryPool(const GLenum queryTarget)
+    : queryTarget_(queryTarget)
+{
+}
+
+OcclusionQueryPool::~OcclusionQueryPool()
+{
+    deleteQueries();
+}
+
+size_t OcclusionQueryPool::acquireQuery()
+{
+    size_t handle;
+    if (!freeQueries_.empty())
+    {
+        handle = freeQueries_.back();
+        freeQueries_.pop_back();
+    }
+    else
+    {
+        GLuint queryID = 0;
+        glGenQueries(1, &queryID);
+        handle = queries_.size();
+        queries_.push_back({ queryID, false, false, false, true });
+    }
+
+    auto& query = queries_[handle];
+    query.isAcquired = true;
+    query.isPending = false;
+    query.hasBeenIssued = false;
+    query.isVisible = true;
+    return handle;
+}
+
+void OcclusionQueryPool::releaseQuery(const size_t handle)
+{
+    auto& query = queries_[handle];
+    if (!query.isAcquired) {
+        return;
+    }
+
+    if (query.isPending)
+    {
+        pendingQueries_.erase(std::find(pendingQueries_.begin(), pendingQueries_.end(), handle));
+        query.isPending = false;
+    }
+
+    query.isAcquired = false;
+    freeQueries_.push_back(handle);
+}
+
+bool OcclusionQueryPool::beginQuery(const size_t handle)
+{
+    auto& query = queries_[handle];
+    if (query.isPending) {
+        return false;
+    }
+
+    glBeginQuery(queryTarget_, query.queryID);
+    query.isPending = true;
+    query.hasBeenIssued = true;
+    pendingQueries_.push_back(handle);
+    return true;
+}
+
+void OcclusionQueryPool::endQuery()
+{
+    glEndQuery(queryTarget_);
+}
+
+size_t OcclusionQueryPool::collectResults()
+{
+    // GPU finishes queries in the order they were issued, so the first unavailable result ends the collection
+    size_t numCollectedResults = 0;
+    while (numCollectedResults < pendingQueries_.size())
+    {
+        auto& query = queries_[pendingQueries_[numCollectedResults]];
+        GLuint isResultAvailable = GL_FALSE;
+        glGetQueryObjectuiv(query.queryID, GL_QUERY_RESULT_AVAILABLE, &isResultAvailable);
+        if (isResultAvailable == GL_FALSE) {
+            break;
+        }
+
+        GLuint result = 0;
+        glGetQueryObjectuiv(query.queryID, GL_QUERY_RESULT, &result);
+        query.isVisible = result > 0;
+        query.isPending = false;
+        numCollectedResults++;
+    }
+
+    pendingQueries_.erase(pendingQueries_.begin(), pendingQueries_.begin() + numCollectedResults);
+    return numCollectedResults;
+}
+
+bool OcclusionQueryPool::isVisible(const size_t handle) const
+{
+    return queries_[handle].isVisible;
+}
+
+bool OcclusionQueryPool::isPending(const size_t handle) const
+{
+    return queries_[handle].isPending;
+}
+
+bool OcclusionQueryPool::beginConditionalRender(const size_t handle, const GLenum mode) const
+{
+    const auto& query = queries_[handle];
+    if (!query.hasBeenIssued) {
+        return false;
+    }
+
+    glBeginConditionalRender(query.queryID, mode);
+    return true;
+}
+
+void OcclusionQueryPool::endConditionalRender() const
+{
+    glEndConditionalRender();
+}
+
+size_t OcclusionQueryPool::getNumAcquiredQueries() const
+{
+    return queries_.size() - freeQueries_.size();
+}
+
+size_t OcclusionQueryPool::getNumPendingQueries() const
+{
+    return pendingQueries_.size();
+}
+
+void OcclusionQueryPool::deleteQueries()
+{
+    if (queries_.empty()) {
+        return;
+    }
+
+    for (const auto& query : queries_) {
+        glDeleteQueries(1, &query.queryID);
+    }
+
+    std::cout << "Deleted occlusion query pool with " << queries_.size() << " queries" << std::endl;
+    queries_.clear();
+    freeQueries_.clear();
+    pendingQueries_.clear();
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+// STL
+#include <vector>
+
+// GLAD
+#include <glad/glad.h>
+
+/**
+ * Pool of occlusion queries, whose results are never waited for. Query is issued in one frame and its result
+ * is collected in one of the next frames, as soon as GPU reports it's available. Until then, the last known result
+ * is used and the query is not issued again. Queries are referred to by handles, that stay valid until released.
+ */
+class OcclusionQueryPool
+{
+public:
+    /**
+     * Creates empty pool, queries are generated as they're acquired.
+     *
+     * @param queryTarget  Query target - GL_ANY_SAMPLES_PASSED (default), GL_ANY_SAMPLES_PASSED_CONSERVATIVE or GL_SAMPLES_PASSED
+     */
+    explicit OcclusionQueryPool(GLenum queryTarget = GL_ANY_SAMPLES_PASSED);
+    OcclusionQueryPool(const OcclusionQueryPool&) = delete; // No copy constructor allowed
+    void operator=(const OcclusionQueryPool&) = delete; // No copy assignment allowed
+    ~OcclusionQueryPool();
+
+    /**
+     * Acquires query from the pool (released queries are reused). Until the query has any result, it's considered visible.
+     *
+     * @return Handle of the acquired query.
+     */
+    size_t acquireQuery();
+
+    /**
+     * Returns query back to the pool. Pending result of the query is thrown away.
+     */
+    void releaseQuery(size_t handle);
+
+    /**
+     * Begins query, unless its previous result is still pending - in that case nothing happens and false is returned.
+     * Query must be ended with endQuery only if this method returned true.
+     */
+    bool beginQuery(size_t handle);
+
+    /**
+     * Ends the query begun by beginQuery. Result is not read here, see collectResults.
+     */
+    void endQuery();
+
+    /**
+     * Reads results of all pending queries, that are already available. It never waits for the GPU.
+     *
+     * @return Number of collected results.
+     */
+    size_t collectResults();
+
+    /**
+     * Gets the last known result of the query - if any samples have passed.
+     */
+    bool isVisible(size_t handle) const;
+
+    /**
+     * Checks, if result of the query is still pending.
+     */
+    bool isPending(size_t handle) const;
+
+    /**
+     * Begins conditional rendering - following draw calls are discarded by the GPU, if no samples have passed in
+     * the last issued query, so visibility is decided without the CPU reading the result at all.
+     *
+     * @param handle  Handle of the query
+     * @param mode    Conditional rendering mode (with default GL_QUERY_NO_WAIT, GPU renders if the result isn't ready yet)
+     *
+     * @return False if the query has never been issued (then nothing happens and endConditionalRender must not be called).
+     */
+    bool beginConditionalRender(size_t handle, GLenum mode = GL_QUERY_NO_WAIT) const;
+
+    /**
+     * Ends conditional rendering begun by beginConditionalRender.
+     */
+    void endConditionalRender() const;
+
+    /**
+     * Gets number of queries acquired from the pool.
+     */
+    size_t getNumAcquiredQueries() const;
+
+    /**
+     * Gets number of queries, whose results are still pending.
+     */
+    size_t getNumPendingQueries() const;
+
+    /**
+     * Deletes all queries of the pool. All handles become invalid.
+     */
+    void deleteQueries();
+
+private:
+    /**
+     * One query of the pool with its last known result.
+     */
+    struct Query
+    {
+        GLuint queryID; // OpenGL query object ID
+        bool isAcquired; // If the query is acquired (not in the list of free queries)
+        bool isPending; // If the query has been issued and its result hasn't been collected yet
+        bool hasBeenIssued; // If the query has been issued at least once since it was acquired
+        bool isVisible; // Last known result of the query
+    };
+
+    GLenum queryTarget_; // Target of all queries of the pool
+    std::vector<Query> queries_; // All queries of the pool, handle is an index here
+    std::vector<size_t> freeQueries_; // Handles of released queries, that can be reused
+    std::vector<size_t> pendingQueries_; // Handles of queries with pending results, in order of issuing
+};
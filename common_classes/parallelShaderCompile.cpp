@@ -0,0 +1,71 @@
+// STL
+#include <iostream>
+#include <mutex>
+
+// GLFW
+#include <GLFW/glfw3.h>
+
+// Project
+#include "parallelShaderCompile.h"
+
+namespace {
+
+typedef void (APIENTRYP PFN_GL_MAX_SHADER_COMPILER_THREADS)(GLuint count);
+
+bool isParallelShaderCompileSupported = false; // Flag telling, whether the extension has been found and loaded
+
+} // namespace
+
+const GLenum ParallelShaderCompile::MAX_SHADER_COMPILER_THREADS_KHR = 0x91B0;
+const GLenum ParallelShaderCompile::COMPLETION_STATUS_KHR = 0x91B1;
+
+bool ParallelShaderCompile::isSupported()
+{
+    static std::once_flag loadOnceFlag;
+    std::call_once(loadOnceFlag, []()
+    {
+        // KHR and ARB versions are the same, only the function name suffix differs
+        PFN_GL_MAX_SHADER_COMPILER_THREADS maxShaderCompilerThreads = nullptr;
+        if (glfwExtensionSupported("GL_KHR_parallel_shader_compile")) {
+            maxShaderCompilerThreads = reinterpret_cast<PFN_GL_MAX_SHADER_COMPILER_THREADS>(glfwGetProcAddress("glMaxShaderCompilerThreadsKHR"));
+        }
+        else if (glfwExtensionSupported("GL_ARB_parallel_shader_compile")) {
+            maxShaderCompilerThreads = reinterpret_cast<PFN_GL_MAX_SHADER_COMPILER_THREADS>(glfwGetProcAddress("glMaxShaderCompilerThreadsARB"));
+        }
+
+        if (maxShaderCompilerThreads == nullptr)
+        {
+            std::cout << "Parallel shader compilation is not supported, shaders will be compiled one after another" << std::endl;
+            return;
+        }
+
+        // Let the driver decide, how many threads it uses
+        maxShaderCompilerThreads(0xFFFFFFFF);
+        isParallelShaderCompileSupported = true;
+        std::cout << "Parallel shader compilation is supported" << std::endl;
+    });
+
+    return isParallelShaderCompileSupported;
+}
+
+bool ParallelShaderCompile::isShaderCompilationFinished(const GLuint shaderID)
+{
+    if (!isSupported()) {
+        return true;
+    }
+
+    GLint completionStatus = GL_TRUE;
+    glGetShaderiv(shaderID, COMPLETION_STATUS_KHR, &completionStatus);
+    return completionStatus == GL_TRUE;
+}
+
+bool ParallelShaderCompile::isProgramLinkingFinished(const GLuint programID)
+{
+    if (!isSupported()) {
+        return true;
+    }
+
+    GLint completionStatus = GL_TRUE;
+    glGetProgramiv(programID, COMPLETION_STATUS_KHR, &completionStatus);
+    return completionStatus == GL_TRUE;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+// GLAD
+#include <glad/glad.h>
+
+/**
+ * Wraps GL_KHR_parallel_shader_compile (or its ARB twin) extension. The extension is not part of the generated
+ * GLAD loader, so its function is loaded manually. When it's supported, driver compiles shaders and links programs
+ * on its own threads and completion of compiles / links can be polled without blocking.
+ */
+class ParallelShaderCompile
+{
+public:
+    static const GLenum MAX_SHADER_COMPILER_THREADS_KHR; // Enum of maximal number of compiler threads (same as in ARB version)
+    static const GLenum COMPLETION_STATUS_KHR; // Enum of non-blocking completion status query (same as in ARB version)
+
+    /**
+     * Checks, if parallel shader compilation is supported. First call loads the extension function
+     * and lets the driver use as many compiler threads as it wants (requires current OpenGL context).
+     */
+    static bool isSupported();
+
+    /**
+     * Checks, if compilation of given shader has finished. Without the extension, it always returns true,
+     * because status query blocks until the compilation is done anyway.
+     */
+    static bool isShaderCompilationFinished(GLuint shaderID);
+
+    /**
+     * Checks, if linking of given program has finished. Without the extension, it always returns true,
+     * because status query blocks until the linking is done anyway.
+     */
+    static bool isProgramLinkingFinished(GLuint programID);
+};
@@ -0,0 +1,237 @@
+// STL
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <chrono>
+#include <cstring>
+
+// Platform specific directory creation
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+// Project
+#include "programBinaryCache.h"
+
+namespace {
+
+const uint32_t BINARY_FILE_MAGIC = 0x4342504D; // "MPBC" - file magic of cached program binary
+const uint32_t BINARY_FILE_VERSION = 1; // Version of cached program binary file layout
+
+/**
+ * Header of every cached program binary file.
+ */
+struct BinaryFileHeader
+{
+    uint32_t magic; // Must be BINARY_FILE_MAGIC
+    uint32_t version; // Must be BINARY_FILE_VERSION
+    uint64_t programKey; // Key of the stored program
+    uint32_t binaryFormat; // Driver-specific binary format
+    uint32_t binaryLength; // Length of the binary following the header
+};
+
+} // namespace
+
+const std::string ProgramBinaryCache::DEFAULT_CACHE_DIRECTORY = "shader_cache";
+const uint64_t ProgramBinaryCache::HASH_SEED = 14695981039346656037ULL;
+
+double ProgramBinaryCache::Statistics::getHitRate() const
+{
+    const auto numLookups = numHits + numMisses + numRejected;
+    return numLookups > 0 ? static_cast<double>(numHits) / numLookups : 0.0;
+}
+
+ProgramBinaryCache& ProgramBinaryCache::getInstance()
+{
+    static ProgramBinaryCache cache;
+    return cache;
+}
+
+void ProgramBinaryCache::setEnabled(const bool enabled)
+{
+    isEnabled_ = enabled;
+}
+
+bool ProgramBinaryCache::isEnabled() const
+{
+    if (!isEnabled_) {
+        return false;
+    }
+
+    // Some drivers don't support any binary format, then it makes no sense to even try
+    if (isSupported_ == -1)
+    {
+        GLint numBinaryFormats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numBinaryFormats);
+        isSupported_ = numBinaryFormats > 0 ? 1 : 0;
+        if (isSupported_ == 0) {
+            std::cout << "Driver does not support any program binary format, program binary cache is disabled" << std::endl;
+        }
+    }
+
+    return isSupported_ == 1;
+}
+
+void ProgramBinaryCache::setCacheDirectory(const std::string& cacheDirectory)
+{
+    cacheDirectory_ = cacheDirectory;
+    isCacheDirectoryCreated_ = false;
+}
+
+uint64_t ProgramBinaryCache::hashData(const void* data, const size_t size, const uint64_t seed)
+{
+    auto result = seed;
+    const auto bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        result ^= bytes[i];
+        result *= 1099511628211ULL;
+    }
+
+    return result;
+}
+
+uint64_t ProgramBinaryCache::getDriverHash() const
+{
+    if (isDriverHashCalculated_) {
+        return driverHash_;
+    }
+
+    driverHash_ = HASH_SEED;
+    for (const auto name : { GL_VENDOR, GL_RENDERER, GL_VERSION })
+    {
+        const auto value = reinterpret_cast<const char*>(glGetString(name));
+        if (value != nullptr) {
+            driverHash_ = hashData(value, strlen(value), driverHash_);
+        }
+
+        // Separate the strings, so that different splits don't produce the same hash
+        const char separator = '\n';
+        driverHash_ = hashData(&separator, 1, driverHash_);
+    }
+
+    isDriverHashCalculated_ = true;
+    return driverHash_;
+}
+
+bool ProgramBinaryCache::tryLoadProgramBinary(const GLuint programID, const uint64_t programKey)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    std::ifstream file(getBinaryFilePath(programKey), std::ios::binary);
+    if (!file.good())
+    {
+        statistics_.numMisses++;
+        return false;
+    }
+
+    BinaryFileHeader header;
+    std::vector<char> binary;
+    file.read(reinterpret_cast<char*>(&header), sizeof(BinaryFileHeader));
+    if (file.good() && header.magic == BINARY_FILE_MAGIC && header.version == BINARY_FILE_VERSION && header.programKey == programKey)
+    {
+        binary.resize(header.binaryLength);
+        file.read(binary.data(), header.binaryLength);
+    }
+
+    if (binary.empty() || !file.good())
+    {
+        std::cerr << "Cached program binary " << getBinaryFilePath(programKey) << " is corrupted, program will be compiled from sources" << std::endl;
+        statistics_.numRejected++;
+        return false;
+    }
+
+    // Driver may reject the binary (e.g. after driver update), in that case program has to be compiled again
+    glProgramBinary(programID, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+    GLint linkStatus = GL_FALSE;
+    glGetProgramiv(programID, GL_LINK_STATUS, &linkStatus);
+    if (linkStatus != GL_TRUE)
+    {
+        std::cout << "Cached program binary " << getBinaryFilePath(programKey) << " has been rejected by the driver, program will be compiled from sources" << std::endl;
+        statistics_.numRejected++;
+        return false;
+    }
+
+    statistics_.numHits++;
+    statistics_.secondsLoadingBinaries += std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    return true;
+}
+
+void ProgramBinaryCache::saveProgramBinary(const GLuint programID, const uint64_t programKey)
+{
+    GLint binaryLength = 0;
+    glGetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+    if (binaryLength <= 0) {
+        return;
+    }
+
+    BinaryFileHeader header;
+    header.magic = BINARY_FILE_MAGIC;
+    header.version = BINARY_FILE_VERSION;
+    header.programKey = programKey;
+
+    std::vector<char> binary(binaryLength);
+    GLenum binaryFormat = 0;
+    GLsizei retrievedLength = 0;
+    glGetProgramBinary(programID, binaryLength, &retrievedLength, &binaryFormat, binary.data());
+    if (retrievedLength <= 0) {
+        return;
+    }
+
+    header.binaryFormat = binaryFormat;
+    header.binaryLength = static_cast<uint32_t>(retrievedLength);
+
+    if (!isCacheDirectoryCreated_)
+    {
+        // Directory might exist already, so the result is not checked - opening the file will fail if something's wrong
+#ifdef _WIN32
+        _mkdir(cacheDirectory_.c_str());
+#else
+        mkdir(cacheDirectory_.c_str(), 0755);
+#endif
+        isCacheDirectoryCreated_ = true;
+    }
+
+    std::ofstream file(getBinaryFilePath(programKey), std::ios::binary | std::ios::trunc);
+    if (!file.good())
+    {
+        std::cerr << "Could not store program binary to " << getBinaryFilePath(programKey) << "!" << std::endl;
+        return;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(BinaryFileHeader));
+    file.write(binary.data(), retrievedLength);
+}
+
+void ProgramBinaryCache::addCompileAndLinkTime(const double seconds)
+{
+    statistics_.secondsCompilingAndLinking += seconds;
+}
+
+const ProgramBinaryCache::Statistics& ProgramBinaryCache::getStatistics() const
+{
+    return statistics_;
+}
+
+void ProgramBinaryCache::printStatistics() const
+{
+    const auto numLookups = statistics_.numHits + statistics_.numMisses + statistics_.numRejected;
+    if (numLookups == 0) {
+        return;
+    }
+
+    std::cout << "Program binary cache: " << statistics_.numHits << " hits, " << statistics_.numMisses << " misses, "
+        << statistics_.numRejected << " rejected (hit rate " << std::fixed << std::setprecision(1) << statistics_.getHitRate() * 100.0 << "%), "
+        << std::setprecision(3) << statistics_.secondsLoadingBinaries << " s loading binaries, "
+        << statistics_.secondsCompilingAndLinking << " s compiling and linking" << std::defaultfloat << std::endl;
+}
+
+std::string ProgramBinaryCache::getBinaryFilePath(const uint64_t programKey) const
+{
+    std::stringstream ss;
+    ss << cacheDirectory_ << "/" << std::hex << std::setw(16) << std::setfill('0') << programKey << ".bin";
+    return ss.str();
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+// STL
+#include <string>
+#include <cstdint>
+
+// GLAD
+#include <glad/glad.h>
+
+/**
+ * Singleton class that stores linked shader program binaries on disk and loads them on next launches,
+ * so that shaders don't have to be compiled and programs linked again. Binaries are keyed by a hash of
+ * the fully preprocessed sources of all shaders of the program, transform feedback recorded variables
+ * and driver vendor, renderer and version strings. If the binary is missing, stale or rejected by the driver,
+ * program is compiled and linked normally and its new binary is stored.
+ */
+class ProgramBinaryCache
+{
+public:
+    static const std::string DEFAULT_CACHE_DIRECTORY; // Default directory to store program binaries in (relative to working directory)
+    static const uint64_t HASH_SEED; // Initial value of hashes (FNV-1a offset basis)
+
+    /**
+     * Startup statistics of the cache.
+     */
+    struct Statistics
+    {
+        int numHits{ 0 }; // Number of programs loaded from the cache
+        int numMisses{ 0 }; // Number of programs not found in the cache
+        int numRejected{ 0 }; // Number of cached binaries rejected by the driver (or corrupted)
+        double secondsLoadingBinaries{ 0.0 }; // Total time spent loading programs from binaries
+        double secondsCompilingAndLinking{ 0.0 }; // Total time spent compiling and linking programs from sources
+
+        /**
+         * Gets ratio of cache hits to all cache lookups (0.0 to 1.0).
+         */
+        double getHitRate() const;
+    };
+
+    /**
+     * Gets the one and only instance of the program binary cache.
+     */
+    static ProgramBinaryCache& getInstance();
+
+    /**
+     * Enables or disables the cache. When the cache is disabled, shaders are compiled immediately when they're loaded.
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * Checks, if the cache is enabled and if the driver supports at least one program binary format.
+     */
+    bool isEnabled() const;
+
+    /**
+     * Sets directory, where program binaries are stored.
+     */
+    void setCacheDirectory(const std::string& cacheDirectory);
+
+    /**
+     * Calculates 64-bit FNV-1a hash of given data, optionally continuing from previous hash.
+     *
+     * @param data  Pointer to the data
+     * @param size  Size of the data in bytes
+     * @param seed  Hash to continue from
+     */
+    static uint64_t hashData(const void* data, size_t size, uint64_t seed = HASH_SEED);
+
+    /**
+     * Gets hash of driver vendor, renderer and version strings. Binaries are valid only for the same driver.
+     */
+    uint64_t getDriverHash() const;
+
+    /**
+     * Tries to load program binary with given key into the program. Updates hit / miss / rejected counters.
+     *
+     * @param programID   OpenGL shader program ID
+     * @param programKey  Key (hash) of the program
+     *
+     * @return True, if the binary has been found and program has been linked from it successfully.
+     */
+    bool tryLoadProgramBinary(GLuint programID, uint64_t programKey);
+
+    /**
+     * Retrieves binary of successfully linked program and stores it under given key.
+     *
+     * @param programID   OpenGL shader program ID
+     * @param programKey  Key (hash) of the program
+     */
+    void saveProgramBinary(GLuint programID, uint64_t programKey);
+
+    /**
+     * Adds time spent compiling and linking program from sources (after a cache miss) to statistics.
+     */
+    void addCompileAndLinkTime(double seconds);
+
+    /**
+     * Gets startup statistics of the cache.
+     */
+    const Statistics& getStatistics() const;
+
+    /**
+     * Prints statistics of the cache to standard output (if any program has been looked up).
+     */
+    void printStatistics() const;
+
+private:
+    ProgramBinaryCache() {} // Private constructor to make class singleton
+    ProgramBinaryCache(const ProgramBinaryCache&) = delete; // No copy constructor allowed
+    void operator=(const ProgramBinaryCache&) = delete; // No copy assignment allowed
+
+    /**
+     * Gets path of the file, where program with given key is stored.
+     */
+    std::string getBinaryFilePath(uint64_t programKey) const;
+
+    bool isEnabled_{ true }; // Flag telling, whether the cache is enabled
+    std::string cacheDirectory_{ DEFAULT_CACHE_DIRECTORY }; // Directory to store program binaries in
+    mutable int isSupported_{ -1 }; // Whether driver supports program binaries (-1 means not queried yet)
+    mutable bool isDriverHashCalculated_{ false }; // Flag telling, whether driver hash has been calculated already
+    mutable uint64_t driverHash_{ 0 }; // Cached hash of driver strings
+    bool isCacheDirectoryCreated_{ false }; // Flag telling, whether we have tried to create cache directory already
+    Statistics statistics_; // Startup statistics of the cache
+};
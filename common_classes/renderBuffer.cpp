@@ -3,6 +3,36 @@
 
 // Project
 #include "renderBuffer.h"
+#include "gpuResourceRegistry.h"
+
+namespace {
+
+/**
+ * Estimates, how many bytes one pixel of renderbuffer with given internal format takes in GPU memory.
+ */
+size_t getBytesPerPixel(GLenum internalFormat)
+{
+    switch (internalFormat)
+    {
+        case GL_R8:
+        case GL_STENCIL_INDEX8:
+            return 1;
+        case GL_DEPTH_COMPONENT16:
+        case GL_RG8:
+            return 2;
+        case GL_RGB8:
+            return 3;
+        case GL_RGBA16F:
+        case GL_DEPTH32F_STENCIL8:
+            return 8;
+        case GL_RGBA32F:
+            return 16;
+        default:
+            return 4;
+    }
+}
+
+} // namespace
 
 RenderBuffer::~RenderBuffer()
 {
@@ -24,6 +54,8 @@ bool RenderBuffer::create(GLenum internalFormat, GLsizei width, GLsizei height)
     // Bind newly created renderbuffer and set its storage attributes
     glBindRenderbuffer(GL_RENDERBUFFER, renderBufferID_);
     glRenderbufferStorage(GL_RENDERBUFFER, internalFormat, width, height);
+    GPUResourceRegistry::getInstance().registerResource(GPUResourceType::RenderBuffer, renderBufferID_,
+        static_cast<size_t>(width) * height * getBytesPerPixel(internalFormat));
 
     // Cache the attributes as member variables
     internalFormat_ = internalFormat;
@@ -53,6 +85,7 @@ void RenderBuffer::deleteRenderBuffer()
     }
 
     std::cout << "Deleting renderbuffer with ID #" << renderBufferID_ << std::endl;
+    GPUResourceRegistry::getInstance().unregisterResource(GPUResourceType::RenderBuffer, renderBufferID_);
     glDeleteRenderbuffers(1, &renderBufferID_);
     renderBufferID_ = 0;
     width_ = 0;
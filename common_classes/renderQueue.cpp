@@ -0,0 +1,212 @@
+// STL
+#include <algorithm>
+#include <iterator>
+#include <numeric>
+
+// Project
+#include "renderQueue.h"
+#include "glStateCache.h"
+
+namespace {
+
+// Layout of the sort key (from the highest bits):
+// opaque:      | pass (2) | program (10) | material (8) | texture (12) | mesh (12) | depth (20) |
+// transparent: | pass (2) | inverted depth (20) | program (10) | material (8) | texture (12) | mesh (12) |
+const int PASS_BITS = 2;
+const int PROGRAM_BITS = 10;
+const int MATERIAL_BITS = 8;
+const int TEXTURE_BITS = 12;
+const int MESH_BITS = 12;
+const int DEPTH_BITS = 20;
+
+static_assert(PASS_BITS + PROGRAM_BITS + MATERIAL_BITS + TEXTURE_BITS + MESH_BITS + DEPTH_BITS == 64, "Sort key must have exactly 64 bits!");
+
+const uint64_t DEPTH_MASK = (uint64_t(1) << DEPTH_BITS) - 1;
+
+} // namespace
+
+void RenderQueue::begin(const glm::mat4& viewMatrix, const float maxDepth)
+{
+    viewMatrix_ = viewMatrix;
+    maxDepth_ = maxDepth > 0.0f ? maxDepth : 1.0f;
+    items_.clear();
+}
+
+void RenderQueue::submit(const DrawItem& drawItem, const Pass pass)
+{
+    const auto viewPosition = viewMatrix_ * drawItem.modelMatrix[3];
+    items_.push_back({ createSortKey(drawItem, pass, -viewPosition.z), pass, drawItem });
+}
+
+void RenderQueue::replay()
+{
+    sortedIndices_.resize(items_.size());
+    std::iota(sortedIndices_.begin(), sortedIndices_.end(), 0);
+    if (isSortingEnabled_) {
+        radixSortItems();
+    }
+
+    statistics_ = Statistics();
+    statistics_.numItems = items_.size();
+
+    ShaderProgram* currentProgram = nullptr;
+    const shader_structs::Material* currentMaterial = nullptr;
+    const Texture* currentTexture = nullptr;
+    const static_meshes_3D::StaticMesh3D* currentMesh = nullptr;
+    auto isTransparentStateSet = false;
+
+    auto& stateCache = GLStateCache::getInstance();
+    for (const auto index : sortedIndices_)
+    {
+        const auto& queuedItem = items_[index];
+        const auto& drawItem = queuedItem.drawItem;
+
+        // Transparent items are blended and they must not write to depth buffer, so that they don't hide each other
+        if (queuedItem.pass == Pass::Transparent && !isTransparentStateSet)
+        {
+            stateCache.enable(GL_BLEND);
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            glDepthMask(GL_FALSE);
+            isTransparentStateSet = true;
+        }
+
+        if (drawItem.shaderProgram != currentProgram)
+        {
+            currentProgram = drawItem.shaderProgram;
+            currentProgram->useProgram();
+            currentMaterial = nullptr; // Material is a uniform, so it's per program
+            statistics_.numProgramSwitches++;
+        }
+
+        if (drawItem.material != nullptr && drawItem.material != currentMaterial)
+        {
+            currentMaterial = drawItem.material;
+            currentMaterial->setUniform(*currentProgram, ShaderConstants::material());
+            statistics_.numMaterialSwitches++;
+        }
+
+        if (drawItem.texture != nullptr && drawItem.texture != currentTexture)
+        {
+            currentTexture = drawItem.texture;
+            currentTexture->bind(0);
+            statistics_.numTextureSwitches++;
+        }
+
+        if (drawItem.mesh != currentMesh)
+        {
+            currentMesh = drawItem.mesh;
+            statistics_.numMeshSwitches++;
+        }
+
+        currentProgram->setModelAndNormalMatrix(drawItem.modelMatrix);
+
+        if (drawItem.setupFunction) {
+            drawItem.setupFunction(*currentProgram);
+        }
+
+        if (drawItem.renderFunction) {
+            drawItem.renderFunction();
+        }
+        else if (drawItem.mesh != nullptr) {
+            drawItem.mesh->render();
+        }
+    }
+
+    if (isTransparentStateSet)
+    {
+        glDepthMask(GL_TRUE);
+        stateCache.disable(GL_BLEND);
+    }
+}
+
+void RenderQueue::setSortingEnabled(const bool enabled)
+{
+    isSortingEnabled_ = enabled;
+}
+
+bool RenderQueue::isSortingEnabled() const
+{
+    return isSortingEnabled_;
+}
+
+size_t RenderQueue::getNumItems() const
+{
+    return items_.size();
+}
+
+const RenderQueue::Statistics& RenderQueue::getStatistics() const
+{
+    return statistics_;
+}
+
+uint64_t RenderQueue::createSortKey(const DrawItem& drawItem, const Pass pass, const float depth)
+{
+    const auto normalizedDepth = std::min(std::max(depth / maxDepth_, 0.0f), 1.0f);
+    const auto quantizedDepth = static_cast<uint64_t>(normalizedDepth * static_cast<float>(DEPTH_MASK)) & DEPTH_MASK;
+
+    uint64_t stateKey = getResourceID(programIDs_, drawItem.shaderProgram, PROGRAM_BITS);
+    stateKey = (stateKey << MATERIAL_BITS) | getResourceID(materialIDs_, drawItem.material, MATERIAL_BITS);
+    stateKey = (stateKey << TEXTURE_BITS) | getResourceID(textureIDs_, drawItem.texture, TEXTURE_BITS);
+    stateKey = (stateKey << MESH_BITS) | getResourceID(meshIDs_, drawItem.mesh, MESH_BITS);
+
+    const auto passKey = static_cast<uint64_t>(pass) << (64 - PASS_BITS);
+    if (pass == Pass::Transparent)
+    {
+        // Back to front - the farthest item must come first, state comes only after depth
+        const auto invertedDepth = DEPTH_MASK - quantizedDepth;
+        return passKey | (invertedDepth << (64 - PASS_BITS - DEPTH_BITS)) | stateKey;
+    }
+
+    // Front to back within the same state, so that early depth test rejects as many fragments as possible
+    return passKey | (stateKey << DEPTH_BITS) | quantizedDepth;
+}
+
+uint64_t RenderQueue::getResourceID(std::unordered_map<const void*, uint64_t>& resourceIDs, const void* resource, const int numBits)
+{
+    if (resource == nullptr) {
+        return 0;
+    }
+
+    // IDs not fitting into the bits wrap around - it only makes sorting less optimal, rendering stays correct
+    auto itResource = resourceIDs.find(resource);
+    if (itResource == resourceIDs.end())
+    {
+        const auto newID = static_cast<uint64_t>(resourceIDs.size()) + 1;
+        itResource = resourceIDs.emplace(resource, newID).first;
+    }
+
+    return itResource->second & ((uint64_t(1) << numBits) - 1);
+}
+
+void RenderQueue::radixSortItems()
+{
+    const auto numItems = sortedIndices_.size();
+    tempIndices_.resize(numItems);
+
+    for (auto shift = 0; shift < 64; shift += 8)
+    {
+        size_t counts[256] = {};
+        for (const auto index : sortedIndices_) {
+            counts[(items_[index].sortKey >> shift) & 0xFF]++;
+        }
+
+        // If all keys have the same byte here, this pass would not change anything
+        if (std::find(std::begin(counts), std::end(counts), numItems) != std::end(counts)) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for (auto& count : counts)
+        {
+            const auto bucketSize = count;
+            count = offset;
+            offset += bucketSize;
+        }
+
+        for (const auto index : sortedIndices_) {
+            tempIndices_[counts[(items_[index].sortKey >> shift) & 0xFF]++] = index;
+        }
+
+        sortedIndices_.swap(tempIndices_);
+    }
+}
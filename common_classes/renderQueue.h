@@ -0,0 +1,150 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+// Project
+#include "shaderProgram.h"
+#include "texture.h"
+#include "shader_structs/material.h"
+#include "static_meshes_3D/staticMesh3D.h"
+
+/**
+ * Collects draw items of a frame and replays them in the order given by their 64-bit sort keys. Opaque items
+ * are ordered by shader program, material, texture and mesh (and front to back within the same state), so that
+ * the state switches are minimized. Transparent items are drawn afterwards from back to front with blending on.
+ * Keys are sorted with LSD radix sort, which is linear in number of items.
+ */
+class RenderQueue
+{
+public:
+    /**
+     * Rendering pass of the draw item - it occupies the highest bits of the sort key, so passes are never mixed.
+     */
+    enum class Pass
+    {
+        Opaque = 0,
+        Transparent = 1
+    };
+
+    /**
+     * Everything needed to render one object. Only shader program is mandatory, either mesh or render function
+     * must be provided as well.
+     */
+    struct DrawItem
+    {
+        ShaderProgram* shaderProgram{ nullptr }; // Shader program to render the item with
+        const shader_structs::Material* material{ nullptr }; // Material to set (nullptr means keep whatever is set)
+        const Texture* texture{ nullptr }; // Texture to bind to the texture unit 0 (nullptr means keep whatever is bound)
+        const static_meshes_3D::StaticMesh3D* mesh{ nullptr }; // Mesh to render
+        glm::mat4 modelMatrix{ 1.0f }; // Model matrix of the item
+        std::function<void(ShaderProgram&)> setupFunction; // Optional function setting additional per-item uniforms
+        std::function<void()> renderFunction; // Optional function rendering the item instead of mesh->render()
+    };
+
+    /**
+     * Statistics of the last replay.
+     */
+    struct Statistics
+    {
+        size_t numItems{ 0 }; // Number of replayed draw items
+        size_t numProgramSwitches{ 0 }; // How many times was shader program switched
+        size_t numMaterialSwitches{ 0 }; // How many times was material set
+        size_t numTextureSwitches{ 0 }; // How many times was texture bound
+        size_t numMeshSwitches{ 0 }; // How many times did the rendered mesh change
+    };
+
+    /**
+     * Clears the queue and prepares it for submitting items of a new frame.
+     *
+     * @param viewMatrix  View matrix used to calculate depth of the items
+     * @param maxDepth    Maximal expected depth of the items (e.g. far plane distance), deeper items share the same depth
+     */
+    void begin(const glm::mat4& viewMatrix, float maxDepth);
+
+    /**
+     * Submits draw item to the queue. Nothing gets rendered until replay() is called.
+     *
+     * @param drawItem  Draw item to submit
+     * @param pass      Rendering pass of the item
+     */
+    void submit(const DrawItem& drawItem, Pass pass = Pass::Opaque);
+
+    /**
+     * Sorts all submitted items and renders them. Items stay in the queue, so they can be replayed again.
+     */
+    void replay();
+
+    /**
+     * Enables or disables sorting (enabled by default). When disabled, items are replayed in submission order,
+     * which is useful to compare the number of state switches.
+     */
+    void setSortingEnabled(bool enabled);
+
+    /**
+     * Checks, if sorting of items is enabled.
+     */
+    bool isSortingEnabled() const;
+
+    /**
+     * Gets number of currently submitted items.
+     */
+    size_t getNumItems() const;
+
+    /**
+     * Gets statistics of the last replay.
+     */
+    const Statistics& getStatistics() const;
+
+private:
+    /**
+     * Draw item together with its sort key.
+     */
+    struct QueuedItem
+    {
+        uint64_t sortKey; // Sort key of the item
+        Pass pass; // Rendering pass of the item
+        DrawItem drawItem; // Item to be rendered
+    };
+
+    /**
+     * Builds 64-bit sort key out of item state and its depth.
+     */
+    uint64_t createSortKey(const DrawItem& drawItem, Pass pass, float depth);
+
+    /**
+     * Gets small integer ID of the resource, that can be stored in the sort key. IDs are assigned
+     * in order of first appearance and kept between frames, so sort order is stable.
+     *
+     * @param resourceIDs  Map with already assigned IDs
+     * @param resource     Pointer to the resource (nullptr gets ID 0)
+     * @param numBits      Number of bits available for the ID in sort key
+     */
+    static uint64_t getResourceID(std::unordered_map<const void*, uint64_t>& resourceIDs, const void* resource, int numBits);
+
+    /**
+     * Sorts indices of queued items by their sort keys using LSD radix sort (8 bits per pass).
+     */
+    void radixSortItems();
+
+    glm::mat4 viewMatrix_{ 1.0f }; // View matrix used to calculate depth
+    float maxDepth_{ 1.0f }; // Maximal expected depth of items
+    bool isSortingEnabled_{ true }; // Flag telling, whether items are sorted before replay
+
+    std::vector<QueuedItem> items_; // All submitted items
+    std::vector<uint32_t> sortedIndices_; // Indices of items in the order of replay
+    std::vector<uint32_t> tempIndices_; // Helper buffer for radix sort
+
+    std::unordered_map<const void*, uint64_t> programIDs_; // Sort IDs of shader programs
+    std::unordered_map<const void*, uint64_t> materialIDs_; // Sort IDs of materials
+    std::unordered_map<const void*, uint64_t> textureIDs_; // Sort IDs of textures
+    std::unordered_map<const void*, uint64_t> meshIDs_; // Sort IDs of meshes
+
+    Statistics statistics_; // Statistics of the last replay
+};
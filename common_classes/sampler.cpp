@@ -3,6 +3,7 @@
 
 // Project
 #include "sampler.h"
+#include "glStateCache.h"
 
 Sampler::~Sampler()
 {
@@ -26,7 +27,7 @@ void Sampler::bind(const int textureUnit) const
         return;
     }
 
-    glBindSampler(textureUnit, _samplerID);
+    GLStateCache::getInstance().bindSampler(textureUnit, _samplerID);
 }
 
 void Sampler::deleteSampler()
@@ -35,6 +36,7 @@ void Sampler::deleteSampler()
         return;
     }
 
+    GLStateCache::getInstance().onSamplerDeleted(_samplerID);
     glDeleteSamplers(1, &_samplerID);
     _isCreated = false;
 }
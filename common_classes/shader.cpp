@@ -1,41 +1,103 @@
 // STL
-#include <sstream>
 #include <iostream>
-#include <fstream>
 
 // Project
 #include "shader.h"
-#include "stringUtils.h"
+#include "shaderPreprocessor.h"
+#include "programBinaryCache.h"
+#include "parallelShaderCompile.h"
+
+std::atomic<size_t> ShaderConstant::numConstants_{ 0 };
+
+ShaderConstant::ShaderConstant(const char* name, uint64_t nameHash)
+    : name_(name)
+    , nameHash_(nameHash)
+    , index_(numConstants_++)
+{
+}
+
+const std::string& ShaderConstant::getName() const
+{
+    return name_;
+}
+
+uint64_t ShaderConstant::getNameHash() const
+{
+    return nameHash_;
+}
+
+size_t ShaderConstant::getIndex() const
+{
+    return index_;
+}
 
 Shader::~Shader()
 {
     deleteShader();
 }
 
-bool Shader::loadShaderFromFile(const std::string& fileName, GLenum shaderType)
+bool Shader::loadShaderFromFile(const std::string& fileName, GLenum shaderType, bool deferCompilation, const ShaderDefines& defines)
 {
-    std::vector<std::string> fileLines;
-    std::set<std::string> filesIncludedAlready;
-
-    if(!getLinesFromFile(fileName, fileLines, filesIncludedAlready))
+    ShaderPreprocessor::Result preprocessed;
+    if(!ShaderPreprocessor::getInstance().preprocessFile(fileName, preprocessed))
         return false;
 
-    std::vector<const char*> programSource;
-    for(const auto& line : fileLines) {
-        programSource.push_back(line.c_str());
+    auto& source = preprocessed.source;
+    sourceFileNames_ = std::move(preprocessed.fileNames);
+
+    // Defines must come after the #version directive, #line directive restores line numbers of the original file
+    if (!defines.empty())
+    {
+        const auto hasVersion = source.compare(0, 8, "#version") == 0;
+        const auto versionLineEnd = hasVersion ? source.find('\n') : std::string::npos;
+        const auto insertPosition = versionLineEnd == std::string::npos ? 0 : versionLineEnd + 1;
+        source.insert(insertPosition, defines.getSourceCode() + "#line " + (insertPosition == 0 ? "1" : "2") + " 0\n");
+    }
+
+    // Remember the source hash, it identifies the shader in program binary cache
+    shaderType_ = shaderType;
+    fileName_ = fileName;
+    sourceHash_ = ProgramBinaryCache::hashData(&shaderType_, sizeof(GLenum));
+    sourceHash_ = ProgramBinaryCache::hashData(source.data(), source.size(), sourceHash_);
+
+    deferredSource_ = std::move(source);
+    return deferCompilation || ensureCompiled();
+}
+
+void Shader::startCompilation() const
+{
+    if (shaderID_ != 0 || deferredSource_.empty()) {
+        return;
     }
 
-    // Create and compile shader
-    shaderID_ = glCreateShader(shaderType);
-    glShaderSource(shaderID_, static_cast<GLsizei>(fileLines.size()), programSource.data(), nullptr);
+    // Create and compile shader, source is not needed anymore after that
+    const auto sourcePtr = deferredSource_.c_str();
+    shaderID_ = glCreateShader(shaderType_);
+    glShaderSource(shaderID_, 1, &sourcePtr, nullptr);
     glCompileShader(shaderID_);
+    deferredSource_.clear();
+    deferredSource_.shrink_to_fit();
+    isCompilationPending_ = true;
+}
+
+bool Shader::isCompilationFinished() const
+{
+    return !isCompilationPending_ || ParallelShaderCompile::isShaderCompilationFinished(shaderID_);
+}
 
-    // Get and check the compilation status
+bool Shader::finishCompilation() const
+{
+    if (!isCompilationPending_) {
+        return isCompiled_;
+    }
+
+    // Get and check the compilation status (this blocks, if the compilation is still running)
+    isCompilationPending_ = false;
     GLint compilationStatus;
     glGetShaderiv(shaderID_, GL_COMPILE_STATUS, &compilationStatus);
     if(compilationStatus == GL_FALSE)
     {
-        std::cerr << "Error! Shader file " << fileName << " wasn't compiled!";
+        std::cerr << "Error! Shader file " << fileName_ << " wasn't compiled!";
 
         // Get length of the error log first
         GLint logLength;
@@ -50,11 +112,15 @@ bool Shader::loadShaderFromFile(const std::string& fileName, GLenum shaderType)
             delete[] logMessage;
         }
 
+        // Source string numbers in the log come from #line directives emitted by the preprocessor
+        for (size_t i = 0; i < sourceFileNames_.size(); i++) {
+            std::cerr << "Source string " << i << ": " << sourceFileNames_[i] << std::endl;
+        }
+
         std::cerr << std::endl;
         return false;
     }
 
-    shaderType_ = shaderType;
     isCompiled_ = true;
     return true;
 }
@@ -64,8 +130,25 @@ bool Shader::isCompiled() const
     return isCompiled_;
 }
 
+bool Shader::isLoaded() const
+{
+    return isCompiled_ || isCompilationPending_ || !deferredSource_.empty();
+}
+
+bool Shader::ensureCompiled() const
+{
+    startCompilation();
+    return finishCompilation();
+}
+
+uint64_t Shader::getSourceHash() const
+{
+    return sourceHash_;
+}
+
 void Shader::deleteShader()
 {
+    deferredSource_.clear();
     if (shaderID_ == 0) {
         return;
     }
@@ -73,6 +156,7 @@ void Shader::deleteShader()
     std::cout << "Deleting shader with ID " << shaderID_ << std::endl;
     glDeleteShader(shaderID_);
     isCompiled_ = false;
+    isCompilationPending_ = false;
     shaderID_ = 0;
 }
 
@@ -85,81 +169,3 @@ GLenum Shader::getShaderType() const
 {
     return shaderType_;
 }
-
-bool Shader::getLinesFromFile(const std::string& fileName, std::vector<std::string>& result, std::set<std::string>& filesIncludedAlready, bool isReadingIncludedFile) const
-{
-    std::ifstream file(fileName);
-    if (!file.good())
-    {
-        std::cout << "File " << fileName << " not found! (Have you set the working directory of the application to $(SolutionDir)bin/?)" << std::endl;
-        return false;
-    }
-
-    std::string startDirectory;
-    auto slashCharacter = '/';
-    auto normFileName = string_utils::normalizeSlashes(fileName, slashCharacter);
-
-    size_t slashIndex = -1;
-    for (auto i = static_cast<int>(fileName.size()) - 1; i >= 0; i--)
-    {
-        if (fileName[i] == slashCharacter)
-        {
-            slashIndex = i;
-            slashCharacter = fileName[i];
-            break;
-        }
-    }
-
-    startDirectory = fileName.substr(0, slashIndex + 1);
-
-    // Get all lines from a file
-    std::string line;
-    auto isInsideIncludePart = false;
-
-    while (std::getline(file, line))
-    {
-        line += "\n"; // getline does not keep newline character
-        std::stringstream ss(line);
-        std::string firstToken;
-        ss >> firstToken;
-        if (firstToken == "#include")
-        {
-            std::string includeFileName;
-            ss >> includeFileName;
-            if (includeFileName.size() > 0 && includeFileName[0] == '\"' && includeFileName[includeFileName.size() - 1] == '\"')
-            {
-                includeFileName = string_utils::normalizeSlashes(includeFileName.substr(1, includeFileName.size() - 2), slashCharacter);
-                std::string directory = startDirectory;
-                std::vector<std::string> subPaths = string_utils::split(includeFileName, slashCharacter);
-                std::string sFinalFileName = "";
-                for (const std::string& subPath : subPaths)
-                {
-                    if (subPath == "..")
-                        directory = string_utils::upOneDirectory(directory, slashCharacter);
-                    else
-                    {
-                        if (sFinalFileName.size() > 0)
-                            sFinalFileName += slashCharacter;
-                        sFinalFileName += subPath;
-                    }
-                }
-
-                const auto combinedIncludeFilePath = directory + sFinalFileName;
-                if (filesIncludedAlready.find(combinedIncludeFilePath) == filesIncludedAlready.end())
-                {
-                    filesIncludedAlready.insert(combinedIncludeFilePath);
-                    getLinesFromFile(directory + sFinalFileName, result, filesIncludedAlready, true);
-                }
-            }
-        }
-        else if (firstToken == "#include_part")
-            isInsideIncludePart = true;
-        else if (firstToken == "#definition_part")
-            isInsideIncludePart = false;
-        else if (!isReadingIncludedFile || (isReadingIncludedFile && isInsideIncludePart))
-            result.push_back(line);
-    }
-
-    file.close();
-    return true;
-}
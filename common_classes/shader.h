@@ -3,16 +3,85 @@
 // STL
 #include <vector>
 #include <string>
-#include <set>
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
 
 // GLAD
 #include <glad/glad.h>
 
-#define DEFINE_SHADER_CONSTANT(constantName, constantValue) \
-static const std::string constantName()                     \
-{                                                           \
-    static std::string value = constantValue;               \
-    return value;                                           \
+// Project
+#include "shaderDefines.h"
+
+/**
+ * Named constant used in shader programs (uniform name, shader key...). Its name is hashed at compile time
+ * and every constant gets a dense index at its construction, so that shader programs can keep uniform
+ * locations of constants in flat tables indexed directly with it. Constant converts to std::string,
+ * so it can be used everywhere, where a plain string name is expected.
+ */
+class ShaderConstant
+{
+public:
+    /**
+     * Creates shader constant with given name and its precomputed hash.
+     *
+     * @param name      Name of the constant
+     * @param nameHash  Hash of the name (see hashName)
+     */
+    ShaderConstant(const char* name, uint64_t nameHash);
+
+    ShaderConstant(const ShaderConstant&) = delete; // No copy constructor allowed
+    void operator=(const ShaderConstant&) = delete; // No copy assignment allowed
+
+    /**
+     * Calculates 64-bit FNV-1a hash of given name. Can be evaluated at compile time.
+     *
+     * @param name    Name to hash
+     * @param length  Number of characters to hash (if it's not given, the whole null-terminated string is hashed)
+     */
+    static constexpr uint64_t hashName(const char* name, size_t length = static_cast<size_t>(-1))
+    {
+        uint64_t result = 14695981039346656037ULL;
+        for (size_t i = 0; i < length && name[i] != '\0'; i++)
+        {
+            result ^= static_cast<unsigned char>(name[i]);
+            result *= 1099511628211ULL;
+        }
+
+        return result;
+    }
+
+    /**
+     * Gets name of the constant.
+     */
+    const std::string& getName() const;
+
+    /**
+     * Gets hash of the name of the constant.
+     */
+    uint64_t getNameHash() const;
+
+    /**
+     * Gets dense index of the constant (constants are numbered from 0 in order of their creation).
+     */
+    size_t getIndex() const;
+
+    operator const std::string&() const { return name_; }
+
+private:
+    static std::atomic<size_t> numConstants_; // Number of constants created so far (used to assign indices)
+
+    std::string name_; // Name of the constant
+    uint64_t nameHash_{ 0 }; // Hash of the name
+    size_t index_{ 0 }; // Dense index of the constant
+};
+
+#define DEFINE_SHADER_CONSTANT(constantName, constantValue)                                                     \
+static const ShaderConstant& constantName()                                                                     \
+{                                                                                                               \
+    static const ShaderConstant value(constantValue,                                                            \
+        std::integral_constant<uint64_t, ShaderConstant::hashName(constantValue)>::value);                      \
+    return value;                                                                                               \
 }
 
 #define DEFINE_SHADER_CONSTANT_INDEX(constantName, constantValue)          \
@@ -77,14 +146,18 @@ public:
     ~Shader();
 
     /**
-     * Loads and compiles shader from a specified file.
+     * Loads and compiles shader from a specified file. Compilation can be deferred - then only the preprocessed
+     * source is kept and shader gets compiled once some program really needs it (it might get linked from
+     * a cached program binary instead).
      *
-     * @param fileName    path to a file
-     * @param shaderType  type of shader (vertex, fragment, geometry...)
+     * @param fileName           path to a file
+     * @param shaderType         type of shader (vertex, fragment, geometry...)
+     * @param deferCompilation   Flag telling, whether compilation should be deferred until it's needed
+     * @param defines            Preprocessor defines injected after the #version directive (to compile a shader variant)
      *
-     * @return True, if the shader has been successfully loaded and compiled, false otherwise.
+     * @return True, if the shader has been successfully loaded and compiled (or its compilation has been deferred), false otherwise.
      */
-    bool loadShaderFromFile(const std::string& fileName, GLenum shaderType);
+    bool loadShaderFromFile(const std::string& fileName, GLenum shaderType, bool deferCompilation = false, const ShaderDefines& defines = ShaderDefines());
 
     /**
      * Checks, if shader is loaded and compiled successfully.
@@ -93,6 +166,40 @@ public:
      */
     bool isCompiled() const;
 
+    /**
+     * Checks, if shader is loaded - it's either compiled or its source is ready to be compiled on demand.
+     */
+    bool isLoaded() const;
+
+    /**
+     * Compiles the shader, if its compilation has been deferred. Does nothing if it has been compiled already.
+     *
+     * @return True, if the shader is compiled or false, if the compilation has failed.
+     */
+    bool ensureCompiled() const;
+
+    /**
+     * Starts compilation of the shader, if its compilation has been deferred, but doesn't wait for the result.
+     */
+    void startCompilation() const;
+
+    /**
+     * Checks, if started compilation has finished (never blocks with parallel shader compilation).
+     */
+    bool isCompilationFinished() const;
+
+    /**
+     * Finishes started compilation - checks its status and reports errors (blocks, if the compilation is still running).
+     *
+     * @return True, if the shader is compiled or false, if the compilation has failed.
+     */
+    bool finishCompilation() const;
+
+    /**
+     * Gets hash of shader type and its fully preprocessed source (with all includes expanded).
+     */
+    uint64_t getSourceHash() const;
+
     /**
      * Deletes shader object from OpenGL.
      */
@@ -109,18 +216,13 @@ public:
     GLenum getShaderType() const;
 
 private:
-    /**
-     * Gets all lines from specified shader file.
-     *
-     * @param fileName               Filename to read the line from.
-     * @param result                 std::vector to store the source code lines into
-     * @param isReadingIncludedFile  Flag saying, whether we are reading file that's been included, that is only #include_part.
-     *
-     * @return True, if the loading has been successful, or false otherwise.
-     */
-    bool getLinesFromFile(const std::string& fileName, std::vector<std::string>& result, std::set<std::string>& filesIncludedAlready, bool isReadingIncludedFile = false) const;
-
-    GLuint shaderID_{ 0 }; // OpenGL-assigned shader ID
+    // Compilation state is mutable, because deferred shaders are compiled on demand by the programs using them
+    mutable GLuint shaderID_{ 0 }; // OpenGL-assigned shader ID
     GLenum shaderType_{ 0 }; // Type of shader (GL_VERTEX_SHADER, GL_FRAGMENT_SHADER...)
-    bool isCompiled_{ false }; // Flag telling, whether shader has been loaded and compiled successfully
+    mutable bool isCompiled_{ false }; // Flag telling, whether shader has been loaded and compiled successfully
+    mutable bool isCompilationPending_{ false }; // Flag telling, whether compilation has been started, but its result has not been checked yet
+    std::string fileName_; // File the shader has been loaded from
+    std::vector<std::string> sourceFileNames_; // Files the preprocessed source consists of (index is source string number in compiler log)
+    mutable std::string deferredSource_; // Preprocessed source waiting for compilation (empty if compilation is not deferred)
+    uint64_t sourceHash_{ 0 }; // Hash of shader type and preprocessed source
 };
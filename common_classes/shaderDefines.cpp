@@ -0,0 +1,45 @@
+// Project
+#include "shaderDefines.h"
+
+ShaderDefines& ShaderDefines::define(const std::string& name, const std::string& value)
+{
+    defines_[name] = value;
+
+    // Rebuild the key, it's usually used many times after the defines are set
+    key_.clear();
+    for (const auto& nameValuePair : defines_)
+    {
+        if (!key_.empty()) {
+            key_ += ';';
+        }
+
+        key_ += nameValuePair.first + '=' + nameValuePair.second;
+    }
+
+    return *this;
+}
+
+ShaderDefines& ShaderDefines::define(const std::string& name, const int value)
+{
+    return define(name, std::to_string(value));
+}
+
+bool ShaderDefines::empty() const
+{
+    return defines_.empty();
+}
+
+const std::string& ShaderDefines::getKey() const
+{
+    return key_;
+}
+
+std::string ShaderDefines::getSourceCode() const
+{
+    std::string result;
+    for (const auto& nameValuePair : defines_) {
+        result += "#define " + nameValuePair.first + " " + nameValuePair.second + "\n";
+    }
+
+    return result;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+// STL
+#include <string>
+#include <map>
+
+/**
+ * Set of preprocessor #defines, that are injected into shader sources right after the #version directive.
+ * Same shader files compiled with different defines give different shader variants, which lets shaders
+ * resolve things like number of lights or enabled features at compile time instead of branching at runtime.
+ */
+class ShaderDefines
+{
+public:
+    /**
+     * Adds (or replaces) a define with given value.
+     *
+     * @param name   Name of the define
+     * @param value  Value of the define (can be empty)
+     *
+     * @return Reference to this object, so that defines can be chained.
+     */
+    ShaderDefines& define(const std::string& name, const std::string& value = "");
+
+    /**
+     * Adds (or replaces) a define with given integer value.
+     */
+    ShaderDefines& define(const std::string& name, int value);
+
+    /**
+     * Checks, if there are no defines.
+     */
+    bool empty() const;
+
+    /**
+     * Gets key uniquely identifying this set of defines (defines are sorted by name, so order of adding them doesn't matter).
+     */
+    const std::string& getKey() const;
+
+    /**
+     * Gets GLSL source code with all the #define directives (one per line).
+     */
+    std::string getSourceCode() const;
+
+private:
+    std::map<std::string, std::string> defines_; // Values of defines by their names
+    std::string key_; // Cached key of the defines
+};
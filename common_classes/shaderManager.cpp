@@ -19,7 +19,7 @@ void ShaderManager::loadVertexShader(const std::string& key, const std::string &
     }
 
     auto vertexShader = std::make_unique<Shader>();
-    if (!vertexShader->loadShaderFromFile(filePath, GL_VERTEX_SHADER))
+    if (!vertexShader->loadShaderFromFile(filePath, GL_VERTEX_SHADER, true))
     {
         auto msg = "Could not load vertex shader '" + filePath + "'!";
         throw std::runtime_error(msg);
@@ -37,7 +37,7 @@ void ShaderManager::loadFragmentShader(const std::string& key, const std::string
     }
 
     auto fragmentShader = std::make_unique<Shader>();
-    if (!fragmentShader->loadShaderFromFile(filePath, GL_FRAGMENT_SHADER))
+    if (!fragmentShader->loadShaderFromFile(filePath, GL_FRAGMENT_SHADER, true))
     {
         auto msg = "Could not load fragment shader '" + filePath + "'!";
         throw std::runtime_error(msg);
@@ -55,7 +55,7 @@ void ShaderManager::loadGeometryShader(const std::string& key, const std::string
     }
 
     auto geometryShader = std::make_unique<Shader>();
-    if (!geometryShader->loadShaderFromFile(filePath, GL_GEOMETRY_SHADER))
+    if (!geometryShader->loadShaderFromFile(filePath, GL_GEOMETRY_SHADER, true))
     {
         auto msg = "Could not load geometry shader '" + filePath + "'!";
         throw std::runtime_error(msg);
@@ -111,11 +111,32 @@ const Shader& ShaderManager::getGeometryShader(const std::string & key) const
     return *_geometryShaderCache.at(key);
 }
 
+const Shader& ShaderManager::getShaderVariant(const GLenum shaderType, const std::string& filePath, const ShaderDefines& defines)
+{
+    const auto variantKey = std::to_string(shaderType) + ":" + filePath + "#" + defines.getKey();
+    const auto itShaderVariant = shaderVariantCache_.find(variantKey);
+    if (itShaderVariant != shaderVariantCache_.end()) {
+        return *itShaderVariant->second;
+    }
+
+    auto shaderVariant = std::make_unique<Shader>();
+    if (!shaderVariant->loadShaderFromFile(filePath, shaderType, true, defines))
+    {
+        auto msg = "Could not load shader '" + filePath + "' with defines '" + defines.getKey() + "'!";
+        throw std::runtime_error(msg);
+    }
+
+    auto& result = *shaderVariant;
+    shaderVariantCache_[variantKey] = std::move(shaderVariant);
+    return result;
+}
+
 void ShaderManager::clearShaderCache()
 {
     _vertexShaderCache.clear();
     _fragmentShaderCache.clear();
     _geometryShaderCache.clear();
+    shaderVariantCache_.clear();
 }
 
 bool ShaderManager::containsVertexShader(const std::string& key) const
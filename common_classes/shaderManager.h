@@ -12,7 +12,9 @@
 #include "shader.h"
 
 /**
- * Singleton class that manages and keeps track of all shaders in the program.
+ * Singleton class that manages and keeps track of all shaders in the program. Shaders are only loaded and preprocessed here,
+ * their compilation is deferred until programs are linked, so that driver can compile them in parallel (or skip them,
+ * if program binary is cached).
  */
 class ShaderManager
 {
@@ -109,6 +111,18 @@ public:
      */
     bool containsGeometryShader(const std::string& key) const;
 
+    /**
+     * Retrieves variant of a shader - shader loaded from given file with given defines. If it's not loaded yet,
+     * it gets loaded and stored, so every variant is loaded only once.
+     *
+     * @param shaderType  Type of shader (vertex, fragment, geometry...)
+     * @param filePath    Path to the shader file
+     * @param defines     Preprocessor defines of the variant
+     *
+     * @return Shader variant instance.
+     */
+    const Shader& getShaderVariant(GLenum shaderType, const std::string& filePath, const ShaderDefines& defines);
+
     /** 
      * Deletes all the loaded shaders from OpenGL and clears the shaders cache.
      */
@@ -122,4 +136,5 @@ private:
     std::map<std::string, std::unique_ptr<Shader>> _vertexShaderCache; // Vertex shader cache - stores vertex shaders within their keys in std::map
     std::map<std::string, std::unique_ptr<Shader>> _fragmentShaderCache; // Fragment shader cache - stores fragment shaders within their keys in std::map
     std::map<std::string, std::unique_ptr<Shader>> _geometryShaderCache; // Gemetry shader cache - stores geometry shaders within their keys in std::map
+    std::map<std::string, std::unique_ptr<Shader>> shaderVariantCache_; // Shader variants cache - key consists of shader type, file path and defines
 };
\ No newline at end of file
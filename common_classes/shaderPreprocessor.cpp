@@ -0,0 +1,274 @@
+// STL
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+
+// Modification time of files
+#include <sys/types.h>
+#include <sys/stat.h>
+
+// Project
+#include "shaderPreprocessor.h"
+
+namespace {
+
+/**
+ * Checks, if the token given by its start and end is equal to given keyword.
+ */
+bool isToken(const char* tokenStart, const char* tokenEnd, const char* keyword)
+{
+    const auto keywordLength = strlen(keyword);
+    return static_cast<size_t>(tokenEnd - tokenStart) == keywordLength && strncmp(tokenStart, keyword, keywordLength) == 0;
+}
+
+/**
+ * Checks, if the character is a whitespace within line (newline is not considered here).
+ */
+bool isLineWhitespace(const char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+} // namespace
+
+ShaderPreprocessor& ShaderPreprocessor::getInstance()
+{
+    static ShaderPreprocessor preprocessor;
+    return preprocessor;
+}
+
+bool ShaderPreprocessor::preprocessFile(const std::string& fileName, Result& result)
+{
+    result.source.clear();
+    result.fileNames.clear();
+
+    // First line of the shader is consecutive to "line 0" of file 0, so no #line directive is emitted before #version
+    PreprocessingState state;
+    state.result = &result;
+    state.lastFileIndex = 0;
+    state.lastLineNumber = 0;
+    return appendFile(normalizePath(fileName.data(), fileName.size()), false, state);
+}
+
+void ShaderPreprocessor::clearCache()
+{
+    parsedFiles_.clear();
+}
+
+size_t ShaderPreprocessor::getNumCacheHits() const
+{
+    return numCacheHits_;
+}
+
+size_t ShaderPreprocessor::getNumFileReads() const
+{
+    return numFileReads_;
+}
+
+std::string ShaderPreprocessor::normalizePath(const char* path, const size_t length)
+{
+    // Collect segments as pointer / length pairs first, resolving "." and ".." on the way
+    std::vector<std::pair<const char*, size_t>> segments;
+    const auto isAbsolute = length > 0 && (path[0] == '/' || path[0] == '\\');
+    size_t segmentStart = 0;
+    for (size_t i = 0; i <= length; i++)
+    {
+        if (i < length && path[i] != '/' && path[i] != '\\') {
+            continue;
+        }
+
+        const auto segmentPtr = path + segmentStart;
+        const auto segmentLength = i - segmentStart;
+        segmentStart = i + 1;
+
+        if (segmentLength == 0 || (segmentLength == 1 && segmentPtr[0] == '.')) {
+            continue;
+        }
+
+        const auto isParentSegment = segmentLength == 2 && segmentPtr[0] == '.' && segmentPtr[1] == '.';
+        const auto canGoUp = !segments.empty() && !(segments.back().second == 2 && segments.back().first[0] == '.' && segments.back().first[1] == '.');
+        if (isParentSegment && canGoUp) {
+            segments.pop_back();
+        }
+        else {
+            segments.push_back(std::make_pair(segmentPtr, segmentLength));
+        }
+    }
+
+    std::string result;
+    result.reserve(length);
+    if (isAbsolute) {
+        result += '/';
+    }
+
+    for (size_t i = 0; i < segments.size(); i++)
+    {
+        if (i > 0) {
+            result += '/';
+        }
+
+        result.append(segments[i].first, segments[i].second);
+    }
+
+    return result;
+}
+
+const ShaderPreprocessor::ParsedFile* ShaderPreprocessor::getParsedFile(const std::string& normalizedPath)
+{
+    struct stat fileStatus;
+    if (stat(normalizedPath.c_str(), &fileStatus) != 0) {
+        return nullptr;
+    }
+
+    // Reuse parsed file, if it has not been modified since it was parsed
+    const auto itParsedFile = parsedFiles_.find(normalizedPath);
+    if (itParsedFile != parsedFiles_.end() && itParsedFile->second.modificationTime == fileStatus.st_mtime)
+    {
+        numCacheHits_++;
+        return &itParsedFile->second;
+    }
+
+    std::ifstream file(normalizedPath, std::ios::binary);
+    if (!file.good()) {
+        return nullptr;
+    }
+
+    // Read the whole file at once
+    ParsedFile parsedFile;
+    parsedFile.modificationTime = fileStatus.st_mtime;
+    file.seekg(0, std::ios::end);
+    const auto fileSize = static_cast<size_t>(file.tellg());
+    file.seekg(0, std::ios::beg);
+    parsedFile.contents.resize(fileSize);
+    if (fileSize > 0) {
+        file.read(&parsedFile.contents[0], fileSize);
+    }
+
+    if (parsedFile.contents.empty() || parsedFile.contents.back() != '\n') {
+        parsedFile.contents += '\n';
+    }
+
+    numFileReads_++;
+
+    // Included files are resolved relatively to the directory of this file
+    const auto lastSlashIndex = normalizedPath.find_last_of('/');
+    const auto directoryLength = lastSlashIndex == std::string::npos ? 0 : lastSlashIndex + 1;
+
+    // Split the contents to lines and recognize preprocessor directives we handle
+    const auto& contents = parsedFile.contents;
+    size_t lineStart = 0;
+    auto lineNumber = 1;
+    while (lineStart < contents.size())
+    {
+        const auto lineEnd = contents.find('\n', lineStart) + 1;
+        const auto linePtr = contents.data() + lineStart;
+        const auto lineEndPtr = contents.data() + lineEnd;
+
+        auto tokenStart = linePtr;
+        while (tokenStart < lineEndPtr && isLineWhitespace(*tokenStart)) {
+            tokenStart++;
+        }
+
+        auto tokenEnd = tokenStart;
+        while (tokenEnd < lineEndPtr && !isLineWhitespace(*tokenEnd) && *tokenEnd != '\n') {
+            tokenEnd++;
+        }
+
+        ParsedLine parsedLine;
+        parsedLine.type = LineType::Code;
+        parsedLine.offset = lineStart;
+        parsedLine.length = lineEnd - lineStart;
+        parsedLine.lineNumber = lineNumber;
+
+        if (isToken(tokenStart, tokenEnd, "#include"))
+        {
+            // Included file name must be in quotes, otherwise the line is just dropped
+            parsedLine.type = LineType::Include;
+            const auto quoteStart = std::find(tokenEnd, lineEndPtr, '\"');
+            const auto quoteEnd = quoteStart < lineEndPtr ? std::find(quoteStart + 1, lineEndPtr, '\"') : lineEndPtr;
+            if (quoteEnd < lineEndPtr)
+            {
+                std::string combinedPath(normalizedPath, 0, directoryLength);
+                combinedPath.append(quoteStart + 1, quoteEnd);
+                parsedLine.includePath = normalizePath(combinedPath.data(), combinedPath.size());
+            }
+        }
+        else if (isToken(tokenStart, tokenEnd, "#include_part")) {
+            parsedLine.type = LineType::IncludePart;
+        }
+        else if (isToken(tokenStart, tokenEnd, "#definition_part")) {
+            parsedLine.type = LineType::DefinitionPart;
+        }
+
+        parsedFile.lines.push_back(std::move(parsedLine));
+        lineStart = lineEnd;
+        lineNumber++;
+    }
+
+    auto& cachedFile = parsedFiles_[normalizedPath];
+    cachedFile = std::move(parsedFile);
+    return &cachedFile;
+}
+
+bool ShaderPreprocessor::appendFile(const std::string& normalizedPath, const bool isIncludedFile, PreprocessingState& state)
+{
+    const auto parsedFile = getParsedFile(normalizedPath);
+    if (parsedFile == nullptr)
+    {
+        std::cout << "File " << normalizedPath << " not found! (Have you set the working directory of the application to $(SolutionDir)bin/?)" << std::endl;
+        return false;
+    }
+
+    auto& result = *state.result;
+    const auto fileIndex = static_cast<int>(result.fileNames.size());
+    result.fileNames.push_back(normalizedPath);
+    if (!isIncludedFile) {
+        result.source.reserve(parsedFile->contents.size() * 2);
+    }
+
+    auto isInsideIncludePart = false;
+    for (const auto& line : parsedFile->lines)
+    {
+        switch (line.type)
+        {
+            case LineType::Include:
+            {
+                const auto& includedFiles = state.filesIncludedAlready;
+                if (!line.includePath.empty() && std::find(includedFiles.begin(), includedFiles.end(), line.includePath) == includedFiles.end())
+                {
+                    state.filesIncludedAlready.push_back(line.includePath);
+                    appendFile(line.includePath, true, state);
+                }
+                break;
+            }
+
+            case LineType::IncludePart:
+                isInsideIncludePart = true;
+                break;
+
+            case LineType::DefinitionPart:
+                isInsideIncludePart = false;
+                break;
+
+            case LineType::Code:
+            {
+                if (isIncludedFile && !isInsideIncludePart) {
+                    break;
+                }
+
+                // Whenever lines stop being consecutive (file switch or skipped lines), tell the compiler where we are
+                if (state.lastFileIndex != fileIndex || state.lastLineNumber + 1 != line.lineNumber) {
+                    result.source += "#line " + std::to_string(line.lineNumber) + " " + std::to_string(fileIndex) + "\n";
+                }
+
+                result.source.append(parsedFile->contents, line.offset, line.length);
+                state.lastFileIndex = fileIndex;
+                state.lastLineNumber = line.lineNumber;
+                break;
+            }
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+// STL
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <ctime>
+
+/**
+ * Singleton class that preprocesses GLSL shader files - it expands #include directives and handles
+ * #include_part / #definition_part sections of included files. Parsed files are cached by their normalized
+ * path and modification time, so that files shared by many shaders (like lighting or random functions)
+ * are read and parsed only once. Result is one contiguous source with #line directives, which map
+ * lines back to the original files (source string number is index of the file in the result).
+ */
+class ShaderPreprocessor
+{
+public:
+    /**
+     * Result of preprocessing of one shader file.
+     */
+    struct Result
+    {
+        std::string source; // Contiguous preprocessed source
+        std::vector<std::string> fileNames; // Files the source consists of, index is the source string number used in #line directives
+    };
+
+    /**
+     * Gets the one and only instance of the shader preprocessor.
+     */
+    static ShaderPreprocessor& getInstance();
+
+    /**
+     * Preprocesses given shader file.
+     *
+     * @param fileName  Path to the shader file
+     * @param result    Here the preprocessed source and list of source files is returned
+     *
+     * @return True, if the file has been preprocessed successfully or false, if it could not be read.
+     */
+    bool preprocessFile(const std::string& fileName, Result& result);
+
+    /**
+     * Clears cache of parsed files.
+     */
+    void clearCache();
+
+    /**
+     * Gets number of times, a parsed file has been reused from the cache.
+     */
+    size_t getNumCacheHits() const;
+
+    /**
+     * Gets number of times, a file has been read from the disk and parsed.
+     */
+    size_t getNumFileReads() const;
+
+    /**
+     * Normalizes path - all slashes become forward slashes and "." and ".." segments are resolved
+     * (unless ".." goes above the beginning of the path).
+     *
+     * @param path    Pointer to the path characters
+     * @param length  Length of the path
+     *
+     * @return Normalized path.
+     */
+    static std::string normalizePath(const char* path, size_t length);
+
+private:
+    ShaderPreprocessor() {} // Private constructor to make class singleton
+    ShaderPreprocessor(const ShaderPreprocessor&) = delete; // No copy constructor allowed
+    void operator=(const ShaderPreprocessor&) = delete; // No copy assignment allowed
+
+    /**
+     * Types of lines recognized by the preprocessor.
+     */
+    enum class LineType
+    {
+        Code,
+        Include,
+        IncludePart,
+        DefinitionPart
+    };
+
+    /**
+     * One parsed line of a file - it points into the file contents, so no copy of the line is made.
+     */
+    struct ParsedLine
+    {
+        LineType type; // Type of the line
+        size_t offset; // Offset of the line within file contents
+        size_t length; // Length of the line including newline character
+        int lineNumber; // Number of the line within the file (starting from 1)
+        std::string includePath; // Normalized path of included file (only for include lines)
+    };
+
+    /**
+     * File, that has been read and parsed already.
+     */
+    struct ParsedFile
+    {
+        time_t modificationTime{ 0 }; // Modification time of the file at the time it was parsed
+        std::string contents; // Whole contents of the file (with ensured trailing newline)
+        std::vector<ParsedLine> lines; // Parsed lines pointing into contents
+    };
+
+    /**
+     * State of preprocessing of one shader file.
+     */
+    struct PreprocessingState
+    {
+        Result* result; // Result being built
+        std::vector<std::string> filesIncludedAlready; // Normalized paths of files included already (every file is included once only)
+        int lastFileIndex{ -1 }; // Source string number of the last emitted line
+        int lastLineNumber{ 0 }; // Line number of the last emitted line
+    };
+
+    /**
+     * Gets parsed file from the cache or reads and parses it if it's not there or it has changed since.
+     *
+     * @return Pointer to parsed file or nullptr, if the file could not be read.
+     */
+    const ParsedFile* getParsedFile(const std::string& normalizedPath);
+
+    /**
+     * Appends lines of given file to the preprocessing result.
+     *
+     * @param normalizedPath  Normalized path of the file
+     * @param isIncludedFile  Flag telling, whether the file is being included (then only its include parts are taken)
+     * @param state           Preprocessing state
+     *
+     * @return True, if the file has been read successfully.
+     */
+    bool appendFile(const std::string& normalizedPath, bool isIncludedFile, PreprocessingState& state);
+
+    std::unordered_map<std::string, ParsedFile> parsedFiles_; // Cache of parsed files, key is normalized path
+    size_t numCacheHits_{ 0 }; // Number of times a parsed file has been reused
+    size_t numFileReads_{ 0 }; // Number of times a file has been read and parsed
+};
@@ -1,8 +1,17 @@
 // STL
 #include <iostream>
+#include <chrono>
+#include <cstring>
+#include <algorithm>
 
 // Project
 #include "shaderProgram.h"
+#include "programBinaryCache.h"
+#include "parallelShaderCompile.h"
+#include "glStateCache.h"
+
+bool ShaderProgram::isUniformShadowingEnabled_ = true;
+ShaderProgram::UniformStatistics ShaderProgram::uniformStatistics_;
 
 ShaderProgram::~ShaderProgram()
 {
@@ -14,55 +23,95 @@ void ShaderProgram::createProgram()
     shaderProgramID_ = glCreateProgram();
 }
 
-bool ShaderProgram::addShaderToProgram(const Shader& shader) const
+bool ShaderProgram::addShaderToProgram(const Shader& shader)
 {
-    if (!shader.isCompiled())
+    if (!shader.isLoaded())
         return false;
 
-    glAttachShader(shaderProgramID_, shader.getShaderID());
+    shaders_.push_back(&shader);
     return true;
 }
 
 bool ShaderProgram::linkProgram()
 {
-	if (_isLinked) {
-		return true;
-	}
+    startLinkProgram();
+    return finishLinkProgram();
+}
 
-    // Try to link program and get the link status
-    glLinkProgram(shaderProgramID_);
-    GLint linkStatus;
-    glGetProgramiv(shaderProgramID_, GL_LINK_STATUS, &linkStatus);
-    _isLinked = linkStatus == GL_TRUE;
+void ShaderProgram::startLinkProgram()
+{
+    if (linkStage_ != LinkStage::NotStarted) {
+        return;
+    }
 
-    if (!_isLinked)
+    auto& programBinaryCache = ProgramBinaryCache::getInstance();
+    const auto isCacheEnabled = programBinaryCache.isEnabled();
+    programBinaryKey_ = isCacheEnabled ? calculateProgramBinaryKey() : 0;
+    if (isCacheEnabled && programBinaryCache.tryLoadProgramBinary(shaderProgramID_, programBinaryKey_))
     {
-        std::cerr << "Error! Shader program wasn't linked!";
+        _isLinked = true;
+        linkStage_ = LinkStage::Finished;
+        gatherActiveUniformLocations();
+        return;
+    }
 
-        // Get length of the error log first
-        GLint logLength;
-        glGetProgramiv(shaderProgramID_, GL_INFO_LOG_LENGTH, &logLength);
+    // Start compilation of all shaders at once, so that the driver can compile them in parallel
+    linkStartTime_ = std::chrono::steady_clock::now();
+    for (const auto shader : shaders_) {
+        shader->startCompilation();
+    }
 
-        // If there is some log, then retrieve it and output extra information
-        if (logLength > 0)
+    linkStage_ = LinkStage::CompilingShaders;
+}
+
+bool ShaderProgram::updateLinkProgram()
+{
+    if (linkStage_ == LinkStage::CompilingShaders)
+    {
+        for (const auto shader : shaders_)
         {
-            GLchar* logMessage = new GLchar[logLength];
-            glGetProgramInfoLog(shaderProgramID_, logLength, nullptr, logMessage);
-            std::cerr << " The linker returned: " << std::endl << std::endl << logMessage;
-            delete[] logMessage;
+            if (!shader->isCompilationFinished()) {
+                return false;
+            }
         }
 
-        std::cerr << std::endl;
-        return false;
+        startLinkingFromSources();
     }
 
+    if (linkStage_ == LinkStage::Linking)
+    {
+        if (!ParallelShaderCompile::isProgramLinkingFinished(shaderProgramID_)) {
+            return false;
+        }
+
+        finishLinkingFromSources();
+    }
+
+    return linkStage_ == LinkStage::Finished;
+}
+
+bool ShaderProgram::finishLinkProgram()
+{
+    if (linkStage_ == LinkStage::CompilingShaders) {
+        startLinkingFromSources();
+    }
+
+    if (linkStage_ == LinkStage::Linking) {
+        finishLinkingFromSources();
+    }
+
+    return _isLinked;
+}
+
+bool ShaderProgram::isLinked() const
+{
     return _isLinked;
 }
 
 void ShaderProgram::useProgram() const
 {
     if (_isLinked) {
-        glUseProgram(shaderProgramID_);
+        GLStateCache::getInstance().useProgram(shaderProgramID_);
     }
 }
 
@@ -73,8 +122,15 @@ void ShaderProgram::deleteProgram()
     }
 
     std::cout << "Deleting shader program with ID " << shaderProgramID_ << std::endl;
+    GLStateCache::getInstance().onProgramDeleted(shaderProgramID_);
     glDeleteProgram(shaderProgramID_);
     _isLinked = false;
+    linkStage_ = LinkStage::NotStarted;
+    shaders_.clear();
+    _uniforms.clear();
+    activeUniforms_.clear();
+    uniformShadows_.clear();
+    constantUniforms_.clear();
 }
 
 GLuint ShaderProgram::getShaderProgramID() const
@@ -92,6 +148,16 @@ Uniform& ShaderProgram::operator[](const std::string& varName)
     return _uniforms[varName];
 }
 
+Uniform& ShaderProgram::operator[](const ShaderConstant& constant)
+{
+    const auto index = constant.getIndex();
+    if (index < constantUniforms_.size() && constantUniforms_[index].isResolved()) {
+        return constantUniforms_[index];
+    }
+
+    return resolveConstantUniform(constant);
+}
+
 // Model and normal matrix setting is pretty common, that's why this convenience function
 
 void ShaderProgram::setModelAndNormalMatrix(const glm::mat4& modelMatrix)
@@ -124,12 +190,202 @@ void ShaderProgram::bindUniformBlockToBindingPoint(const std::string& uniformBlo
     }
 }
 
-void ShaderProgram::setTransformFeedbackRecordedVariables(const std::vector<std::string>& recordedVariablesNames, const GLenum bufferMode) const
+void ShaderProgram::setTransformFeedbackRecordedVariables(const std::vector<std::string>& recordedVariablesNames, const GLenum bufferMode)
 {
+	// Recorded variables are part of the program binary, so they must be part of its cache key as well
+	transformFeedbackVariablesHash_ = ProgramBinaryCache::hashData(&bufferMode, sizeof(GLenum));
 	std::vector<const char*> recordedVariablesNamesPtrs;
 	for (const auto& recordedVariableName : recordedVariablesNames) {
 		recordedVariablesNamesPtrs.push_back(recordedVariableName.c_str());
+		transformFeedbackVariablesHash_ = ProgramBinaryCache::hashData(recordedVariableName.c_str(), recordedVariableName.size() + 1, transformFeedbackVariablesHash_);
 	}
 
 	glTransformFeedbackVaryings(shaderProgramID_, static_cast<GLsizei>(recordedVariablesNamesPtrs.size()), recordedVariablesNamesPtrs.data(), bufferMode);
 }
+
+uint64_t ShaderProgram::calculateProgramBinaryKey() const
+{
+    auto result = ProgramBinaryCache::getInstance().getDriverHash();
+    for (const auto shader : shaders_)
+    {
+        const auto sourceHash = shader->getSourceHash();
+        result = ProgramBinaryCache::hashData(&sourceHash, sizeof(uint64_t), result);
+    }
+
+    return ProgramBinaryCache::hashData(&transformFeedbackVariablesHash_, sizeof(uint64_t), result);
+}
+
+void ShaderProgram::startLinkingFromSources()
+{
+    // Finish compilation of all shaders (those compiled already just report their status) and attach them
+    for (const auto shader : shaders_)
+    {
+        if (!shader->finishCompilation())
+        {
+            linkStage_ = LinkStage::Finished;
+            return;
+        }
+
+        glAttachShader(shaderProgramID_, shader->getShaderID());
+    }
+
+    glProgramParameteri(shaderProgramID_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(shaderProgramID_);
+    linkStage_ = LinkStage::Linking;
+}
+
+void ShaderProgram::finishLinkingFromSources()
+{
+    // Get the link status (this blocks, if the linking is still running)
+    linkStage_ = LinkStage::Finished;
+    GLint linkStatus;
+    glGetProgramiv(shaderProgramID_, GL_LINK_STATUS, &linkStatus);
+    if (linkStatus != GL_TRUE)
+    {
+        std::cerr << "Error! Shader program wasn't linked!";
+
+        // Get length of the error log first
+        GLint logLength;
+        glGetProgramiv(shaderProgramID_, GL_INFO_LOG_LENGTH, &logLength);
+
+        // If there is some log, then retrieve it and output extra information
+        if (logLength > 0)
+        {
+            GLchar* logMessage = new GLchar[logLength];
+            glGetProgramInfoLog(shaderProgramID_, logLength, nullptr, logMessage);
+            std::cerr << " The linker returned: " << std::endl << std::endl << logMessage;
+            delete[] logMessage;
+        }
+
+        std::cerr << std::endl;
+        return;
+    }
+
+    _isLinked = true;
+    auto& programBinaryCache = ProgramBinaryCache::getInstance();
+    if (programBinaryCache.isEnabled())
+    {
+        programBinaryCache.addCompileAndLinkTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - linkStartTime_).count());
+        programBinaryCache.saveProgramBinary(shaderProgramID_, programBinaryKey_);
+    }
+
+    gatherActiveUniformLocations();
+}
+
+void ShaderProgram::gatherActiveUniformLocations()
+{
+    activeUniforms_.clear();
+    constantUniforms_.clear();
+    uniformShadows_.clear();
+
+    GLint numActiveUniforms = 0, maxNameLength = 0;
+    glGetProgramiv(shaderProgramID_, GL_ACTIVE_UNIFORMS, &numActiveUniforms);
+    glGetProgramiv(shaderProgramID_, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+    if (numActiveUniforms <= 0 || maxNameLength <= 0) {
+        return;
+    }
+
+    std::vector<GLchar> nameBuffer(maxNameLength);
+    for (GLint i = 0; i < numActiveUniforms; i++)
+    {
+        GLsizei nameLength = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(shaderProgramID_, static_cast<GLuint>(i), maxNameLength, &nameLength, &size, &type, nameBuffer.data());
+
+        // Members of uniform blocks don't have any location, skip them
+        const auto location = glGetUniformLocation(shaderProgramID_, nameBuffer.data());
+        if (location == -1) {
+            continue;
+        }
+
+        const std::string name(nameBuffer.data(), nameLength);
+        activeUniforms_[ShaderConstant::hashName(name.c_str())] = ActiveUniform{ name, location };
+
+        // Arrays are reported as "name[0]", but they are usually set with plain name
+        if (nameLength > 3 && name.compare(nameLength - 3, 3, "[0]") == 0)
+        {
+            const auto plainName = name.substr(0, nameLength - 3);
+            activeUniforms_[ShaderConstant::hashName(plainName.c_str())] = ActiveUniform{ plainName, location };
+        }
+    }
+}
+
+Uniform& ShaderProgram::resolveConstantUniform(const ShaderConstant& constant)
+{
+    const auto index = constant.getIndex();
+    if (index >= constantUniforms_.size()) {
+        constantUniforms_.resize(index + 1);
+    }
+
+    // If the uniform is not among active uniforms (or other name has the same hash), fall back to querying it by name
+    // (this also reports missing uniform)
+    const auto itActiveUniform = activeUniforms_.find(constant.getNameHash());
+    if (itActiveUniform != activeUniforms_.end() && itActiveUniform->second.name == constant.getName()) {
+        constantUniforms_[index] = Uniform(constant.getName(), this, itActiveUniform->second.location);
+    }
+    else {
+        constantUniforms_[index] = Uniform(constant.getName(), this);
+    }
+
+    return constantUniforms_[index];
+}
+
+bool ShaderProgram::updateUniformShadow(const GLint location, const void* data, const size_t size)
+{
+    if (!isUniformShadowingEnabled_ || location < 0 || size > sizeof(glm::mat4))
+    {
+        uniformStatistics_.numIssuedCalls++;
+        return true;
+    }
+
+    const auto index = static_cast<size_t>(location);
+    if (index >= uniformShadows_.size()) {
+        uniformShadows_.resize(index + 1);
+    }
+
+    auto& shadow = uniformShadows_[index];
+    if (shadow.size == size && memcmp(shadow.data, data, size) == 0)
+    {
+        uniformStatistics_.numSkippedCalls++;
+        return false;
+    }
+
+    shadow.size = size;
+    memcpy(shadow.data, data, size);
+    uniformStatistics_.numIssuedCalls++;
+    return true;
+}
+
+void ShaderProgram::invalidateUniformShadows(const GLint location, const GLsizei count)
+{
+    uniformStatistics_.numIssuedCalls++;
+    if (location < 0) {
+        return;
+    }
+
+    const auto endIndex = std::min(static_cast<size_t>(location) + static_cast<size_t>(count), uniformShadows_.size());
+    for (auto index = static_cast<size_t>(location); index < endIndex; index++) {
+        uniformShadows_[index].size = 0;
+    }
+}
+
+void ShaderProgram::setUniformShadowingEnabled(const bool enabled)
+{
+    isUniformShadowingEnabled_ = enabled;
+}
+
+bool ShaderProgram::isUniformShadowingEnabled()
+{
+    return isUniformShadowingEnabled_;
+}
+
+const ShaderProgram::UniformStatistics& ShaderProgram::getUniformStatistics()
+{
+    return uniformStatistics_;
+}
+
+void ShaderProgram::resetUniformStatistics()
+{
+    uniformStatistics_ = UniformStatistics();
+}
@@ -2,7 +2,11 @@
 
 // STL
 #include <map>
+#include <deque>
+#include <unordered_map>
+#include <vector>
 #include <string>
+#include <chrono>
 
 // GLAD
 #include <glad/glad.h>
@@ -20,6 +24,16 @@
 class ShaderProgram
 {
 public:
+    /**
+     * Statistics of uniform uploads - how many glUniform* calls have been issued and how many have been skipped,
+     * because the value was the same as the last one sent to the same program and location.
+     */
+    struct UniformStatistics
+    {
+        size_t numIssuedCalls{ 0 }; // Number of issued glUniform* calls
+        size_t numSkippedCalls{ 0 }; // Number of skipped redundant glUniform* calls
+    };
+
     ~ShaderProgram();
 
     /**
@@ -28,19 +42,49 @@ public:
     void createProgram();
 
     /**
-     * Adds a shader to shader program. Shader must be properly loaded and compiled.
+     * Adds a shader to shader program. Shader must be properly loaded (its compilation might be deferred).
+     * Shaders are attached to the program during linking.
      *
      * @return True, if the shader has been added or false otherwise.
      */
-    bool addShaderToProgram(const Shader& shader) const;
+    bool addShaderToProgram(const Shader& shader);
 
     /**
-     * Links the program. If the function succeeds, shader program is ready to use.
+     * Links the program. If the function succeeds, shader program is ready to use. If program binary cache
+     * is enabled, program is loaded from the cached binary if possible, otherwise shaders are compiled
+     * (if their compilation has been deferred), program is linked and its binary is stored to the cache.
      *
      * @return True, if the shader has been linked or false otherwise.
      */
     bool linkProgram();
 
+    /**
+     * Starts linking of the program without waiting for it. Program is loaded from the cached binary if possible
+     * (then it's linked immediately), otherwise compilation of all its shaders is started. With parallel shader
+     * compilation, driver compiles and links on its own threads and the progress can be polled with updateLinkProgram.
+     */
+    void startLinkProgram();
+
+    /**
+     * Advances started linking of the program without blocking - once all shaders are compiled, program linking
+     * is started and once linking is done, its result is checked.
+     *
+     * @return True, if linking has finished (successfully or not), false if it's still in progress.
+     */
+    bool updateLinkProgram();
+
+    /**
+     * Finishes started linking of the program, waiting for the driver if necessary.
+     *
+     * @return True, if the shader has been linked or false otherwise.
+     */
+    bool finishLinkProgram();
+
+    /**
+     * Checks, if the program has been linked successfully.
+     */
+    bool isLinked() const;
+
     /**
      * Uses this shader program (makes current).
      */
@@ -65,6 +109,17 @@ public:
      */
     Uniform& operator[](const std::string& varName);
 
+    /**
+     * Gets uniform variable by shader constant. Locations of constants are kept in a flat table indexed
+     * with the constant index, so after the first use it's just an array access. First use resolves
+     * the location from active uniforms gathered during linking.
+     *
+     * @param constant  Shader constant with uniform variable name (see DEFINE_SHADER_CONSTANT)
+     *
+     * @return Uniform variable, even if it does not exist (it will be invalid).
+     */
+    Uniform& operator[](const ShaderConstant& constant);
+
     /**
      * Sets model and normal matrix at once. Setting the two together is pretty common,
      * that's why this convenience function exists.
@@ -105,10 +160,118 @@ public:
 	 *
 	 * @see https://www.khronos.org/registry/OpenGL-Refpages/gl4/html/glTransformFeedbackVaryings.xhtml
 	 */
-	void setTransformFeedbackRecordedVariables(const std::vector<std::string>& recordedVariablesNames, GLenum bufferMode = GL_INTERLEAVED_ATTRIBS) const;
+	void setTransformFeedbackRecordedVariables(const std::vector<std::string>& recordedVariablesNames, GLenum bufferMode = GL_INTERLEAVED_ATTRIBS);
+
+    /**
+     * Checks value about to be uploaded to uniform at given location against the last value sent to this program
+     * and location. If it's different (or shadowing is disabled), the value is remembered and call is counted as issued,
+     * otherwise it's counted as skipped. Uniforms are expected to be set while this program is in use.
+     *
+     * @param location  Uniform location
+     * @param data      Pointer to the value to be uploaded
+     * @param size      Size of the value in bytes
+     *
+     * @return True, if the value has to be uploaded or false, if the upload is redundant.
+     */
+    bool updateUniformShadow(GLint location, const void* data, size_t size);
+
+    /**
+     * Forgets last values of uniforms at given location range (used when arrays are uploaded, because they are not shadowed).
+     * The upload is counted as issued.
+     *
+     * @param location  First uniform location
+     * @param count     Number of consecutive locations
+     */
+    void invalidateUniformShadows(GLint location, GLsizei count);
+
+    /**
+     * Enables or disables skipping of redundant uniform uploads in all shader programs (enabled by default).
+     */
+    static void setUniformShadowingEnabled(bool enabled);
+
+    /**
+     * Checks, if skipping of redundant uniform uploads is enabled.
+     */
+    static bool isUniformShadowingEnabled();
+
+    /**
+     * Gets statistics of uniform uploads of all shader programs since the last reset.
+     */
+    static const UniformStatistics& getUniformStatistics();
+
+    /**
+     * Resets statistics of uniform uploads (usually at the beginning of a frame).
+     */
+    static void resetUniformStatistics();
 
 private:
+    /**
+     * Last value sent to one uniform location. Only single values are shadowed, mat4 being the biggest one.
+     */
+    struct UniformShadow
+    {
+        size_t size{ 0 }; // Size of the value in bytes (0 if no value is known)
+        unsigned char data[sizeof(glm::mat4)]; // Raw bytes of the value
+    };
+
+    /**
+     * Active uniform of linked program. Name is kept, so that hash collisions can be told apart.
+     */
+    struct ActiveUniform
+    {
+        std::string name; // Name of the uniform (arrays without "[0]" suffix are stored under their plain name as well)
+        GLint location; // Location of the uniform
+    };
+
+    /**
+     * Stages of program linking.
+     */
+    enum class LinkStage
+    {
+        NotStarted,
+        CompilingShaders,
+        Linking,
+        Finished
+    };
+
+    /**
+     * Calculates key of the program for program binary cache - hash of all shader sources, transform feedback
+     * recorded variables and the driver.
+     */
+    uint64_t calculateProgramBinaryKey() const;
+
+    /**
+     * Finishes compilation of all shaders of the program, attaches them and starts linking of the program.
+     */
+    void startLinkingFromSources();
+
+    /**
+     * Checks the link status of the program and stores its binary to the cache, if the linking has succeeded.
+     */
+    void finishLinkingFromSources();
+
+    /**
+     * Queries all active uniforms of linked program and stores their locations by name hash.
+     */
+    void gatherActiveUniformLocations();
+
+    /**
+     * Resolves uniform of given shader constant and stores it in the flat table of constant uniforms.
+     */
+    Uniform& resolveConstantUniform(const ShaderConstant& constant);
+
     GLuint shaderProgramID_{ 0 }; // OpenGL-assigned shader program ID
+    std::vector<const Shader*> shaders_; // Shaders added to this program (they get attached during linking)
+    uint64_t transformFeedbackVariablesHash_{ 0 }; // Hash of transform feedback recorded variables and buffer mode (0 if not used)
     bool _isLinked{ false }; // Flag teling, whether shader program has been linked successfully
+    LinkStage linkStage_{ LinkStage::NotStarted }; // Current stage of program linking
+    uint64_t programBinaryKey_{ 0 }; // Key of the program in program binary cache (0 if the cache is disabled)
+    std::chrono::steady_clock::time_point linkStartTime_; // Time, when compiling and linking from sources has started
     std::map<std::string, Uniform> _uniforms; // Cache of uniform locations (reduces OpenGL calls)
+    std::unordered_map<uint64_t, ActiveUniform> activeUniforms_; // Active uniforms by their name hash (gathered after linking)
+    std::deque<Uniform> constantUniforms_; // Uniforms of shader constants, indexed with constant index (deque keeps returned references valid when it grows)
+    std::vector<UniformShadow> uniformShadows_; // Last values sent to uniforms, indexed with uniform location
+
+    static bool isUniformShadowingEnabled_; // Flag telling, whether redundant uniform uploads are skipped
+    static UniformStatistics uniformStatistics_; // Statistics of uniform uploads since the last reset
 };
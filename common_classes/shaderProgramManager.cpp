@@ -3,6 +3,8 @@
 
 // Project
 #include "shaderProgramManager.h"
+#include "parallelShaderCompile.h"
+#include "shaderManager.h"
 
 ShaderProgramManager& ShaderProgramManager::getInstance()
 {
@@ -36,23 +38,133 @@ ShaderProgram& ShaderProgramManager::getShaderProgram(const std::string& key) co
     return *_shaderProgramCache.at(key);
 }
 
+void ShaderProgramManager::createShaderProgramVariants(const std::string& key, const std::vector<std::pair<GLenum, std::string>>& shaderFiles)
+{
+    if (shaderProgramVariantsFiles_.count(key) > 0)
+    {
+        auto msg = "Shader program variants with key '" + key + "' already exist!";
+        throw std::runtime_error(msg.c_str());
+    }
+
+    shaderProgramVariantsFiles_[key] = shaderFiles;
+}
+
+ShaderProgram& ShaderProgramManager::getShaderProgramVariant(const std::string& key, const ShaderDefines& defines)
+{
+    const auto variantKey = key + "#" + defines.getKey();
+    const auto itVariant = shaderProgramVariantCache_.find(variantKey);
+    if (itVariant != shaderProgramVariantCache_.end()) {
+        return *itVariant->second;
+    }
+
+    const auto itShaderFiles = shaderProgramVariantsFiles_.find(key);
+    if (itShaderFiles == shaderProgramVariantsFiles_.end())
+    {
+        auto msg = "Attempting to get variant of non-existing shader program variants with key '" + key + "'!";
+        throw std::runtime_error(msg.c_str());
+    }
+
+    auto& sm = ShaderManager::getInstance();
+    auto shaderProgram = std::make_unique<ShaderProgram>();
+    shaderProgram->createProgram();
+    for (const auto& shaderFile : itShaderFiles->second) {
+        shaderProgram->addShaderToProgram(sm.getShaderVariant(shaderFile.first, shaderFile.second, defines));
+    }
+
+    if (!shaderProgram->linkProgram()) {
+        throwLinkError(variantKey);
+    }
+
+    auto& result = *shaderProgram;
+    shaderProgramVariantCache_[variantKey] = std::move(shaderProgram);
+    return result;
+}
+
+size_t ShaderProgramManager::getNumShaderProgramVariants() const
+{
+    return shaderProgramVariantCache_.size();
+}
+
 void ShaderProgramManager::linkAllPrograms()
 {
+    // Start all programs first, so that the driver can compile and link them in parallel
+    startLinkingAllPrograms();
+    for (const auto& keyShaderProgramPair : _shaderProgramCache)
+    {
+        if (!keyShaderProgramPair.second->finishLinkProgram()) {
+            throwLinkError(keyShaderProgramPair.first);
+        }
+    }
+}
+
+void ShaderProgramManager::startLinkingAllPrograms()
+{
+    for (const auto& keyShaderProgramPair : _shaderProgramCache) {
+        keyShaderProgramPair.second->startLinkProgram();
+    }
+}
+
+bool ShaderProgramManager::updateLinkingPrograms()
+{
+    const auto isParallelCompileSupported = ParallelShaderCompile::isSupported();
+    auto areAllProgramsLinked = true;
+    for (const auto& keyShaderProgramPair : _shaderProgramCache)
+    {
+        auto& shaderProgram = *keyShaderProgramPair.second;
+        if (shaderProgram.isLinked()) {
+            continue;
+        }
+
+        if (!shaderProgram.updateLinkProgram())
+        {
+            areAllProgramsLinked = false;
+            continue;
+        }
+
+        if (!shaderProgram.isLinked()) {
+            throwLinkError(keyShaderProgramPair.first);
+        }
+
+        // Without parallel compilation, update has blocked until the program was linked, so don't link more in this call
+        if (!isParallelCompileSupported) {
+            return false;
+        }
+    }
+
+    return areAllProgramsLinked;
+}
+
+float ShaderProgramManager::getLinkingProgress() const
+{
+    if (_shaderProgramCache.empty()) {
+        return 1.0f;
+    }
+
+    auto numLinkedPrograms = 0;
     for (const auto& keyShaderProgramPair : _shaderProgramCache)
     {
-        if (!keyShaderProgramPair.second->linkProgram()) {
-            auto msg = "Could not link shader program with key '" + keyShaderProgramPair.first + "'!";
-            throw std::runtime_error(msg.c_str());
+        if (keyShaderProgramPair.second->isLinked()) {
+            numLinkedPrograms++;
         }
     }
+
+    return static_cast<float>(numLinkedPrograms) / static_cast<float>(_shaderProgramCache.size());
 }
 
 void ShaderProgramManager::clearShaderProgramCache()
 {
     _shaderProgramCache.clear();
+    shaderProgramVariantCache_.clear();
+    shaderProgramVariantsFiles_.clear();
 }
 
 bool ShaderProgramManager::containsShaderProgram(const std::string& key) const
 {
     return _shaderProgramCache.count(key) > 0;
 }
+
+void ShaderProgramManager::throwLinkError(const std::string& key)
+{
+    auto msg = "Could not link shader program with key '" + key + "'!";
+    throw std::runtime_error(msg.c_str());
+}
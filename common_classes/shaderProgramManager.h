@@ -4,6 +4,8 @@
 #include <string>
 #include <map>
 #include <memory>
+#include <vector>
+#include <utility>
 
 // GLAD
 #include <glad/glad.h>
@@ -40,11 +42,57 @@ public:
 	 */
 	ShaderProgram& getShaderProgram(const std::string& key) const;
 
+	/**
+	 * Registers shader program with variants - instead of one program, separate program is compiled and linked
+	 * for every set of defines requested by getShaderProgramVariant. Variants are then cached, so every one
+	 * of them is compiled and linked only once (and it can be loaded from program binary cache on next launches).
+	 *
+	 * @param key          Key of the shader program with variants
+	 * @param shaderFiles  Types and file paths of all shaders of the program
+	 */
+	void createShaderProgramVariants(const std::string& key, const std::vector<std::pair<GLenum, std::string>>& shaderFiles);
+
+	/**
+	 * Retrieves variant of shader program with given defines. If it doesn't exist yet, its shaders
+	 * are loaded and compiled with the defines and the program is linked right away.
+	 *
+	 * @param key      Key of the shader program with variants
+	 * @param defines  Preprocessor defines of the variant
+	 *
+	 * @return Linked shader program variant.
+	 */
+	ShaderProgram& getShaderProgramVariant(const std::string& key, const ShaderDefines& defines);
+
+	/**
+	 * Gets number of shader program variants, that have been created so far.
+	 */
+	size_t getNumShaderProgramVariants() const;
+
 	/**
 	 * Performs linkage of all existing shader programs.
 	 */
 	void linkAllPrograms();
 
+	/**
+	 * Starts linkage of all existing shader programs without waiting for it (see ShaderProgram::startLinkProgram).
+	 * Call updateLinkingPrograms every frame until it returns true.
+	 */
+	void startLinkingAllPrograms();
+
+	/**
+	 * Advances linkage of all shader programs started with startLinkingAllPrograms. With parallel shader compilation,
+	 * it never blocks. Without it, it links one program per call, so that the application stays responsive.
+	 * Throws an exception, if some program could not be linked.
+	 *
+	 * @return True, if all programs have been linked or false, if some are still being linked.
+	 */
+	bool updateLinkingPrograms();
+
+	/**
+	 * Gets ratio of linked programs to all programs (0.0 to 1.0).
+	 */
+	float getLinkingProgress() const;
+
 	/**
 	 * Deletes all the shader programs loaded and clears the shader program cache.
 	 */
@@ -64,5 +112,12 @@ private:
 	 */
 	bool containsShaderProgram(const std::string& key) const;
 
+	/**
+	 * Throws an exception telling, that shader program with given key could not be linked.
+	 */
+	static void throwLinkError(const std::string& key);
+
 	std::map<std::string, std::unique_ptr<ShaderProgram>> _shaderProgramCache; // Shader program cache - stores shader programs within their keys in std::map
+	std::map<std::string, std::vector<std::pair<GLenum, std::string>>> shaderProgramVariantsFiles_; // Shader files of programs with variants
+	std::map<std::string, std::unique_ptr<ShaderProgram>> shaderProgramVariantCache_; // Shader program variants cache - key consists of program key and defines
 };
\ No newline at end of file
@@ -0,0 +1,375 @@
+// STL
+#include <algorithm>
+#include <cmath>
+
+// SIMD intrinsics (AVX when the compiler targets it, SSE on every x86-64 compiler, plain C++ otherwise)
+#if defined(__AVX__)
+#define SOFTWARE_OCCLUSION_CULLER_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SOFTWARE_OCCLUSION_CULLER_SSE
+#include <emmintrin.h>
+#endif
+
+// Project
+#include "softwareOcclusionCuller.h"
+
+const int SoftwareOcclusionCuller::DEFAULT_WIDTH = 256;
+const int SoftwareOcclusionCuller::DEFAULT_HEIGHT = 144;
+
+namespace {
+
+const float FAR_DEPTH = 1.0f; // Depth of empty pixels
+const float NEAR_PLANE_EPSILON = 1e-5f; // Vertices closer to the near plane (in clip space) are considered to be behind it
+
+} // namespace
+
+SoftwareOcclusionCuller::SoftwareOcclusionCuller(const int width, const int height)
+{
+    setResolution(width, height);
+}
+
+void SoftwareOcclusionCuller::setResolution(const int width, const int height)
+{
+    // Rows are processed by whole SIMD batches, so the width has to be divisible by the widest batch
+    width_ = std::max(8, (width + 7) / 8 * 8);
+    height_ = std::max(1, height);
+
+    pyramidLevels_.clear();
+    pyramidLevelSizes_.clear();
+    glm::ivec2 levelSize(width_, height_);
+    while (true)
+    {
+        pyramidLevelSizes_.push_back(levelSize);
+        pyramidLevels_.emplace_back(static_cast<size_t>(levelSize.x * levelSize.y), FAR_DEPTH);
+        if (levelSize.x == 1 && levelSize.y == 1) {
+            break;
+        }
+
+        levelSize = glm::ivec2(std::max(1, (levelSize.x + 1) / 2), std::max(1, (levelSize.y + 1) / 2));
+    }
+}
+
+size_t SoftwareOcclusionCuller::addOccluder(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices, const glm::mat4& modelMatrix)
+{
+    occluders_.push_back({ positions, indices, { modelMatrix } });
+    return occluders_.size() - 1;
+}
+
+void SoftwareOcclusionCuller::setOccluderModelMatrix(const size_t occluderIndex, const glm::mat4& modelMatrix)
+{
+    occluders_[occluderIndex].modelMatrices.assign(1, modelMatrix);
+}
+
+void SoftwareOcclusionCuller::setOccluderModelMatrices(const size_t occluderIndex, const std::vector<glm::mat4>& modelMatrices)
+{
+    occluders_[occluderIndex].modelMatrices = modelMatrices;
+}
+
+void SoftwareOcclusionCuller::clearOccluders()
+{
+    occluders_.clear();
+}
+
+void SoftwareOcclusionCuller::renderOccluders(const glm::mat4& projectionViewMatrix)
+{
+    projectionViewMatrix_ = projectionViewMatrix;
+    std::fill(pyramidLevels_[0].begin(), pyramidLevels_[0].end(), FAR_DEPTH);
+    numRasterizedTriangles_ = 0;
+
+    for (const auto& occluder : occluders_)
+    {
+        for (const auto& modelMatrix : occluder.modelMatrices)
+        {
+            const auto mvpMatrix = projectionViewMatrix * modelMatrix;
+            transformedPositions_.clear();
+            for (const auto& position : occluder.positions) {
+                transformedPositions_.push_back(mvpMatrix * glm::vec4(position, 1.0f));
+            }
+
+            for (size_t i = 0; i + 2 < occluder.indices.size(); i += 3)
+            {
+                rasterizeClipSpaceTriangle(transformedPositions_[occluder.indices[i]], transformedPositions_[occluder.indices[i + 1]],
+                    transformedPositions_[occluder.indices[i + 2]]);
+            }
+        }
+    }
+
+    buildDepthPyramid();
+}
+
+bool SoftwareOcclusionCuller::isAABBVisible(const AABB& box) const
+{
+    glm::vec3 ndcMin(1e30f), ndcMax(-1e30f);
+    for (auto i = 0; i < 8; i++)
+    {
+        const glm::vec3 corner(i & 1 ? box.max.x : box.min.x, i & 2 ? box.max.y : box.min.y, i & 4 ? box.max.z : box.min.z);
+        const auto clipPosition = projectionViewMatrix_ * glm::vec4(corner, 1.0f);
+
+        // We can't tell much about boxes crossing the near plane, so they're just visible
+        if (clipPosition.z < -clipPosition.w || clipPosition.w < NEAR_PLANE_EPSILON) {
+            return true;
+        }
+
+        const auto ndcPosition = glm::vec3(clipPosition) / clipPosition.w;
+        ndcMin = glm::min(ndcMin, ndcPosition);
+        ndcMax = glm::max(ndcMax, ndcPosition);
+    }
+
+    if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f || ndcMin.z > 1.0f) {
+        return false;
+    }
+
+    // Find pixel rectangle covered by the box and its nearest depth
+    const auto minX = std::min(std::max(static_cast<int>((ndcMin.x * 0.5f + 0.5f) * width_), 0), width_ - 1);
+    const auto maxX = std::min(std::max(static_cast<int>((ndcMax.x * 0.5f + 0.5f) * width_), 0), width_ - 1);
+    const auto minY = std::min(std::max(static_cast<int>((ndcMin.y * 0.5f + 0.5f) * height_), 0), height_ - 1);
+    const auto maxY = std::min(std::max(static_cast<int>((ndcMax.y * 0.5f + 0.5f) * height_), 0), height_ - 1);
+    const auto boxNearestDepth = ndcMin.z * 0.5f + 0.5f;
+
+    // Go up the pyramid, until the rectangle covers at most 4x4 texels
+    auto level = 0;
+    const auto lastLevel = getNumPyramidLevels() - 1;
+    while (level < lastLevel && ((maxX >> level) - (minX >> level) > 3 || (maxY >> level) - (minY >> level) > 3)) {
+        level++;
+    }
+
+    const auto& levelDepths = pyramidLevels_[level];
+    const auto& levelSize = pyramidLevelSizes_[level];
+    for (auto y = minY >> level; y <= std::min(maxY >> level, levelSize.y - 1); y++)
+    {
+        for (auto x = minX >> level; x <= std::min(maxX >> level, levelSize.x - 1); x++)
+        {
+            if (boxNearestDepth <= levelDepths[y * levelSize.x + x]) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+int SoftwareOcclusionCuller::getWidth() const
+{
+    return width_;
+}
+
+int SoftwareOcclusionCuller::getHeight() const
+{
+    return height_;
+}
+
+int SoftwareOcclusionCuller::getNumPyramidLevels() const
+{
+    return static_cast<int>(pyramidLevels_.size());
+}
+
+const std::vector<float>& SoftwareOcclusionCuller::getPyramidLevel(const int level) const
+{
+    return pyramidLevels_[level];
+}
+
+size_t SoftwareOcclusionCuller::getNumRasterizedTriangles() const
+{
+    return numRasterizedTriangles_;
+}
+
+const char* SoftwareOcclusionCuller::getSIMDInstructionSet()
+{
+#if defined(SOFTWARE_OCCLUSION_CULLER_AVX)
+    return "AVX";
+#elif defined(SOFTWARE_OCCLUSION_CULLER_SSE)
+    return "SSE";
+#else
+    return "none";
+#endif
+}
+
+void SoftwareOcclusionCuller::rasterizeClipSpaceTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c)
+{
+    // Clip polygon against the near plane (z >= -w), triangle becomes at most quad
+    const glm::vec4 vertices[3] = { a, b, c };
+    glm::vec4 clippedVertices[4];
+    auto numClippedVertices = 0;
+    for (auto i = 0; i < 3; i++)
+    {
+        const auto& current = vertices[i];
+        const auto& next = vertices[(i + 1) % 3];
+        const auto currentDistance = current.z + current.w;
+        const auto nextDistance = next.z + next.w;
+        if (currentDistance >= 0.0f) {
+            clippedVertices[numClippedVertices++] = current;
+        }
+
+        if ((currentDistance >= 0.0f) != (nextDistance >= 0.0f))
+        {
+            const auto t = currentDistance / (currentDistance - nextDistance);
+            clippedVertices[numClippedVertices++] = current + (next - current) * t;
+        }
+    }
+
+    if (numClippedVertices < 3) {
+        return;
+    }
+
+    // Perspective division and viewport transform
+    glm::vec3 screenVertices[4];
+    for (auto i = 0; i < numClippedVertices; i++)
+    {
+        const auto& clipPosition = clippedVertices[i];
+        const auto w = std::max(clipPosition.w, NEAR_PLANE_EPSILON);
+        screenVertices[i] = glm::vec3((clipPosition.x / w * 0.5f + 0.5f) * width_, (clipPosition.y / w * 0.5f + 0.5f) * height_,
+            clipPosition.z / w * 0.5f + 0.5f);
+    }
+
+    rasterizeScreenSpaceTriangle(screenVertices[0], screenVertices[1], screenVertices[2]);
+    if (numClippedVertices == 4) {
+        rasterizeScreenSpaceTriangle(screenVertices[0], screenVertices[2], screenVertices[3]);
+    }
+}
+
+void SoftwareOcclusionCuller::rasterizeScreenSpaceTriangle(glm::vec3 v0, glm::vec3 v1, glm::vec3 v2)
+{
+    // Both windings are rasterized (occluders are usually seen from one side only anyway), edge functions need counter-clockwise order
+    auto area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+    if (std::fabs(area) < 1e-8f) {
+        return;
+    }
+
+    if (area < 0.0f)
+    {
+        std::swap(v1, v2);
+        area = -area;
+    }
+
+    // Bounding rectangle of the triangle clamped to the screen, X starts at the beginning of SIMD batch
+    const auto minX = std::max(0, static_cast<int>(std::floor(std::min({ v0.x, v1.x, v2.x }))));
+    const auto maxX = std::min(width_ - 1, static_cast<int>(std::ceil(std::max({ v0.x, v1.x, v2.x }))));
+    const auto minY = std::max(0, static_cast<int>(std::floor(std::min({ v0.y, v1.y, v2.y }))));
+    const auto maxY = std::min(height_ - 1, static_cast<int>(std::ceil(std::max({ v0.y, v1.y, v2.y }))));
+    if (minX > maxX || minY > maxY) {
+        return;
+    }
+
+    numRasterizedTriangles_++;
+
+    // Edge functions E(x, y) = A * x + B * y + C, inside of the triangle all three are non-negative
+    const glm::vec3 edgeVertices[3][2] = { { v0, v1 }, { v1, v2 }, { v2, v0 } };
+    float edgeA[3], edgeB[3], edgeC[3];
+    for (auto i = 0; i < 3; i++)
+    {
+        const auto& from = edgeVertices[i][0];
+        const auto& to = edgeVertices[i][1];
+        edgeA[i] = from.y - to.y;
+        edgeB[i] = to.x - from.x;
+        edgeC[i] = -(edgeA[i] * from.x + edgeB[i] * from.y);
+    }
+
+    // Depth is linear in screen space: z(x, y) = depthA * x + depthB * y + depthC
+    const auto depthA = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) / area;
+    const auto depthB = ((v1.x - v0.x) * (v2.z - v0.z) - (v2.x - v0.x) * (v1.z - v0.z)) / area;
+    const auto depthC = v0.z - depthA * v0.x - depthB * v0.y;
+
+    auto& depthBuffer = pyramidLevels_[0];
+#if defined(SOFTWARE_OCCLUSION_CULLER_AVX)
+    const auto startX = minX / 8 * 8;
+    const auto pixelOffsets = _mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f);
+    for (auto y = minY; y <= maxY; y++)
+    {
+        const auto pixelY = static_cast<float>(y) + 0.5f;
+        const auto rowEdge0 = _mm256_set1_ps(edgeB[0] * pixelY + edgeC[0]);
+        const auto rowEdge1 = _mm256_set1_ps(edgeB[1] * pixelY + edgeC[1]);
+        const auto rowEdge2 = _mm256_set1_ps(edgeB[2] * pixelY + edgeC[2]);
+        const auto rowDepth = _mm256_set1_ps(depthB * pixelY + depthC);
+        auto rowPixels = depthBuffer.data() + y * width_;
+        for (auto x = startX; x <= maxX; x += 8)
+        {
+            const auto pixelX = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), pixelOffsets);
+            const auto edge0 = _mm256_add_ps(_mm256_mul_ps(pixelX, _mm256_set1_ps(edgeA[0])), rowEdge0);
+            const auto edge1 = _mm256_add_ps(_mm256_mul_ps(pixelX, _mm256_set1_ps(edgeA[1])), rowEdge1);
+            const auto edge2 = _mm256_add_ps(_mm256_mul_ps(pixelX, _mm256_set1_ps(edgeA[2])), rowEdge2);
+
+            const auto insideMask = _mm256_and_ps(_mm256_and_ps(_mm256_cmp_ps(edge0, _mm256_setzero_ps(), _CMP_GE_OQ),
+                _mm256_cmp_ps(edge1, _mm256_setzero_ps(), _CMP_GE_OQ)), _mm256_cmp_ps(edge2, _mm256_setzero_ps(), _CMP_GE_OQ));
+            if (_mm256_movemask_ps(insideMask) == 0) {
+                continue;
+            }
+
+            const auto depth = _mm256_add_ps(_mm256_mul_ps(pixelX, _mm256_set1_ps(depthA)), rowDepth);
+            const auto previousDepth = _mm256_loadu_ps(rowPixels + x);
+            _mm256_storeu_ps(rowPixels + x, _mm256_blendv_ps(previousDepth, _mm256_min_ps(previousDepth, depth), insideMask));
+        }
+    }
+#elif defined(SOFTWARE_OCCLUSION_CULLER_SSE)
+    const auto startX = minX / 4 * 4;
+    const auto pixelOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    for (auto y = minY; y <= maxY; y++)
+    {
+        const auto pixelY = static_cast<float>(y) + 0.5f;
+        const auto rowEdge0 = _mm_set1_ps(edgeB[0] * pixelY + edgeC[0]);
+        const auto rowEdge1 = _mm_set1_ps(edgeB[1] * pixelY + edgeC[1]);
+        const auto rowEdge2 = _mm_set1_ps(edgeB[2] * pixelY + edgeC[2]);
+        const auto rowDepth = _mm_set1_ps(depthB * pixelY + depthC);
+        auto rowPixels = depthBuffer.data() + y * width_;
+        for (auto x = startX; x <= maxX; x += 4)
+        {
+            const auto pixelX = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), pixelOffsets);
+            const auto edge0 = _mm_add_ps(_mm_mul_ps(pixelX, _mm_set1_ps(edgeA[0])), rowEdge0);
+            const auto edge1 = _mm_add_ps(_mm_mul_ps(pixelX, _mm_set1_ps(edgeA[1])), rowEdge1);
+            const auto edge2 = _mm_add_ps(_mm_mul_ps(pixelX, _mm_set1_ps(edgeA[2])), rowEdge2);
+
+            const auto insideMask = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edge0, _mm_setzero_ps()), _mm_cmpge_ps(edge1, _mm_setzero_ps())),
+                _mm_cmpge_ps(edge2, _mm_setzero_ps()));
+            if (_mm_movemask_ps(insideMask) == 0) {
+                continue;
+            }
+
+            const auto depth = _mm_add_ps(_mm_mul_ps(pixelX, _mm_set1_ps(depthA)), rowDepth);
+            const auto previousDepth = _mm_loadu_ps(rowPixels + x);
+            const auto newDepth = _mm_min_ps(previousDepth, depth);
+            _mm_storeu_ps(rowPixels + x, _mm_or_ps(_mm_and_ps(insideMask, newDepth), _mm_andnot_ps(insideMask, previousDepth)));
+        }
+    }
+#else
+    for (auto y = minY; y <= maxY; y++)
+    {
+        const auto pixelY = static_cast<float>(y) + 0.5f;
+        auto rowPixels = depthBuffer.data() + y * width_;
+        for (auto x = minX; x <= maxX; x++)
+        {
+            const auto pixelX = static_cast<float>(x) + 0.5f;
+            if (edgeA[0] * pixelX + edgeB[0] * pixelY + edgeC[0] < 0.0f || edgeA[1] * pixelX + edgeB[1] * pixelY + edgeC[1] < 0.0f
+                || edgeA[2] * pixelX + edgeB[2] * pixelY + edgeC[2] < 0.0f) {
+                continue;
+            }
+
+            rowPixels[x] = std::min(rowPixels[x], depthA * pixelX + depthB * pixelY + depthC);
+        }
+    }
+#endif
+}
+
+void SoftwareOcclusionCuller::buildDepthPyramid()
+{
+    // Every texel keeps the farthest of (up to) 4 texels below it, so that test against it stays conservative
+    for (size_t level = 1; level < pyramidLevels_.size(); level++)
+    {
+        const auto& sourceDepths = pyramidLevels_[level - 1];
+        const auto& sourceSize = pyramidLevelSizes_[level - 1];
+        auto& levelDepths = pyramidLevels_[level];
+        const auto& levelSize = pyramidLevelSizes_[level];
+        for (auto y = 0; y < levelSize.y; y++)
+        {
+            const auto sourceY0 = std::min(2 * y, sourceSize.y - 1);
+            const auto sourceY1 = std::min(2 * y + 1, sourceSize.y - 1);
+            for (auto x = 0; x < levelSize.x; x++)
+            {
+                const auto sourceX0 = std::min(2 * x, sourceSize.x - 1);
+                const auto sourceX1 = std::min(2 * x + 1, sourceSize.x - 1);
+                levelDepths[y * levelSize.x + x] = std::max(
+                    std::max(sourceDepths[sourceY0 * sourceSize.x + sourceX0], sourceDepths[sourceY0 * sourceSize.x + sourceX1]),
+                    std::max(sourceDepths[sourceY1 * sourceSize.x + sourceX0], sourceDepths[sourceY1 * sourceSize.x + sourceX1]));
+            }
+        }
+    }
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+// Project
+#include "boundingVolumes.h"
+
+/**
+ * Occlusion culling done completely on the CPU. Few designated occluders (ground, buildings, large props) are rasterized
+ * into a small depth buffer (SSE rasterizes 4 and AVX 8 pixels at once), then a depth pyramid is built out of it, where
+ * every texel holds the farthest depth of the texels below. Bounding box is then tested against a few texels of the level,
+ * where it covers just a couple of them. No OpenGL is needed, so results are known before anything is submitted to the GPU.
+ * Depth is taken at pixel centers, so occluder edges are accurate only up to the resolution of the depth buffer.
+ */
+class SoftwareOcclusionCuller
+{
+public:
+    static const int DEFAULT_WIDTH; // Default width of the depth buffer
+    static const int DEFAULT_HEIGHT; // Default height of the depth buffer
+
+    /**
+     * Creates culler with depth buffer of given resolution (width is rounded up to the multiple of 8).
+     */
+    SoftwareOcclusionCuller(int width = DEFAULT_WIDTH, int height = DEFAULT_HEIGHT);
+
+    /**
+     * Changes resolution of the depth buffer (width is rounded up to the multiple of 8).
+     */
+    void setResolution(int width, int height);
+
+    /**
+     * Adds occluder mesh. It's rasterized every time renderOccluders is called.
+     *
+     * @param positions    Vertex positions of the occluder in its model space
+     * @param indices      Triangle list indices (three per triangle)
+     * @param modelMatrix  Model matrix of the occluder
+     *
+     * @return Index of the added occluder.
+     */
+    size_t addOccluder(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& indices, const glm::mat4& modelMatrix = glm::mat4(1.0f));
+
+    /**
+     * Changes model matrix of the occluder (for moving occluders).
+     */
+    void setOccluderModelMatrix(size_t occluderIndex, const glm::mat4& modelMatrix);
+
+    /**
+     * Sets multiple model matrices of the occluder - it's rasterized once for every one of them (e.g. for many
+     * moving objects with the same occluder shape). Empty list means the occluder isn't rasterized at all.
+     */
+    void setOccluderModelMatrices(size_t occluderIndex, const std::vector<glm::mat4>& modelMatrices);
+
+    /**
+     * Removes all occluders.
+     */
+    void clearOccluders();
+
+    /**
+     * Clears the depth buffer, rasterizes all occluders and builds the depth pyramid. Must be called before testing boxes.
+     *
+     * @param projectionViewMatrix  Combined projection and view matrix of the camera
+     */
+    void renderOccluders(const glm::mat4& projectionViewMatrix);
+
+    /**
+     * Checks, if the box (in world space) might be visible - it's not completely behind the rasterized occluders.
+     * Boxes crossing the near plane are always considered visible, boxes outside of the screen are not.
+     */
+    bool isAABBVisible(const AABB& box) const;
+
+    /**
+     * Gets width of the depth buffer.
+     */
+    int getWidth() const;
+
+    /**
+     * Gets height of the depth buffer.
+     */
+    int getHeight() const;
+
+    /**
+     * Gets number of levels of the depth pyramid (level 0 is the depth buffer itself).
+     */
+    int getNumPyramidLevels() const;
+
+    /**
+     * Gets depth values of the pyramid level (rows from bottom to top, depths in range 0 to 1, 1 is far).
+     */
+    const std::vector<float>& getPyramidLevel(int level) const;
+
+    /**
+     * Gets number of triangles rasterized during the last renderOccluders.
+     */
+    size_t getNumRasterizedTriangles() const;
+
+    /**
+     * Gets name of SIMD instruction set used by the rasterizer ("AVX", "SSE" or "none").
+     */
+    static const char* getSIMDInstructionSet();
+
+private:
+    /**
+     * Occluder mesh with its placement.
+     */
+    struct Occluder
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<uint32_t> indices;
+        std::vector<glm::mat4> modelMatrices; // Occluder is rasterized once for every model matrix
+    };
+
+    /**
+     * Clips triangle (in clip space) against the near plane and rasterizes the resulting one or two triangles.
+     */
+    void rasterizeClipSpaceTriangle(const glm::vec4& a, const glm::vec4& b, const glm::vec4& c);
+
+    /**
+     * Rasterizes triangle given in screen space (x and y in pixels, z is depth in range 0 to 1).
+     */
+    void rasterizeScreenSpaceTriangle(glm::vec3 v0, glm::vec3 v1, glm::vec3 v2);
+
+    /**
+     * Builds all levels of the depth pyramid from the depth buffer.
+     */
+    void buildDepthPyramid();
+
+    int width_; // Width of the depth buffer (multiple of 8)
+    int height_; // Height of the depth buffer
+    std::vector<Occluder> occluders_; // All occluders
+    glm::mat4 projectionViewMatrix_{ 1.0f }; // Projection view matrix of the last renderOccluders
+    std::vector<std::vector<float>> pyramidLevels_; // Depth pyramid, level 0 is the depth buffer
+    std::vector<glm::ivec2> pyramidLevelSizes_; // Width and height of every pyramid level
+    std::vector<glm::vec4> transformedPositions_; // Clip space positions of the currently rasterized occluder
+    size_t numRasterizedTriangles_{ 0 }; // Number of triangles rasterized during the last renderOccluders
+};
@@ -0,0 +1,540 @@
+// STL
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+// Project
+#include "spatialHashGrid.h"
+
+const uint32_t SpatialHashGrid::INVALID_HANDLE = 0xFFFFFFFFu;
+
+namespace {
+
+const size_t INITIAL_TABLE_SIZE = 64; // Initial size of the hash table of cells (power of two)
+const float MAX_CELL_COORDINATE = 1073741824.0f; // Coordinates are clamped to this, so that unbounded regions don't overflow integers
+
+/**
+ * Converts world coordinate to cell coordinate.
+ */
+int toCellCoordinate(const float coordinate, const float inverseCellSize)
+{
+    const auto cellCoordinate = std::floor(coordinate * inverseCellSize);
+    return static_cast<int>(std::max(-MAX_CELL_COORDINATE, std::min(MAX_CELL_COORDINATE, cellCoordinate)));
+}
+
+/**
+ * Hashes cell coordinates into the hash table with power of two size.
+ */
+size_t hashCellCoordinates(const glm::ivec3& coordinates, const size_t tableSize)
+{
+    const auto hash = static_cast<uint32_t>(coordinates.x) * 73856093u ^ static_cast<uint32_t>(coordinates.y) * 19349663u
+        ^ static_cast<uint32_t>(coordinates.z) * 83492791u;
+    return static_cast<size_t>(hash) & (tableSize - 1);
+}
+
+bool areCoordinatesEqual(const glm::ivec3& a, const glm::ivec3& b)
+{
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+bool doBoxesIntersect(const AABB& a, const AABB& b)
+{
+    return a.min.x <= b.max.x && a.max.x >= b.min.x && a.min.y <= b.max.y && a.max.y >= b.min.y && a.min.z <= b.max.z && a.max.z >= b.min.z;
+}
+
+/**
+ * Intersects ray with the box (slab test). If the origin is inside of the box, hit distance is 0.
+ *
+ * @return True, if the box is hit within [0, maxDistance].
+ */
+bool intersectRayWithBox(const glm::vec3& origin, const glm::vec3& inverseDirection, const AABB& box, const float maxDistance, float& outDistance)
+{
+    auto nearDistance = 0.0f;
+    auto farDistance = maxDistance;
+    for (auto axis = 0; axis < 3; axis++)
+    {
+        auto t0 = (box.min[axis] - origin[axis]) * inverseDirection[axis];
+        auto t1 = (box.max[axis] - origin[axis]) * inverseDirection[axis];
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+
+        // NaN appears only if the ray is parallel to the slab and starts on its boundary - it's treated as a hit
+        nearDistance = t0 > nearDistance ? t0 : nearDistance;
+        farDistance = t1 < farDistance ? t1 : farDistance;
+        if (nearDistance > farDistance) {
+            return false;
+        }
+    }
+
+    outDistance = nearDistance;
+    return true;
+}
+
+} // namespace
+
+SpatialHashGrid::SpatialHashGrid(const float cellSize)
+    : cellSize_(cellSize)
+    , inverseCellSize_(1.0f / cellSize)
+{
+    clear();
+}
+
+void SpatialHashGrid::clear()
+{
+    cells_.clear();
+    cellTable_.assign(INITIAL_TABLE_SIZE, INVALID_HANDLE);
+    locations_.clear();
+    freeHandles_.clear();
+    maxHalfExtents_ = glm::vec3(0.0f);
+    minOccupiedCoordinates_ = glm::ivec3(0, 0, 0);
+    maxOccupiedCoordinates_ = glm::ivec3(-1, -1, -1);
+    numObjects_ = 0;
+    numRemovalsSinceRecalculation_ = 0;
+}
+
+uint32_t SpatialHashGrid::insert(const AABB& box)
+{
+    uint32_t handle;
+    if (!freeHandles_.empty())
+    {
+        handle = freeHandles_.back();
+        freeHandles_.pop_back();
+    }
+    else
+    {
+        handle = static_cast<uint32_t>(locations_.size());
+        locations_.push_back({ glm::ivec3(0, 0, 0), INVALID_HANDLE, 0 });
+    }
+
+    maxHalfExtents_ = glm::max(maxHalfExtents_, box.getExtents());
+    addEntry(findOrCreateCell(getCellCoordinates(box.getCenter())), { box, handle });
+    numObjects_++;
+    return handle;
+}
+
+void SpatialHashGrid::move(const uint32_t handle, const AABB& box)
+{
+    const auto location = locations_[handle];
+    maxHalfExtents_ = glm::max(maxHalfExtents_, box.getExtents());
+
+    // Most of the time objects stay within their cell, then just the box is updated
+    const auto cellCoordinates = getCellCoordinates(box.getCenter());
+    if (areCoordinatesEqual(location.cellCoordinates, cellCoordinates))
+    {
+        cells_[location.cellIndex].entries[location.entryIndex].box = box;
+        return;
+    }
+
+    removeEntry(location);
+    addEntry(findOrCreateCell(cellCoordinates), { box, handle });
+}
+
+void SpatialHashGrid::remove(const uint32_t handle)
+{
+    removeEntry(locations_[handle]);
+    locations_[handle].cellIndex = INVALID_HANDLE;
+    freeHandles_.push_back(handle);
+    numObjects_--;
+
+    // Bounds only grow on insertion, so they're tightened once the removed objects outnumber the remaining ones
+    if (++numRemovalsSinceRecalculation_ > numObjects_) {
+        recalculateBounds();
+    }
+}
+
+const AABB& SpatialHashGrid::getBox(const uint32_t handle) const
+{
+    const auto& location = locations_[handle];
+    return cells_[location.cellIndex].entries[location.entryIndex].box;
+}
+
+void SpatialHashGrid::queryAABB(const AABB& region, std::vector<uint32_t>& outHandles) const
+{
+    outHandles.clear();
+
+    // Objects from cells up to the half extents away might reach into the region
+    const auto minCoordinates = getCellCoordinates(region.min - maxHalfExtents_);
+    const auto maxCoordinates = getCellCoordinates(region.max + maxHalfExtents_);
+    forEachCellInRange(minCoordinates, maxCoordinates, [&region, &outHandles](const Cell& cell)
+    {
+        for (const auto& entry : cell.entries)
+        {
+            if (doBoxesIntersect(entry.box, region)) {
+                outHandles.push_back(entry.handle);
+            }
+        }
+    });
+}
+
+void SpatialHashGrid::querySphere(const glm::vec3& center, const float radius, std::vector<uint32_t>& outHandles) const
+{
+    outHandles.clear();
+
+    const auto minCoordinates = getCellCoordinates(center - glm::vec3(radius) - maxHalfExtents_);
+    const auto maxCoordinates = getCellCoordinates(center + glm::vec3(radius) + maxHalfExtents_);
+    const auto radiusSquared = radius * radius;
+    forEachCellInRange(minCoordinates, maxCoordinates, [&center, radiusSquared, &outHandles](const Cell& cell)
+    {
+        for (const auto& entry : cell.entries)
+        {
+            // Distance from the center to the nearest point of the box
+            const auto offset = glm::max(entry.box.min - center, glm::vec3(0.0f)) + glm::max(center - entry.box.max, glm::vec3(0.0f));
+            if (glm::dot(offset, offset) <= radiusSquared) {
+                outHandles.push_back(entry.handle);
+            }
+        }
+    });
+}
+
+void SpatialHashGrid::queryFrustum(const Frustum& frustum, std::vector<uint32_t>& outHandles) const
+{
+    outHandles.clear();
+    for (const auto& cell : cells_)
+    {
+        auto planeMask = Frustum::ALL_PLANES_MASK;
+        const auto containment = frustum.classifyAABB(getLooseCellBox(cell), planeMask);
+        if (containment == Frustum::Containment::Outside) {
+            continue;
+        }
+
+        for (const auto& entry : cell.entries)
+        {
+            auto entryPlaneMask = planeMask;
+            if (containment == Frustum::Containment::Inside || frustum.classifyAABB(entry.box, entryPlaneMask) != Frustum::Containment::Outside) {
+                outHandles.push_back(entry.handle);
+            }
+        }
+    }
+}
+
+uint32_t SpatialHashGrid::raycast(const glm::vec3& origin, const glm::vec3& direction, const float maxDistance, float* outDistance) const
+{
+    if (numObjects_ == 0) {
+        return INVALID_HANDLE;
+    }
+
+    // Clip the ray to the region, where any object can be
+    const glm::vec3 inverseDirection(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+    AABB occupiedRegion;
+    occupiedRegion.min = glm::vec3(static_cast<float>(minOccupiedCoordinates_.x), static_cast<float>(minOccupiedCoordinates_.y),
+        static_cast<float>(minOccupiedCoordinates_.z)) * cellSize_ - maxHalfExtents_;
+    occupiedRegion.max = glm::vec3(static_cast<float>(maxOccupiedCoordinates_.x + 1), static_cast<float>(maxOccupiedCoordinates_.y + 1),
+        static_cast<float>(maxOccupiedCoordinates_.z + 1)) * cellSize_ + maxHalfExtents_;
+
+    auto enterDistance = 0.0f;
+    if (!intersectRayWithBox(origin, inverseDirection, occupiedRegion, maxDistance, enterDistance)) {
+        return INVALID_HANDLE;
+    }
+
+    // Object, whose box is hit at point p, is stored at most this many cells away from the cell containing p
+    const glm::ivec3 neighborhood(static_cast<int>(std::ceil(maxHalfExtents_.x * inverseCellSize_)),
+        static_cast<int>(std::ceil(maxHalfExtents_.y * inverseCellSize_)), static_cast<int>(std::ceil(maxHalfExtents_.z * inverseCellSize_)));
+
+    // Walk the cells along the ray (3D DDA), starting where the ray enters the occupied region
+    auto cellCoordinates = getCellCoordinates(origin + direction * enterDistance);
+    glm::ivec3 step;
+    glm::vec3 nextBoundaryDistance, boundaryDistanceDelta;
+    for (auto axis = 0; axis < 3; axis++)
+    {
+        if (direction[axis] > 0.0f)
+        {
+            step[axis] = 1;
+            nextBoundaryDistance[axis] = ((cellCoordinates[axis] + 1) * cellSize_ - origin[axis]) * inverseDirection[axis];
+            boundaryDistanceDelta[axis] = cellSize_ * inverseDirection[axis];
+        }
+        else if (direction[axis] < 0.0f)
+        {
+            step[axis] = -1;
+            nextBoundaryDistance[axis] = (cellCoordinates[axis] * cellSize_ - origin[axis]) * inverseDirection[axis];
+            boundaryDistanceDelta[axis] = -cellSize_ * inverseDirection[axis];
+        }
+        else
+        {
+            step[axis] = 0;
+            nextBoundaryDistance[axis] = maxDistance + 1.0f;
+            boundaryDistanceDelta[axis] = 0.0f;
+        }
+    }
+
+    auto nearestHandle = INVALID_HANDLE;
+    auto nearestDistance = maxDistance;
+    auto cellDistance = enterDistance;
+    while (cellDistance <= nearestDistance)
+    {
+        // Every object hit within this cell is found here, so as soon as the walk gets past the nearest hit, it can end
+        forEachCellInRange(cellCoordinates - neighborhood, cellCoordinates + neighborhood,
+            [&origin, &inverseDirection, &nearestHandle, &nearestDistance](const Cell& cell)
+        {
+            for (const auto& entry : cell.entries)
+            {
+                auto hitDistance = 0.0f;
+                if (intersectRayWithBox(origin, inverseDirection, entry.box, nearestDistance, hitDistance) && (hitDistance < nearestDistance || nearestHandle == INVALID_HANDLE))
+                {
+                    nearestHandle = entry.handle;
+                    nearestDistance = hitDistance;
+                }
+            }
+        });
+
+        auto axis = 0;
+        if (nextBoundaryDistance.y < nextBoundaryDistance[axis]) {
+            axis = 1;
+        }
+        if (nextBoundaryDistance.z < nextBoundaryDistance[axis]) {
+            axis = 2;
+        }
+
+        cellDistance = nextBoundaryDistance[axis];
+        if (step[axis] == 0 || cellDistance > maxDistance) {
+            break;
+        }
+
+        cellCoordinates[axis] += step[axis];
+        nextBoundaryDistance[axis] += boundaryDistanceDelta[axis];
+
+        // Once the walk leaves the occupied region in direction it's going, no more objects can be hit
+        if ((step[axis] > 0 && cellCoordinates[axis] > maxOccupiedCoordinates_[axis] + neighborhood[axis])
+            || (step[axis] < 0 && cellCoordinates[axis] < minOccupiedCoordinates_[axis] - neighborhood[axis])) {
+            break;
+        }
+    }
+
+    if (nearestHandle != INVALID_HANDLE && outDistance != nullptr) {
+        *outDistance = nearestDistance;
+    }
+
+    return nearestHandle;
+}
+
+size_t SpatialHashGrid::getNumObjects() const
+{
+    return numObjects_;
+}
+
+size_t SpatialHashGrid::getNumCells() const
+{
+    return cells_.size();
+}
+
+float SpatialHashGrid::getCellSize() const
+{
+    return cellSize_;
+}
+
+glm::ivec3 SpatialHashGrid::getCellCoordinates(const glm::vec3& position) const
+{
+    return glm::ivec3(toCellCoordinate(position.x, inverseCellSize_), toCellCoordinate(position.y, inverseCellSize_),
+        toCellCoordinate(position.z, inverseCellSize_));
+}
+
+AABB SpatialHashGrid::getLooseCellBox(const Cell& cell) const
+{
+    const auto cellMin = glm::vec3(static_cast<float>(cell.coordinates.x), static_cast<float>(cell.coordinates.y),
+        static_cast<float>(cell.coordinates.z)) * cellSize_;
+    AABB result;
+    result.min = cellMin - maxHalfExtents_;
+    result.max = cellMin + glm::vec3(cellSize_) + maxHalfExtents_;
+    return result;
+}
+
+uint32_t SpatialHashGrid::findCell(const glm::ivec3& coordinates) const
+{
+    // Linear probing until the cell or an empty slot is found (table is never more than half full)
+    const auto tableMask = cellTable_.size() - 1;
+    for (auto slot = hashCellCoordinates(coordinates, cellTable_.size()); ; slot = (slot + 1) & tableMask)
+    {
+        const auto cellIndex = cellTable_[slot];
+        if (cellIndex == INVALID_HANDLE || areCoordinatesEqual(cells_[cellIndex].coordinates, coordinates)) {
+            return cellIndex;
+        }
+    }
+}
+
+uint32_t SpatialHashGrid::findOrCreateCell(const glm::ivec3& coordinates)
+{
+    const auto existingCellIndex = findCell(coordinates);
+    if (existingCellIndex != INVALID_HANDLE) {
+        return existingCellIndex;
+    }
+
+    if (cells_.empty())
+    {
+        minOccupiedCoordinates_ = coordinates;
+        maxOccupiedCoordinates_ = coordinates;
+    }
+    else
+    {
+        minOccupiedCoordinates_ = glm::ivec3(std::min(minOccupiedCoordinates_.x, coordinates.x), std::min(minOccupiedCoordinates_.y, coordinates.y),
+            std::min(minOccupiedCoordinates_.z, coordinates.z));
+        maxOccupiedCoordinates_ = glm::ivec3(std::max(maxOccupiedCoordinates_.x, coordinates.x), std::max(maxOccupiedCoordinates_.y, coordinates.y),
+            std::max(maxOccupiedCoordinates_.z, coordinates.z));
+    }
+
+    const auto cellIndex = static_cast<uint32_t>(cells_.size());
+    cells_.push_back({ coordinates, {} });
+    if (2 * cells_.size() > cellTable_.size()) {
+        rehash(2 * cellTable_.size());
+    }
+    else
+    {
+        const auto tableMask = cellTable_.size() - 1;
+        auto slot = hashCellCoordinates(coordinates, cellTable_.size());
+        while (cellTable_[slot] != INVALID_HANDLE) {
+            slot = (slot + 1) & tableMask;
+        }
+
+        cellTable_[slot] = cellIndex;
+    }
+
+    return cellIndex;
+}
+
+void SpatialHashGrid::addEntry(const uint32_t cellIndex, const Entry& entry)
+{
+    auto& cell = cells_[cellIndex];
+    locations_[entry.handle] = { cell.coordinates, cellIndex, static_cast<uint32_t>(cell.entries.size()) };
+    cell.entries.push_back(entry);
+}
+
+void SpatialHashGrid::removeEntry(const Location location)
+{
+    auto& entries = cells_[location.cellIndex].entries;
+    if (location.entryIndex + 1 != entries.size())
+    {
+        entries[location.entryIndex] = entries.back();
+        locations_[entries[location.entryIndex].handle].entryIndex = location.entryIndex;
+    }
+
+    entries.pop_back();
+    if (entries.empty()) {
+        freeCell(location.cellIndex);
+    }
+}
+
+void SpatialHashGrid::freeCell(const uint32_t cellIndex)
+{
+    // Find the slot of the cell and remove it with backward shift, so that no probing sequence gets broken
+    const auto tableMask = cellTable_.size() - 1;
+    auto emptySlot = hashCellCoordinates(cells_[cellIndex].coordinates, cellTable_.size());
+    while (cellTable_[emptySlot] != cellIndex) {
+        emptySlot = (emptySlot + 1) & tableMask;
+    }
+
+    for (auto slot = (emptySlot + 1) & tableMask; cellTable_[slot] != INVALID_HANDLE; slot = (slot + 1) & tableMask)
+    {
+        // Cell can move to the empty slot only if the empty slot lies on its probing sequence (between its home slot and its slot)
+        const auto homeSlot = hashCellCoordinates(cells_[cellTable_[slot]].coordinates, cellTable_.size());
+        if (((slot - homeSlot) & tableMask) >= ((slot - emptySlot) & tableMask))
+        {
+            cellTable_[emptySlot] = cellTable_[slot];
+            emptySlot = slot;
+        }
+    }
+
+    cellTable_[emptySlot] = INVALID_HANDLE;
+
+    // Last cell takes place of the freed one, its slot and locations of its objects are fixed up
+    const auto lastCellIndex = static_cast<uint32_t>(cells_.size() - 1);
+    if (cellIndex != lastCellIndex)
+    {
+        auto slot = hashCellCoordinates(cells_[lastCellIndex].coordinates, cellTable_.size());
+        while (cellTable_[slot] != lastCellIndex) {
+            slot = (slot + 1) & tableMask;
+        }
+
+        cellTable_[slot] = cellIndex;
+        cells_[cellIndex] = std::move(cells_[lastCellIndex]);
+        for (const auto& entry : cells_[cellIndex].entries) {
+            locations_[entry.handle].cellIndex = cellIndex;
+        }
+    }
+
+    cells_.pop_back();
+}
+
+void SpatialHashGrid::recalculateBounds()
+{
+    numRemovalsSinceRecalculation_ = 0;
+    maxHalfExtents_ = glm::vec3(0.0f);
+    minOccupiedCoordinates_ = glm::ivec3(0, 0, 0);
+    maxOccupiedCoordinates_ = glm::ivec3(-1, -1, -1);
+    for (size_t i = 0; i < cells_.size(); i++)
+    {
+        const auto& coordinates = cells_[i].coordinates;
+        if (i == 0)
+        {
+            minOccupiedCoordinates_ = coordinates;
+            maxOccupiedCoordinates_ = coordinates;
+        }
+        else
+        {
+            minOccupiedCoordinates_ = glm::ivec3(std::min(minOccupiedCoordinates_.x, coordinates.x), std::min(minOccupiedCoordinates_.y, coordinates.y),
+                std::min(minOccupiedCoordinates_.z, coordinates.z));
+            maxOccupiedCoordinates_ = glm::ivec3(std::max(maxOccupiedCoordinates_.x, coordinates.x), std::max(maxOccupiedCoordinates_.y, coordinates.y),
+                std::max(maxOccupiedCoordinates_.z, coordinates.z));
+        }
+
+        for (const auto& entry : cells_[i].entries) {
+            maxHalfExtents_ = glm::max(maxHalfExtents_, entry.box.getExtents());
+        }
+    }
+}
+
+void SpatialHashGrid::rehash(const size_t tableSize)
+{
+    cellTable_.assign(tableSize, INVALID_HANDLE);
+    const auto tableMask = tableSize - 1;
+    for (size_t i = 0; i < cells_.size(); i++)
+    {
+        auto slot = hashCellCoordinates(cells_[i].coordinates, tableSize);
+        while (cellTable_[slot] != INVALID_HANDLE) {
+            slot = (slot + 1) & tableMask;
+        }
+
+        cellTable_[slot] = static_cast<uint32_t>(i);
+    }
+}
+
+template <typename Function>
+void SpatialHashGrid::forEachCellInRange(const glm::ivec3& minCoordinates, const glm::ivec3& maxCoordinates, Function function) const
+{
+    // Nothing exists outside of the occupied cells
+    const glm::ivec3 rangeMin(std::max(minCoordinates.x, minOccupiedCoordinates_.x), std::max(minCoordinates.y, minOccupiedCoordinates_.y),
+        std::max(minCoordinates.z, minOccupiedCoordinates_.z));
+    const glm::ivec3 rangeMax(std::min(maxCoordinates.x, maxOccupiedCoordinates_.x), std::min(maxCoordinates.y, maxOccupiedCoordinates_.y),
+        std::min(maxCoordinates.z, maxOccupiedCoordinates_.z));
+    if (rangeMin.x > rangeMax.x || rangeMin.y > rangeMax.y || rangeMin.z > rangeMax.z) {
+        return;
+    }
+
+    const auto numCellsInRange = static_cast<double>(rangeMax.x - rangeMin.x + 1) * static_cast<double>(rangeMax.y - rangeMin.y + 1)
+        * static_cast<double>(rangeMax.z - rangeMin.z + 1);
+    if (numCellsInRange > static_cast<double>(cells_.size()))
+    {
+        for (const auto& cell : cells_)
+        {
+            const auto& coordinates = cell.coordinates;
+            if (coordinates.x >= rangeMin.x && coordinates.x <= rangeMax.x && coordinates.y >= rangeMin.y && coordinates.y <= rangeMax.y
+                && coordinates.z >= rangeMin.z && coordinates.z <= rangeMax.z) {
+                function(cell);
+            }
+        }
+
+        return;
+    }
+
+    for (auto z = rangeMin.z; z <= rangeMax.z; z++)
+    {
+        for (auto y = rangeMin.y; y <= rangeMax.y; y++)
+        {
+            for (auto x = rangeMin.x; x <= rangeMax.x; x++)
+            {
+                const auto cellIndex = findCell(glm::ivec3(x, y, z));
+                if (cellIndex != INVALID_HANDLE) {
+                    function(cells_[cellIndex]);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,208 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+// Project
+#include "boundingVolumes.h"
+#include "frustum.h"
+
+/**
+ * Uniform grid for dynamic sets of objects, where only the occupied cells exist (they're found by hashing cell coordinates,
+ * so the world doesn't have to be bounded). Every object lives in the cell containing the center of its box (the grid
+ * is loose - queries are extended by the largest half extents of the objects) and it's stored there together with its box,
+ * so that going through a cell reads one contiguous array. Inserting, moving and removing objects take constant time
+ * and queries visit only the cells around the queried region, so they depend on local density and not total object count.
+ */
+class SpatialHashGrid
+{
+public:
+    static const uint32_t INVALID_HANDLE; // Handle, that no object ever gets (returned when nothing has been found)
+
+    /**
+     * Creates empty grid. Cell size should be about the size of typical object (or a bit larger).
+     */
+    explicit SpatialHashGrid(float cellSize = 10.0f);
+
+    /**
+     * Removes all objects and cells. All handles become invalid.
+     */
+    void clear();
+
+    /**
+     * Inserts new object.
+     *
+     * @param box  Bounding box of the object
+     *
+     * @return Handle of the object, that stays the same until the object is removed.
+     */
+    uint32_t insert(const AABB& box);
+
+    /**
+     * Updates bounding box of the object. If its center stays in the same cell, only the stored box is changed.
+     */
+    void move(uint32_t handle, const AABB& box);
+
+    /**
+     * Removes object from the grid. Its handle might be reused by the objects inserted later. Cell, that becomes empty,
+     * is freed right away. Once there have been more removals than there are objects left, occupied region and largest
+     * half extents are recalculated (they only grow otherwise), so the cost is amortized constant.
+     */
+    void remove(uint32_t handle);
+
+    /**
+     * Gets bounding box of the object, as it's stored in the grid.
+     */
+    const AABB& getBox(uint32_t handle) const;
+
+    /**
+     * Gathers handles of objects, whose boxes intersect the region.
+     *
+     * @param region      Queried region
+     * @param outHandles  Handles of found objects (cleared first)
+     */
+    void queryAABB(const AABB& region, std::vector<uint32_t>& outHandles) const;
+
+    /**
+     * Gathers handles of objects, whose boxes intersect the sphere (e.g. objects in proximity of a point).
+     *
+     * @param center      Center of the sphere
+     * @param radius      Radius of the sphere
+     * @param outHandles  Handles of found objects (cleared first)
+     */
+    void querySphere(const glm::vec3& center, float radius, std::vector<uint32_t>& outHandles) const;
+
+    /**
+     * Gathers handles of objects, whose boxes are at least partially inside the frustum. Whole cells are tested
+     * first, objects of cells completely inside the frustum are taken without testing them.
+     *
+     * @param frustum     Queried frustum
+     * @param outHandles  Handles of found objects (cleared first)
+     */
+    void queryFrustum(const Frustum& frustum, std::vector<uint32_t>& outHandles) const;
+
+    /**
+     * Finds the nearest object, whose box is hit by the ray. Cells along the ray are walked from the origin and the walk
+     * stops as soon as nothing nearer than the current hit can be found.
+     *
+     * @param origin       Origin of the ray
+     * @param direction    Direction of the ray (distances are measured in its lengths, so it's usually normalized)
+     * @param maxDistance  Maximal distance of the hit
+     * @param outDistance  If not null, distance of the hit is stored here
+     *
+     * @return Handle of the hit object or INVALID_HANDLE, if nothing has been hit.
+     */
+    uint32_t raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float* outDistance = nullptr) const;
+
+    /**
+     * Gets number of objects in the grid.
+     */
+    size_t getNumObjects() const;
+
+    /**
+     * Gets number of cells, that contain at least one object.
+     */
+    size_t getNumCells() const;
+
+    /**
+     * Gets size of one cell.
+     */
+    float getCellSize() const;
+
+private:
+    /**
+     * Object stored within the cell.
+     */
+    struct Entry
+    {
+        AABB box; // Bounding box of the object
+        uint32_t handle; // Handle of the object
+    };
+
+    /**
+     * One cell of the grid with all objects, whose centers are in it.
+     */
+    struct Cell
+    {
+        glm::ivec3 coordinates; // Integer coordinates of the cell
+        std::vector<Entry> entries; // Objects of the cell
+    };
+
+    /**
+     * Where the object with given handle is stored.
+     */
+    struct Location
+    {
+        glm::ivec3 cellCoordinates; // Coordinates of the cell (kept here, so that moving within the cell doesn't have to read the cell)
+        uint32_t cellIndex; // Index of the cell (INVALID_HANDLE, if the handle is free)
+        uint32_t entryIndex; // Index of the entry within the cell
+    };
+
+    /**
+     * Gets coordinates of the cell containing the position.
+     */
+    glm::ivec3 getCellCoordinates(const glm::vec3& position) const;
+
+    /**
+     * Gets region covered by the cell extended by the largest half extents of objects (no object of the cell reaches outside of it).
+     */
+    AABB getLooseCellBox(const Cell& cell) const;
+
+    /**
+     * Finds index of the cell with given coordinates (INVALID_HANDLE, if it doesn't exist).
+     */
+    uint32_t findCell(const glm::ivec3& coordinates) const;
+
+    /**
+     * Finds index of the cell with given coordinates or creates the cell.
+     */
+    uint32_t findOrCreateCell(const glm::ivec3& coordinates);
+
+    /**
+     * Adds entry to the cell and remembers its location.
+     */
+    void addEntry(uint32_t cellIndex, const Entry& entry);
+
+    /**
+     * Removes entry from the cell (last entry of the cell takes its place). If the cell becomes empty, it's freed.
+     */
+    void removeEntry(Location location);
+
+    /**
+     * Frees empty cell - it's removed from the hash table and the last cell takes its place.
+     */
+    void freeCell(uint32_t cellIndex);
+
+    /**
+     * Recalculates occupied region and largest half extents from the objects, that are in the grid now.
+     */
+    void recalculateBounds();
+
+    /**
+     * Rebuilds hash table of cells with the new size (power of two).
+     */
+    void rehash(size_t tableSize);
+
+    /**
+     * Calls the function with every existing cell, whose coordinates are within [minCoordinates, maxCoordinates].
+     * Coordinates are walked, if there are less of them than the existing cells, otherwise existing cells are filtered.
+     */
+    template <typename Function>
+    void forEachCellInRange(const glm::ivec3& minCoordinates, const glm::ivec3& maxCoordinates, Function function) const;
+
+    float cellSize_; // Size of one cell
+    float inverseCellSize_; // 1 / cell size
+    std::vector<Cell> cells_; // All cells, that have been created
+    std::vector<uint32_t> cellTable_; // Open addressing hash table of cell indices (INVALID_HANDLE means empty slot)
+    std::vector<Location> locations_; // Location of every object, handle is an index here
+    std::vector<uint32_t> freeHandles_; // Handles of removed objects, that can be reused
+    glm::vec3 maxHalfExtents_{ 0.0f }; // Largest half extents of objects since the last recalculation (tells, how loose the cells are)
+    glm::ivec3 minOccupiedCoordinates_; // Minimal coordinates of cells since the last recalculation
+    glm::ivec3 maxOccupiedCoordinates_; // Maximal coordinates of cells since the last recalculation
+    size_t numObjects_{ 0 }; // Number of objects in the grid
+    size_t numRemovalsSinceRecalculation_{ 0 }; // Number of removed objects since bounds have been recalculated
+};
@@ -3,6 +3,7 @@
 
 // Project
 #include "quad.h"
+#include "../../glStateCache.h"
 
 namespace static_meshes_2D {
 
@@ -26,7 +27,7 @@ void Quad::render() const
         return;
     }
 
-    glBindVertexArray(_vao);
+    GLStateCache::getInstance().bindVertexArray(_vao);
     glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 }
 
@@ -37,7 +38,7 @@ void Quad::initializeData()
     }
 
     glGenVertexArrays(1, &_vao);
-    glBindVertexArray(_vao);
+    GLStateCache::getInstance().bindVertexArray(_vao);
 
     const int numVertices = 4;
     int vertexByteSize = getVertexByteSize();	
@@ -3,6 +3,7 @@
 
 // Project
 #include "staticMesh2D.h"
+#include "../glStateCache.h"
 
 namespace static_meshes_2D {
 
@@ -24,6 +25,7 @@ void StaticMesh2D::deleteMesh()
         return;
     }
 
+    GLStateCache::getInstance().onVertexArrayDeleted(_vao);
     glDeleteVertexArrays(1, &_vao);
     _vbo.deleteVBO();
 
@@ -1,3 +1,7 @@
+// STL
+#include <algorithm>
+#include <numeric>
+
 // Assimp
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -10,6 +14,7 @@
 #include "assimpModel.h"
 #include "../stringUtils.h"
 #include "../textureManager.h"
+#include "../gpuResourceRegistry.h"
 
 namespace static_meshes_3D {
 
@@ -31,6 +36,7 @@ bool AssimpModel::loadModelFromFile(const std::string& filePath, const std::stri
         deleteMesh();
     }
 
+    GPUResourceRegistry::ScopedTag registryTag("assimp_model");
     Assimp::Importer importer;
     const aiScene* scene = importer.ReadFile(filePath,
         aiProcess_CalcTangentSpace |
@@ -44,21 +50,26 @@ bool AssimpModel::loadModelFromFile(const std::string& filePath, const std::stri
     }
 
     _modelRootDirectoryPath = string_utils::getDirectoryPath(filePath);
-
-    glGenVertexArrays(1, &_vao);
-    glBindVertexArray(_vao);
-
-    _vbo.createVBO();
-    _vbo.bindVBO();
+    _meshStartIndices.clear();
+    _meshVerticesCount.clear();
+    _meshMaterialIndices.clear();
+    _materialTextureKeys.clear();
 
     const auto vertexByteSize = sizeof(aiVector3D) * 2 + sizeof(aiVector2D);
     auto vertexCount = 0;
 
+    // Store meshes ordered by material, so that all meshes with the same material are next to each other and they can be rendered at once
+    std::vector<size_t> meshOrder(scene->mNumMeshes);
+    std::iota(meshOrder.begin(), meshOrder.end(), 0);
+    std::stable_sort(meshOrder.begin(), meshOrder.end(), [scene](const size_t a, const size_t b) {
+        return scene->mMeshes[a]->mMaterialIndex < scene->mMeshes[b]->mMaterialIndex;
+    });
+
     if (hasPositions())
     {
-        for (size_t i = 0; i < scene->mNumMeshes; i++)
+        for (const auto meshIndex : meshOrder)
         {
-            const auto meshPtr = scene->mMeshes[i];
+            const auto meshPtr = scene->mMeshes[meshIndex];
             auto vertexCountMesh = 0;
             _meshStartIndices.push_back(vertexCount);
             _meshMaterialIndices.push_back(meshPtr->mMaterialIndex);
@@ -86,9 +97,9 @@ bool AssimpModel::loadModelFromFile(const std::string& filePath, const std::stri
 
     if (hasTextureCoordinates())
     {
-        for (size_t i = 0; i < scene->mNumMeshes; i++)
+        for (const auto meshIndex : meshOrder)
         {
-            const auto meshPtr = scene->mMeshes[i];
+            const auto meshPtr = scene->mMeshes[meshIndex];
             for (size_t j = 0; j < meshPtr->mNumFaces; j++)
             {
                 const auto& face = meshPtr->mFaces[j];
@@ -108,9 +119,9 @@ bool AssimpModel::loadModelFromFile(const std::string& filePath, const std::stri
     if (hasNormals())
     {
         const auto normalMatrix = glm::transpose(glm::inverse(glm::mat3(modelTransformMatrix)));
-        for (size_t i = 0; i < scene->mNumMeshes; i++)
+        for (const auto meshIndex : meshOrder)
         {
-            const auto meshPtr = scene->mMeshes[i];
+            const auto meshPtr = scene->mMeshes[meshIndex];
             for (size_t j = 0; j < meshPtr->mNumFaces; j++)
             {
                 const auto& face = meshPtr->mFaces[j];
@@ -147,8 +158,9 @@ bool AssimpModel::loadModelFromFile(const std::string& filePath, const std::stri
         loadMaterialTexture(0, defaultTextureName);
     }
 
-    _vbo.uploadDataToGPU(GL_STATIC_DRAW);
-    setVertexAttributesPointers(vertexCount);
+    _numVertices = vertexCount;
+    createDrawBatches();
+    moveDataToGeometryArena(vertexCount);
     _isInitialized = true;
 
     return _isInitialized;
@@ -160,23 +172,14 @@ void AssimpModel::render() const
         return;
     }
 
-    glBindVertexArray(_vao);
-
-    std::string lastUsedTextureKey = "";
-    for(size_t i = 0; i < _meshStartIndices.size(); i++)
+    bindGeometry();
+    for (const auto& drawBatch : _drawBatches)
     {
-        const auto usedMaterialIndex = _meshMaterialIndices[i];
-        if (_materialTextureKeys.count(usedMaterialIndex) > 0)
-        {
-            const auto textureKey = _materialTextureKeys.at(usedMaterialIndex);
-            if (textureKey != lastUsedTextureKey) {
-                TextureManager::getInstance().getTexture(textureKey).bind();
-            }
-
-            lastUsedTextureKey = textureKey;
+        if (!drawBatch.textureKey.empty()) {
+            TextureManager::getInstance().getTexture(drawBatch.textureKey).bind();
         }
 
-        glDrawArrays(GL_TRIANGLES, _meshStartIndices[i], _meshVerticesCount[i]);
+        drawArrays(GL_TRIANGLES, drawBatch.firstVertex, drawBatch.numVertices);
     }
 }
 
@@ -186,10 +189,9 @@ void AssimpModel::renderPoints() const
         return;
     }
 
-    glBindVertexArray(_vao);
-    for (size_t i = 0; i < _meshStartIndices.size(); i++) {
-        glDrawArrays(GL_POINTS, _meshStartIndices[i], _meshVerticesCount[i]);
-    }
+    // All meshes are stored one after another, so points of the whole model can be rendered at once
+    bindGeometry();
+    drawArrays(GL_POINTS, 0, _numVertices);
 }
 
 void AssimpModel::loadMaterialTexture(const int materialIndex, const std::string& textureFileName)
@@ -209,6 +211,25 @@ void AssimpModel::loadMaterialTexture(const int materialIndex, const std::string
     _materialTextureKeys[materialIndex] = newTextureKey;
 }
 
+void AssimpModel::createDrawBatches()
+{
+    _drawBatches.clear();
+    for (size_t i = 0; i < _meshStartIndices.size(); i++)
+    {
+        const auto usedMaterialIndex = _meshMaterialIndices[i];
+        const auto textureKey = _materialTextureKeys.count(usedMaterialIndex) > 0 ? _materialTextureKeys.at(usedMaterialIndex) : "";
+
+        // Mesh without texture is rendered with whatever has been bound before, so it can always join the previous batch
+        if (!_drawBatches.empty() && (textureKey.empty() || textureKey == _drawBatches.back().textureKey))
+        {
+            _drawBatches.back().numVertices += _meshVerticesCount[i];
+            continue;
+        }
+
+        _drawBatches.push_back({ _meshStartIndices[i], _meshVerticesCount[i], textureKey });
+    }
+}
+
 std::string AssimpModel::aiStringToStdString(const aiString& aiStringStruct)
 {
     auto dataPtr = aiStringStruct.data;
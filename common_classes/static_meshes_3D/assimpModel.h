@@ -40,7 +40,18 @@ public:
     void renderPoints() const override;
 
 protected:
+    /**
+     * Range of consecutive vertices sharing the same texture, that is rendered with a single draw call.
+     */
+    struct DrawBatch
+    {
+        int firstVertex; // First vertex of the batch in the VBO
+        int numVertices; // Number of vertices in the batch
+        std::string textureKey; // Texture key to bind before rendering the batch (empty means keep the current one)
+    };
+
     void loadMaterialTexture(const int materialIndex, const std::string& textureFileName);
+    void createDrawBatches();
     static std::string aiStringToStdString(const aiString& aiStringStruct);
 
     std::string _modelRootDirectoryPath; // Path of the directory where model (and possibly its assets) is located
@@ -48,6 +59,8 @@ protected:
     std::vector<int> _meshVerticesCount; // How many vertices are there for every mesh
     std::vector<int> _meshMaterialIndices; // Index of material for every mesh
     std::map<int, std::string> _materialTextureKeys; // Map for index of material -> texture key to be retrieved from TextureManager
+    std::vector<DrawBatch> _drawBatches; // Meshes merged by texture, so that every texture takes only one draw call
+    int _numVertices = 0; // Total number of vertices of all meshes
 };
 
 }; // namespace static_meshes_3D
\ No newline at end of file
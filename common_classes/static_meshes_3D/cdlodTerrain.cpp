@@ -0,0 +1,418 @@
+// STL
+#include <algorithm>
+#include <stdexcept>
+
+// GLM
+#include <glm/glm.hpp>
+
+// Project
+#include "cdlodTerrain.h"
+
+#include "../../common_classes/glStateCache.h"
+#include "../../common_classes/gpuResourceRegistry.h"
+#include "../../common_classes/shaderManager.h"
+#include "../../common_classes/shaderProgramManager.h"
+#include "../../common_classes/textureManager.h"
+
+namespace static_meshes_3D {
+
+namespace {
+
+const GLuint HEIGHT_TEXTURE_UNIT = 16; // Texture unit of the height texture (right after units, that terrain layers can use)
+const float MORPH_START_RATIO = 0.7f; // Where between the previous and the current LOD range does morphing into coarser grid start
+const float UNLIMITED_RANGE = 1e30f; // Range of the top level, that renders everything beyond ranges of the finer levels
+
+/**
+ * Checks, if the box intersects the sphere (or contains its center).
+ */
+bool boxIntersectsSphere(const AABB& box, const glm::vec3& center, const float radius)
+{
+    const auto nearestPoint = glm::clamp(center, box.min, box.max);
+    const auto difference = center - nearestPoint;
+    return glm::dot(difference, difference) <= radius * radius;
+}
+
+} // namespace
+
+const std::string CDLODTerrain::SHADER_PROGRAM_KEY = "cdlod_terrain";
+const int CDLODTerrain::GRID_SIZE = 32;
+const float CDLODTerrain::DEFAULT_LOD_DISTANCE_RATIO = 3.0f;
+
+GLuint CDLODTerrain::sharedGridVAO_ = 0;
+VertexBufferObject CDLODTerrain::sharedGridVertices_;
+VertexBufferObject CDLODTerrain::sharedGridIndices_;
+int CDLODTerrain::numInstances_ = 0;
+
+CDLODTerrain::CDLODTerrain(const Heightmap::HeightData& heightData, const float lodDistanceRatio, const int minNumLevels)
+    : rows_(heightData.rows)
+    , columns_(heightData.columns)
+    , lodDistanceRatio_(lodDistanceRatio)
+{
+    if (numInstances_++ == 0) {
+        createSharedGrid();
+    }
+
+    if (heightData.empty() || rows_ < 2 || columns_ < 2) {
+        return;
+    }
+
+    GPUResourceRegistry::ScopedTag registryTag("cdlod_terrain");
+
+    // Height values go to the texture as they are, one texel per heightmap vertex. Filtering is linear,
+    // so that morphing vertices, that are between two heightmap vertices, get interpolated height
+    glGenTextures(1, &heightTextureID_);
+    GLStateCache::getInstance().bindTexture2D(HEIGHT_TEXTURE_UNIT, heightTextureID_);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, columns_, rows_, 0, GL_RED, GL_FLOAT, heightData.values.data());
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    GPUResourceRegistry::getInstance().registerResource(GPUResourceType::Texture, heightTextureID_, static_cast<size_t>(rows_) * columns_ * sizeof(float));
+
+    // Root node has to cover the whole heightmap
+    const auto numQuads = std::max(rows_, columns_) - 1;
+    numLevels_ = std::max(minNumLevels, 1);
+    while ((GRID_SIZE << (numLevels_ - 1)) < numQuads) {
+        numLevels_++;
+    }
+
+    createNode(heightData, 0, 0, numLevels_ - 1);
+    lodRanges_.resize(numLevels_);
+}
+
+CDLODTerrain::~CDLODTerrain()
+{
+    if (heightTextureID_ != 0)
+    {
+        GPUResourceRegistry::getInstance().unregisterResource(GPUResourceType::Texture, heightTextureID_);
+        GLStateCache::getInstance().onTextureDeleted(heightTextureID_);
+        glDeleteTextures(1, &heightTextureID_);
+    }
+
+    if (--numInstances_ == 0) {
+        deleteSharedGrid();
+    }
+}
+
+void CDLODTerrain::prepareShaderProgram()
+{
+    auto& sm = ShaderManager::getInstance();
+
+    if (!sm.containsFragmentShader(ShaderKeys::ambientLight()) || !sm.containsFragmentShader(ShaderKeys::diffuseLight())) {
+        throw std::runtime_error("Please load fragment shaders for ambient light and diffuse light!");
+    }
+
+    sm.loadVertexShader(SHADER_PROGRAM_KEY, "data/shaders/heightmap/cdlod.vert");
+    if (!sm.containsFragmentShader(Heightmap::MULTILAYER_SHADER_PROGRAM_KEY)) {
+        sm.loadFragmentShader(Heightmap::MULTILAYER_SHADER_PROGRAM_KEY, "data/shaders/heightmap/multilayer.frag");
+    }
+
+    auto& spm = ShaderProgramManager::getInstance();
+    auto& terrainShaderProgram = spm.createShaderProgram(SHADER_PROGRAM_KEY);
+    terrainShaderProgram.addShaderToProgram(sm.getVertexShader(SHADER_PROGRAM_KEY));
+    terrainShaderProgram.addShaderToProgram(sm.getFragmentShader(Heightmap::MULTILAYER_SHADER_PROGRAM_KEY));
+
+    terrainShaderProgram.addShaderToProgram(sm.getFragmentShader(ShaderKeys::ambientLight()));
+    terrainShaderProgram.addShaderToProgram(sm.getFragmentShader(ShaderKeys::diffuseLight()));
+}
+
+ShaderProgram& CDLODTerrain::getShaderProgram()
+{
+    return ShaderProgramManager::getInstance().getShaderProgram(SHADER_PROGRAM_KEY);
+}
+
+void CDLODTerrain::selectNodes(const glm::mat4& modelMatrix, const glm::vec3& cameraPosition, const Frustum& frustum)
+{
+    selectedNodes_.clear();
+    numRenderedTriangles_ = 0;
+    selectionCameraPosition_ = cameraPosition;
+    if (nodes_.empty()) {
+        return;
+    }
+
+    // LOD ranges are proportional to world space size of nodes of every level, top level takes whatever is left
+    const auto scaleX = glm::length(glm::vec3(modelMatrix[0]));
+    const auto scaleZ = glm::length(glm::vec3(modelMatrix[2]));
+    const auto quadWorldSize = std::max(scaleX / static_cast<float>(columns_ - 1), scaleZ / static_cast<float>(rows_ - 1));
+    for (auto level = 0; level < numLevels_; level++) {
+        lodRanges_[level] = lodDistanceRatio_ * quadWorldSize * static_cast<float>(GRID_SIZE << level);
+    }
+    lodRanges_[numLevels_ - 1] = UNLIMITED_RANGE;
+
+    selectNode(0, modelMatrix, cameraPosition, frustum, Frustum::ALL_PLANES_MASK);
+}
+
+void CDLODTerrain::render() const
+{
+    if (selectedNodes_.empty()) {
+        return;
+    }
+
+    auto& terrainShaderProgram = getShaderProgram();
+    terrainShaderProgram[ShaderConstants::heightSampler()] = static_cast<GLint>(HEIGHT_TEXTURE_UNIT);
+    terrainShaderProgram[ShaderConstants::cameraPosition()] = selectionCameraPosition_;
+    terrainShaderProgram[ShaderConstants::heightmapOrigin()] = heightmapOrigin_;
+
+    auto& stateCache = GLStateCache::getInstance();
+    stateCache.bindTexture2D(HEIGHT_TEXTURE_UNIT, heightTextureID_);
+    stateCache.bindSampler(HEIGHT_TEXTURE_UNIT, 0);
+    stateCache.bindVertexArray(sharedGridVAO_);
+    stateCache.disable(GL_PRIMITIVE_RESTART); // Restart index left by other meshes can be a real vertex of the grid
+
+    const auto quadrantNumIndices = GRID_SIZE * GRID_SIZE / 4 * 6;
+    for (const auto& selectedNode : selectedNodes_)
+    {
+        // Vertices of the node morph into its parent's grid between start of morphing and the end of the node's range
+        const auto& node = nodes_[selectedNode.nodeIndex];
+        const auto previousRange = node.level > 0 ? lodRanges_[node.level - 1] : 0.0f;
+        const auto morphEnd = lodRanges_[node.level];
+        const auto morphStart = previousRange + (morphEnd - previousRange) * MORPH_START_RATIO;
+        terrainShaderProgram[ShaderConstants::nodeOffset()] = glm::vec2(static_cast<float>(node.column), static_cast<float>(node.row));
+        terrainShaderProgram[ShaderConstants::nodeScale()] = static_cast<float>(1 << node.level);
+        terrainShaderProgram[ShaderConstants::morphRange()] = glm::vec2(morphStart, morphEnd);
+
+        if (selectedNode.quadrantMask == 15)
+        {
+            glDrawElements(GL_TRIANGLES, quadrantNumIndices * 4, GL_UNSIGNED_SHORT, nullptr);
+            continue;
+        }
+
+        for (auto quadrant = 0; quadrant < 4; quadrant++)
+        {
+            if ((selectedNode.quadrantMask & (1 << quadrant)) == 0) {
+                continue;
+            }
+
+            const auto byteOffset = static_cast<size_t>(quadrant) * quadrantNumIndices * sizeof(GLushort);
+            glDrawElements(GL_TRIANGLES, quadrantNumIndices, GL_UNSIGNED_SHORT, reinterpret_cast<void*>(byteOffset));
+        }
+    }
+}
+
+void CDLODTerrain::renderMultilayered(const std::vector<std::string>& textureKeys, const std::vector<float>& levels) const
+{
+    // If there are less than 2 textures, does not even make sense to render terrain in multilayer way
+    if (textureKeys.size() < 2) {
+        return;
+    }
+
+    // Number of levels defined must be correct
+    if ((textureKeys.size() - 1) * 2 != levels.size()) {
+        return;
+    }
+
+    // Bind chosen textures first
+    const auto& tm = TextureManager::getInstance();
+    auto& terrainShaderProgram = getShaderProgram();
+    for (auto i = 0; i < static_cast<int>(textureKeys.size()); i++)
+    {
+        tm.getTexture(textureKeys[i]).bind(i);
+        terrainShaderProgram[Heightmap::ShaderConstants::terrainSampler(i)] = i;
+    }
+
+    // Set uniform levels
+    terrainShaderProgram[Heightmap::ShaderConstants::numLevels()] = static_cast<int>(levels.size());
+    terrainShaderProgram[Heightmap::ShaderConstants::levels()] = levels;
+
+    // Finally render terrain
+    render();
+}
+
+void CDLODTerrain::setHeightmapOrigin(const glm::vec2& heightmapOrigin)
+{
+    heightmapOrigin_ = heightmapOrigin;
+}
+
+int CDLODTerrain::getRows() const
+{
+    return rows_;
+}
+
+int CDLODTerrain::getColumns() const
+{
+    return columns_;
+}
+
+int CDLODTerrain::getNumLevels() const
+{
+    return numLevels_;
+}
+
+size_t CDLODTerrain::getNumSelectedNodes() const
+{
+    return selectedNodes_.size();
+}
+
+size_t CDLODTerrain::getNumRenderedTriangles() const
+{
+    return numRenderedTriangles_;
+}
+
+int CDLODTerrain::createNode(const Heightmap::HeightData& heightData, const int column, const int row, const int level)
+{
+    const auto nodeIndex = static_cast<int>(nodes_.size());
+    nodes_.push_back(Node{ column, row, level, 0.0f, 0.0f, { -1, -1, -1, -1 } });
+
+    auto minHeight = 1e30f;
+    auto maxHeight = -1e30f;
+    if (level == 0)
+    {
+        // Leaf node - go through its heightmap vertices (the last row / column is shared with the next node)
+        const auto lastRow = std::min(row + GRID_SIZE, rows_ - 1);
+        const auto lastColumn = std::min(column + GRID_SIZE, columns_ - 1);
+        for (auto i = row; i <= lastRow; i++)
+        {
+            for (auto j = column; j <= lastColumn; j++)
+            {
+                const auto height = heightData.at(i, j);
+                minHeight = std::min(minHeight, height);
+                maxHeight = std::max(maxHeight, height);
+            }
+        }
+    }
+    else
+    {
+        // Inner node - child i covers quadrant (i % 2, i / 2), children completely outside of the heightmap don't exist
+        const auto halfSize = GRID_SIZE << (level - 1);
+        int children[4];
+        for (auto i = 0; i < 4; i++)
+        {
+            const auto childColumn = column + (i & 1) * halfSize;
+            const auto childRow = row + (i >> 1) * halfSize;
+            children[i] = -1;
+            if (childColumn >= columns_ - 1 || childRow >= rows_ - 1) {
+                continue;
+            }
+
+            children[i] = createNode(heightData, childColumn, childRow, level - 1);
+            minHeight = std::min(minHeight, nodes_[children[i]].minHeight);
+            maxHeight = std::max(maxHeight, nodes_[children[i]].maxHeight);
+        }
+
+        std::copy(children, children + 4, nodes_[nodeIndex].children);
+    }
+
+    nodes_[nodeIndex].minHeight = minHeight;
+    nodes_[nodeIndex].maxHeight = maxHeight;
+    return nodeIndex;
+}
+
+AABB CDLODTerrain::getNodeBox(const Node& node, const glm::mat4& modelMatrix) const
+{
+    // Node may reach beyond the heightmap edge, but vertices there are clamped to the edge in the vertex shader
+    const auto nodeSize = GRID_SIZE << node.level;
+    const auto lastColumn = std::min(node.column + nodeSize, columns_ - 1);
+    const auto lastRow = std::min(node.row + nodeSize, rows_ - 1);
+
+    AABB box;
+    box.min = glm::vec3(-0.5f + static_cast<float>(node.column) / static_cast<float>(columns_ - 1), node.minHeight,
+        -0.5f + static_cast<float>(node.row) / static_cast<float>(rows_ - 1));
+    box.max = glm::vec3(-0.5f + static_cast<float>(lastColumn) / static_cast<float>(columns_ - 1), node.maxHeight,
+        -0.5f + static_cast<float>(lastRow) / static_cast<float>(rows_ - 1));
+    return box.transformed(modelMatrix);
+}
+
+bool CDLODTerrain::selectNode(const int nodeIndex, const glm::mat4& modelMatrix, const glm::vec3& cameraPosition, const Frustum& frustum, int planeMask)
+{
+    const auto& node = nodes_[nodeIndex];
+    const auto box = getNodeBox(node, modelMatrix);
+
+    // Node outside of the frustum is handled - there is nothing to render
+    if (planeMask != 0 && frustum.classifyAABB(box, planeMask) == Frustum::Containment::Outside) {
+        return true;
+    }
+
+    // Node out of range of its level must be rendered by its parent (with coarser grid)
+    if (!boxIntersectsSphere(box, cameraPosition, lodRanges_[node.level])) {
+        return false;
+    }
+
+    // If the node doesn't reach into the range of finer level, the whole node is rendered
+    const auto quadrantNumTriangles = static_cast<size_t>(GRID_SIZE * GRID_SIZE / 2);
+    if (node.level == 0 || !boxIntersectsSphere(box, cameraPosition, lodRanges_[node.level - 1]))
+    {
+        selectedNodes_.push_back(SelectedNode{ nodeIndex, 15 });
+        numRenderedTriangles_ += quadrantNumTriangles * 4;
+        return true;
+    }
+
+    // Otherwise children render what they can and the node renders quadrants of the children, that are out of their range
+    auto quadrantMask = 0;
+    for (auto i = 0; i < 4; i++)
+    {
+        const auto childIndex = node.children[i];
+        if (childIndex != -1 && !selectNode(childIndex, modelMatrix, cameraPosition, frustum, planeMask)) {
+            quadrantMask |= 1 << i;
+        }
+    }
+
+    if (quadrantMask != 0)
+    {
+        selectedNodes_.push_back(SelectedNode{ nodeIndex, quadrantMask });
+        for (auto i = 0; i < 4; i++)
+        {
+            if ((quadrantMask & (1 << i)) != 0) {
+                numRenderedTriangles_ += quadrantNumTriangles;
+            }
+        }
+    }
+
+    return true;
+}
+
+void CDLODTerrain::createSharedGrid()
+{
+    GPUResourceRegistry::ScopedTag registryTag("cdlod_terrain");
+
+    // Vertices are just integer coordinates within the grid, vertex shader places them into the node
+    sharedGridVertices_.createVBO(static_cast<size_t>(GRID_SIZE + 1) * (GRID_SIZE + 1) * sizeof(glm::vec2));
+    for (auto z = 0; z <= GRID_SIZE; z++)
+    {
+        for (auto x = 0; x <= GRID_SIZE; x++) {
+            sharedGridVertices_.addData(glm::vec2(static_cast<float>(x), static_cast<float>(z)));
+        }
+    }
+
+    // Indices are ordered by quadrants (in the same order as node children), so that any quadrant can be rendered
+    // on its own. All quads are split by the same diagonal, which is what morphed vertices of the coarser grid need
+    const auto halfSize = GRID_SIZE / 2;
+    sharedGridIndices_.createVBO(static_cast<size_t>(GRID_SIZE) * GRID_SIZE * 6 * sizeof(GLushort));
+    for (auto quadrant = 0; quadrant < 4; quadrant++)
+    {
+        const auto firstX = (quadrant & 1) * halfSize;
+        const auto firstZ = (quadrant >> 1) * halfSize;
+        for (auto z = firstZ; z < firstZ + halfSize; z++)
+        {
+            for (auto x = firstX; x < firstX + halfSize; x++)
+            {
+                const auto topLeft = static_cast<GLushort>(z * (GRID_SIZE + 1) + x);
+                const auto topRight = static_cast<GLushort>(topLeft + 1);
+                const auto bottomLeft = static_cast<GLushort>(topLeft + GRID_SIZE + 1);
+                const auto bottomRight = static_cast<GLushort>(bottomLeft + 1);
+                const GLushort quadIndices[] = { topLeft, bottomRight, topRight, topLeft, bottomLeft, bottomRight };
+                sharedGridIndices_.addRawData(quadIndices, sizeof(quadIndices));
+            }
+        }
+    }
+
+    glGenVertexArrays(1, &sharedGridVAO_);
+    GLStateCache::getInstance().bindVertexArray(sharedGridVAO_);
+    sharedGridVertices_.bindVBO();
+    sharedGridVertices_.uploadDataToGPU(GL_STATIC_DRAW);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), nullptr);
+    sharedGridIndices_.bindVBO(GL_ELEMENT_ARRAY_BUFFER);
+    sharedGridIndices_.uploadDataToGPU(GL_STATIC_DRAW);
+}
+
+void CDLODTerrain::deleteSharedGrid()
+{
+    GLStateCache::getInstance().onVertexArrayDeleted(sharedGridVAO_);
+    glDeleteVertexArrays(1, &sharedGridVAO_);
+    sharedGridVAO_ = 0;
+
+    sharedGridVertices_.deleteVBO();
+    sharedGridIndices_.deleteVBO();
+}
+
+} // namespace static_meshes_3D
@@ -0,0 +1,192 @@
+#pragma once
+
+// STL
+#include <string>
+#include <vector>
+
+// GLAD
+#include <glad/glad.h>
+
+// GLM
+#include <glm/glm.hpp>
+
+// Project
+#include "../boundingVolumes.h"
+#include "../frustum.h"
+#include "../shaderProgram.h"
+#include "../vertexBufferObject.h"
+
+#include "heightmap.h"
+
+namespace static_meshes_3D {
+
+/**
+ * Terrain rendered with continuous distance-dependent level of detail (CDLOD). Height data are stored in a texture
+ * and the terrain is covered by a quadtree of nodes - every node is rendered with the same small grid mesh, that is
+ * scaled to the node size and displaced in the vertex shader. Nodes near the camera are small (dense), distant nodes
+ * are big (sparse), so the number of rendered triangles depends on LOD distances, not on terrain size. Vertices
+ * morph smoothly into the coarser grid before the node switches to its parent's level, so there are no cracks
+ * between neighbouring levels. Terrain is in the same space as Heightmap ([-0.5, 0.5] x [0, 1] x [-0.5, 0.5]).
+ */
+class CDLODTerrain
+{
+public:
+    static const std::string SHADER_PROGRAM_KEY; // Holds a key for CDLOD terrain shader program (used as vertex shader key too)
+    static const int GRID_SIZE; // Number of quads of the grid mesh along one side (every node is rendered with this grid)
+    static const float DEFAULT_LOD_DISTANCE_RATIO; // Default ratio between LOD range and size of nodes of that level
+
+    struct ShaderConstants
+    {
+        DEFINE_SHADER_CONSTANT(heightSampler, "heightSampler")
+        DEFINE_SHADER_CONSTANT(nodeOffset, "nodeOffset")
+        DEFINE_SHADER_CONSTANT(nodeScale, "nodeScale")
+        DEFINE_SHADER_CONSTANT(morphRange, "morphRange")
+        DEFINE_SHADER_CONSTANT(cameraPosition, "cameraPosition")
+        DEFINE_SHADER_CONSTANT(heightmapOrigin, "heightmapOrigin")
+    };
+
+    /**
+     * Creates terrain from the height data. Only height texture and quadtree with height ranges are kept, not the data.
+     *
+     * @param heightData        Height data to create terrain from (e.g. Heightmap::getHeightData())
+     * @param lodDistanceRatio  How far (in sizes of the nodes) is each level used, before next coarser level takes over
+     * @param minNumLevels      Minimal number of quadtree levels (parts of a bigger terrain must have the same top level, so that they switch levels at the same distances)
+     */
+    CDLODTerrain(const Heightmap::HeightData& heightData, float lodDistanceRatio = DEFAULT_LOD_DISTANCE_RATIO, int minNumLevels = 1);
+    ~CDLODTerrain();
+
+    CDLODTerrain(const CDLODTerrain&) = delete; // No copy constructor allowed
+    void operator=(const CDLODTerrain&) = delete; // No copy assignment allowed
+
+    /**
+     * Loads shaders and creates CDLOD terrain shader program - CDLOD vertex shader with multilayer heightmap fragment shader.
+     */
+    static void prepareShaderProgram();
+    static ShaderProgram& getShaderProgram();
+
+    /**
+     * Selects nodes to be rendered for the current camera. Call this before rendering, whenever camera or model matrix changes.
+     *
+     * @param modelMatrix     Model matrix, that the terrain is rendered with
+     * @param cameraPosition  Position of the camera (in world space)
+     * @param frustum         View frustum (in world space), nodes outside of it are not selected
+     */
+    void selectNodes(const glm::mat4& modelMatrix, const glm::vec3& cameraPosition, const Frustum& frustum);
+
+    /**
+     * Renders selected nodes with CDLOD terrain shader program (it must be in use with matrices set).
+     */
+    void render() const;
+
+    /**
+     * Renders selected nodes with multiple layers, same as Heightmap::renderMultilayered.
+     *
+     * @param textureKeys  Contains which textures should be used (ordered from bottom-most to top-most layer)
+     * @param levels       Contains where within the terrain should layer transitions start / stop
+     */
+    void renderMultilayered(const std::vector<std::string>& textureKeys, const std::vector<float>& levels) const;
+
+    /**
+     * Sets column and row of the first vertex within the bigger heightmap, that this terrain is a part of (e.g. a tile),
+     * so that texture coordinates continue seamlessly across neighbouring parts. Default is (0, 0).
+     */
+    void setHeightmapOrigin(const glm::vec2& heightmapOrigin);
+
+    /**
+     * Gets number of heightmap rows.
+     */
+    int getRows() const;
+
+    /**
+     * Gets number of heightmap columns.
+     */
+    int getColumns() const;
+
+    /**
+     * Gets number of quadtree levels (level 0 is the finest one).
+     */
+    int getNumLevels() const;
+
+    /**
+     * Gets number of nodes selected by the last selection (partially rendered nodes included).
+     */
+    size_t getNumSelectedNodes() const;
+
+    /**
+     * Gets number of triangles, that are rendered with the last selection.
+     */
+    size_t getNumRenderedTriangles() const;
+
+private:
+    /**
+     * Node of the quadtree covering square area of the heightmap.
+     */
+    struct Node
+    {
+        int column; // Column of the first heightmap vertex of the node
+        int row; // Row of the first heightmap vertex of the node
+        int level; // Level of the node (node covers GRID_SIZE * 2^level heightmap quads along one side)
+        float minHeight; // Minimal height within the node
+        float maxHeight; // Maximal height within the node
+        int children[4]; // Indices of child nodes (-1, if the child would be completely outside of the heightmap)
+    };
+
+    /**
+     * Node selected for rendering - either as a whole or just some of its quadrants (those, whose children weren't selected).
+     */
+    struct SelectedNode
+    {
+        int nodeIndex; // Index of the node
+        int quadrantMask; // Bit i is set, if quadrant of child i is rendered (15 means the whole node)
+    };
+
+    /**
+     * Creates node and all of its children recursively.
+     *
+     * @return Index of the created node.
+     */
+    int createNode(const Heightmap::HeightData& heightData, int column, int row, int level);
+
+    /**
+     * Gets bounding box of the node in world space.
+     */
+    AABB getNodeBox(const Node& node, const glm::mat4& modelMatrix) const;
+
+    /**
+     * Selects the node or its children recursively.
+     *
+     * @param planeMask  Frustum planes, that still have to be tested (parent is completely inside of the others)
+     *
+     * @return False, if the node is out of range of its level (parent has to render its area), true otherwise.
+     */
+    bool selectNode(int nodeIndex, const glm::mat4& modelMatrix, const glm::vec3& cameraPosition, const Frustum& frustum, int planeMask);
+
+    /**
+     * Creates grid mesh shared by all terrains, if it doesn't exist yet.
+     */
+    static void createSharedGrid();
+
+    /**
+     * Deletes grid mesh shared by all terrains.
+     */
+    static void deleteSharedGrid();
+
+    static GLuint sharedGridVAO_; // VAO of the grid mesh shared by all terrains
+    static VertexBufferObject sharedGridVertices_; // Grid vertex coordinates (integer positions within the grid)
+    static VertexBufferObject sharedGridIndices_; // 16-bit grid indices ordered by quadrants, so that every quadrant is a contiguous range
+    static int numInstances_; // Number of existing terrains (shared grid is deleted with the last one)
+
+    GLuint heightTextureID_{ 0 }; // Texture with height values (one texel per heightmap vertex)
+    int rows_{ 0 }; // Number of heightmap rows
+    int columns_{ 0 }; // Number of heightmap columns
+    int numLevels_{ 0 }; // Number of quadtree levels
+    float lodDistanceRatio_; // Ratio between LOD range and size of nodes of that level
+    glm::vec2 heightmapOrigin_{ 0.0f }; // Column and row of the first vertex within the bigger heightmap
+    std::vector<Node> nodes_; // All nodes of the quadtree, root is the first one
+    std::vector<float> lodRanges_; // Distance, up to which nodes of every level are used (calculated by selection)
+    std::vector<SelectedNode> selectedNodes_; // Nodes selected by the last selection
+    glm::vec3 selectionCameraPosition_{ 0.0f }; // Camera position of the last selection
+    size_t numRenderedTriangles_{ 0 }; // Number of triangles of selected nodes
+};
+
+} // namespace static_meshes_3D
@@ -0,0 +1,459 @@
+// STL
+#include <iostream>
+#include <algorithm>
+#include <iterator>
+#include <cstring>
+
+// GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+// Project
+#include "geometryArena.h"
+#include "staticMesh3D.h"
+#include "instanceBuffer.h"
+#include "../gpuResourceRegistry.h"
+#include "../glStateCache.h"
+
+namespace static_meshes_3D {
+
+namespace {
+
+/**
+ * Describes one vertex attribute, as it is stored within the arena.
+ */
+struct ArenaAttribute
+{
+    int flag; // Vertex format flag of the attribute (POSITIONS_FLAG, TEXTURE_COORDINATES_FLAG, NORMALS_FLAG)
+    int attributeIndex; // Index of the vertex attribute
+    GLint numComponents; // Number of components, as passed to glVertexAttribPointer
+    GLenum componentType; // Type of components, as passed to glVertexAttribPointer
+    GLboolean normalized; // Whether integer data get normalized to [0, 1] / [-1, 1] range
+    size_t byteSize; // Byte size of the attribute within the arena
+    size_t sourceByteSize; // Byte size of the attribute within the planar source data (floats)
+};
+
+/**
+ * Gets attributes of given vertex format in the order they're stored in.
+ */
+std::vector<ArenaAttribute> getArenaAttributes(int vertexFormat)
+{
+    std::vector<ArenaAttribute> result;
+    if (vertexFormat & GeometryArena::POSITIONS_FLAG)
+    {
+        result.push_back({ GeometryArena::POSITIONS_FLAG, StaticMesh3D::POSITION_ATTRIBUTE_INDEX, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), sizeof(glm::vec3) });
+    }
+
+    if (vertexFormat & GeometryArena::TEXTURE_COORDINATES_FLAG)
+    {
+        if (vertexFormat & GeometryArena::HALF_TEXTURE_COORDINATES_FLAG) {
+            result.push_back({ GeometryArena::TEXTURE_COORDINATES_FLAG, StaticMesh3D::TEXTURE_COORDINATE_ATTRIBUTE_INDEX, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(GLuint), sizeof(glm::vec2) });
+        }
+        else {
+            result.push_back({ GeometryArena::TEXTURE_COORDINATES_FLAG, StaticMesh3D::TEXTURE_COORDINATE_ATTRIBUTE_INDEX, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), sizeof(glm::vec2) });
+        }
+    }
+
+    if (vertexFormat & GeometryArena::NORMALS_FLAG)
+    {
+        // Packed normals have 4 components, shaders declaring vec3 normal simply ignore the last one
+        if (vertexFormat & GeometryArena::PACKED_NORMALS_FLAG) {
+            result.push_back({ GeometryArena::NORMALS_FLAG, StaticMesh3D::NORMAL_ATTRIBUTE_INDEX, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(GLuint), sizeof(glm::vec3) });
+        }
+        else {
+            result.push_back({ GeometryArena::NORMALS_FLAG, StaticMesh3D::NORMAL_ATTRIBUTE_INDEX, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), sizeof(glm::vec3) });
+        }
+    }
+
+    return result;
+}
+
+/**
+ * Encodes one attribute value from source floats into the arena representation.
+ *
+ * @param attribute     Attribute to encode
+ * @param vertexFormat  Vertex format of the attribute
+ * @param source        Pointer to the source floats
+ * @param destination   Where to write encoded attribute
+ */
+void encodeAttribute(const ArenaAttribute& attribute, int vertexFormat, const unsigned char* source, unsigned char* destination)
+{
+    if (attribute.flag == GeometryArena::TEXTURE_COORDINATES_FLAG && (vertexFormat & GeometryArena::HALF_TEXTURE_COORDINATES_FLAG))
+    {
+        glm::vec2 textureCoordinate;
+        memcpy(&textureCoordinate, source, sizeof(glm::vec2));
+        const GLuint packed = glm::packHalf2x16(textureCoordinate);
+        memcpy(destination, &packed, sizeof(GLuint));
+    }
+    else if (attribute.flag == GeometryArena::NORMALS_FLAG && (vertexFormat & GeometryArena::PACKED_NORMALS_FLAG))
+    {
+        glm::vec3 normal;
+        memcpy(&normal, source, sizeof(glm::vec3));
+        const GLuint packed = glm::packSnorm3x10_1x2(glm::vec4(normal, 0.0f));
+        memcpy(destination, &packed, sizeof(GLuint));
+    }
+    else {
+        memcpy(destination, source, attribute.byteSize);
+    }
+}
+
+} // namespace
+
+const int GeometryArena::POSITIONS_FLAG = 1 << 0;
+const int GeometryArena::TEXTURE_COORDINATES_FLAG = 1 << 1;
+const int GeometryArena::NORMALS_FLAG = 1 << 2;
+
+const int GeometryArena::PLANAR_LAYOUT_FLAG = 1 << 3;
+const int GeometryArena::HALF_TEXTURE_COORDINATES_FLAG = 1 << 4;
+const int GeometryArena::PACKED_NORMALS_FLAG = 1 << 5;
+
+const size_t GeometryArena::DEFAULT_POOL_VERTEX_BYTES = 16 * 1024 * 1024;
+const size_t GeometryArena::DEFAULT_POOL_INDICES = 1024 * 1024;
+
+bool GeometryArena::Allocation::isValid() const
+{
+    return poolIndex >= 0;
+}
+
+GeometryArena& GeometryArena::getInstance()
+{
+    static GeometryArena ga;
+    return ga;
+}
+
+int GeometryArena::getVertexFormat(bool hasPositions, bool hasTextureCoordinates, bool hasNormals, int vertexEncodingFlags)
+{
+    return (hasPositions ? POSITIONS_FLAG : 0) | (hasTextureCoordinates ? TEXTURE_COORDINATES_FLAG : 0) | (hasNormals ? NORMALS_FLAG : 0) | vertexEncodingFlags;
+}
+
+GLsizei GeometryArena::getVertexByteSize(int vertexFormat)
+{
+    size_t result = 0;
+    for (const auto& attribute : getArenaAttributes(vertexFormat)) {
+        result += attribute.byteSize;
+    }
+
+    return static_cast<GLsizei>(result);
+}
+
+GeometryArena::Allocation GeometryArena::allocate(int vertexFormat, GLsizei numVertices, GLsizei numIndices)
+{
+    Allocation result;
+    if (numVertices <= 0 || getVertexByteSize(vertexFormat) == 0) {
+        return result;
+    }
+
+    // Try existing pools of the same vertex format first, both vertices and indices must fit into the same pool
+    for (auto i = 0; i < static_cast<int>(pools_.size()) && !result.isValid(); i++)
+    {
+        auto& pool = pools_[i];
+        if (pool.vertexFormat != vertexFormat) {
+            continue;
+        }
+
+        size_t vertexOffset = 0, indexOffset = 0;
+        if (!pool.freeVertices.allocate(numVertices, vertexOffset)) {
+            continue;
+        }
+
+        if (numIndices > 0 && !pool.freeIndices.allocate(numIndices, indexOffset))
+        {
+            pool.freeVertices.free(vertexOffset, numVertices);
+            continue;
+        }
+
+        result.poolIndex = i;
+        result.baseVertex = static_cast<GLint>(vertexOffset);
+        result.firstIndex = static_cast<GLsizei>(indexOffset);
+    }
+
+    // No space anywhere, create a new pool
+    if (!result.isValid())
+    {
+        const auto poolIndex = createPool(vertexFormat, numVertices, numIndices);
+        auto& pool = pools_[poolIndex];
+
+        size_t vertexOffset = 0, indexOffset = 0;
+        pool.freeVertices.allocate(numVertices, vertexOffset);
+        if (numIndices > 0) {
+            pool.freeIndices.allocate(numIndices, indexOffset);
+        }
+
+        result.poolIndex = poolIndex;
+        result.baseVertex = static_cast<GLint>(vertexOffset);
+        result.firstIndex = static_cast<GLsizei>(indexOffset);
+    }
+
+    result.numVertices = numVertices;
+    result.numIndices = numIndices;
+
+    // Register the range under the tag of its owner, so that it's visible who uses the arena space
+    result.registryID = ++lastRangeRegistryID_;
+    GPUResourceRegistry::getInstance().registerResource(GPUResourceType::GeometryArenaRange, result.registryID,
+        static_cast<size_t>(numVertices) * getVertexByteSize(vertexFormat) + sizeof(GLuint) * numIndices);
+    return result;
+}
+
+void GeometryArena::uploadPlanarVertices(const Allocation& allocation, const void* planarData)
+{
+    if (!allocation.isValid()) {
+        return;
+    }
+
+    const auto& pool = pools_[allocation.poolIndex];
+    const auto attributes = getArenaAttributes(pool.vertexFormat);
+    const auto vertexByteSize = static_cast<size_t>(getVertexByteSize(pool.vertexFormat));
+    const auto isPlanar = (pool.vertexFormat & PLANAR_LAYOUT_FLAG) != 0;
+    const auto planarBytes = static_cast<const unsigned char*>(planarData);
+
+    // Copy write target is used, so that we don't disturb any buffer bindings that might be important
+    GLStateCache::getInstance().bindBuffer(GL_COPY_WRITE_BUFFER, pool.vertexBufferID);
+    const auto mapFlags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+    unsigned char* mappedData = nullptr;
+    if (!isPlanar)
+    {
+        mappedData = static_cast<unsigned char*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, vertexByteSize * allocation.baseVertex, vertexByteSize * allocation.numVertices, mapFlags));
+        if (mappedData == nullptr)
+        {
+            std::cerr << "Could not map geometry arena buffer with ID " << pool.vertexBufferID << "!" << std::endl;
+            return;
+        }
+    }
+
+    // Every attribute is stored as a contiguous block in planar source data, encode them one by one
+    size_t sourceOffset = 0, attributeOffset = 0, blockOffset = 0;
+    for (const auto& attribute : attributes)
+    {
+        // In planar layout, every attribute has its own block in the pool, so we map just the range within that block
+        unsigned char* destination = nullptr;
+        auto destinationStride = vertexByteSize;
+        if (isPlanar)
+        {
+            destination = static_cast<unsigned char*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, blockOffset + attribute.byteSize * allocation.baseVertex,
+                attribute.byteSize * allocation.numVertices, mapFlags));
+            destinationStride = attribute.byteSize;
+            if (destination == nullptr)
+            {
+                std::cerr << "Could not map geometry arena buffer with ID " << pool.vertexBufferID << "!" << std::endl;
+                return;
+            }
+        }
+        else {
+            destination = mappedData + attributeOffset;
+        }
+
+        for (auto i = 0; i < allocation.numVertices; i++)
+        {
+            encodeAttribute(attribute, pool.vertexFormat, planarBytes + sourceOffset + attribute.sourceByteSize * i, destination + destinationStride * i);
+        }
+
+        if (isPlanar) {
+            glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        }
+
+        sourceOffset += attribute.sourceByteSize * allocation.numVertices;
+        attributeOffset += attribute.byteSize;
+        blockOffset += attribute.byteSize * pool.vertexCapacity;
+    }
+
+    if (!isPlanar) {
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    }
+}
+
+void GeometryArena::uploadIndices(const Allocation& allocation, const GLuint* indices)
+{
+    if (!allocation.isValid() || allocation.numIndices == 0) {
+        return;
+    }
+
+    const auto& pool = pools_[allocation.poolIndex];
+    GLStateCache::getInstance().bindBuffer(GL_COPY_WRITE_BUFFER, pool.indexBufferID);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, sizeof(GLuint) * allocation.firstIndex, sizeof(GLuint) * allocation.numIndices, indices);
+}
+
+void GeometryArena::free(Allocation& allocation)
+{
+    if (allocation.registryID != 0) {
+        GPUResourceRegistry::getInstance().unregisterResource(GPUResourceType::GeometryArenaRange, allocation.registryID);
+    }
+
+    // Pools might have been cleared already (e.g. mesh outlived the OpenGL context)
+    if (!allocation.isValid() || allocation.poolIndex >= static_cast<int>(pools_.size())) {
+        allocation = Allocation();
+        return;
+    }
+
+    auto& pool = pools_[allocation.poolIndex];
+    pool.freeVertices.free(allocation.baseVertex, allocation.numVertices);
+    if (allocation.numIndices > 0) {
+        pool.freeIndices.free(allocation.firstIndex, allocation.numIndices);
+    }
+
+    allocation = Allocation();
+}
+
+void GeometryArena::bindVertexArray(const Allocation& allocation) const
+{
+    if (!allocation.isValid()) {
+        return;
+    }
+
+    GLStateCache::getInstance().bindVertexArray(pools_[allocation.poolIndex].vao);
+}
+
+void GeometryArena::bindInstancedVertexArray(const Allocation& allocation, const GLuint instanceBufferID)
+{
+    if (!allocation.isValid()) {
+        return;
+    }
+
+    auto& pool = pools_[allocation.poolIndex];
+    auto& stateCache = GLStateCache::getInstance();
+    if (pool.instancedVao == 0)
+    {
+        glGenVertexArrays(1, &pool.instancedVao);
+        stateCache.bindVertexArray(pool.instancedVao);
+        setupPoolVertexAttributes(pool);
+        InstanceBuffer::setupInstanceAttributes();
+    }
+
+    stateCache.bindVertexArray(pool.instancedVao);
+    glBindVertexBuffer(InstanceBuffer::VERTEX_BUFFER_BINDING_INDEX, instanceBufferID, 0, sizeof(InstanceBuffer::InstanceData));
+}
+
+void GeometryArena::clearArena()
+{
+    auto& stateCache = GLStateCache::getInstance();
+    for (auto& pool : pools_)
+    {
+        std::cout << "Deleting geometry arena pool with vertex buffer ID " << pool.vertexBufferID << " and index buffer ID " << pool.indexBufferID << std::endl;
+        stateCache.onVertexArrayDeleted(pool.vao);
+        stateCache.onBufferDeleted(pool.vertexBufferID);
+        stateCache.onBufferDeleted(pool.indexBufferID);
+        glDeleteVertexArrays(1, &pool.vao);
+        if (pool.instancedVao != 0)
+        {
+            stateCache.onVertexArrayDeleted(pool.instancedVao);
+            glDeleteVertexArrays(1, &pool.instancedVao);
+        }
+        GPUResourceRegistry::getInstance().unregisterResource(GPUResourceType::VertexBuffer, pool.vertexBufferID);
+        GPUResourceRegistry::getInstance().unregisterResource(GPUResourceType::VertexBuffer, pool.indexBufferID);
+        glDeleteBuffers(1, &pool.vertexBufferID);
+        glDeleteBuffers(1, &pool.indexBufferID);
+    }
+
+    pools_.clear();
+}
+
+int GeometryArena::createPool(int vertexFormat, GLsizei minVertices, GLsizei minIndices)
+{
+    const auto vertexByteSize = getVertexByteSize(vertexFormat);
+    const auto numVertices = std::max(DEFAULT_POOL_VERTEX_BYTES / vertexByteSize, static_cast<size_t>(minVertices));
+    const auto numIndices = std::max(DEFAULT_POOL_INDICES, static_cast<size_t>(minIndices));
+
+    Pool pool;
+    pool.vertexFormat = vertexFormat;
+    pool.vertexCapacity = static_cast<GLsizei>(numVertices);
+    pool.freeVertices.reset(numVertices);
+    pool.freeIndices.reset(numIndices);
+
+    auto& stateCache = GLStateCache::getInstance();
+    glGenVertexArrays(1, &pool.vao);
+    stateCache.bindVertexArray(pool.vao);
+
+    GPUResourceRegistry::ScopedTag registryTag("geometry_arena");
+    glGenBuffers(1, &pool.vertexBufferID);
+    stateCache.bindBuffer(GL_ARRAY_BUFFER, pool.vertexBufferID);
+    glBufferData(GL_ARRAY_BUFFER, numVertices * vertexByteSize, nullptr, GL_STATIC_DRAW);
+    GPUResourceRegistry::getInstance().registerResource(GPUResourceType::VertexBuffer, pool.vertexBufferID, numVertices * vertexByteSize);
+
+    glGenBuffers(1, &pool.indexBufferID);
+    stateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, pool.indexBufferID);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, numIndices * sizeof(GLuint), nullptr, GL_STATIC_DRAW);
+    GPUResourceRegistry::getInstance().registerResource(GPUResourceType::VertexBuffer, pool.indexBufferID, numIndices * sizeof(GLuint));
+
+    setupPoolVertexAttributes(pool);
+    stateCache.bindVertexArray(0);
+    std::cout << "Created geometry arena pool for vertex format " << vertexFormat << " with " << numVertices << " vertices and " << numIndices << " indices" << std::endl;
+
+    pools_.push_back(std::move(pool));
+    return static_cast<int>(pools_.size()) - 1;
+}
+
+void GeometryArena::setupPoolVertexAttributes(const Pool& pool)
+{
+    // Index buffer binding is part of VAO state, so every draw from this pool uses it automatically
+    auto& stateCache = GLStateCache::getInstance();
+    stateCache.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, pool.indexBufferID);
+    stateCache.bindBuffer(GL_ARRAY_BUFFER, pool.vertexBufferID);
+
+    // Set up vertex attributes - interleaved ones share one stride, planar ones have their own blocks
+    const auto vertexByteSize = getVertexByteSize(pool.vertexFormat);
+    const auto isPlanar = (pool.vertexFormat & PLANAR_LAYOUT_FLAG) != 0;
+    uint64_t offset = 0;
+    for (const auto& attribute : getArenaAttributes(pool.vertexFormat))
+    {
+        const auto stride = isPlanar ? static_cast<GLsizei>(attribute.byteSize) : vertexByteSize;
+        glEnableVertexAttribArray(attribute.attributeIndex);
+        glVertexAttribPointer(attribute.attributeIndex, attribute.numComponents, attribute.componentType, attribute.normalized, stride, reinterpret_cast<void*>(offset));
+        offset += isPlanar ? attribute.byteSize * pool.vertexCapacity : attribute.byteSize;
+    }
+}
+
+void GeometryArena::FreeRangeList::reset(size_t size)
+{
+    freeRanges_.clear();
+    freeRanges_[0] = size;
+}
+
+bool GeometryArena::FreeRangeList::allocate(size_t size, size_t& outOffset)
+{
+    for (auto it = freeRanges_.begin(); it != freeRanges_.end(); ++it)
+    {
+        if (it->second < size) {
+            continue;
+        }
+
+        outOffset = it->first;
+        const auto remainingSize = it->second - size;
+        freeRanges_.erase(it);
+        if (remainingSize > 0) {
+            freeRanges_[outOffset + size] = remainingSize;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+void GeometryArena::FreeRangeList::free(size_t offset, size_t size)
+{
+    if (size == 0) {
+        return;
+    }
+
+    auto it = freeRanges_.emplace(offset, size).first;
+
+    // Merge with the following free range, if they touch
+    const auto nextIt = std::next(it);
+    if (nextIt != freeRanges_.end() && it->first + it->second == nextIt->first)
+    {
+        it->second += nextIt->second;
+        freeRanges_.erase(nextIt);
+    }
+
+    // Merge with the preceding free range, if they touch
+    if (it != freeRanges_.begin())
+    {
+        const auto prevIt = std::prev(it);
+        if (prevIt->first + prevIt->second == it->first)
+        {
+            prevIt->second += it->second;
+            freeRanges_.erase(it);
+        }
+    }
+}
+
+} // namespace static_meshes_3D
@@ -0,0 +1,193 @@
+#pragma once
+
+// STL
+#include <vector>
+#include <map>
+
+// GLAD
+#include <glad/glad.h>
+
+namespace static_meshes_3D {
+
+/**
+ * Singleton class that suballocates vertex and index data of all static meshes from a few large buffers.
+ * Meshes with the same vertex format share one VAO, so rendering different meshes doesn't need to switch
+ * VAOs and buffers - meshes only draw with their base vertex and index offset. Vertex data are stored
+ * interleaved (or planar, if requested) within the arena buffers and attributes can be stored in packed encodings.
+ */
+class GeometryArena
+{
+public:
+    static const int POSITIONS_FLAG; // Vertex format flag telling, that vertices have positions
+    static const int TEXTURE_COORDINATES_FLAG; // Vertex format flag telling, that vertices have texture coordinates
+    static const int NORMALS_FLAG; // Vertex format flag telling, that vertices have normals
+
+    static const int PLANAR_LAYOUT_FLAG; // Vertex encoding flag - store every attribute in its own block instead of interleaving them
+    static const int HALF_TEXTURE_COORDINATES_FLAG; // Vertex encoding flag - store texture coordinates as half floats
+    static const int PACKED_NORMALS_FLAG; // Vertex encoding flag - store normals as GL_INT_2_10_10_10_REV
+
+    static const size_t DEFAULT_POOL_VERTEX_BYTES; // Default size of vertex buffer of one pool (in bytes)
+    static const size_t DEFAULT_POOL_INDICES; // Default count of indices, that fit into index buffer of one pool
+
+    /**
+     * Holds, where the geometry of one mesh lives within the arena.
+     */
+    struct Allocation
+    {
+        int poolIndex{ -1 }; // Index of the pool the geometry has been allocated from
+        GLint baseVertex{ 0 }; // Index of the first vertex within the pool vertex buffer
+        GLsizei numVertices{ 0 }; // Number of allocated vertices
+        GLsizei firstIndex{ 0 }; // Index of the first index within the pool index buffer
+        GLsizei numIndices{ 0 }; // Number of allocated indices
+        GLuint registryID{ 0 }; // ID under which the range is registered in GPU resource registry
+
+        /**
+         * Checks, if the allocation is valid (it holds some geometry).
+         */
+        bool isValid() const;
+    };
+
+    /**
+     * Gets the one and only instance of the geometry arena.
+     */
+    static GeometryArena& getInstance();
+
+    /**
+     * Gets vertex format identifier from present vertex attributes and vertex encoding flags.
+     *
+     * @param hasPositions           Whether vertices have positions
+     * @param hasTextureCoordinates  Whether vertices have texture coordinates
+     * @param hasNormals             Whether vertices have normals
+     * @param vertexEncodingFlags    Combination of vertex encoding flags (default is 0, that means interleaved floats)
+     */
+    static int getVertexFormat(bool hasPositions, bool hasTextureCoordinates, bool hasNormals, int vertexEncodingFlags = 0);
+
+    /**
+     * Gets byte size of one vertex of given vertex format, as it is stored in the arena.
+     */
+    static GLsizei getVertexByteSize(int vertexFormat);
+
+    /**
+     * Allocates space for vertices (and optionally indices) of given vertex format. Freed ranges are reused first,
+     * if there is no space in any of existing pools, a new pool is created.
+     *
+     * @param vertexFormat  Vertex format of allocated vertices (see getVertexFormat)
+     * @param numVertices   Number of vertices to allocate
+     * @param numIndices    Number of indices to allocate (default is 0 for non-indexed geometry)
+     *
+     * @return Allocation describing where the geometry lives.
+     */
+    Allocation allocate(int vertexFormat, GLsizei numVertices, GLsizei numIndices = 0);
+
+    /**
+     * Uploads vertex data stored in planar layout (all positions, then all texture coordinates, then all normals)
+     * as 32-bit floats to the allocated range. Data are interleaved and encoded while they are being written to the mapped buffer.
+     *
+     * @param allocation  Allocation to upload vertices to
+     * @param planarData  Pointer to the planar vertex data
+     */
+    void uploadPlanarVertices(const Allocation& allocation, const void* planarData);
+
+    /**
+     * Uploads indices to the allocated range. Indices are local to the mesh (base vertex is added while drawing).
+     *
+     * @param allocation  Allocation to upload indices to
+     * @param indices     Pointer to the indices
+     */
+    void uploadIndices(const Allocation& allocation, const GLuint* indices);
+
+    /**
+     * Returns allocated ranges back to the arena, so that they can be reused. Allocation gets invalidated.
+     *
+     * @param allocation  Allocation to be freed
+     */
+    void free(Allocation& allocation);
+
+    /**
+     * Binds shared VAO of the pool the geometry has been allocated from.
+     *
+     * @param allocation  Allocation to bind VAO for
+     */
+    void bindVertexArray(const Allocation& allocation) const;
+
+    /**
+     * Binds VAO for instanced rendering of the pool the geometry has been allocated from and attaches instance buffer to it.
+     * Instanced VAO has the same vertex attributes as the shared one plus per-instance attributes and it's created on first use.
+     *
+     * @param allocation        Allocation to bind VAO for
+     * @param instanceBufferID  Buffer with per-instance data (see InstanceBuffer)
+     */
+    void bindInstancedVertexArray(const Allocation& allocation, GLuint instanceBufferID);
+
+    /**
+     * Deletes all the pools and releases all OpenGL objects of the arena.
+     */
+    void clearArena();
+
+private:
+    GeometryArena() {} // Private constructor to make class singleton
+    GeometryArena(const GeometryArena&) = delete; // No copy constructor allowed
+    void operator=(const GeometryArena&) = delete; // No copy assignment allowed
+
+    /**
+     * Keeps track of free ranges in a buffer and allocates from them (first-fit). Neighbouring free ranges get merged.
+     */
+    class FreeRangeList
+    {
+    public:
+        /**
+         * Resets the list, so that whole buffer of given size is free.
+         */
+        void reset(size_t size);
+
+        /**
+         * Tries to allocate range of given size.
+         *
+         * @param size       Size of the range to allocate
+         * @param outOffset  Here the offset of allocated range is returned
+         *
+         * @return True, if the range has been allocated or false, if there isn't any big enough free range.
+         */
+        bool allocate(size_t size, size_t& outOffset);
+
+        /**
+         * Returns range back to the list of free ranges.
+         */
+        void free(size_t offset, size_t size);
+
+    private:
+        std::map<size_t, size_t> freeRanges_; // Free ranges, maps offset to size of the range
+    };
+
+    /**
+     * Pool of geometry of one vertex format - vertex buffer, index buffer and a VAO sharing them.
+     */
+    struct Pool
+    {
+        int vertexFormat{ 0 }; // Vertex format of the vertices in this pool
+        GLsizei vertexCapacity{ 0 }; // How many vertices fit into the pool vertex buffer
+        GLuint vao{ 0 }; // VAO set up for the pool buffers
+        GLuint instancedVao{ 0 }; // VAO set up for the pool buffers and per-instance attributes (created on demand)
+        GLuint vertexBufferID{ 0 }; // Buffer holding interleaved vertices
+        GLuint indexBufferID{ 0 }; // Buffer holding indices
+        FreeRangeList freeVertices; // Free ranges of vertex buffer (in vertices)
+        FreeRangeList freeIndices; // Free ranges of index buffer (in indices)
+    };
+
+    /**
+     * Creates a new pool for given vertex format. Pool is created big enough to hold given count of vertices and indices.
+     *
+     * @return Index of the newly created pool.
+     */
+    int createPool(int vertexFormat, GLsizei minVertices, GLsizei minIndices);
+
+    /**
+     * Sets up vertex attributes and index buffer of the pool in the currently bound VAO.
+     */
+    static void setupPoolVertexAttributes(const Pool& pool);
+
+    std::vector<Pool> pools_; // All pools of the arena
+    GLuint lastRangeRegistryID_{ 0 }; // Last ID assigned to allocated range in GPU resource registry
+};
+
+} // namespace static_meshes_3D
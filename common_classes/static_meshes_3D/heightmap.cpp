@@ -1,7 +1,17 @@
 // STL
+#include <algorithm>
 #include <iostream>
 #include <random>
 
+// SIMD intrinsics (AVX when the compiler targets it, SSE on every x86-64 compiler, plain C++ otherwise)
+#if defined(__AVX__)
+#define HEIGHTMAP_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HEIGHTMAP_SSE
+#include <emmintrin.h>
+#endif
+
 // GLM
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
@@ -12,29 +22,191 @@
 // Project
 #include "heightmap.h"
 
+#include "../../common_classes/jobSystem.h"
 #include "../../common_classes/textureManager.h"
 #include "../../common_classes/shaderManager.h"
 #include "../../common_classes/shaderProgramManager.h"
+#include "../../common_classes/gpuResourceRegistry.h"
 
 namespace static_meshes_3D {
 
+namespace {
+
+const size_t ROWS_PER_JOB = 64; // Number of rows, whose vertex data are calculated by one job
+
+/**
+ * Normals of both triangles of every quad in one row of quads, stored as structure of arrays. Quad j is stored at index j + 1,
+ * first and last element are always zero, so that vertices at the edges can sum their neighbors without any branching.
+ */
+struct TriangleNormalsRow
+{
+    std::vector<float> x[2], y[2], z[2]; // Components of normals of the first and the second triangle
+
+    explicit TriangleNormalsRow(const int columns)
+    {
+        for (auto k = 0; k < 2; k++)
+        {
+            x[k].assign(columns + 1, 0.0f);
+            y[k].assign(columns + 1, 0.0f);
+            z[k].assign(columns + 1, 0.0f);
+        }
+    }
+
+    void clear()
+    {
+        for (auto k = 0; k < 2; k++)
+        {
+            std::fill(x[k].begin(), x[k].end(), 0.0f);
+            std::fill(y[k].begin(), y[k].end(), 0.0f);
+            std::fill(z[k].begin(), z[k].end(), 0.0f);
+        }
+    }
+};
+
+/**
+ * Calculates normals of both triangles of all quads between two rows of heights. Quad with corners A (top left), B (top right),
+ * C (bottom right) and D (bottom left) is split into triangles ABD and BCD, whose cross products simplify to:
+ *   A: (-dz * (hB - hA), dx * dz, dx * (hA - hD))
+ *   B: (dz * (hD - hC), dx * dz, dx * (hB - hC))
+ *
+ * @param topHeights     Heights of the upper row
+ * @param bottomHeights  Heights of the lower row
+ * @param numQuads       Number of quads in the row (columns - 1)
+ * @param dx             Distance between two columns
+ * @param dz             Distance between two rows
+ * @param result         Row of triangle normals to store the normals to
+ */
+void calculateTriangleNormalsRow(const float* topHeights, const float* bottomHeights, const int numQuads, const float dx, const float dz, TriangleNormalsRow& result)
+{
+    auto j = 0;
+#if defined(HEIGHTMAP_AVX)
+    const auto dxVector = _mm256_set1_ps(dx);
+    const auto dzVector = _mm256_set1_ps(dz);
+    const auto normalYVector = _mm256_set1_ps(dx * dz);
+    const auto normalYSquaredVector = _mm256_mul_ps(normalYVector, normalYVector);
+    for (; j + 8 <= numQuads; j += 8)
+    {
+        const auto heightA = _mm256_loadu_ps(topHeights + j);
+        const auto heightB = _mm256_loadu_ps(topHeights + j + 1);
+        const auto heightC = _mm256_loadu_ps(bottomHeights + j + 1);
+        const auto heightD = _mm256_loadu_ps(bottomHeights + j);
+
+        const auto normalAX = _mm256_mul_ps(dzVector, _mm256_sub_ps(heightA, heightB));
+        const auto normalAZ = _mm256_mul_ps(dxVector, _mm256_sub_ps(heightA, heightD));
+        const auto lengthA = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(normalAX, normalAX), normalYSquaredVector), _mm256_mul_ps(normalAZ, normalAZ)));
+        _mm256_storeu_ps(result.x[0].data() + j + 1, _mm256_div_ps(normalAX, lengthA));
+        _mm256_storeu_ps(result.y[0].data() + j + 1, _mm256_div_ps(normalYVector, lengthA));
+        _mm256_storeu_ps(result.z[0].data() + j + 1, _mm256_div_ps(normalAZ, lengthA));
+
+        const auto normalBX = _mm256_mul_ps(dzVector, _mm256_sub_ps(heightD, heightC));
+        const auto normalBZ = _mm256_mul_ps(dxVector, _mm256_sub_ps(heightB, heightC));
+        const auto lengthB = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(normalBX, normalBX), normalYSquaredVector), _mm256_mul_ps(normalBZ, normalBZ)));
+        _mm256_storeu_ps(result.x[1].data() + j + 1, _mm256_div_ps(normalBX, lengthB));
+        _mm256_storeu_ps(result.y[1].data() + j + 1, _mm256_div_ps(normalYVector, lengthB));
+        _mm256_storeu_ps(result.z[1].data() + j + 1, _mm256_div_ps(normalBZ, lengthB));
+    }
+#elif defined(HEIGHTMAP_SSE)
+    const auto dxVector = _mm_set1_ps(dx);
+    const auto dzVector = _mm_set1_ps(dz);
+    const auto normalYVector = _mm_set1_ps(dx * dz);
+    const auto normalYSquaredVector = _mm_mul_ps(normalYVector, normalYVector);
+    for (; j + 4 <= numQuads; j += 4)
+    {
+        const auto heightA = _mm_loadu_ps(topHeights + j);
+        const auto heightB = _mm_loadu_ps(topHeights + j + 1);
+        const auto heightC = _mm_loadu_ps(bottomHeights + j + 1);
+        const auto heightD = _mm_loadu_ps(bottomHeights + j);
+
+        const auto normalAX = _mm_mul_ps(dzVector, _mm_sub_ps(heightA, heightB));
+        const auto normalAZ = _mm_mul_ps(dxVector, _mm_sub_ps(heightA, heightD));
+        const auto lengthA = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(normalAX, normalAX), normalYSquaredVector), _mm_mul_ps(normalAZ, normalAZ)));
+        _mm_storeu_ps(result.x[0].data() + j + 1, _mm_div_ps(normalAX, lengthA));
+        _mm_storeu_ps(result.y[0].data() + j + 1, _mm_div_ps(normalYVector, lengthA));
+        _mm_storeu_ps(result.z[0].data() + j + 1, _mm_div_ps(normalAZ, lengthA));
+
+        const auto normalBX = _mm_mul_ps(dzVector, _mm_sub_ps(heightD, heightC));
+        const auto normalBZ = _mm_mul_ps(dxVector, _mm_sub_ps(heightB, heightC));
+        const auto lengthB = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(normalBX, normalBX), normalYSquaredVector), _mm_mul_ps(normalBZ, normalBZ)));
+        _mm_storeu_ps(result.x[1].data() + j + 1, _mm_div_ps(normalBX, lengthB));
+        _mm_storeu_ps(result.y[1].data() + j + 1, _mm_div_ps(normalYVector, lengthB));
+        _mm_storeu_ps(result.z[1].data() + j + 1, _mm_div_ps(normalBZ, lengthB));
+    }
+#endif
+
+    // Remaining quads (or all of them without SIMD)
+    const auto normalY = dx * dz;
+    for (; j < numQuads; j++)
+    {
+        const auto heightA = topHeights[j];
+        const auto heightB = topHeights[j + 1];
+        const auto heightC = bottomHeights[j + 1];
+        const auto heightD = bottomHeights[j];
+
+        const auto normalA = glm::normalize(glm::vec3(dz * (heightA - heightB), normalY, dx * (heightA - heightD)));
+        result.x[0][j + 1] = normalA.x;
+        result.y[0][j + 1] = normalA.y;
+        result.z[0][j + 1] = normalA.z;
+
+        const auto normalB = glm::normalize(glm::vec3(dz * (heightD - heightC), normalY, dx * (heightB - heightC)));
+        result.x[1][j + 1] = normalB.x;
+        result.y[1][j + 1] = normalB.y;
+        result.z[1][j + 1] = normalB.z;
+    }
+}
+
+/**
+ * Sums one component of triangle normals adjacent to the vertices of one row: upper-left (first triangle), upper-right (both),
+ * bottom-right (first triangle) and bottom-left (both). Vertex j has quads j - 1 and j at indices j and j + 1.
+ */
+void sumAdjacentTriangleNormals(const std::vector<float>* above, const std::vector<float>* below, const int columns, float* result)
+{
+    auto j = 0;
+#if defined(HEIGHTMAP_AVX)
+    for (; j + 8 <= columns; j += 8)
+    {
+        auto sum = _mm256_add_ps(_mm256_loadu_ps(above[0].data() + j), _mm256_loadu_ps(above[0].data() + j + 1));
+        sum = _mm256_add_ps(sum, _mm256_loadu_ps(above[1].data() + j + 1));
+        sum = _mm256_add_ps(sum, _mm256_loadu_ps(below[0].data() + j + 1));
+        sum = _mm256_add_ps(sum, _mm256_loadu_ps(below[0].data() + j));
+        sum = _mm256_add_ps(sum, _mm256_loadu_ps(below[1].data() + j));
+        _mm256_storeu_ps(result + j, sum);
+    }
+#elif defined(HEIGHTMAP_SSE)
+    for (; j + 4 <= columns; j += 4)
+    {
+        auto sum = _mm_add_ps(_mm_loadu_ps(above[0].data() + j), _mm_loadu_ps(above[0].data() + j + 1));
+        sum = _mm_add_ps(sum, _mm_loadu_ps(above[1].data() + j + 1));
+        sum = _mm_add_ps(sum, _mm_loadu_ps(below[0].data() + j + 1));
+        sum = _mm_add_ps(sum, _mm_loadu_ps(below[0].data() + j));
+        sum = _mm_add_ps(sum, _mm_loadu_ps(below[1].data() + j));
+        _mm_storeu_ps(result + j, sum);
+    }
+#endif
+
+    for (; j < columns; j++) {
+        result[j] = above[0][j] + above[0][j + 1] + above[1][j + 1] + below[0][j + 1] + below[0][j] + below[1][j];
+    }
+}
+
+} // namespace
+
 const std::string Heightmap::MULTILAYER_SHADER_PROGRAM_KEY = "multilayer_heightmap";
 
-Heightmap::Heightmap(const HillAlgorithmParameters& params, bool withPositions, bool withTextureCoordinates, bool withNormals)
-    : StaticMeshIndexed3D(withPositions, withTextureCoordinates, withNormals)
+Heightmap::Heightmap(const HillAlgorithmParameters& params, bool withPositions, bool withTextureCoordinates, bool withNormals, int vertexEncodingFlags)
+    : StaticMeshIndexed3D(withPositions, withTextureCoordinates, withNormals, vertexEncodingFlags)
 {
     createFromHeightData(generateRandomHeightData(params));
 }
 
-Heightmap::Heightmap(const std::string& fileName, bool withPositions, bool withTextureCoordinates, bool withNormals)
-    : StaticMeshIndexed3D(withPositions, withTextureCoordinates, withNormals)
+Heightmap::Heightmap(const std::string& fileName, bool withPositions, bool withTextureCoordinates, bool withNormals, int vertexEncodingFlags)
+    : StaticMeshIndexed3D(withPositions, withTextureCoordinates, withNormals, vertexEncodingFlags)
 {
-    const auto heightData = getHeightDataFromImage(fileName);
-    if (heightData.size() == 0) {
+    auto heightData = getHeightDataFromImage(fileName);
+    if (heightData.empty()) {
         return;
     }
 
-    createFromHeightData(heightData);
+    createFromHeightData(std::move(heightData));
 }
 
 void Heightmap::prepareMultiLayerShaderProgram()
@@ -62,51 +234,71 @@ ShaderProgram& Heightmap::getMultiLayerShaderProgram()
     return ShaderProgramManager::getInstance().getShaderProgram(MULTILAYER_SHADER_PROGRAM_KEY);
 }
 
-void Heightmap::createFromHeightData(const std::vector<std::vector<float>>& heightData)
+void Heightmap::createFromHeightData(HeightData heightData)
 {
     if (_isInitialized) {
         deleteMesh();
     }
 
-    _heightData = heightData;
-    _rows = static_cast<int>(_heightData.size());
-    _columns = static_cast<int>(_heightData[0].size());
+    GPUResourceRegistry::ScopedTag registryTag("heightmap");
+
+    _heightData = std::move(heightData);
+    _rows = _heightData.rows;
+    _columns = _heightData.columns;
     _numVertices = _rows * _columns;
 
-    // First, prepare VAO and VBO for vertex data
-    glGenVertexArrays(1, &_vao);
-    glBindVertexArray(_vao);
-    _vbo.createVBO(_numVertices*getVertexByteSize()); // Preallocate memory
-    _vbo.bindVBO();
+    // Allocate space for the heightmap in the geometry arena
+    _numIndices = (_rows - 1)*_columns * 2 + _rows - 1;
+    auto& geometryArena = GeometryArena::getInstance();
+    _geometry = geometryArena.allocate(getGeometryArenaVertexFormat(), _numVertices, _numIndices);
 
-    if (hasPositions()) {
-        setUpVertices();
-    }
+    // Vertex data are calculated right into the planar layout in the right-sized block (arena interleaves them while writing them to the GPU).
+    // Bands of rows are independent of each other, so they are calculated on the job system
+    {
+        std::vector<unsigned char> planarData(static_cast<size_t>(_numVertices)*getSourceVertexByteSize());
+        auto vertexData = planarData.data();
+        glm::vec3* vertices = nullptr;
+        glm::vec2* textureCoordinates = nullptr;
+        glm::vec3* normals = nullptr;
+        if (hasPositions())
+        {
+            vertices = reinterpret_cast<glm::vec3*>(vertexData);
+            vertexData += static_cast<size_t>(_numVertices) * sizeof(glm::vec3);
+        }
 
-    if (hasTextureCoordinates()) {
-        setUpTextureCoordinates();
-    }
+        if (hasTextureCoordinates())
+        {
+            textureCoordinates = reinterpret_cast<glm::vec2*>(vertexData);
+            vertexData += static_cast<size_t>(_numVertices) * sizeof(glm::vec2);
+        }
 
-    if (hasNormals()) {
-        if (!hasPositions()) {
-            setUpVertices();
+        if (hasNormals()) {
+            normals = reinterpret_cast<glm::vec3*>(vertexData);
         }
 
-        setUpNormals();
+        JobSystem::getInstance().parallelFor(0, static_cast<size_t>(_rows), ROWS_PER_JOB,
+            [this, vertices, textureCoordinates, normals](const size_t firstRow, const size_t lastRow)
+        {
+            if (vertices != nullptr) {
+                setUpVertices(vertices, static_cast<int>(firstRow), static_cast<int>(lastRow));
+            }
+
+            if (textureCoordinates != nullptr) {
+                setUpTextureCoordinates(textureCoordinates, static_cast<int>(firstRow), static_cast<int>(lastRow));
+            }
+
+            if (normals != nullptr) {
+                setUpNormals(normals, static_cast<int>(firstRow), static_cast<int>(lastRow));
+            }
+        });
+
+        calculateBoundingVolumes(planarData.data(), _numVertices);
+        geometryArena.uploadPlanarVertices(_geometry, planarData.data());
     }
-    
-    // Send data to GPU, they're ready now
-    _vbo.uploadDataToGPU(GL_STATIC_DRAW);
-    setVertexAttributesPointers(_numVertices);
 
-    // Vertex data are in, set up the index buffer
+    // Vertex data are in (and their CPU copy is freed), set up the index buffer
     setUpIndexBuffer();
 
-    // Clear the data, we won't need it anymore
-    _vertices.clear();
-    _textureCoordinates.clear();
-    _normals.clear();
-    
     // If get here, we have succeeded with generating heightmap
     _isInitialized = true;
 }
@@ -117,12 +309,9 @@ void Heightmap::render() const
         return;
     }
 
-    glBindVertexArray(_vao);
-    glEnable(GL_PRIMITIVE_RESTART);
-    glPrimitiveRestartIndex(_primitiveRestartIndex);
-
-    glDrawElements(GL_TRIANGLE_STRIP, _numIndices, GL_UNSIGNED_INT, 0);
-    glDisable(GL_PRIMITIVE_RESTART);
+    bindGeometry();
+    enablePrimitiveRestart();
+    drawElements(GL_TRIANGLE_STRIP, _numIndices);
 }
 
 void Heightmap::renderMultilayered(const std::vector<std::string>& textureKeys, const std::vector<float> levels) const
@@ -164,10 +353,10 @@ void Heightmap::renderPoints() const
         return;
     }
 
-    glBindVertexArray(_vao);
+    bindGeometry();
 
     // Render points only
-    glDrawArrays(GL_POINTS, 0, _numVertices);
+    drawArrays(GL_POINTS, 0, _numVertices);
 }
 
 int Heightmap::getRows() const
@@ -186,7 +375,7 @@ float Heightmap::getHeight(const int row, const int column) const
         return 0.0f;
     }
 
-    return _heightData[row][column];
+    return _heightData.at(row, column);
 }
 
 float Heightmap::getRenderedHeightAtPosition(const glm::vec3& renderSize, const glm::vec3& position) const
@@ -200,9 +389,12 @@ float Heightmap::getRenderedHeightAtPosition(const glm::vec3& renderSize, const
     return getHeight(row, column) * renderSize.y;
 }
 
-std::vector<std::vector<float>> Heightmap::generateRandomHeightData(const HillAlgorithmParameters& params)
+Heightmap::HeightData Heightmap::generateRandomHeightData(const HillAlgorithmParameters& params)
 {
-    std::vector<std::vector<float>> heightData(params.rows, std::vector<float>(params.columns, 0.0f));
+    HeightData heightData;
+    heightData.rows = params.rows;
+    heightData.columns = params.columns;
+    heightData.values.assign(static_cast<size_t>(params.rows) * params.columns, 0.0f);
 
     std::random_device rd;
     std::mt19937 generator(rd());
@@ -233,9 +425,10 @@ std::vector<std::vector<float>> Heightmap::generateRandomHeightData(const HillAl
                     continue;
                 }
                 const auto factor = height / r2;
-                heightData[r][c] += hillHeight * factor;
-                if (heightData[r][c] > 1.0f) {
-                    heightData[r][c] = 1.0f;
+                auto& heightValue = heightData.at(r, c);
+                heightValue += hillHeight * factor;
+                if (heightValue > 1.0f) {
+                    heightValue = 1.0f;
                 }
             }
         }
@@ -243,142 +436,124 @@ std::vector<std::vector<float>> Heightmap::generateRandomHeightData(const HillAl
     return heightData;
 }
 
-std::vector<std::vector<float>> Heightmap::getHeightDataFromImage(const std::string& fileName)
+Heightmap::HeightData Heightmap::getHeightDataFromImage(const std::string& fileName)
 {
     stbi_set_flip_vertically_on_load(1);
     int width, height, bytesPerPixel;
     const auto imageData = stbi_load(fileName.c_str(), &width, &height, &bytesPerPixel, 0);
     if (imageData == nullptr)
     {
-        // Return empty vector in case of failure
+        // Return empty height data in case of failure
         std::cout << "Failed to load heightmap image " << fileName << "!" << std::endl;
-        return std::vector<std::vector<float>>();
+        return HeightData();
     }
 
-    std::vector<std::vector<float>> result(height, std::vector<float>(width));
+    HeightData result;
+    result.rows = height;
+    result.columns = width;
+    result.values.resize(static_cast<size_t>(width) * height);
     auto pixelPtr = &imageData[0];
-    for (auto i = 0; i < height; i++)
+    for (auto& value : result.values)
     {
-        for (auto j = 0; j < width; j++)
-        {
-            result[i][j] = static_cast<float>(*pixelPtr) / 255.0f;
-            pixelPtr += bytesPerPixel;
-        }
+        value = static_cast<float>(*pixelPtr) / 255.0f;
+        pixelPtr += bytesPerPixel;
     }
 
     stbi_image_free(imageData);
     return result;
 }
 
-void Heightmap::setUpVertices()
+const Heightmap::HeightData& Heightmap::getHeightData() const
 {
-    _vertices = std::vector<std::vector<glm::vec3>>(_rows, std::vector<glm::vec3>(_columns));
+    return _heightData;
+}
 
-    for (auto i = 0; i < _rows; i++)
+const char* Heightmap::getSIMDInstructionSet()
+{
+#if defined(HEIGHTMAP_AVX)
+    return "AVX";
+#elif defined(HEIGHTMAP_SSE)
+    return "SSE";
+#else
+    return "none";
+#endif
+}
+
+void Heightmap::setUpVertices(glm::vec3* vertices, const int firstRow, const int lastRow) const
+{
+    // X coordinates are the same in every row
+    std::vector<float> vertexX(_columns);
+    for (auto j = 0; j < _columns; j++) {
+        vertexX[j] = -0.5f + static_cast<float>(j) / static_cast<float>(_columns - 1);
+    }
+
+    for (auto i = firstRow; i < lastRow; i++)
     {
-        for (auto j = 0; j < _columns; j++)
-        {
-            const auto factorRow = static_cast<float>(i) / static_cast<float>(_rows - 1);
-            const auto factorColumn = static_cast<float>(j) / static_cast<float>(_columns - 1);
-            const auto& fVertexHeight = _heightData[i][j];
-            _vertices[i][j] = glm::vec3(-0.5f + factorColumn, fVertexHeight, -0.5f + factorRow);
+        const auto vertexZ = -0.5f + static_cast<float>(i) / static_cast<float>(_rows - 1);
+        const auto heights = &_heightData.values[static_cast<size_t>(i) * _columns];
+        auto rowVertices = vertices + static_cast<size_t>(i) * _columns;
+        for (auto j = 0; j < _columns; j++) {
+            rowVertices[j] = glm::vec3(vertexX[j], heights[j], vertexZ);
         }
-        _vbo.addRawData(_vertices[i].data(), _columns*sizeof(glm::vec3));
     }
 }
 
-void Heightmap::setUpTextureCoordinates()
+void Heightmap::setUpTextureCoordinates(glm::vec2* textureCoordinates, const int firstRow, const int lastRow) const
 {
-    _textureCoordinates = std::vector<std::vector<glm::vec2>>(_rows, std::vector<glm::vec2>(_columns));
-
     const auto textureStepU = 0.1f;
     const auto textureStepV = 0.1f;
 
-    for (auto i = 0; i < _rows; i++)
+    for (auto i = firstRow; i < lastRow; i++)
     {
+        auto rowTextureCoordinates = textureCoordinates + static_cast<size_t>(i) * _columns;
         for (auto j = 0; j < _columns; j++) {
-            _textureCoordinates[i][j] = glm::vec2(textureStepU * j, textureStepV * i);
+            rowTextureCoordinates[j] = glm::vec2(textureStepU * j, textureStepV * i);
         }
-        _vbo.addRawData(_textureCoordinates[i].data(), _columns * sizeof(glm::vec2));
     }
 }
 
-void Heightmap::setUpNormals()
+void Heightmap::setUpNormals(glm::vec3* normals, const int firstRow, const int lastRow) const
 {
-    _normals = std::vector<std::vector<glm::vec3>>(_rows, std::vector<glm::vec3>(_columns));
-    std::vector< std::vector<glm::vec3> > tempNormals[2];
-    for (auto i = 0; i < 2; i++) {
-        tempNormals[i] = std::vector<std::vector<glm::vec3>>(_rows-1, std::vector<glm::vec3>(_columns-1));
+    // Only two rows of triangle normals are needed at a time - quads above and below the current row of vertices.
+    // Rows of quads outside of the heightmap stay zero, so vertices at the edges just sum fewer triangles
+    const auto dx = 1.0f / static_cast<float>(_columns - 1);
+    const auto dz = 1.0f / static_cast<float>(_rows - 1);
+    TriangleNormalsRow trianglesAbove(_columns);
+    TriangleNormalsRow trianglesBelow(_columns);
+    const auto heights = _heightData.values.data();
+    if (firstRow > 0) {
+        calculateTriangleNormalsRow(heights + static_cast<size_t>(firstRow - 1) * _columns, heights + static_cast<size_t>(firstRow) * _columns, _columns - 1, dx, dz, trianglesAbove);
     }
 
-    for (auto i = 0; i < _rows - 1; i++)
+    std::vector<float> sumX(_columns), sumY(_columns), sumZ(_columns);
+    for (auto i = firstRow; i < lastRow; i++)
     {
-        for (auto j = 0; j < _columns - 1; j++)
-        {
-            const auto& vertexA = _vertices[i][j];
-            const auto& vertexB = _vertices[i][j+1];
-            const auto& vertexC = _vertices[i+1][j+1];
-            const auto& vertexD = _vertices[i+1][j];
-
-            const auto triangleNormalA = glm::cross(vertexB - vertexA, vertexA - vertexD);
-            const auto triangleNormalB = glm::cross(vertexD - vertexC, vertexC - vertexB);
-
-            tempNormals[0][i][j] = glm::normalize(triangleNormalA);
-            tempNormals[1][i][j] = glm::normalize(triangleNormalB);
+        if (i < _rows - 1) {
+            calculateTriangleNormalsRow(heights + static_cast<size_t>(i) * _columns, heights + static_cast<size_t>(i + 1) * _columns, _columns - 1, dx, dz, trianglesBelow);
+        }
+        else {
+            trianglesBelow.clear();
         }
-    }
-
-    for (auto i = 0; i < _rows; i++)
-    {
-        for (auto j = 0; j < _columns; j++)
-        {
-            // Now we wanna calculate final normal for [i][j] vertex. We will have a look at all triangles this vertex is part of, and then we will make average vector
-            // of all adjacent triangles' normals
-
-            const auto isFirstRow = i == 0;
-            const auto isFirstColumn = j == 0;
-            const auto isLastRow = i == _rows - 1;
-            const auto isLastColumn = j == _columns - 1;
-
-            auto finalVertexNormal = glm::vec3(0.0f, 0.0f, 0.0f);
-
-            // Look for triangle to the upper-left
-            if (!isFirstRow && !isFirstColumn) {
-                finalVertexNormal += tempNormals[0][i-1][j-1];
-            }
-
-            // Look for triangles to the upper-right
-            if (!isFirstRow && !isLastColumn) {
-                for (auto k = 0; k < 2; k++) {
-                    finalVertexNormal += tempNormals[k][i - 1][j];
-                }
-            }
 
-            // Look for triangle to the bottom-right
-            if (!isLastRow && !isLastColumn) {
-                finalVertexNormal += tempNormals[0][i][j];
-            }
+        sumAdjacentTriangleNormals(trianglesAbove.x, trianglesBelow.x, _columns, sumX.data());
+        sumAdjacentTriangleNormals(trianglesAbove.y, trianglesBelow.y, _columns, sumY.data());
+        sumAdjacentTriangleNormals(trianglesAbove.z, trianglesBelow.z, _columns, sumZ.data());
 
-            // Look for triangles to the bottom-right
-            if (!isLastRow && !isFirstColumn) {
-                for (auto k = 0; k < 2; k++) {
-                    finalVertexNormal += tempNormals[k][i][j-1];
-                }
-            }
-
-            // Store final normal of j-th vertex in i-th row
-            _normals[i][j] = glm::normalize(finalVertexNormal);
+        auto rowNormals = normals + static_cast<size_t>(i) * _columns;
+        for (auto j = 0; j < _columns; j++) {
+            rowNormals[j] = glm::normalize(glm::vec3(sumX[j], sumY[j], sumZ[j]));
         }
-        _vbo.addRawData(_normals[i].data(), _columns * sizeof(glm::vec3));
+
+        std::swap(trianglesAbove, trianglesBelow);
     }
 }
 
 void Heightmap::setUpIndexBuffer()
 {
-    // Create a VBO with heightmap indices
-    _indicesVBO.createVBO();
-    _indicesVBO.bindVBO(GL_ELEMENT_ARRAY_BUFFER);
+    // Indices are local to heightmap, primitive restart index is compared before base vertex is added
     _primitiveRestartIndex = _numVertices;
+    std::vector<GLuint> indices;
+    indices.reserve(_numIndices);
 
     for (auto i = 0; i < _rows - 1; i++)
     {
@@ -387,19 +562,15 @@ void Heightmap::setUpIndexBuffer()
             for (auto k = 0; k < 2; k++)
             {
                 const auto row = i + k;
-                const auto index = row * _columns + j;
-                _indicesVBO.addRawData(&index, sizeof(int));
+                indices.push_back(row * _columns + j);
             }
         }
         // Restart triangle strips
-        _indicesVBO.addRawData(&_primitiveRestartIndex, sizeof(int));
+        indices.push_back(_primitiveRestartIndex);
     }
 
-    // Send indices to GPU
-    _indicesVBO.uploadDataToGPU(GL_STATIC_DRAW);
-
-    // Calculate total count of indices
-    _numIndices = (_rows - 1)*_columns * 2 + _rows - 1;
+    // Send indices to the geometry arena
+    GeometryArena::getInstance().uploadIndices(_geometry, indices.data());
 }
 
 } // namespace static_meshes_3D
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 // STL
 #include <string>
+#include <vector>
 
 // GLAD
 #include <glad/glad.h>
@@ -57,18 +58,40 @@ public:
         float hillMaxHeight; // Maximal height of generated hill
     };
 
-    Heightmap(const HillAlgorithmParameters& params, bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true);
-    Heightmap(const std::string& fileName, bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true);
+    /**
+     * Height values of the whole heightmap stored in one flat array, row after row.
+     */
+    struct HeightData
+    {
+        int rows = 0; // Number of rows
+        int columns = 0; // Number of columns
+        std::vector<float> values; // All height values (rows * columns), each should be between 0.0 (lowest point) and 1.0 (highest point)
+
+        /**
+         * Checks, if there are no height values at all.
+         */
+        bool empty() const { return values.empty(); }
+
+        /**
+         * Gets height value at given row and column (no bounds checking).
+         */
+        float& at(const int row, const int column) { return values[static_cast<size_t>(row) * columns + column]; }
+        float at(const int row, const int column) const { return values[static_cast<size_t>(row) * columns + column]; }
+    };
+
+    Heightmap(const HillAlgorithmParameters& params, bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true, int vertexEncodingFlags = 0);
+    Heightmap(const std::string& fileName, bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true, int vertexEncodingFlags = 0);
 
     static void prepareMultiLayerShaderProgram();
     static ShaderProgram& getMultiLayerShaderProgram();
 
     /**
-     * Generates heightmap from the provided height data.
+     * Generates heightmap from the provided height data. Vertex data are calculated in bands of rows on the job system
+     * and written right into the block, that is uploaded to the GPU, so only the height data are kept afterwards.
      *
-     * @param heightData  2D float vector containing height data - each value should be between 0.0 (lowest point) and 1.0 (highest point)
+     * @param heightData  Height data to generate heightmap from (taken over by the heightmap, so pass it with std::move if possible)
      */
-    void createFromHeightData(const std::vector<std::vector<float>>& heightData);
+    void createFromHeightData(HeightData heightData);
 
     /** \brief Renders heightmap. */
     void render() const override;
@@ -121,44 +144,58 @@ public:
      *
      * @param params  Parameters for hill algorithm generator
      * 
-     * @return Generated height data in a 2D float vector with random values from 0.0 to 1.0.
+     * @return Generated height data with random values from 0.0 to 1.0.
      */
-    static std::vector<std::vector<float>> generateRandomHeightData(const HillAlgorithmParameters& params);
+    static HeightData generateRandomHeightData(const HillAlgorithmParameters& params);
 
     /**
      * Gets height data from image - converts grayscale data to height data.
      *
      * @param fileName  Filename to load heightmap from
      *
-     * @return Height data as a 2D float vector with values from 0.0 to 1.0.
+     * @return Height data with values from 0.0 to 1.0 (empty, if the image couldn't be loaded).
+     */
+    static HeightData getHeightDataFromImage(const std::string& fileName);
+
+    /**
+     * Gets height data the heightmap has been created from.
+     */
+    const HeightData& getHeightData() const;
+
+    /**
+     * Gets name of SIMD instruction set used to calculate normals ("AVX", "SSE" or "none").
      */
-    static std::vector<std::vector<float>> getHeightDataFromImage(const std::string& fileName);
+    static const char* getSIMDInstructionSet();
 
 private:
     /**
-     * Sets up heightmap vertices.
+     * Sets up vertices of rows [firstRow, lastRow).
+     *
+     * @param vertices  Positions of all vertices (in the planar block uploaded to the GPU)
      */
-    void setUpVertices();
+    void setUpVertices(glm::vec3* vertices, int firstRow, int lastRow) const;
 
     /**
-     * Sets up heightmap texture coordinates.
+     * Sets up texture coordinates of rows [firstRow, lastRow).
+     *
+     * @param textureCoordinates  Texture coordinates of all vertices (in the planar block uploaded to the GPU)
      */
-    void setUpTextureCoordinates();
+    void setUpTextureCoordinates(glm::vec2* textureCoordinates, int firstRow, int lastRow) const;
 
     /**
-     * Sets up heightmap normals.
+     * Sets up normals of rows [firstRow, lastRow). Every vertex normal is an average of normals of its adjacent triangles,
+     * triangle normals are calculated for one row of quads at a time (also the row above the first one).
+     *
+     * @param normals  Normals of all vertices (in the planar block uploaded to the GPU)
      */
-    void setUpNormals();
+    void setUpNormals(glm::vec3* normals, int firstRow, int lastRow) const;
 
     /**
      * Sets up index buffer.
      */
     void setUpIndexBuffer();
 
-    std::vector<std::vector<float>> _heightData; // Height data representing the current heightmap
-    std::vector<std::vector<glm::vec3>> _vertices; // Vertices data heightmap is generated with (only valid during creation phase)
-    std::vector<std::vector<glm::vec2>> _textureCoordinates; // Texture coordinates data heightmap is generated with (only valid during creation phase)
-    std::vector<std::vector<glm::vec3>> _normals; // Normals data heightmap is generated with (only valid during creation phase)
+    HeightData _heightData; // Height data representing the current heightmap
     int _rows = 0; // Number of heightmap rows
     int _columns = 0; // Number of heightmap columns
 };
@@ -13,21 +13,14 @@ namespace static_meshes_3D {
 
 const std::string HeightmapWithFog::MULTILAYER_SHADER_PROGRAM_WITH_FOG_KEY = "multilayer_heightmap_fog";
 
-HeightmapWithFog::HeightmapWithFog(const HillAlgorithmParameters& params, bool withPositions, bool withTextureCoordinates, bool withNormals)
-    : Heightmap(params, withPositions, withTextureCoordinates, withNormals)
+HeightmapWithFog::HeightmapWithFog(const HillAlgorithmParameters& params, bool withPositions, bool withTextureCoordinates, bool withNormals, int vertexEncodingFlags)
+    : Heightmap(params, withPositions, withTextureCoordinates, withNormals, vertexEncodingFlags)
 {
-    createFromHeightData(generateRandomHeightData(params));
 }
 
-HeightmapWithFog::HeightmapWithFog(const std::string& fileName, bool withPositions, bool withTextureCoordinates, bool withNormals)
-    : Heightmap(fileName, withPositions, withTextureCoordinates, withNormals)
+HeightmapWithFog::HeightmapWithFog(const std::string& fileName, bool withPositions, bool withTextureCoordinates, bool withNormals, int vertexEncodingFlags)
+    : Heightmap(fileName, withPositions, withTextureCoordinates, withNormals, vertexEncodingFlags)
 {
-    const auto heightData = getHeightDataFromImage(fileName);
-    if (heightData.size() == 0) {
-        return;
-    }
-
-    createFromHeightData(heightData);
 }
 
 void HeightmapWithFog::prepareMultiLayerShaderProgramWithFog()
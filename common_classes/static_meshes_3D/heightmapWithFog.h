@@ -13,8 +13,8 @@ class HeightmapWithFog : public Heightmap
 public:
     static const std::string MULTILAYER_SHADER_PROGRAM_WITH_FOG_KEY; // Holds a key for multilayer heightmap shader program with a fog (used as shaders key too)
 
-    HeightmapWithFog(const HillAlgorithmParameters& params, bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true);
-    HeightmapWithFog(const std::string& fileName, bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true);
+    HeightmapWithFog(const HillAlgorithmParameters& params, bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true, int vertexEncodingFlags = 0);
+    HeightmapWithFog(const std::string& fileName, bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true, int vertexEncodingFlags = 0);
 
     static void prepareMultiLayerShaderProgramWithFog();
     static ShaderProgram& getMultiLayerShaderProgramWithFog();
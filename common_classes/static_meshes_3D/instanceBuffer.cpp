@@ -0,0 +1,131 @@
+// STL
+#include <iostream>
+#include <cstddef>
+
+// Project
+#include "instanceBuffer.h"
+#include "../gpuResourceRegistry.h"
+#include "../glStateCache.h"
+
+namespace static_meshes_3D {
+
+const GLuint InstanceBuffer::MODEL_MATRIX_ATTRIBUTE_INDEX = 3;
+const GLuint InstanceBuffer::NORMAL_MATRIX_ATTRIBUTE_INDEX = 7;
+const GLuint InstanceBuffer::COLOR_ATTRIBUTE_INDEX = 10;
+const GLuint InstanceBuffer::VERTEX_BUFFER_BINDING_INDEX = 15;
+
+InstanceBuffer::~InstanceBuffer()
+{
+    deleteBuffer();
+}
+
+void InstanceBuffer::clear()
+{
+    instances_.clear();
+}
+
+void InstanceBuffer::addInstance(const glm::mat4& modelMatrix, const glm::vec4& color)
+{
+    const auto normalMatrix = glm::transpose(glm::inverse(glm::mat3(modelMatrix)));
+
+    InstanceData instance;
+    instance.modelMatrix = modelMatrix;
+    for (auto i = 0; i < 3; i++) {
+        instance.normalMatrixColumns[i] = glm::vec4(normalMatrix[i], 0.0f);
+    }
+    instance.color = color;
+    instances_.push_back(instance);
+}
+
+void InstanceBuffer::upload()
+{
+    auto& stateCache = GLStateCache::getInstance();
+    if (bufferID_ == 0)
+    {
+        GPUResourceRegistry::ScopedTag registryTag("instance_buffer");
+        glGenBuffers(1, &bufferID_);
+        GPUResourceRegistry::getInstance().registerResource(GPUResourceType::VertexBuffer, bufferID_);
+        std::cout << "Created instance buffer with ID " << bufferID_ << std::endl;
+    }
+
+    stateCache.bindBuffer(GL_ARRAY_BUFFER, bufferID_);
+    const auto dataSize = instances_.size() * sizeof(InstanceData);
+    if (instances_.size() > bufferCapacity_)
+    {
+        // Grow with some reserve, so that slowly growing number of instances doesn't reallocate every frame
+        bufferCapacity_ = instances_.size() + instances_.size() / 2;
+        glBufferData(GL_ARRAY_BUFFER, bufferCapacity_ * sizeof(InstanceData), nullptr, GL_DYNAMIC_DRAW);
+        GPUResourceRegistry::getInstance().updateResourceSize(GPUResourceType::VertexBuffer, bufferID_, bufferCapacity_ * sizeof(InstanceData));
+    }
+    else
+    {
+        // Orphan the old storage, so that we don't have to wait for draws still reading from it
+        glBufferData(GL_ARRAY_BUFFER, bufferCapacity_ * sizeof(InstanceData), nullptr, GL_DYNAMIC_DRAW);
+    }
+
+    if (dataSize > 0) {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, dataSize, instances_.data());
+    }
+
+    numUploadedInstances_ = static_cast<GLsizei>(instances_.size());
+}
+
+size_t InstanceBuffer::getNumGatheredInstances() const
+{
+    return instances_.size();
+}
+
+GLsizei InstanceBuffer::getNumInstances() const
+{
+    return numUploadedInstances_;
+}
+
+GLuint InstanceBuffer::getBufferID() const
+{
+    return bufferID_;
+}
+
+void InstanceBuffer::deleteBuffer()
+{
+    instances_.clear();
+    numUploadedInstances_ = 0;
+    if (bufferID_ == 0) {
+        return;
+    }
+
+    std::cout << "Deleting instance buffer with ID " << bufferID_ << std::endl;
+    GLStateCache::getInstance().onBufferDeleted(bufferID_);
+    GPUResourceRegistry::getInstance().unregisterResource(GPUResourceType::VertexBuffer, bufferID_);
+    glDeleteBuffers(1, &bufferID_);
+    bufferID_ = 0;
+    bufferCapacity_ = 0;
+}
+
+void InstanceBuffer::setupInstanceAttributes()
+{
+    // Matrices are passed column by column, every column is a separate attribute
+    for (GLuint i = 0; i < 4; i++)
+    {
+        const auto attributeIndex = MODEL_MATRIX_ATTRIBUTE_INDEX + i;
+        glEnableVertexAttribArray(attributeIndex);
+        glVertexAttribFormat(attributeIndex, 4, GL_FLOAT, GL_FALSE, static_cast<GLuint>(offsetof(InstanceData, modelMatrix) + i * sizeof(glm::vec4)));
+        glVertexAttribBinding(attributeIndex, VERTEX_BUFFER_BINDING_INDEX);
+    }
+
+    for (GLuint i = 0; i < 3; i++)
+    {
+        const auto attributeIndex = NORMAL_MATRIX_ATTRIBUTE_INDEX + i;
+        glEnableVertexAttribArray(attributeIndex);
+        glVertexAttribFormat(attributeIndex, 3, GL_FLOAT, GL_FALSE, static_cast<GLuint>(offsetof(InstanceData, normalMatrixColumns) + i * sizeof(glm::vec4)));
+        glVertexAttribBinding(attributeIndex, VERTEX_BUFFER_BINDING_INDEX);
+    }
+
+    glEnableVertexAttribArray(COLOR_ATTRIBUTE_INDEX);
+    glVertexAttribFormat(COLOR_ATTRIBUTE_INDEX, 4, GL_FLOAT, GL_FALSE, static_cast<GLuint>(offsetof(InstanceData, color)));
+    glVertexAttribBinding(COLOR_ATTRIBUTE_INDEX, VERTEX_BUFFER_BINDING_INDEX);
+
+    // Advance the data once per instance, not per vertex
+    glVertexBindingDivisor(VERTEX_BUFFER_BINDING_INDEX, 1);
+}
+
+} // namespace static_meshes_3D
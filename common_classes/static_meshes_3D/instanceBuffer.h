@@ -0,0 +1,93 @@
+#pragma once
+
+// STL
+#include <vector>
+
+// GLAD
+#include <glad/glad.h>
+
+// GLM
+#include <glm/glm.hpp>
+
+namespace static_meshes_3D {
+
+/**
+ * Buffer of per-instance data (model matrix, normal matrix and color) for instanced rendering of static meshes
+ * (see StaticMesh3D::renderInstanced). Instances are gathered on CPU and uploaded at once, normal matrices
+ * are calculated only when instance is added, not every time it's rendered.
+ */
+class InstanceBuffer
+{
+public:
+    static const GLuint MODEL_MATRIX_ATTRIBUTE_INDEX; // First vertex attribute index of instance model matrix (3, occupies 4 indices)
+    static const GLuint NORMAL_MATRIX_ATTRIBUTE_INDEX; // First vertex attribute index of instance normal matrix (7, occupies 3 indices)
+    static const GLuint COLOR_ATTRIBUTE_INDEX; // Vertex attribute index of instance color (10)
+    static const GLuint VERTEX_BUFFER_BINDING_INDEX; // Vertex buffer binding index, that instance data are read from
+
+    /**
+     * Data of one instance, as they are stored in the buffer.
+     */
+    struct InstanceData
+    {
+        glm::mat4 modelMatrix; // Model matrix of the instance
+        glm::vec4 normalMatrixColumns[3]; // Columns of normal matrix of the instance (padded to vec4)
+        glm::vec4 color; // Color of the instance (multiplies the color of the object)
+    };
+
+    InstanceBuffer() = default;
+    InstanceBuffer(const InstanceBuffer&) = delete; // No copy constructor allowed
+    void operator=(const InstanceBuffer&) = delete; // No copy assignment allowed
+    ~InstanceBuffer();
+
+    /**
+     * Removes all gathered instances (uploaded data stay untouched until next upload).
+     */
+    void clear();
+
+    /**
+     * Adds an instance. Normal matrix is calculated out of the model matrix.
+     *
+     * @param modelMatrix  Model matrix of the instance
+     * @param color        Color of the instance (default is white, that doesn't change anything)
+     */
+    void addInstance(const glm::mat4& modelMatrix, const glm::vec4& color = glm::vec4(1.0f));
+
+    /**
+     * Uploads all gathered instances to the GPU. Buffer is created on first upload and grows as needed.
+     */
+    void upload();
+
+    /**
+     * Gets number of gathered instances.
+     */
+    size_t getNumGatheredInstances() const;
+
+    /**
+     * Gets number of instances uploaded to the GPU (these are rendered).
+     */
+    GLsizei getNumInstances() const;
+
+    /**
+     * Gets OpenGL-assigned buffer ID (0, if nothing has been uploaded yet).
+     */
+    GLuint getBufferID() const;
+
+    /**
+     * Deletes the buffer from the GPU and removes all instances.
+     */
+    void deleteBuffer();
+
+    /**
+     * Sets up per-instance vertex attributes in the currently bound VAO. Attributes are read from
+     * VERTEX_BUFFER_BINDING_INDEX, so binding another instance buffer doesn't need to set them up again.
+     */
+    static void setupInstanceAttributes();
+
+private:
+    std::vector<InstanceData> instances_; // Gathered instances
+    GLuint bufferID_{ 0 }; // OpenGL-assigned buffer ID
+    size_t bufferCapacity_{ 0 }; // How many instances fit into the buffer
+    GLsizei numUploadedInstances_{ 0 }; // Number of instances uploaded to the buffer
+};
+
+} // namespace static_meshes_3D
@@ -36,8 +36,8 @@ void PlainGround::render() const
         return;
     }
 
-    glBindVertexArray(_vao);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    bindGeometry();
+    drawArrays(GL_TRIANGLE_STRIP, 0, 4);
 }
 
 void PlainGround::initializeData()
@@ -46,13 +46,7 @@ void PlainGround::initializeData()
         return;
     }
 
-    glGenVertexArrays(1, &_vao);
-    glBindVertexArray(_vao);
-
     const auto numVertices = 4;
-    const auto vertexByteSize = getVertexByteSize();
-    _vbo.createVBO(vertexByteSize * numVertices);
-    _vbo.bindVBO();
 
     if (hasPositions()) {
         _vbo.addRawData(vertices, sizeof(glm::vec3)*numVertices);
@@ -67,8 +61,7 @@ void PlainGround::initializeData()
         _vbo.addRawData(&normal, sizeof(glm::vec3), numVertices);
     }
 
-    _vbo.uploadDataToGPU(GL_STATIC_DRAW);
-    setVertexAttributesPointers(numVertices);
+    moveDataToGeometryArena(numVertices);
     _isInitialized = true;
 }
 
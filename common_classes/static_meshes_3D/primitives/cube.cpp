@@ -50,8 +50,8 @@ void Cube::render() const
         return;
     }
 
-    glBindVertexArray(_vao);
-    glDrawArrays(GL_TRIANGLES, 0, 36);
+    bindGeometry();
+    drawArrays(GL_TRIANGLES, 0, 36);
 }
 
 void Cube::renderPoints() const
@@ -60,8 +60,8 @@ void Cube::renderPoints() const
         return;
     }
 
-    glBindVertexArray(_vao);
-    glDrawArrays(GL_POINTS, 0, 36);
+    bindGeometry();
+    drawArrays(GL_POINTS, 0, 36);
 }
 
 void Cube::renderFaces(int facesBitmask) const
@@ -70,42 +70,49 @@ void Cube::renderFaces(int facesBitmask) const
         return;
     }
 
-    glBindVertexArray(_vao);
+    bindGeometry();
 
     if (facesBitmask & CUBE_FRONT_FACE) {
-        glDrawArrays(GL_TRIANGLES, 0, 6);
+        drawArrays(GL_TRIANGLES, 0, 6);
     }
     if (facesBitmask & CUBE_BACK_FACE) {
-        glDrawArrays(GL_TRIANGLES, 6, 6);
+        drawArrays(GL_TRIANGLES, 6, 6);
     }
     if (facesBitmask & CUBE_LEFT_FACE) {
-        glDrawArrays(GL_TRIANGLES, 12, 6);
+        drawArrays(GL_TRIANGLES, 12, 6);
     }
     if (facesBitmask & CUBE_RIGHT_FACE) {
-        glDrawArrays(GL_TRIANGLES, 18, 6);
+        drawArrays(GL_TRIANGLES, 18, 6);
     }
     if (facesBitmask & CUBE_TOP_FACE) {
-        glDrawArrays(GL_TRIANGLES, 24, 6);
+        drawArrays(GL_TRIANGLES, 24, 6);
     }
     if (facesBitmask & CUBE_BOTTOM_FACE) {  
-        glDrawArrays(GL_TRIANGLES, 30, 6);
+        drawArrays(GL_TRIANGLES, 30, 6);
     }
 }
 
+void Cube::renderFacesInstanced(const InstanceBuffer& instanceBuffer, const GLuint firstInstance, const GLsizei numInstances, const int facesBitmask) const
+{
+    if (numInstances <= 0) {
+        return;
+    }
+
+    // Same as StaticMesh3D::renderInstanced, just with selected faces only
+    _renderedInstanceBuffer = &instanceBuffer;
+    _renderedFirstInstance = firstInstance;
+    _renderedNumInstances = numInstances;
+    renderFaces(facesBitmask);
+    _renderedInstanceBuffer = nullptr;
+}
+
 void Cube::initializeData()
 {
     if (_isInitialized) {
         return;
     }
 
-    glGenVertexArrays(1, &_vao);
-    glBindVertexArray(_vao);
-
     const auto numVertices = 36;
-    const auto vertexByteSize = getVertexByteSize();
-    _vbo.createVBO(vertexByteSize * numVertices);
-    _vbo.bindVBO();
-    
     if (hasPositions())
     {
         _vbo.addRawData(vertices, sizeof(glm::vec3)*numVertices);
@@ -127,8 +134,7 @@ void Cube::initializeData()
         }
     }
 
-    _vbo.uploadDataToGPU(GL_STATIC_DRAW);
-    setVertexAttributesPointers(numVertices);
+    moveDataToGeometryArena(numVertices);
     _isInitialized = true;
 }
 
@@ -28,6 +28,17 @@ public:
     void renderPoints() const override;
     void renderFaces(int facesBitmask) const;
 
+    /**
+     * Renders only selected faces of a range of instances uploaded to the instance buffer
+     * (see StaticMesh3D::renderInstanced for requirements on the shader program).
+     *
+     * @param instanceBuffer  Buffer with per-instance data
+     * @param firstInstance   Index of the first rendered instance
+     * @param numInstances    Number of rendered instances
+     * @param facesBitmask    Bitmask of the faces to render
+     */
+    void renderFacesInstanced(const InstanceBuffer& instanceBuffer, GLuint firstInstance, GLsizei numInstances, int facesBitmask) const;
+
     static glm::vec3 vertices[36]; // Array of mesh vertices
     static glm::vec2 textureCoordinates[6]; // Array of mesh texture coordinates
     static glm::vec3 normals[6]; // Array of mesh normals
@@ -45,11 +45,6 @@ void Cylinder::initializeData()
     _numVerticesTopBottom = _numSlices + 2;
     _numVerticesTotal = _numVerticesSide + _numVerticesTopBottom * 2;
 
-    // Generate VAO and VBO for vertex attributes
-    glGenVertexArrays(1, &_vao);
-    glBindVertexArray(_vao);
-    _vbo.createVBO(getVertexByteSize() * _numVerticesTotal);
-
     // Pre-calculate sines / cosines for given number of slices
     const auto sliceAngleStep = 2.0f * glm::pi<float>() / static_cast<float>(_numSlices);
     auto currentSliceAngle = 0.0f;
@@ -145,10 +140,8 @@ void Cylinder::initializeData()
         _vbo.addData(glm::vec3(0.0f, -1.0f, 0.0f), _numVerticesTopBottom);
     }
 
-    // Finally upload data to the GPU
-    _vbo.bindVBO();
-    _vbo.uploadDataToGPU(GL_STATIC_DRAW);
-    setVertexAttributesPointers(_numVerticesTotal);
+    // Finally move data to the geometry arena
+    moveDataToGeometryArena(_numVerticesTotal);
 
     _isInitialized = true;
 }
@@ -159,16 +152,16 @@ void Cylinder::render() const
         return;
     }
 
-    glBindVertexArray(_vao);
+    bindGeometry();
 
     // Render cylinder side first
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, _numVerticesSide);
+    drawArrays(GL_TRIANGLE_STRIP, 0, _numVerticesSide);
 
     // Render top cover
-    glDrawArrays(GL_TRIANGLE_FAN, _numVerticesSide, _numVerticesTopBottom);
+    drawArrays(GL_TRIANGLE_FAN, _numVerticesSide, _numVerticesTopBottom);
 
     // Render bottom cover
-    glDrawArrays(GL_TRIANGLE_FAN, _numVerticesSide + _numVerticesTopBottom, _numVerticesTopBottom);
+    drawArrays(GL_TRIANGLE_FAN, _numVerticesSide + _numVerticesTopBottom, _numVerticesTopBottom);
 }
 
 void Cylinder::renderPoints() const
@@ -178,8 +171,8 @@ void Cylinder::renderPoints() const
     }
 
     // Just render all points as they are stored in the VBO
-    glBindVertexArray(_vao);
-    glDrawArrays(GL_POINTS, 0, _numVerticesTotal);
+    bindGeometry();
+    drawArrays(GL_POINTS, 0, _numVerticesTotal);
 }
 
 } // namespace static_meshes_3D
\ No newline at end of file
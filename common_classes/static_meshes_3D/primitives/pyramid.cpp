@@ -35,8 +35,8 @@ void Pyramid::render() const
 		return;
 	}
 
-	glBindVertexArray(_vao);
-	glDrawArrays(GL_TRIANGLES, 0, 12);
+	bindGeometry();
+	drawArrays(GL_TRIANGLES, 0, 12);
 }
 
 void Pyramid::renderPoints() const
@@ -45,8 +45,8 @@ void Pyramid::renderPoints() const
 		return;
 	}
 
-	glBindVertexArray(_vao);
-	glDrawArrays(GL_POINTS, 0, 12);
+	bindGeometry();
+	drawArrays(GL_POINTS, 0, 12);
 }
 
 void Pyramid::initializeData()
@@ -55,14 +55,7 @@ void Pyramid::initializeData()
 		return;
 	}
 
-	glGenVertexArrays(1, &_vao);
-	glBindVertexArray(_vao);
-
 	const auto numVertices = 12;
-    const auto vertexByteSize = getVertexByteSize();	
-	_vbo.createVBO(vertexByteSize * numVertices);
-	_vbo.bindVBO();
-	
 	if (hasPositions())
 	{
 		_vbo.addRawData(vertices, sizeof(glm::vec3)*numVertices);
@@ -90,8 +83,7 @@ void Pyramid::initializeData()
 		}
 	}
 
-	_vbo.uploadDataToGPU(GL_STATIC_DRAW);
-	setVertexAttributesPointers(numVertices);
+	moveDataToGeometryArena(numVertices);
 
 	_isInitialized = true;
 }
@@ -11,8 +11,8 @@
 
 namespace static_meshes_3D {
 
-Sphere::Sphere(float radius, int numSlices, int numStacks, bool withPositions, bool withTextureCoordinates, bool withNormals)
-    : StaticMeshIndexed3D(withPositions, withTextureCoordinates, withNormals)
+Sphere::Sphere(float radius, int numSlices, int numStacks, bool withPositions, bool withTextureCoordinates, bool withNormals, int vertexEncodingFlags)
+    : StaticMeshIndexed3D(withPositions, withTextureCoordinates, withNormals, vertexEncodingFlags)
     , _radius(radius)
     , _numSlices(numSlices)
     , _numStacks(numStacks)
@@ -31,22 +31,17 @@ void Sphere::render() const
         return;
     }
 
-    glBindVertexArray(_vao);
+    bindGeometry();
+    enablePrimitiveRestart();
 
-    glEnable(GL_PRIMITIVE_RESTART);
-    glPrimitiveRestartIndex(_primitiveRestartIndex);
-    
     // Render north pole
-    glDrawElements(GL_TRIANGLES, _numPoleIndices, GL_UNSIGNED_INT, (void*)(sizeof(GLuint)*_northPoleIndexOffset));
+    drawElements(GL_TRIANGLES, _numPoleIndices, _northPoleIndexOffset);
     
     // Render body
-    glDrawElements(GL_TRIANGLE_STRIP, _numBodyIndices, GL_UNSIGNED_INT, (void*)(sizeof(GLuint)*_bodyIndexOffset));
+    drawElements(GL_TRIANGLE_STRIP, _numBodyIndices, _bodyIndexOffset);
 
     // Render south pole 
-    glDrawElements(GL_TRIANGLES, _numPoleIndices, GL_UNSIGNED_INT, (void*)(sizeof(GLuint)*_southPoleIndexOffset));
-
-    // Disable primitive restart, we won't need it now
-    glDisable(GL_PRIMITIVE_RESTART);
+    drawElements(GL_TRIANGLES, _numPoleIndices, _southPoleIndexOffset);
 }
 
 void Sphere::renderPoints() const
@@ -55,8 +50,8 @@ void Sphere::renderPoints() const
         return;
     }
 
-    glBindVertexArray(_vao);
-    glDrawArrays(GL_POINTS, 0, _numVertices);
+    bindGeometry();
+    drawArrays(GL_POINTS, 0, _numVertices);
 }
 
 float Sphere::getRadius() const
@@ -101,11 +96,6 @@ void Sphere::initializeData()
     _primitiveRestartIndex = _numVertices;
 
     // Generate VAO and VBOs for vertex attributes and indices
-    glGenVertexArrays(1, &_vao);
-    glBindVertexArray(_vao);
-    _vbo.createVBO(getVertexByteSize() * _numVertices);
-    _indicesVBO.createVBO(sizeof(GLuint) * _numIndices);
-
     // Pre-calculate sines / cosines for given number of slices
     const auto sliceAngleStep = 2.0f * glm::pi<float>() / static_cast<float>(_numSlices);
     auto currentSliceAngle = 0.0f;
@@ -235,12 +225,7 @@ void Sphere::initializeData()
         _indicesVBO.addData(static_cast<GLuint>(nextSliceIndex));
     }
     
-    _vbo.bindVBO();
-    _vbo.uploadDataToGPU(GL_STATIC_DRAW);
-    setVertexAttributesPointers(_numVertices);
-
-    _indicesVBO.bindVBO(GL_ELEMENT_ARRAY_BUFFER);
-    _indicesVBO.uploadDataToGPU(GL_STATIC_DRAW);
+    moveDataToGeometryArena(_numVertices);
 
     _isInitialized = true;
 }
@@ -14,7 +14,7 @@ namespace static_meshes_3D {
 class Sphere : public StaticMeshIndexed3D
 {
 public:
-    Sphere(float radius, int numSlices, int numStacks, bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true);
+    Sphere(float radius, int numSlices, int numStacks, bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true, int vertexEncodingFlags = 0);
 
     void render() const override;
     void renderPoints() const override;
@@ -6,8 +6,8 @@
 
 namespace static_meshes_3D {
 
-Torus::Torus(int stacks, int slices, float radius, float tubeRadius, bool withPositions, bool withTextureCoordinates, bool withNormals)
-    : StaticMeshIndexed3D(withPositions, withTextureCoordinates, withNormals)
+Torus::Torus(int stacks, int slices, float radius, float tubeRadius, bool withPositions, bool withTextureCoordinates, bool withNormals, int vertexEncodingFlags)
+    : StaticMeshIndexed3D(withPositions, withTextureCoordinates, withNormals, vertexEncodingFlags)
     , _mainSegments(stacks)
     , _tubeSegments(slices)
     , _mainRadius(radius)
@@ -28,11 +28,6 @@ void Torus::initializeData()
     _numIndices = (_mainSegments * 2 * (_tubeSegments + 1)) + _mainSegments - 1;
 
     // Generate VAO and VBOs for vertex attributes and indices
-    glGenVertexArrays(1, &_vao);
-    glBindVertexArray(_vao);
-    _vbo.createVBO(getVertexByteSize() * _numVertices);
-    _indicesVBO.createVBO(sizeof(GLuint)*_numIndices);
-
     // Precalculate steps in radians for main segment and tube segment
     const auto mainSegmentAngleStep = glm::radians(360.0f / static_cast<float>(_mainSegments));
     const auto tubeSegmentAngleStep = glm::radians(360.0f / static_cast<float>(_tubeSegments));
@@ -144,12 +139,7 @@ void Torus::initializeData()
         }
     }
 
-    _vbo.bindVBO();
-    _vbo.uploadDataToGPU(GL_STATIC_DRAW);
-    setVertexAttributesPointers(_numVertices);
-
-    _indicesVBO.bindVBO(GL_ELEMENT_ARRAY_BUFFER);
-    _indicesVBO.uploadDataToGPU(GL_STATIC_DRAW);
+    moveDataToGeometryArena(_numVertices);
 
     _isInitialized = true;
 }
@@ -160,16 +150,12 @@ void Torus::render() const
         return;
     }
 
-    glBindVertexArray(_vao);
+    bindGeometry();
     // Enable primitive restart, because we're rendering several triangle strips (for each main segment)
-    glEnable(GL_PRIMITIVE_RESTART);
-    glPrimitiveRestartIndex(_primitiveRestartIndex);
+    enablePrimitiveRestart();
 
     // Render torus using precalculated indices
-    glDrawElements(GL_TRIANGLE_STRIP, _numIndices, GL_UNSIGNED_INT, 0);
-
-    // Disable primitive restart, we won't need it now
-    glDisable(GL_PRIMITIVE_RESTART);
+    drawElements(GL_TRIANGLE_STRIP, _numIndices);
 }
 
 void Torus::renderPoints() const
@@ -178,10 +164,10 @@ void Torus::renderPoints() const
         return;
     }
 
-    glBindVertexArray(_vao);
+    bindGeometry();
 
     // Render torus points only
-    glDrawArrays(GL_POINTS, 0, _numVertices);
+    drawArrays(GL_POINTS, 0, _numVertices);
 }
 
 float Torus::getMainRadius() const
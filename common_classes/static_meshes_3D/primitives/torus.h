@@ -12,7 +12,7 @@ class Torus : public StaticMeshIndexed3D
 {
 public:
     Torus(int mainSegments, int tubeSegments, float mainRadius, float tubeRadius,
-        bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true);
+        bool withPositions = true, bool withTextureCoordinates = true, bool withNormals = true, int vertexEncodingFlags = 0);
 
     void render() const override;
     void renderPoints() const override;
@@ -10,10 +10,11 @@ const int StaticMesh3D::POSITION_ATTRIBUTE_INDEX           = 0;
 const int StaticMesh3D::TEXTURE_COORDINATE_ATTRIBUTE_INDEX = 1;
 const int StaticMesh3D::NORMAL_ATTRIBUTE_INDEX             = 2;
 
-StaticMesh3D::StaticMesh3D(bool withPositions, bool withTextureCoordinates, bool withNormals)
+StaticMesh3D::StaticMesh3D(bool withPositions, bool withTextureCoordinates, bool withNormals, int vertexEncodingFlags)
     : _hasPositions(withPositions)
     , _hasTextureCoordinates(withTextureCoordinates)
-    , _hasNormals(withNormals) {}
+    , _hasNormals(withNormals)
+    , _vertexEncodingFlags(vertexEncodingFlags) {}
 
 StaticMesh3D::~StaticMesh3D()
 {
@@ -26,8 +27,7 @@ void StaticMesh3D::deleteMesh()
         return;
     }
 
-    glDeleteVertexArrays(1, &_vao);
-    _vbo.deleteVBO();
+    GeometryArena::getInstance().free(_geometry);
 
     _isInitialized = false;
 }
@@ -48,6 +48,11 @@ bool StaticMesh3D::hasNormals() const
 }
 
 int StaticMesh3D::getVertexByteSize() const
+{
+    return GeometryArena::getVertexByteSize(getGeometryArenaVertexFormat());
+}
+
+int StaticMesh3D::getSourceVertexByteSize() const
 {
     int result = 0;
     if (hasPositions()) {
@@ -63,31 +68,82 @@ int StaticMesh3D::getVertexByteSize() const
     return result;
 }
 
-void StaticMesh3D::setVertexAttributesPointers(int numVertices)
+const AABB& StaticMesh3D::getBoundingBox() const
+{
+    return _boundingBox;
+}
+
+const BoundingSphere& StaticMesh3D::getBoundingSphere() const
+{
+    return _boundingSphere;
+}
+
+void StaticMesh3D::moveDataToGeometryArena(int numVertices)
 {
-    uint64_t offset = 0;
-    if (hasPositions())
-    {
-        glEnableVertexAttribArray(POSITION_ATTRIBUTE_INDEX);
-        glVertexAttribPointer(POSITION_ATTRIBUTE_INDEX, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), reinterpret_cast<void*>(offset));
+    calculateBoundingVolumes(_vbo.getRawDataPointer(), numVertices);
+
+    auto& geometryArena = GeometryArena::getInstance();
+    _geometry = geometryArena.allocate(getGeometryArenaVertexFormat(), numVertices);
+    geometryArena.uploadPlanarVertices(_geometry, _vbo.getRawDataPointer());
+
+    // Data live in the arena now, we don't need them in memory anymore
+    _vbo.discardRawData();
+}
 
-        offset += sizeof(glm::vec3)*numVertices;
+void StaticMesh3D::calculateBoundingVolumes(const void* planarData, int numVertices)
+{
+    _boundingBox = AABB();
+    _boundingSphere = BoundingSphere();
+    if (!hasPositions() || numVertices <= 0) {
+        return;
     }
 
-    if (hasTextureCoordinates())
-    {
-        glEnableVertexAttribArray(TEXTURE_COORDINATE_ATTRIBUTE_INDEX);
-        glVertexAttribPointer(TEXTURE_COORDINATE_ATTRIBUTE_INDEX, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), reinterpret_cast<void*>(offset));
+    const auto positions = static_cast<const glm::vec3*>(planarData);
+    _boundingBox = AABB::fromPoints(positions, numVertices);
+    _boundingSphere = BoundingSphere::fromPoints(positions, numVertices);
+}
 
-        offset += sizeof(glm::vec2)*numVertices;
+int StaticMesh3D::getGeometryArenaVertexFormat() const
+{
+    return GeometryArena::getVertexFormat(hasPositions(), hasTextureCoordinates(), hasNormals(), _vertexEncodingFlags);
+}
+
+void StaticMesh3D::renderInstanced(const InstanceBuffer& instanceBuffer) const
+{
+    renderInstanced(instanceBuffer, 0, instanceBuffer.getNumInstances());
+}
+
+void StaticMesh3D::renderInstanced(const InstanceBuffer& instanceBuffer, const GLuint firstInstance, const GLsizei numInstances) const
+{
+    if (numInstances <= 0) {
+        return;
     }
 
-    if (hasNormals())
-    {
-        glEnableVertexAttribArray(NORMAL_ATTRIBUTE_INDEX);
-        glVertexAttribPointer(NORMAL_ATTRIBUTE_INDEX, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), reinterpret_cast<void*>(offset));
+    // Draw helpers switch to instanced draw calls, while the instance buffer is set
+    _renderedInstanceBuffer = &instanceBuffer;
+    _renderedFirstInstance = firstInstance;
+    _renderedNumInstances = numInstances;
+    render();
+    _renderedInstanceBuffer = nullptr;
+}
 
-        offset += sizeof(glm::vec3)*numVertices;
+void StaticMesh3D::bindGeometry() const
+{
+    if (_renderedInstanceBuffer != nullptr) {
+        GeometryArena::getInstance().bindInstancedVertexArray(_geometry, _renderedInstanceBuffer->getBufferID());
+    }
+    else {
+        GeometryArena::getInstance().bindVertexArray(_geometry);
+    }
+}
+
+void StaticMesh3D::drawArrays(GLenum mode, GLint firstVertex, GLsizei numVertices) const
+{
+    if (_renderedInstanceBuffer != nullptr) {
+        glDrawArraysInstancedBaseInstance(mode, _geometry.baseVertex + firstVertex, numVertices, _renderedNumInstances, _renderedFirstInstance);
+    }
+    else {
+        glDrawArrays(mode, _geometry.baseVertex + firstVertex, numVertices);
     }
 }
 
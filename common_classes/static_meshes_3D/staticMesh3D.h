@@ -1,7 +1,13 @@
 #pragma once
 
+// GLM
+#include <glm/glm.hpp>
+
 // Project
+#include "../boundingVolumes.h"
 #include "../vertexBufferObject.h"
+#include "geometryArena.h"
+#include "instanceBuffer.h"
 
 namespace static_meshes_3D {
 
@@ -15,7 +21,15 @@ public:
 	static const int TEXTURE_COORDINATE_ATTRIBUTE_INDEX; // Vertex attribute index of texture coordinate (1)
 	static const int NORMAL_ATTRIBUTE_INDEX; // Vertex attribute index of vertex normal (2)
 
-	StaticMesh3D(bool withPositions, bool withTextureCoordinates, bool withNormals);
+	/**
+	 * Creates static mesh with given vertex attributes.
+	 *
+	 * @param withPositions           Whether mesh has vertex positions
+	 * @param withTextureCoordinates  Whether mesh has texture coordinates
+	 * @param withNormals             Whether mesh has vertex normals
+	 * @param vertexEncodingFlags     How the vertices are laid out and encoded in GPU memory (GeometryArena vertex encoding flags, default is interleaved floats)
+	 */
+	StaticMesh3D(bool withPositions, bool withTextureCoordinates, bool withNormals, int vertexEncodingFlags = 0);
 	virtual ~StaticMesh3D();
 
 	/**
@@ -29,6 +43,26 @@ public:
 	 */
 	virtual void renderPoints() const {}
 
+	/**
+	 * Renders all instances uploaded to the instance buffer. Every draw call of render() is issued once
+	 * as an instanced draw call, so this works for every mesh rendered through bindGeometry / drawArrays / drawElements.
+	 * Shader must read per-instance attributes (e.g. main shaders compiled with INSTANCED define). The model matrix
+	 * uniform is applied before the instance matrices, so it should be identity.
+	 *
+	 * @param instanceBuffer  Buffer with per-instance data
+	 */
+	void renderInstanced(const InstanceBuffer& instanceBuffer) const;
+
+	/**
+	 * Renders only a range of instances uploaded to the instance buffer (uses base instance, so that one
+	 * buffer can hold instances of many separate draws, e.g. one draw per occlusion query).
+	 *
+	 * @param instanceBuffer  Buffer with per-instance data
+	 * @param firstInstance   Index of the first rendered instance
+	 * @param numInstances    Number of rendered instances
+	 */
+	void renderInstanced(const InstanceBuffer& instanceBuffer, GLuint firstInstance, GLsizei numInstances) const;
+
 	/**
 	 * Deletes static mesh data.
 	 */
@@ -50,18 +84,34 @@ public:
 	bool hasNormals() const;
 
 	/**
-	 * Gets byte size of one vertex (depending on present vertex attributes).
+	 * Gets byte size of one vertex, as it is stored in GPU memory (depending on present vertex attributes and their encodings).
 	 */
 	int getVertexByteSize() const;
 
+	/**
+	 * Gets bounding box of the mesh in mesh space (calculated, when the mesh is moved to the geometry arena).
+	 */
+	const AABB& getBoundingBox() const;
+
+	/**
+	 * Gets bounding sphere of the mesh in mesh space.
+	 */
+	const BoundingSphere& getBoundingSphere() const;
+
 protected:
 	bool _hasPositions = false; // Flag telling, if we have vertex positions
 	bool _hasTextureCoordinates = false; // Flag telling, if we have texture coordinates
 	bool _hasNormals = false; // Flag telling, if we have vertex normals
+	int _vertexEncodingFlags = 0; // Vertex layout and encoding flags used when storing vertices in geometry arena
 
 	bool _isInitialized = false; // Is mesh initialized flag
-	GLuint _vao = 0; // VAO ID from OpenGL
-	VertexBufferObject _vbo; // Our VBO wrapper class holding static mesh data
+	VertexBufferObject _vbo; // Our VBO wrapper class used to gather static mesh data (in planar layout) before they're moved to geometry arena
+	GeometryArena::Allocation _geometry; // Where the mesh geometry lives within the geometry arena
+	mutable const InstanceBuffer* _renderedInstanceBuffer = nullptr; // Instance buffer being rendered by renderInstanced (nullptr when rendering normally)
+	mutable GLuint _renderedFirstInstance = 0; // First instance being rendered by renderInstanced
+	mutable GLsizei _renderedNumInstances = 0; // Number of instances being rendered by renderInstanced
+	AABB _boundingBox; // Bounding box of the mesh (empty, if mesh has no positions)
+	BoundingSphere _boundingSphere; // Bounding sphere of the mesh
 
 	/**
 	 * Initializes vertex data. Default implementation does nothing as its not needed for all classes
@@ -69,11 +119,43 @@ protected:
 	virtual void initializeData() {}
 
 	/**
-	* Sets vertex attribute pointers in a standard way.
-	*
-	* @param numVertices  Number of vertices present in the buffer
-	*/
-	void setVertexAttributesPointers(int numVertices);
+	 * Moves gathered vertex data to the geometry arena and releases them from memory afterwards.
+	 *
+	 * @param numVertices  Number of vertices that have been gathered
+	 */
+	virtual void moveDataToGeometryArena(int numVertices);
+
+	/**
+	 * Calculates bounding volumes from vertex data in planar layout (positions are the first block).
+	 *
+	 * @param planarData   Pointer to the planar vertex data
+	 * @param numVertices  Number of vertices
+	 */
+	void calculateBoundingVolumes(const void* planarData, int numVertices);
+
+	/**
+	 * Gets byte size of one vertex of gathered vertex data, where all attributes are 32-bit floats.
+	 */
+	int getSourceVertexByteSize() const;
+
+	/**
+	 * Gets vertex format of this mesh, as it is stored in geometry arena (attributes + encodings).
+	 */
+	int getGeometryArenaVertexFormat() const;
+
+	/**
+	 * Binds VAO shared by all meshes with the same vertex format (or its instanced counterpart within renderInstanced).
+	 */
+	void bindGeometry() const;
+
+	/**
+	 * Renders range of mesh vertices (vertex indices are relative to the mesh). Within renderInstanced, all instances are rendered.
+	 *
+	 * @param mode         Primitive type to render
+	 * @param firstVertex  First vertex of the mesh to render
+	 * @param numVertices  How many vertices to render
+	 */
+	void drawArrays(GLenum mode, GLint firstVertex, GLsizei numVertices) const;
 };
 
 }; // namespace static_meshes_3D
\ No newline at end of file
@@ -1,25 +1,54 @@
 // Project
 #include "staticMeshIndexed3D.h"
+#include "../glStateCache.h"
 
 namespace static_meshes_3D {
 
-StaticMeshIndexed3D::StaticMeshIndexed3D(bool withPositions, bool withTextureCoordinates, bool withNormals)
-    : StaticMesh3D(withPositions, withTextureCoordinates, withNormals) {}
+StaticMeshIndexed3D::StaticMeshIndexed3D(bool withPositions, bool withTextureCoordinates, bool withNormals, int vertexEncodingFlags)
+    : StaticMesh3D(withPositions, withTextureCoordinates, withNormals, vertexEncodingFlags) {}
 
 StaticMeshIndexed3D::~StaticMeshIndexed3D()
 {
-    if (_isInitialized) {
-        // It's enough to delete indices VBO here, rest of stuff is destructed in super destructor
-        _indicesVBO.deleteVBO();
-    }
+    // Indices are part of the same geometry arena allocation, so everything is freed in super destructor
 }
 
 void StaticMeshIndexed3D::deleteMesh()
 {
     if (_isInitialized) {
-        _indicesVBO.deleteVBO();
         StaticMesh3D::deleteMesh();
     }
 }
 
+void StaticMeshIndexed3D::moveDataToGeometryArena(int numVertices)
+{
+    calculateBoundingVolumes(_vbo.getRawDataPointer(), numVertices);
+
+    auto& geometryArena = GeometryArena::getInstance();
+    _geometry = geometryArena.allocate(getGeometryArenaVertexFormat(), numVertices, _numIndices);
+    geometryArena.uploadPlanarVertices(_geometry, _vbo.getRawDataPointer());
+    geometryArena.uploadIndices(_geometry, static_cast<const GLuint*>(_indicesVBO.getRawDataPointer()));
+
+    // Data live in the arena now, we don't need them in memory anymore
+    _vbo.discardRawData();
+    _indicesVBO.discardRawData();
+}
+
+void StaticMeshIndexed3D::drawElements(GLenum mode, GLsizei numIndices, GLsizei firstIndex) const
+{
+    const auto indicesOffset = reinterpret_cast<void*>(sizeof(GLuint) * (_geometry.firstIndex + firstIndex));
+    if (_renderedInstanceBuffer != nullptr) {
+        glDrawElementsInstancedBaseVertexBaseInstance(mode, numIndices, GL_UNSIGNED_INT, indicesOffset, _renderedNumInstances, _geometry.baseVertex, _renderedFirstInstance);
+    }
+    else {
+        glDrawElementsBaseVertex(mode, numIndices, GL_UNSIGNED_INT, indicesOffset, _geometry.baseVertex);
+    }
+}
+
+void StaticMeshIndexed3D::enablePrimitiveRestart() const
+{
+    auto& stateCache = GLStateCache::getInstance();
+    stateCache.enable(GL_PRIMITIVE_RESTART);
+    stateCache.setPrimitiveRestartIndex(static_cast<GLuint>(_primitiveRestartIndex));
+}
+
 } // namespace static_meshes_3D
\ No newline at end of file
@@ -11,13 +11,37 @@ namespace static_meshes_3D {
 class StaticMeshIndexed3D : public StaticMesh3D
 {
 public:
-    StaticMeshIndexed3D(bool withPositions, bool withTextureCoordinates, bool withNormals);
+    StaticMeshIndexed3D(bool withPositions, bool withTextureCoordinates, bool withNormals, int vertexEncodingFlags = 0);
     virtual ~StaticMeshIndexed3D();
 
     void deleteMesh() override;
 
 protected:
-    VertexBufferObject _indicesVBO; // Our VBO wrapper class holding indices data
+    /**
+     * Moves gathered vertex data and indices to the geometry arena and releases them from memory afterwards.
+     *
+     * @param numVertices  Number of vertices that have been gathered (indices count is taken from _numIndices)
+     */
+    void moveDataToGeometryArena(int numVertices) override;
+
+    /**
+     * Renders range of mesh indices. Indices are relative to the mesh, base vertex of the mesh is added automatically.
+     * Within renderInstanced, all instances are rendered.
+     *
+     * @param mode        Primitive type to render
+     * @param numIndices  How many indices to render
+     * @param firstIndex  First index of the mesh to render (default is 0)
+     */
+    void drawElements(GLenum mode, GLsizei numIndices, GLsizei firstIndex = 0) const;
+
+    /**
+     * Enables primitive restart with primitive restart index of this mesh. Primitive restart is part of the state of every
+     * indexed draw - meshes using it call this before drawing and indexed draws without restart must disable it through
+     * GLStateCache, otherwise their index, that equals the restart index left behind by the last mesh, would drop primitives.
+     */
+    void enablePrimitiveRestart() const;
+
+    VertexBufferObject _indicesVBO; // Our VBO wrapper class used to gather indices before they're moved to geometry arena
 
     int _numVertices = 0; // Holds the total number of generated vertices
     int _numIndices = 0; // Holds the number of generated indices used for rendering
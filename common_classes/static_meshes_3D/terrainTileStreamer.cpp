@@ -0,0 +1,263 @@
+// STL
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// GLM
+#include <glm/gtc/matrix_transform.hpp>
+
+// Project
+#include "terrainTileStreamer.h"
+
+namespace static_meshes_3D {
+
+const size_t TerrainTileStreamer::MAX_LOADED_TILES = 4;
+
+TerrainTileStreamer::TerrainTileStreamer(const std::string& tiledFileName, const glm::vec3& vertexSpacing, const float viewRadius, const size_t maxResidentTiles, const size_t maxUploadsPerFrame)
+    : vertexSpacing_(vertexSpacing)
+    , viewRadius_(viewRadius)
+    , maxResidentTiles_(maxResidentTiles)
+    , maxUploadsPerFrame_(std::max(maxUploadsPerFrame, size_t(1)))
+{
+    if (!tiledHeightFile_.open(tiledFileName)) {
+        return;
+    }
+
+    // Circle of view radius can touch this many tiles at most, all of them must fit in at the same time
+    const auto tileWorldSize = static_cast<float>(tiledHeightFile_.getTileSize()) * std::min(vertexSpacing_.x, vertexSpacing_.z);
+    const auto maxTilesAlongSide = static_cast<size_t>(std::ceil(2.0f * viewRadius_ / tileWorldSize)) + 1;
+    maxResidentTiles_ = std::max(maxResidentTiles_, maxTilesAlongSide * maxTilesAlongSide);
+
+    // All tiles get the quadtree of the full tile, even the smaller ones at the edges
+    while ((CDLODTerrain::GRID_SIZE << (numTileLevels_ - 1)) < tiledHeightFile_.getTileSize()) {
+        numTileLevels_++;
+    }
+
+    loaderThread_ = std::thread(&TerrainTileStreamer::loaderThreadMain, this);
+}
+
+TerrainTileStreamer::~TerrainTileStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(loaderMutex_);
+        isRunning_ = false;
+    }
+
+    loaderCondition_.notify_all();
+    if (loaderThread_.joinable()) {
+        loaderThread_.join();
+    }
+}
+
+bool TerrainTileStreamer::isOpen() const
+{
+    return tiledHeightFile_.isOpen();
+}
+
+void TerrainTileStreamer::update(const glm::vec3& cameraPosition)
+{
+    if (!isOpen()) {
+        return;
+    }
+
+    frameIndex_++;
+    const auto wantedTiles = getWantedTiles(cameraPosition);
+    wantedTiles_ = std::unordered_set<int>(wantedTiles.begin(), wantedTiles.end());
+
+    // Old requests, that the loader thread hasn't got to, are replaced by the current ones (nearest first)
+    std::deque<LoadedTile> loadedTiles;
+    {
+        std::lock_guard<std::mutex> lock(loaderMutex_);
+        for (const auto tileIndex : requestedTiles_) {
+            pendingTiles_.erase(tileIndex);
+        }
+        requestedTiles_.clear();
+
+        for (const auto tileIndex : wantedTiles)
+        {
+            auto residentTile = residentTiles_.find(tileIndex);
+            if (residentTile != residentTiles_.end()) {
+                residentTile->second.lastUsedFrame = frameIndex_;
+            }
+            else if (pendingTiles_.insert(tileIndex).second) {
+                requestedTiles_.push_back(tileIndex);
+            }
+        }
+
+        for (size_t i = 0; i < maxUploadsPerFrame_ && !loadedTiles_.empty(); i++)
+        {
+            loadedTiles.push_back(std::move(loadedTiles_.front()));
+            loadedTiles_.pop_front();
+        }
+    }
+    loaderCondition_.notify_one();
+
+    // Uploading happens outside of the lock, loader thread can already read next tiles
+    for (auto& loadedTile : loadedTiles)
+    {
+        pendingTiles_.erase(loadedTile.tileIndex);
+        if (wantedTiles_.count(loadedTile.tileIndex) != 0) {
+            uploadTile(loadedTile);
+        }
+    }
+
+    evictTiles();
+}
+
+void TerrainTileStreamer::renderMultilayered(const glm::vec3& cameraPosition, const Frustum& frustum, const std::vector<std::string>& textureKeys, const std::vector<float>& levels)
+{
+    numRenderedTriangles_ = 0;
+    auto& terrainShaderProgram = CDLODTerrain::getShaderProgram();
+    for (auto& residentTile : residentTiles_)
+    {
+        auto& tile = residentTile.second;
+        tile.terrain->selectNodes(tile.modelMatrix, cameraPosition, frustum);
+        if (tile.terrain->getNumSelectedNodes() == 0) {
+            continue;
+        }
+
+        terrainShaderProgram.setModelAndNormalMatrix(tile.modelMatrix);
+        tile.terrain->renderMultilayered(textureKeys, levels);
+        numRenderedTriangles_ += tile.terrain->getNumRenderedTriangles();
+    }
+}
+
+size_t TerrainTileStreamer::getNumTiles() const
+{
+    return static_cast<size_t>(tiledHeightFile_.getNumTileRows()) * tiledHeightFile_.getNumTileColumns();
+}
+
+size_t TerrainTileStreamer::getNumResidentTiles() const
+{
+    return residentTiles_.size();
+}
+
+size_t TerrainTileStreamer::getNumPendingTiles() const
+{
+    return pendingTiles_.size();
+}
+
+size_t TerrainTileStreamer::getNumRenderedTriangles() const
+{
+    return numRenderedTriangles_;
+}
+
+std::vector<int> TerrainTileStreamer::getWantedTiles(const glm::vec3& cameraPosition) const
+{
+    // Whole terrain is centered around the origin
+    const auto tileSize = tiledHeightFile_.getTileSize();
+    const auto tileWorldSize = glm::vec2(vertexSpacing_.x, vertexSpacing_.z) * static_cast<float>(tileSize);
+    const auto terrainMin = -0.5f * glm::vec2(vertexSpacing_.x * (tiledHeightFile_.getColumns() - 1), vertexSpacing_.z * (tiledHeightFile_.getRows() - 1));
+    const auto camera = glm::vec2(cameraPosition.x, cameraPosition.z) - terrainMin;
+
+    // Only tiles within the bounding square of the view circle are tested
+    const auto firstColumn = std::max(static_cast<int>(std::floor((camera.x - viewRadius_) / tileWorldSize.x)), 0);
+    const auto lastColumn = std::min(static_cast<int>(std::floor((camera.x + viewRadius_) / tileWorldSize.x)), tiledHeightFile_.getNumTileColumns() - 1);
+    const auto firstRow = std::max(static_cast<int>(std::floor((camera.y - viewRadius_) / tileWorldSize.y)), 0);
+    const auto lastRow = std::min(static_cast<int>(std::floor((camera.y + viewRadius_) / tileWorldSize.y)), tiledHeightFile_.getNumTileRows() - 1);
+
+    std::vector<std::pair<float, int>> tileDistances;
+    for (auto tileRow = firstRow; tileRow <= lastRow; tileRow++)
+    {
+        for (auto tileColumn = firstColumn; tileColumn <= lastColumn; tileColumn++)
+        {
+            const auto tileMin = glm::vec2(tileColumn, tileRow) * tileWorldSize;
+            const auto closestPoint = glm::clamp(camera, tileMin, tileMin + tileWorldSize);
+            const auto distance = glm::length(camera - closestPoint);
+            if (distance <= viewRadius_) {
+                tileDistances.emplace_back(distance, tileRow * tiledHeightFile_.getNumTileColumns() + tileColumn);
+            }
+        }
+    }
+
+    std::sort(tileDistances.begin(), tileDistances.end());
+    std::vector<int> result;
+    result.reserve(tileDistances.size());
+    for (const auto& tileDistance : tileDistances) {
+        result.push_back(tileDistance.second);
+    }
+
+    return result;
+}
+
+void TerrainTileStreamer::uploadTile(LoadedTile& loadedTile)
+{
+    const auto& heightData = loadedTile.heightData;
+    if (heightData.empty()) {
+        return;
+    }
+
+    const auto tileSize = tiledHeightFile_.getTileSize();
+    const auto tileRow = loadedTile.tileIndex / tiledHeightFile_.getNumTileColumns();
+    const auto tileColumn = loadedTile.tileIndex % tiledHeightFile_.getNumTileColumns();
+
+    // Tile terrain spans [-0.5, 0.5] over its own quads, so it's scaled by its size and moved to its center
+    const auto numQuads = glm::vec2(heightData.columns - 1, heightData.rows - 1);
+    const auto firstVertex = glm::vec2(tileColumn * tileSize, tileRow * tileSize);
+    const auto terrainMin = -0.5f * glm::vec2(vertexSpacing_.x * (tiledHeightFile_.getColumns() - 1), vertexSpacing_.z * (tiledHeightFile_.getRows() - 1));
+    const auto tileCenter = terrainMin + (firstVertex + 0.5f * numQuads) * glm::vec2(vertexSpacing_.x, vertexSpacing_.z);
+
+    ResidentTile residentTile;
+    residentTile.terrain = std::make_unique<CDLODTerrain>(heightData, CDLODTerrain::DEFAULT_LOD_DISTANCE_RATIO, numTileLevels_);
+    residentTile.terrain->setHeightmapOrigin(firstVertex);
+    residentTile.modelMatrix = glm::translate(glm::mat4(1.0f), glm::vec3(tileCenter.x, 0.0f, tileCenter.y));
+    residentTile.modelMatrix = glm::scale(residentTile.modelMatrix, glm::vec3(numQuads.x * vertexSpacing_.x, vertexSpacing_.y, numQuads.y * vertexSpacing_.z));
+    residentTile.lastUsedFrame = frameIndex_;
+    residentTiles_[loadedTile.tileIndex] = std::move(residentTile);
+}
+
+void TerrainTileStreamer::evictTiles()
+{
+    while (residentTiles_.size() > maxResidentTiles_)
+    {
+        auto leastRecentlyUsed = residentTiles_.end();
+        for (auto it = residentTiles_.begin(); it != residentTiles_.end(); ++it)
+        {
+            if (wantedTiles_.count(it->first) == 0 && (leastRecentlyUsed == residentTiles_.end() || it->second.lastUsedFrame < leastRecentlyUsed->second.lastUsedFrame)) {
+                leastRecentlyUsed = it;
+            }
+        }
+
+        if (leastRecentlyUsed == residentTiles_.end()) {
+            break;
+        }
+
+        residentTiles_.erase(leastRecentlyUsed);
+    }
+}
+
+void TerrainTileStreamer::loaderThreadMain()
+{
+    const auto numTileColumns = tiledHeightFile_.getNumTileColumns();
+    while (true)
+    {
+        int tileIndex;
+        {
+            // Wait for a request and for space among loaded tiles, so that reading ahead can't exhaust memory
+            std::unique_lock<std::mutex> lock(loaderMutex_);
+            loaderCondition_.wait(lock, [this]() {
+                return !isRunning_ || (!requestedTiles_.empty() && loadedTiles_.size() < MAX_LOADED_TILES);
+            });
+
+            if (!isRunning_) {
+                return;
+            }
+
+            tileIndex = requestedTiles_.front();
+            requestedTiles_.pop_front();
+        }
+
+        // Reading (and page faults of the mapped file) happens outside of the lock
+        LoadedTile loadedTile{ tileIndex, tiledHeightFile_.readTile(tileIndex / numTileColumns, tileIndex % numTileColumns) };
+        if (loadedTile.heightData.empty()) {
+            std::cout << "Could not read terrain tile " << tileIndex << "!" << std::endl;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(loaderMutex_);
+            loadedTiles_.push_back(std::move(loadedTile));
+        }
+    }
+}
+
+} // namespace static_meshes_3D
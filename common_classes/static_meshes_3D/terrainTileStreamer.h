@@ -0,0 +1,157 @@
+#pragma once
+
+// STL
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// GLM
+#include <glm/glm.hpp>
+
+// Project
+#include "../frustum.h"
+
+#include "cdlodTerrain.h"
+#include "tiledHeightFile.h"
+
+namespace static_meshes_3D {
+
+/**
+ * Streams tiles of a terrain, that is too big to be held in memory, from a tiled height file. Only tiles within the view
+ * radius around the camera are resident - background thread reads requested tiles from the memory mapped file and main
+ * thread uploads a few of them per frame as CDLOD terrains. When there are more resident tiles than allowed, least recently
+ * used tiles, that are out of the view radius, are evicted. So the memory usage depends on the view radius, not on the map size.
+ * Whole terrain is centered around the origin with its lowest point at y = 0.
+ */
+class TerrainTileStreamer
+{
+public:
+    static const size_t MAX_LOADED_TILES; // How many tiles can wait for upload, before the loader thread stops reading new ones
+
+    /**
+     * Opens tiled height file and starts the loader thread. No tiles are loaded until the first update.
+     *
+     * @param tiledFileName       Tiled height file (see TiledHeightFile::convertFromImage)
+     * @param vertexSpacing       Distance between neighbouring vertices in X and Z and height of the highest point in Y
+     * @param viewRadius          Tiles intersecting the circle of this radius around the camera (in XZ plane) are streamed in
+     * @param maxResidentTiles    How many tiles can be resident (raised to the number of tiles, that view radius can cover)
+     * @param maxUploadsPerFrame  How many loaded tiles are uploaded to the GPU per update
+     */
+    TerrainTileStreamer(const std::string& tiledFileName, const glm::vec3& vertexSpacing, float viewRadius, size_t maxResidentTiles, size_t maxUploadsPerFrame = 2);
+    ~TerrainTileStreamer();
+
+    TerrainTileStreamer(const TerrainTileStreamer&) = delete; // No copy constructor allowed
+    void operator=(const TerrainTileStreamer&) = delete; // No copy assignment allowed
+
+    /**
+     * Checks, if the tiled height file has been opened successfully.
+     */
+    bool isOpen() const;
+
+    /**
+     * Requests tiles around the camera from the loader thread (nearest ones first), uploads some of the loaded ones
+     * and evicts least recently used tiles over the limit. Call this once per frame.
+     *
+     * @param cameraPosition  Position of the camera (in world space)
+     */
+    void update(const glm::vec3& cameraPosition);
+
+    /**
+     * Selects nodes of all resident tiles and renders them with multiple layers. CDLOD terrain shader program
+     * must be in use with projection and view matrices set.
+     *
+     * @param cameraPosition  Position of the camera (in world space)
+     * @param frustum         View frustum (in world space)
+     * @param textureKeys     Contains which textures should be used (ordered from bottom-most to top-most layer)
+     * @param levels          Contains where within the terrain should layer transitions start / stop
+     */
+    void renderMultilayered(const glm::vec3& cameraPosition, const Frustum& frustum, const std::vector<std::string>& textureKeys, const std::vector<float>& levels);
+
+    /**
+     * Gets total number of tiles in the tiled height file.
+     */
+    size_t getNumTiles() const;
+
+    /**
+     * Gets number of tiles, that are uploaded and can be rendered.
+     */
+    size_t getNumResidentTiles() const;
+
+    /**
+     * Gets number of tiles, that are requested or loaded, but not uploaded yet.
+     */
+    size_t getNumPendingTiles() const;
+
+    /**
+     * Gets number of triangles rendered by the last render call.
+     */
+    size_t getNumRenderedTriangles() const;
+
+private:
+    /**
+     * Tile uploaded to the GPU.
+     */
+    struct ResidentTile
+    {
+        std::unique_ptr<CDLODTerrain> terrain; // Terrain of the tile
+        glm::mat4 modelMatrix; // Places the tile within the whole terrain
+        size_t lastUsedFrame; // Last frame, in which the tile was within the view radius
+    };
+
+    /**
+     * Tile read by the loader thread, that waits for upload.
+     */
+    struct LoadedTile
+    {
+        int tileIndex; // Index of the tile (row * number of tile columns + column)
+        Heightmap::HeightData heightData; // Height data of the tile
+    };
+
+    /**
+     * Gets indices of tiles intersecting the view radius around the camera, sorted from the nearest one.
+     */
+    std::vector<int> getWantedTiles(const glm::vec3& cameraPosition) const;
+
+    /**
+     * Creates CDLOD terrain of the loaded tile and makes it resident.
+     */
+    void uploadTile(LoadedTile& loadedTile);
+
+    /**
+     * Evicts least recently used tiles, that aren't wanted, until the number of resident tiles is within the limit.
+     */
+    void evictTiles();
+
+    /**
+     * Main function of the loader thread.
+     */
+    void loaderThreadMain();
+
+    TiledHeightFile tiledHeightFile_; // Memory mapped file with all tiles
+    glm::vec3 vertexSpacing_; // Distance between vertices in X and Z, height scale in Y
+    float viewRadius_; // Radius around the camera, within which the tiles are streamed in
+    size_t maxResidentTiles_; // Maximal number of resident tiles
+    size_t maxUploadsPerFrame_; // Maximal number of uploads per update
+    int numTileLevels_{ 1 }; // Number of quadtree levels of full tile, so that all tiles switch levels at the same distances
+
+    std::unordered_map<int, ResidentTile> residentTiles_; // Uploaded tiles by their index
+    std::unordered_set<int> pendingTiles_; // Tiles requested from the loader thread or loaded, but not uploaded yet
+    std::unordered_set<int> wantedTiles_; // Tiles within the view radius during the last update
+    size_t frameIndex_{ 0 }; // Number of updates so far
+    size_t numRenderedTriangles_{ 0 }; // Number of triangles rendered by the last render call
+
+    std::thread loaderThread_; // Thread reading tiles from the file
+    std::mutex loaderMutex_; // Guards everything below
+    std::condition_variable loaderCondition_; // Wakes the loader thread, when there are new requests or space for loaded tiles
+    std::deque<int> requestedTiles_; // Tiles to read, nearest first
+    std::deque<LoadedTile> loadedTiles_; // Tiles read, waiting for upload
+    bool isRunning_{ true }; // Flag telling the loader thread to keep running
+};
+
+} // namespace static_meshes_3D
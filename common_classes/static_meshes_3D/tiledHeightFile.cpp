@@ -0,0 +1,277 @@
+// STL
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+// Project
+#include "tiledHeightFile.h"
+
+namespace static_meshes_3D {
+
+namespace {
+
+const uint32_t TILED_HEIGHT_FILE_MAGIC = 0x4C54484D; // "MHTL" - file magic of tiled height file
+const uint32_t TILED_HEIGHT_FILE_VERSION = 1; // Version of tiled height file layout
+const float MAX_HEIGHT_VALUE = 65535.0f; // Stored value of the highest point (height 1.0)
+const uint64_t TILE_ALIGNMENT = 4096; // Tiles start at page boundaries, so that releasing pages of one tile never touches its neighbours
+
+/**
+ * Header of tiled height file. It's followed by byte offsets of all tiles (uint64_t, row after row)
+ * and tiles consist of 16-bit height values (row after row), padded to TILE_ALIGNMENT. All values are stored
+ * in host byte order, because the mapped file is read in place - it's a local cache converted from the image,
+ * so file written on a machine with other byte order is rejected, as its magic doesn't match.
+ */
+struct TiledHeightFileHeader
+{
+    uint32_t magic; // Must be TILED_HEIGHT_FILE_MAGIC
+    uint32_t version; // Must be TILED_HEIGHT_FILE_VERSION
+    uint32_t rows; // Number of rows of the whole heightmap
+    uint32_t columns; // Number of columns of the whole heightmap
+    uint32_t tileSize; // Number of heightmap quads along one side of a tile
+    uint32_t numTileRows; // Number of rows of tiles
+    uint32_t numTileColumns; // Number of columns of tiles
+    uint32_t reserved; // Keeps the tile index aligned to 8 bytes
+};
+
+/**
+ * Gets number of tiles needed to cover given number of vertices.
+ */
+int getNumTiles(const int numVertices, const int tileSize)
+{
+    return (numVertices - 1 + tileSize - 1) / tileSize;
+}
+
+/**
+ * Gets byte size of the tile rounded up to TILE_ALIGNMENT.
+ */
+uint64_t getAlignedTileByteSize(const int tileRows, const int tileColumns)
+{
+    const auto tileByteSize = static_cast<uint64_t>(tileRows) * tileColumns * sizeof(uint16_t);
+    return (tileByteSize + TILE_ALIGNMENT - 1) / TILE_ALIGNMENT * TILE_ALIGNMENT;
+}
+
+/**
+ * Gets index into the original image of the vertex of repeated image, every other copy is mirrored.
+ */
+int getMirroredIndex(const int index, const int numVertices)
+{
+    const auto period = 2 * (numVertices - 1);
+    const auto indexInPeriod = index % period;
+    return indexInPeriod < numVertices ? indexInPeriod : period - indexInPeriod;
+}
+
+} // namespace
+
+const std::string TiledHeightFile::FILE_EXTENSION = ".tiles";
+
+bool TiledHeightFile::convertFromImage(const std::string& imageFileName, const std::string& fileName, const int tileSize, const int repeatCount)
+{
+    const auto image = Heightmap::getHeightDataFromImage(imageFileName);
+    if (image.empty() || image.rows < 2 || image.columns < 2 || tileSize < 1 || repeatCount < 1) {
+        return false;
+    }
+
+    TiledHeightFileHeader header;
+    header.magic = TILED_HEIGHT_FILE_MAGIC;
+    header.version = TILED_HEIGHT_FILE_VERSION;
+    header.rows = static_cast<uint32_t>(repeatCount * (image.rows - 1) + 1);
+    header.columns = static_cast<uint32_t>(repeatCount * (image.columns - 1) + 1);
+    header.tileSize = static_cast<uint32_t>(tileSize);
+    header.numTileRows = static_cast<uint32_t>(getNumTiles(static_cast<int>(header.rows), tileSize));
+    header.numTileColumns = static_cast<uint32_t>(getNumTiles(static_cast<int>(header.columns), tileSize));
+    header.reserved = 0;
+
+    std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+    if (!file.good())
+    {
+        std::cout << "Could not create tiled height file " << fileName << "!" << std::endl;
+        return false;
+    }
+
+    // Tile sizes are known up front, so the whole tile index is written before the tiles
+    const auto numTiles = static_cast<size_t>(header.numTileRows) * header.numTileColumns;
+    std::vector<uint64_t> tileOffsets(numTiles);
+    const auto headerByteSize = static_cast<uint64_t>(sizeof(TiledHeightFileHeader) + numTiles * sizeof(uint64_t));
+    auto tileOffset = (headerByteSize + TILE_ALIGNMENT - 1) / TILE_ALIGNMENT * TILE_ALIGNMENT;
+    for (auto tileRow = 0; tileRow < static_cast<int>(header.numTileRows); tileRow++)
+    {
+        for (auto tileColumn = 0; tileColumn < static_cast<int>(header.numTileColumns); tileColumn++)
+        {
+            const auto tileRows = std::min(tileSize, static_cast<int>(header.rows) - 1 - tileRow * tileSize) + 1;
+            const auto tileColumns = std::min(tileSize, static_cast<int>(header.columns) - 1 - tileColumn * tileSize) + 1;
+            tileOffsets[tileRow * header.numTileColumns + tileColumn] = tileOffset;
+            tileOffset += getAlignedTileByteSize(tileRows, tileColumns);
+        }
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(TiledHeightFileHeader));
+    file.write(reinterpret_cast<const char*>(tileOffsets.data()), numTiles * sizeof(uint64_t));
+    const std::vector<char> headerPadding(static_cast<size_t>(tileOffsets[0] - headerByteSize), 0);
+    file.write(headerPadding.data(), headerPadding.size());
+
+    std::vector<uint16_t> tileValues;
+    for (auto tileRow = 0; tileRow < static_cast<int>(header.numTileRows); tileRow++)
+    {
+        for (auto tileColumn = 0; tileColumn < static_cast<int>(header.numTileColumns); tileColumn++)
+        {
+            const auto firstRow = tileRow * tileSize;
+            const auto firstColumn = tileColumn * tileSize;
+            const auto tileRows = std::min(tileSize, static_cast<int>(header.rows) - 1 - firstRow) + 1;
+            const auto tileColumns = std::min(tileSize, static_cast<int>(header.columns) - 1 - firstColumn) + 1;
+            tileValues.assign(static_cast<size_t>(getAlignedTileByteSize(tileRows, tileColumns) / sizeof(uint16_t)), 0);
+            auto value = tileValues.begin();
+            for (auto i = 0; i < tileRows; i++)
+            {
+                const auto imageRow = getMirroredIndex(firstRow + i, image.rows);
+                for (auto j = 0; j < tileColumns; j++)
+                {
+                    const auto height = image.at(imageRow, getMirroredIndex(firstColumn + j, image.columns));
+                    *value++ = static_cast<uint16_t>(std::min(std::max(height, 0.0f), 1.0f) * MAX_HEIGHT_VALUE + 0.5f);
+                }
+            }
+
+            file.write(reinterpret_cast<const char*>(tileValues.data()), tileValues.size() * sizeof(uint16_t));
+        }
+    }
+
+    if (!file.good())
+    {
+        std::cout << "Could not write tiled height file " << fileName << "!" << std::endl;
+        return false;
+    }
+
+    std::cout << "Converted heightmap " << imageFileName << " to tiled height file " << fileName << " (" << header.columns << "x" << header.rows
+        << " vertices, " << header.numTileColumns << "x" << header.numTileRows << " tiles)" << std::endl;
+    return true;
+}
+
+bool TiledHeightFile::open(const std::string& fileName)
+{
+    close();
+    if (!file_.open(fileName)) {
+        return false;
+    }
+
+    // Check the header first
+    const auto fileSize = file_.getSize();
+    if (fileSize < sizeof(TiledHeightFileHeader))
+    {
+        std::cout << "Tiled height file " << fileName << " is corrupted!" << std::endl;
+        close();
+        return false;
+    }
+
+    const auto& header = *reinterpret_cast<const TiledHeightFileHeader*>(file_.getData());
+    const auto tileSize = static_cast<int>(header.tileSize);
+    if (header.magic != TILED_HEIGHT_FILE_MAGIC || header.version != TILED_HEIGHT_FILE_VERSION || header.rows < 2 || header.columns < 2 || tileSize < 1
+        || header.numTileRows != static_cast<uint32_t>(getNumTiles(static_cast<int>(header.rows), tileSize))
+        || header.numTileColumns != static_cast<uint32_t>(getNumTiles(static_cast<int>(header.columns), tileSize)))
+    {
+        std::cout << "Tiled height file " << fileName << " has invalid header!" << std::endl;
+        close();
+        return false;
+    }
+
+    rows_ = static_cast<int>(header.rows);
+    columns_ = static_cast<int>(header.columns);
+    tileSize_ = tileSize;
+    numTileRows_ = static_cast<int>(header.numTileRows);
+    numTileColumns_ = static_cast<int>(header.numTileColumns);
+
+    // Then check, that all tiles are within the file
+    const auto numTiles = static_cast<size_t>(numTileRows_) * numTileColumns_;
+    if (fileSize < sizeof(TiledHeightFileHeader) + numTiles * sizeof(uint64_t))
+    {
+        std::cout << "Tiled height file " << fileName << " is corrupted!" << std::endl;
+        close();
+        return false;
+    }
+
+    tileOffsets_ = reinterpret_cast<const uint64_t*>(file_.getData() + sizeof(TiledHeightFileHeader));
+    for (auto tileRow = 0; tileRow < numTileRows_; tileRow++)
+    {
+        for (auto tileColumn = 0; tileColumn < numTileColumns_; tileColumn++)
+        {
+            int tileRows, tileColumns;
+            getTileVertexCounts(tileRow, tileColumn, tileRows, tileColumns);
+            const auto tileOffset = tileOffsets_[tileRow * numTileColumns_ + tileColumn];
+            const auto tileByteSize = static_cast<uint64_t>(tileRows) * tileColumns * sizeof(uint16_t);
+            if (tileOffset % sizeof(uint16_t) != 0 || tileOffset > fileSize || tileByteSize > fileSize - tileOffset)
+            {
+                std::cout << "Tiled height file " << fileName << " is corrupted!" << std::endl;
+                close();
+                return false;
+            }
+        }
+    }
+
+    // Tile index isn't needed resident, it's touched again only for tiles being read
+    file_.releasePages(0, sizeof(TiledHeightFileHeader) + numTiles * sizeof(uint64_t));
+    return true;
+}
+
+void TiledHeightFile::close()
+{
+    file_.close();
+    tileOffsets_ = nullptr;
+    rows_ = columns_ = tileSize_ = numTileRows_ = numTileColumns_ = 0;
+}
+
+bool TiledHeightFile::isOpen() const
+{
+    return file_.isOpen();
+}
+
+int TiledHeightFile::getRows() const
+{
+    return rows_;
+}
+
+int TiledHeightFile::getColumns() const
+{
+    return columns_;
+}
+
+int TiledHeightFile::getTileSize() const
+{
+    return tileSize_;
+}
+
+int TiledHeightFile::getNumTileRows() const
+{
+    return numTileRows_;
+}
+
+int TiledHeightFile::getNumTileColumns() const
+{
+    return numTileColumns_;
+}
+
+Heightmap::HeightData TiledHeightFile::readTile(const int tileRow, const int tileColumn) const
+{
+    if (!isOpen() || tileRow < 0 || tileRow >= numTileRows_ || tileColumn < 0 || tileColumn >= numTileColumns_) {
+        return Heightmap::HeightData();
+    }
+
+    Heightmap::HeightData result;
+    getTileVertexCounts(tileRow, tileColumn, result.rows, result.columns);
+    result.values.resize(static_cast<size_t>(result.rows) * result.columns);
+
+    const auto tileOffset = static_cast<size_t>(tileOffsets_[tileRow * numTileColumns_ + tileColumn]);
+    const auto tileValues = reinterpret_cast<const uint16_t*>(file_.getData() + tileOffset);
+    std::transform(tileValues, tileValues + result.values.size(), result.values.begin(), [](const uint16_t value) {
+        return static_cast<float>(value) / MAX_HEIGHT_VALUE;
+    });
+
+    file_.releasePages(tileOffset, static_cast<size_t>(getAlignedTileByteSize(result.rows, result.columns)));
+    return result;
+}
+
+void TiledHeightFile::getTileVertexCounts(const int tileRow, const int tileColumn, int& outRows, int& outColumns) const
+{
+    outRows = std::min(tileSize_, rows_ - 1 - tileRow * tileSize_) + 1;
+    outColumns = std::min(tileSize_, columns_ - 1 - tileColumn * tileSize_) + 1;
+}
+
+} // namespace static_meshes_3D
@@ -0,0 +1,106 @@
+#pragma once
+
+// STL
+#include <cstdint>
+#include <string>
+
+// Project
+#include "../memoryMappedFile.h"
+
+#include "heightmap.h"
+
+namespace static_meshes_3D {
+
+/**
+ * Height data split into square tiles and stored as 16-bit values in a file, that is memory mapped, so tiles can be read
+ * one by one without loading the whole file. File starts with a header, followed by a tile index (byte offset of every tile)
+ * and tile data. Neighbouring tiles share their border vertices, so every tile can be rendered on its own without gaps.
+ * Tiles at the right and bottom edge are smaller, if the heightmap size isn't a multiple of the tile size.
+ */
+class TiledHeightFile
+{
+public:
+    static const std::string FILE_EXTENSION; // Extension of tiled height files (".tiles")
+
+    /**
+     * Converts heightmap image to tiled height file. Tiles are written one after another, so only one tile is held
+     * in memory besides the image itself.
+     *
+     * @param imageFileName  Heightmap image to convert (see Heightmap::getHeightDataFromImage)
+     * @param fileName       Tiled height file to create
+     * @param tileSize       Number of heightmap quads along one side of a tile
+     * @param repeatCount    How many times is the image repeated along each axis (every other copy is mirrored, so the terrain stays continuous)
+     *
+     * @return True, if the file has been created successfully or false otherwise.
+     */
+    static bool convertFromImage(const std::string& imageFileName, const std::string& fileName, int tileSize, int repeatCount = 1);
+
+    /**
+     * Opens tiled height file (previously opened file is closed first).
+     *
+     * @return True, if the file has been opened and its header and tile index are valid or false otherwise.
+     */
+    bool open(const std::string& fileName);
+
+    /**
+     * Closes the file.
+     */
+    void close();
+
+    /**
+     * Checks, if the file is open.
+     */
+    bool isOpen() const;
+
+    /**
+     * Gets number of rows of the whole heightmap.
+     */
+    int getRows() const;
+
+    /**
+     * Gets number of columns of the whole heightmap.
+     */
+    int getColumns() const;
+
+    /**
+     * Gets number of heightmap quads along one side of a tile.
+     */
+    int getTileSize() const;
+
+    /**
+     * Gets number of rows of tiles.
+     */
+    int getNumTileRows() const;
+
+    /**
+     * Gets number of columns of tiles.
+     */
+    int getNumTileColumns() const;
+
+    /**
+     * Reads height data of one tile. Only the pages of this tile are touched and they're released right afterwards,
+     * so that reading tiles doesn't make the whole file resident over time. Can be called from any thread.
+     *
+     * @param tileRow     Row of the tile
+     * @param tileColumn  Column of the tile
+     *
+     * @return Height data of the tile with values from 0.0 to 1.0 (empty, if the tile doesn't exist).
+     */
+    Heightmap::HeightData readTile(int tileRow, int tileColumn) const;
+
+private:
+    /**
+     * Gets number of rows and columns of vertices of the tile.
+     */
+    void getTileVertexCounts(int tileRow, int tileColumn, int& outRows, int& outColumns) const;
+
+    MemoryMappedFile file_; // Mapped tiled height file
+    const uint64_t* tileOffsets_{ nullptr }; // Byte offsets of all tiles within the file (pointing into the mapped file)
+    int rows_{ 0 }; // Number of rows of the whole heightmap
+    int columns_{ 0 }; // Number of columns of the whole heightmap
+    int tileSize_{ 0 }; // Number of heightmap quads along one side of a tile
+    int numTileRows_{ 0 }; // Number of rows of tiles
+    int numTileColumns_{ 0 }; // Number of columns of tiles
+};
+
+} // namespace static_meshes_3D
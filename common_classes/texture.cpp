@@ -8,6 +8,31 @@
 
 // Project
 #include "texture.h"
+#include "gpuResourceRegistry.h"
+#include "glStateCache.h"
+
+namespace {
+
+/**
+ * Estimates, how many bytes one texel of texture with given format takes in GPU memory.
+ */
+size_t getBytesPerTexel(GLenum format)
+{
+    switch (format)
+    {
+        case GL_RED:
+        case GL_DEPTH_COMPONENT:
+            return 1;
+        case GL_RG:
+            return 2;
+        case GL_RGB:
+            return 3;
+        default:
+            return 4;
+    }
+}
+
+} // namespace
 
 Texture::~Texture()
 {
@@ -25,13 +50,20 @@ bool Texture::createFromData(const unsigned char* data, GLsizei width, GLsizei h
     format_ = format;
 
     glGenTextures(1, &textureID_);
-    glBindTexture(GL_TEXTURE_2D, textureID_);
+    GLStateCache::getInstance().bindTexture2D(0, textureID_);
     glTexImage2D(GL_TEXTURE_2D, 0, format_, width_, height_, 0, format_, GL_UNSIGNED_BYTE, data);
 
     if (generateMipmaps) {
         glGenerateMipmap(GL_TEXTURE_2D);
     }
 
+    // Whole mipmap chain takes approximately one third more memory than the base level
+    auto byteSize = static_cast<size_t>(width_) * height_ * getBytesPerTexel(format_);
+    if (generateMipmaps) {
+        byteSize += byteSize / 3;
+    }
+
+    GPUResourceRegistry::getInstance().registerResource(GPUResourceType::Texture, textureID_, byteSize);
     return true;
 }
 
@@ -69,8 +101,7 @@ void Texture::bind(const GLenum textureUnit) const
         return;
     }
 
-    glActiveTexture(GL_TEXTURE0 + textureUnit);
-    glBindTexture(GL_TEXTURE_2D, textureID_);
+    GLStateCache::getInstance().bindTexture2D(textureUnit, textureID_);
 }
 
 void Texture::deleteTexture()
@@ -79,6 +110,8 @@ void Texture::deleteTexture()
         return;
     }
 
+    GPUResourceRegistry::getInstance().unregisterResource(GPUResourceType::Texture, textureID_);
+    GLStateCache::getInstance().onTextureDeleted(textureID_);
     glDeleteTextures(1, &textureID_);
     textureID_ = 0;
     width_ = height_ = 0;
@@ -7,6 +7,8 @@
 
 // Project
 #include "transformFeedbackParticleSystem.h"
+#include "gpuResourceRegistry.h"
+#include "glStateCache.h"
 #include "shaderManager.h"
 #include "shaderProgramManager.h"
 
@@ -53,7 +55,7 @@ void TransformFeedbackParticleSystem::renderParticles()
     // Prepare rendering and then render from index 1 (at index 0, there is always generator)
     prepareRenderParticles();
 
-    glBindVertexArray(renderVAOs_[readBufferIndex_]);
+    GLStateCache::getInstance().bindVertexArray(renderVAOs_[readBufferIndex_]);
     glDrawArrays(GL_POINTS, 1, numberOfParticles_ - 1);
 }
 
@@ -71,13 +73,14 @@ void TransformFeedbackParticleSystem::updateParticles(const float deltaTime)
     prepareUpdateParticles(deltaTime);
 
     // Bind transform feedback object, VAO for updating particles and tell OpenGL where to store recorded data
+    auto& stateCache = GLStateCache::getInstance();
     glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, transformFeedbackID_);
-    glBindVertexArray(updateVAOs_[readBufferIndex_]);
-    glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, particlesVBOs_[writeBufferIndex]);
+    stateCache.bindVertexArray(updateVAOs_[readBufferIndex_]);
+    stateCache.bindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, particlesVBOs_[writeBufferIndex]);
 
     // Update particles with special update shader program and also observe how many particles have been written
     // Discard rasterization - we don't want to render this, it's only about updating
-    glEnable(GL_RASTERIZER_DISCARD);
+    stateCache.enable(GL_RASTERIZER_DISCARD);
     glBeginQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, numParticlesQueryID_);
     
     glBeginTransformFeedback(GL_POINTS);
@@ -92,7 +95,7 @@ void TransformFeedbackParticleSystem::updateParticles(const float deltaTime)
 
     // Unbind transform feedback and restore normal rendering (don't discard anymore)
     glBindTransformFeedback(GL_TRANSFORM_FEEDBACK, 0);
-    glDisable(GL_RASTERIZER_DISCARD);
+    stateCache.disable(GL_RASTERIZER_DISCARD);
 }
 
 void TransformFeedbackParticleSystem::calculateBillboardingVectors(const glm::vec3 &cameraViewVector, const glm::vec3& cameraUpVector)
@@ -122,10 +125,21 @@ void TransformFeedbackParticleSystem::releaseParticleSystem()
     glDeleteTransformFeedbacks(1, &transformFeedbackID_);
     glDeleteQueries(1, &numParticlesQueryID_);
 
+    auto& stateCache = GLStateCache::getInstance();
+    for (auto i = 0; i < 2; i++)
+    {
+        stateCache.onVertexArrayDeleted(renderVAOs_[i]);
+        stateCache.onVertexArrayDeleted(updateVAOs_[i]);
+    }
     glDeleteVertexArrays(2, renderVAOs_);
     glDeleteVertexArrays(2, updateVAOs_);
 
     std::cout << "Deleting VBOs for particle system with IDs [" << particlesVBOs_[0] << ", " << particlesVBOs_[1] << "]" << std::endl;
+    for (auto i = 0; i < 2; i++)
+    {
+        GPUResourceRegistry::getInstance().unregisterResource(GPUResourceType::TransformFeedbackBuffer, particlesVBOs_[i]);
+        stateCache.onBufferDeleted(particlesVBOs_[i]);
+    }
     glDeleteBuffers(2, particlesVBOs_);
 
     recordedVariables_.clear();
@@ -215,11 +229,13 @@ void TransformFeedbackParticleSystem::generateOpenGLObjects()
     const int32_t initialGeneratorType = PARTICLE_TYPE_GENERATOR;
 
     // Generate two VBOs - one serves as source of data (read buffer) and one is written to (write buffer)
+    GPUResourceRegistry::ScopedTag registryTag("particle_system");
     glGenBuffers(2, particlesVBOs_);
     for (auto i = 0; i < 2; i++)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, particlesVBOs_[i]);
+        GLStateCache::getInstance().bindBuffer(GL_ARRAY_BUFFER, particlesVBOs_[i]);
         glBufferData(GL_ARRAY_BUFFER, bufferByteSize, NULL, GL_DYNAMIC_DRAW);
+        GPUResourceRegistry::getInstance().registerResource(GPUResourceType::TransformFeedbackBuffer, particlesVBOs_[i], bufferByteSize);
         if (i == 0)
         {
             // Initialize first (read buffer) with one particle that is a generator
@@ -234,8 +250,8 @@ void TransformFeedbackParticleSystem::generateOpenGLObjects()
     glGenVertexArrays(2, updateVAOs_);
     for (auto i = 0; i < 2; i++)
     {
-        glBindVertexArray(updateVAOs_[i]);
-        glBindBuffer(GL_ARRAY_BUFFER, particlesVBOs_[i]);
+        GLStateCache::getInstance().bindVertexArray(updateVAOs_[i]);
+        GLStateCache::getInstance().bindBuffer(GL_ARRAY_BUFFER, particlesVBOs_[i]);
 
         GLsizeiptr byteOffset = 0;
         for (size_t j = 0; j < recordedVariables_.size(); j++)
@@ -249,8 +265,8 @@ void TransformFeedbackParticleSystem::generateOpenGLObjects()
     glGenVertexArrays(2, renderVAOs_);
     for (auto i = 0; i < 2; i++)
     {
-        glBindVertexArray(renderVAOs_[i]);
-        glBindBuffer(GL_ARRAY_BUFFER, particlesVBOs_[i]);
+        GLStateCache::getInstance().bindVertexArray(renderVAOs_[i]);
+        GLStateCache::getInstance().bindBuffer(GL_ARRAY_BUFFER, particlesVBOs_[i]);
 
         GLsizeiptr byteOffset = 0;
         for (size_t j = 0; j < recordedVariables_.size(); j++)
@@ -14,6 +14,33 @@ Uniform::Uniform(const std::string& name, ShaderProgram* shaderProgram)
     }
 }
 
+Uniform::Uniform(const std::string& name, ShaderProgram* shaderProgram, GLint location)
+    : name_(name)
+    , shaderProgram_(shaderProgram)
+    , location_(location)
+{
+}
+
+bool Uniform::isResolved() const
+{
+    return shaderProgram_ != nullptr;
+}
+
+bool Uniform::isUploadNeeded(const void* data, const size_t elementSize, const GLsizei count) const
+{
+    if (shaderProgram_ == nullptr) {
+        return true;
+    }
+
+    // Only single values are shadowed, arrays just invalidate shadows of all locations they occupy
+    if (count == 1) {
+        return shaderProgram_->updateUniformShadow(location_, data, elementSize);
+    }
+
+    shaderProgram_->invalidateUniformShadows(location_, count);
+    return true;
+}
+
 Uniform& Uniform::operator=(const glm::vec2& vector2D)
 {
     set(vector2D);
@@ -24,12 +51,16 @@ Uniform& Uniform::operator=(const glm::vec2& vector2D)
 
 void Uniform::set(const glm::vec2& vector2D) const
 {
-    glUniform2fv(location_, 1, reinterpret_cast<const GLfloat*>(&vector2D));
+    if (isUploadNeeded(&vector2D, sizeof(glm::vec2), 1)) {
+        glUniform2fv(location_, 1, reinterpret_cast<const GLfloat*>(&vector2D));
+    }
 }
 
 void Uniform::set(const glm::vec2* vectors2D, GLsizei count) const
 {
-    glUniform2fv(location_, count, reinterpret_cast<const GLfloat*>(vectors2D));
+    if (isUploadNeeded(vectors2D, sizeof(glm::vec2), count)) {
+        glUniform2fv(location_, count, reinterpret_cast<const GLfloat*>(vectors2D));
+    }
 }
 
 // Family of functions setting vec3 uniforms
@@ -42,12 +73,16 @@ Uniform& Uniform::operator=(const glm::vec3& vector3D)
 
 void Uniform::set(const glm::vec3& vector3D) const
 {
-    glUniform3fv(location_, 1, reinterpret_cast<const GLfloat*>(&vector3D));
+    if (isUploadNeeded(&vector3D, sizeof(glm::vec3), 1)) {
+        glUniform3fv(location_, 1, reinterpret_cast<const GLfloat*>(&vector3D));
+    }
 }
 
 void Uniform::set(const glm::vec3* vectors3D, GLsizei count) const
 {
-    glUniform3fv(location_, count, reinterpret_cast<const GLfloat*>(vectors3D));
+    if (isUploadNeeded(vectors3D, sizeof(glm::vec3), count)) {
+        glUniform3fv(location_, count, reinterpret_cast<const GLfloat*>(vectors3D));
+    }
 }
 
 // Family of functions setting vec4 uniforms
@@ -60,12 +95,16 @@ Uniform& Uniform::operator=(const glm::vec4& vector4D)
 
 void Uniform::set(const glm::vec4& vector4D) const
 {
-    glUniform4fv(location_, 1, reinterpret_cast<const GLfloat*>(&vector4D));
+    if (isUploadNeeded(&vector4D, sizeof(glm::vec4), 1)) {
+        glUniform4fv(location_, 1, reinterpret_cast<const GLfloat*>(&vector4D));
+    }
 }
 
 void Uniform::set(const glm::vec4* vectors4D, GLsizei count) const
 {
-    glUniform4fv(location_, count, reinterpret_cast<const GLfloat*>(vectors4D));
+    if (isUploadNeeded(vectors4D, sizeof(glm::vec4), count)) {
+        glUniform4fv(location_, count, reinterpret_cast<const GLfloat*>(vectors4D));
+    }
 }
 
 // Family of functions setting float uniforms
@@ -84,12 +123,16 @@ Uniform& Uniform::operator=(const std::vector<GLfloat>& floatValues)
 
 void Uniform::set(GLfloat floatValue) const
 {
-    glUniform1fv(location_, 1, static_cast<const GLfloat*>(&floatValue));
+    if (isUploadNeeded(&floatValue, sizeof(GLfloat), 1)) {
+        glUniform1fv(location_, 1, static_cast<const GLfloat*>(&floatValue));
+    }
 }
 
 void Uniform::set(const GLfloat* floatValues, GLsizei count) const
 {
-    glUniform1fv(location_, count, floatValues);
+    if (isUploadNeeded(floatValues, sizeof(GLfloat), count)) {
+        glUniform1fv(location_, count, floatValues);
+    }
 }
 
 // Family of functions setting integer uniforms
@@ -102,12 +145,16 @@ Uniform& Uniform::operator=(const GLint integerValue)
 
 void Uniform::set(GLint integerValue) const
 {
-    glUniform1iv(location_, 1, static_cast<const GLint*>(&integerValue));
+    if (isUploadNeeded(&integerValue, sizeof(GLint), 1)) {
+        glUniform1iv(location_, 1, static_cast<const GLint*>(&integerValue));
+    }
 }
 
 void Uniform::set(const GLint* integerValues, GLsizei count) const
 {
-    glUniform1iv(location_, count, integerValues);
+    if (isUploadNeeded(integerValues, sizeof(GLint), count)) {
+        glUniform1iv(location_, count, integerValues);
+    }
 }
 
 // Family of functions setting 3x3 matrices uniforms
@@ -120,12 +167,16 @@ Uniform& Uniform::operator=(const glm::mat3& matrix)
 
 void Uniform::set(const glm::mat3& matrix) const
 {
-    glUniformMatrix3fv(location_, 1, false, reinterpret_cast<const GLfloat*>(&matrix));
+    if (isUploadNeeded(&matrix, sizeof(glm::mat3), 1)) {
+        glUniformMatrix3fv(location_, 1, false, reinterpret_cast<const GLfloat*>(&matrix));
+    }
 }
 
 void Uniform::set(const glm::mat3* matrices, GLsizei count) const
 {
-    glUniformMatrix3fv(location_, count, false, reinterpret_cast<const GLfloat*>(matrices));
+    if (isUploadNeeded(matrices, sizeof(glm::mat3), count)) {
+        glUniformMatrix3fv(location_, count, false, reinterpret_cast<const GLfloat*>(matrices));
+    }
 }
 
 // Family of functions setting 4x4 matrices uniforms
@@ -138,10 +189,14 @@ Uniform& Uniform::operator=(const glm::mat4& matrix)
 
 void Uniform::set(const glm::mat4& matrix) const
 {
-    glUniformMatrix4fv(location_, 1, false, reinterpret_cast<const GLfloat*>(&matrix));
+    if (isUploadNeeded(&matrix, sizeof(glm::mat4), 1)) {
+        glUniformMatrix4fv(location_, 1, false, reinterpret_cast<const GLfloat*>(&matrix));
+    }
 }
 
 void Uniform::set(const glm::mat4* matrices, GLsizei count) const
 {
-    glUniformMatrix4fv(location_, count, false, reinterpret_cast<const GLfloat*>(matrices));
+    if (isUploadNeeded(matrices, sizeof(glm::mat4), count)) {
+        glUniformMatrix4fv(location_, count, false, reinterpret_cast<const GLfloat*>(matrices));
+    }
 }
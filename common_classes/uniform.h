@@ -21,6 +21,12 @@ class Uniform
 public:
     Uniform() = default; // Required to work with ShaderProgram [] operator
     Uniform(const std::string& name, ShaderProgram* shaderProgram);
+    Uniform(const std::string& name, ShaderProgram* shaderProgram, GLint location); // Location has already been resolved
+
+    /**
+     * Checks, if the uniform has been resolved within some shader program (default constructed one has not).
+     */
+    bool isResolved() const;
 
     // Family of functions setting vec2 uniforms
     Uniform& operator=(const glm::vec2& vector2D);
@@ -59,6 +65,15 @@ public:
     void set(const glm::mat4* matrices, GLsizei count = 1) const;
 
 private:
+    /**
+     * Checks, if value has to be uploaded, or if it's the same as the last one sent to the shader program and location.
+     *
+     * @param data         Pointer to the value(s)
+     * @param elementSize  Size of one value in bytes
+     * @param count        Number of values
+     */
+    bool isUploadNeeded(const void* data, size_t elementSize, GLsizei count) const;
+
     std::string name_; // Name of the uniform variable
     ShaderProgram* shaderProgram_{ nullptr }; // Pointer to shader program this uniform belongs to
     GLint location_{ -1 }; // OpenGL assigned uniform location (cached in this variable)
@@ -1,8 +1,11 @@
 // STL
 #include <iostream>
+#include <cstring>
 
 // Project
 #include "uniformBufferObject.h"
+#include "gpuResourceRegistry.h"
+#include "glStateCache.h"
 
 UniformBufferObject::~UniformBufferObject()
 {
@@ -19,14 +22,43 @@ void UniformBufferObject::createUBO(const size_t byteSize, GLenum usageHint)
 
     // Generate buffer ID, bind it immediately and reserve space for it
     glGenBuffers(1, &_bufferID);
-    glBindBuffer(GL_UNIFORM_BUFFER, _bufferID);
+    GLStateCache::getInstance().bindBuffer(GL_UNIFORM_BUFFER, _bufferID);
     glBufferData(GL_UNIFORM_BUFFER, byteSize, NULL, usageHint);
+    GPUResourceRegistry::getInstance().registerResource(GPUResourceType::UniformBuffer, _bufferID, byteSize);
 
     // Mark that the buffer has been created and store its size
     _isBufferCreated = true;
     _byteSize = byteSize;
 }
 
+void UniformBufferObject::createStreamingUBO(const size_t regionByteSize, const size_t numRegions)
+{
+    if (_isBufferCreated)
+    {
+        std::cerr << "This buffer is already created! You need to delete it before re-creating it!" << std::endl;
+        return;
+    }
+
+    // Every chunk bound with glBindBufferRange must start at the offset alignment, so regions are aligned the same way
+    GLint offsetAlignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+    const auto streamingAlignment = offsetAlignment > 0 ? static_cast<size_t>(offsetAlignment) : 256;
+
+    // Generate buffer ID, allocate immutable storage and map it persistently
+    glGenBuffers(1, &_bufferID);
+    GLStateCache::getInstance().bindBuffer(GL_UNIFORM_BUFFER, _bufferID);
+    const auto isMapped = _streamingRing.create(GL_UNIFORM_BUFFER, regionByteSize, numRegions, streamingAlignment);
+    _byteSize = _streamingRing.getTotalSize();
+    GPUResourceRegistry::getInstance().registerResource(GPUResourceType::UniformBuffer, _bufferID, _byteSize);
+    _isBufferCreated = true;
+
+    if (!isMapped)
+    {
+        std::cerr << "Could not persistently map streaming uniform buffer object with ID " << _bufferID << "!" << std::endl;
+        deleteUBO();
+    }
+}
+
 void UniformBufferObject::bindUBO() const
 {
     if (!_isBufferCreated)
@@ -35,7 +67,7 @@ void UniformBufferObject::bindUBO() const
         return;
     }
 
-    glBindBuffer(GL_UNIFORM_BUFFER, _bufferID);
+    GLStateCache::getInstance().bindBuffer(GL_UNIFORM_BUFFER, _bufferID);
 }
 
 void UniformBufferObject::setBufferData(const size_t offset, const void* ptrData, const size_t dataSize)
@@ -61,6 +93,50 @@ void UniformBufferObject::setBufferData(const size_t offset, const void* ptrData
     glBufferSubData(GL_UNIFORM_BUFFER, offset, dataSize, ptrData);
 }
 
+void* UniformBufferObject::reserveStreamingData(const size_t dataSize, size_t& outOffset)
+{
+    if (!_streamingRing.isMapped())
+    {
+        std::cerr << "Could not reserve streaming data because uniform buffer object is not created in streaming mode!" << std::endl;
+        return nullptr;
+    }
+
+    const auto ptrData = _streamingRing.reserve(dataSize, outOffset);
+    if (ptrData == nullptr) {
+        std::cerr << "Could not reserve streaming data because it would overflow the region! Region size: " << _streamingRing.getRegionSize() << ", data size: " << dataSize << std::endl;
+    }
+
+    return ptrData;
+}
+
+void UniformBufferObject::setStreamingData(const GLuint bindingPoint, const void* ptrData, const size_t dataSize)
+{
+    size_t offset = 0;
+    const auto ptrDestination = reserveStreamingData(dataSize, offset);
+    if (ptrDestination == nullptr) {
+        return;
+    }
+
+    memcpy(ptrDestination, ptrData, dataSize);
+    bindBufferRangeToBindingPoint(bindingPoint, offset, dataSize);
+}
+
+void UniformBufferObject::bindBufferRangeToBindingPoint(const GLuint bindingPoint, const size_t offset, const size_t dataSize) const
+{
+    if (!_isBufferCreated)
+    {
+        std::cerr << "Could not bind buffer range to binding point " << bindingPoint << ", because uniform buffer object is not created yet!" << std::endl;
+        return;
+    }
+
+    GLStateCache::getInstance().bindBufferRange(GL_UNIFORM_BUFFER, bindingPoint, _bufferID, offset, dataSize);
+}
+
+void UniformBufferObject::finishStreamingFrame()
+{
+    _streamingRing.finishRegion();
+}
+
 void UniformBufferObject::bindBufferBaseToBindingPoint(const GLuint bindingPoint) const
 {
     if (!_isBufferCreated)
@@ -69,7 +145,7 @@ void UniformBufferObject::bindBufferBaseToBindingPoint(const GLuint bindingPoint
         return;
     }
 
-    glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, _bufferID);
+    GLStateCache::getInstance().bindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, _bufferID);
 }
 
 GLuint UniformBufferObject::getBufferID() const
@@ -84,6 +160,13 @@ void UniformBufferObject::deleteUBO()
     }
 
     std::cout << "Deleting uniform buffer object with ID " << _bufferID << "..." << std::endl;
+    if (_streamingRing.isMapped()) {
+        GLStateCache::getInstance().bindBuffer(GL_UNIFORM_BUFFER, _bufferID);
+    }
+
+    _streamingRing.release(GL_UNIFORM_BUFFER);
+    GPUResourceRegistry::getInstance().unregisterResource(GPUResourceType::UniformBuffer, _bufferID);
+    GLStateCache::getInstance().onBufferDeleted(_bufferID);
     glDeleteBuffers(1, &_bufferID);
     _isBufferCreated = false;
 }
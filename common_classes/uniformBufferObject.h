@@ -3,6 +3,9 @@
 // GLAD
 #include <glad/glad.h>
 
+// Project
+#include "bufferStreamingRing.h"
+
 /**
  * Wraps OpenGL's uniform buffer object to a convenient higher level class.
  */
@@ -18,6 +21,16 @@ public:
      */
 	void createUBO(const size_t byteSize, GLenum usageHint = GL_STREAM_DRAW);
 
+    /**
+     * Creates new UBO in streaming mode. Buffer storage is persistently mapped and split into several regions (ring buffer),
+     * one region is used per frame and guarded by a fence. Data within the region are sub-allocated at the required
+     * GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, so that every chunk can be bound with glBindBufferRange.
+     *
+     * @param regionByteSize  Size of one region in bytes (maximal amount of data streamed within one frame)
+     * @param numRegions      Number of regions in the ring (default is 3, that means triple-buffering)
+     */
+    void createStreamingUBO(const size_t regionByteSize, const size_t numRegions = 3);
+
     /**
      * Binds this uniform buffer object (makes current).
      */
@@ -32,6 +45,41 @@ public:
      */
     void setBufferData(const size_t offset, const void* ptrData, const size_t dataSize);
 
+    /**
+     * Reserves aligned chunk of current streaming region (works in streaming mode only). If the region
+     * is still being read by the GPU, this function waits for it first.
+     *
+     * @param dataSize      Size of data to be written
+     * @param outOffset     Here the byte offset of the chunk within the buffer is returned
+     *
+     * @return Pointer, where caller can write the data directly, or nullptr, if something fails.
+     */
+    void* reserveStreamingData(const size_t dataSize, size_t& outOffset);
+
+    /**
+     * Streams data in one go (e.g. contiguous array of std140 structures) and binds them to the given binding point.
+     *
+     * @param bindingPoint  Binding point to bind the streamed data to
+     * @param ptrData       Pointer to data to be streamed
+     * @param dataSize      Size of data to be streamed
+     */
+    void setStreamingData(const GLuint bindingPoint, const void* ptrData, const size_t dataSize);
+
+    /**
+     * Binds range of the buffer to the given binding point.
+     *
+     * @param bindingPoint  Binding point to bind the range to
+     * @param offset        Byte offset of the range (must respect GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT)
+     * @param dataSize      Size of the range
+     */
+    void bindBufferRangeToBindingPoint(const GLuint bindingPoint, const size_t offset, const size_t dataSize) const;
+
+    /**
+     * Finishes current streaming frame - places a fence after all draw calls that have used the current region
+     * and moves on to the next region. Call this once per frame, after everything has been rendered.
+     */
+    void finishStreamingFrame();
+
     /**
      * Binds buffer base to the given binding point. This means, that the whole buffer
      * from the beginning will represent the data at that binding point.
@@ -55,6 +103,8 @@ private:
     size_t _byteSize; // Holds buffer size in bytes
 
 	bool _isBufferCreated = false; // Flag telling if the buffer is created
+
+    BufferStreamingRing _streamingRing; // Persistently mapped ring of regions aligned to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT (only in streaming mode)
 };
 
 /**
@@ -4,6 +4,8 @@
 
 // Project
 #include "vertexBufferObject.h"
+#include "gpuResourceRegistry.h"
+#include "glStateCache.h"
 
 void VertexBufferObject::createVBO(size_t reserveSizeBytes)
 {
@@ -14,10 +16,42 @@ void VertexBufferObject::createVBO(size_t reserveSizeBytes)
     }
 
     glGenBuffers(1, &bufferID_);
+    GPUResourceRegistry::getInstance().registerResource(GPUResourceType::VertexBuffer, bufferID_);
     rawData_.reserve(reserveSizeBytes > 0 ? reserveSizeBytes : 1024);
     std::cout << "Created vertex buffer object with ID " << bufferID_ << " and initial reserved size " << rawData_.capacity() << " bytes" << std::endl;
 }
 
+bool VertexBufferObject::createStreamingVBO(size_t regionSizeBytes, size_t numRegions, GLenum bufferType)
+{
+    if (isBufferCreated())
+    {
+        std::cerr << "This buffer is already created! You need to delete it before re-creating it!" << std::endl;
+        return false;
+    }
+
+    if (regionSizeBytes == 0 || numRegions == 0)
+    {
+        std::cerr << "Cannot create streaming buffer with zero region size or zero regions!" << std::endl;
+        return false;
+    }
+
+    glGenBuffers(1, &bufferID_);
+    bufferType_ = bufferType;
+    GLStateCache::getInstance().bindBuffer(bufferType_, bufferID_);
+    const auto isMapped = streamingRing_.create(bufferType_, regionSizeBytes, numRegions, STREAMING_ALIGNMENT);
+    GPUResourceRegistry::getInstance().registerResource(GPUResourceType::VertexBuffer, bufferID_, streamingRing_.getTotalSize());
+    if (!isMapped)
+    {
+        std::cerr << "Could not persistently map streaming buffer with ID " << bufferID_ << "!" << std::endl;
+        deleteVBO();
+        return false;
+    }
+
+    uploadedDataSize_ = streamingRing_.getTotalSize();
+    std::cout << "Created streaming vertex buffer object with ID " << bufferID_ << ", " << numRegions << " regions of " << streamingRing_.getRegionSize() << " bytes" << std::endl;
+    return true;
+}
+
 void VertexBufferObject::bindVBO(GLenum bufferType)
 {
     if (!isBufferCreated())
@@ -27,7 +61,7 @@ void VertexBufferObject::bindVBO(GLenum bufferType)
     }
 
     bufferType_ = bufferType;
-    glBindBuffer(bufferType_, bufferID_);
+    GLStateCache::getInstance().bindBuffer(bufferType_, bufferID_);
 }
 
 void VertexBufferObject::addRawData(const void* ptrData, size_t dataSizeBytes, size_t repeat)
@@ -35,26 +69,24 @@ void VertexBufferObject::addRawData(const void* ptrData, size_t dataSizeBytes, s
     const auto bytesToAdd = dataSizeBytes * repeat;
     const auto requiredCapacity = bytesAdded_ + bytesToAdd;
 
-    // If the current capacity isn't sufficient, let's resize the internal vector of raw data
+    // If the current capacity isn't sufficient, let's enlarge the internal vector of raw data
     if (requiredCapacity > rawData_.capacity())
     {
         // Determine new raw data buffer capacity - enlarge by a factor of two until it becomes big enough
-        auto newCapacity = rawData_.capacity() * 2;
+        auto newCapacity = rawData_.capacity() > 0 ? rawData_.capacity() * 2 : 1024;
         while (newCapacity < requiredCapacity) {
             newCapacity *= 2;
         }
 
-        // Reserve new vector with higher capacity (which will replace member rawData_) and copy existing data over
-        std::vector<unsigned char> newRawData;
-        newRawData.reserve(newCapacity);
-        memcpy(newRawData.data(), rawData_.data(), bytesAdded_);
-        rawData_ = std::move(newRawData);
+        // Reserving keeps the already added data in place
+        rawData_.reserve(newCapacity);
     }
 
     // Add the data now that we are sure that capacity is sufficient
+    const auto bytePtr = static_cast<const unsigned char*>(ptrData);
     for (size_t i = 0; i < repeat; i++)
     {
-        memcpy(rawData_.data() + bytesAdded_, ptrData, dataSizeBytes);
+        rawData_.insert(rawData_.end(), bytePtr, bytePtr + dataSizeBytes);
         bytesAdded_ += dataSizeBytes;
     }
 }
@@ -64,6 +96,12 @@ void* VertexBufferObject::getRawDataPointer()
     return rawData_.data();
 }
 
+void VertexBufferObject::discardRawData()
+{
+    std::vector<unsigned char>().swap(rawData_);
+    bytesAdded_ = 0;
+}
+
 void VertexBufferObject::uploadDataToGPU(GLenum usageHint)
 {
     if (!isBufferCreated())
@@ -74,7 +112,11 @@ void VertexBufferObject::uploadDataToGPU(GLenum usageHint)
 
     glBufferData(bufferType_, bytesAdded_, rawData_.data(), usageHint);
     uploadedDataSize_ = bytesAdded_;
+    GPUResourceRegistry::getInstance().updateResourceSize(GPUResourceType::VertexBuffer, bufferID_, uploadedDataSize_);
     bytesAdded_ = 0;
+
+    // Data live in GPU memory now, so release the in-memory copy (clear alone would keep the capacity)
+    std::vector<unsigned char>().swap(rawData_);
 }
 
 void* VertexBufferObject::mapBufferToMemory(GLenum usageHint) const
@@ -100,6 +142,37 @@ void VertexBufferObject::unmapBuffer() const
     glUnmapBuffer(bufferType_);
 }
 
+void* VertexBufferObject::reserveStreamingData(size_t dataSizeBytes, size_t& outByteOffset)
+{
+    if (!isStreaming())
+    {
+        std::cerr << "This buffer has not been created in streaming mode! Call createStreamingVBO first!" << std::endl;
+        return nullptr;
+    }
+
+    const auto ptrData = streamingRing_.reserve(dataSizeBytes, outByteOffset);
+    if (ptrData == nullptr) {
+        std::cerr << "Streaming region of buffer with ID " << bufferID_ << " is too small to hold another " << dataSizeBytes << " bytes!" << std::endl;
+    }
+
+    return ptrData;
+}
+
+void VertexBufferObject::finishStreamingRegion()
+{
+    streamingRing_.finishRegion();
+}
+
+size_t VertexBufferObject::getStreamingRegionBytesLeft() const
+{
+    return streamingRing_.getRegionBytesLeft();
+}
+
+bool VertexBufferObject::isStreaming() const
+{
+    return streamingRing_.isMapped();
+}
+
 GLuint VertexBufferObject::getBufferID() const
 {
     return bufferID_;
@@ -117,6 +190,15 @@ void VertexBufferObject::deleteVBO()
     }
 
     std::cout << "Deleting vertex buffer object with ID " << bufferID_ << "..." << std::endl;
+    if (isStreaming()) {
+        GLStateCache::getInstance().bindBuffer(bufferType_, bufferID_);
+    }
+
+    streamingRing_.release(bufferType_);
+    std::vector<unsigned char>().swap(rawData_);
+
+    GPUResourceRegistry::getInstance().unregisterResource(GPUResourceType::VertexBuffer, bufferID_);
+    GLStateCache::getInstance().onBufferDeleted(bufferID_);
     glDeleteBuffers(1, &bufferID_);
     bufferID_ = 0;
     bytesAdded_ = 0;
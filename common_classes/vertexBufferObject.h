@@ -6,6 +6,9 @@
 // GLAD
 #include <glad/glad.h>
 
+// Project
+#include "bufferStreamingRing.h"
+
 /**
  * Wraps OpenGL's vertex buffer object to a convenient higher level class.
  */
@@ -19,6 +22,19 @@ public:
      */
     void createVBO(size_t reserveSizeBytes = 0);
 
+    /**
+     * Creates a new VBO in streaming mode. Buffer storage is allocated only once, it stays persistently mapped
+     * and it's split into several regions (ring buffer), each of them guarded by a fence. This is intended
+     * for data that are re-specified every frame (HUD quads, debug lines, CPU-simulated particles...).
+     *
+     * @param regionSizeBytes  Size of one region in bytes (maximal amount of data streamed within one frame)
+     * @param numRegions       Number of regions in the ring (default is 3, that means triple-buffering)
+     * @param bufferType       Type of the buffer (usually GL_ARRAY_BUFFER)
+     *
+     * @return True, if the streaming buffer has been created successfully or false otherwise.
+     */
+    bool createStreamingVBO(size_t regionSizeBytes, size_t numRegions = 3, GLenum bufferType = GL_ARRAY_BUFFER);
+
     /**
      * Binds this vertex buffer object (makes current).
      *
@@ -52,8 +68,14 @@ public:
      */
     void* getRawDataPointer();
 
+    /**
+     * Discards gathered in-memory data without uploading them (e.g. when they've been copied somewhere else).
+     */
+    void discardRawData();
+
     /**
      * Uploads gathered data to the GPU memory. Now the VBO is ready to be used.
+     * In-memory copy of the data is released afterwards, as it's not needed anymore.
      *
      * @param usageHint  Hint for OpenGL, how is the data intended to be used (GL_STATIC_DRAW, GL_DYNAMIC_DRAW)
      */
@@ -84,6 +106,33 @@ public:
      */
     void unmapBuffer() const;
 
+    /**
+     * Reserves space for streamed data in the current region of the ring buffer (works in streaming mode only).
+     * If the region is still being read by the GPU, this function waits for it first.
+     *
+     * @param dataSizeBytes  Size of the data that will be written (in bytes)
+     * @param outByteOffset  Here the byte offset within the buffer is returned, use it to draw from (attribute pointers / first vertex)
+     *
+     * @return Pointer, where caller can write the data directly, or nullptr, if something fails.
+     */
+    void* reserveStreamingData(size_t dataSizeBytes, size_t& outByteOffset);
+
+    /**
+     * Finishes current streaming region - places a fence after all draw calls that have used it
+     * and moves on to the next region. Call this once per frame, after streamed data have been rendered.
+     */
+    void finishStreamingRegion();
+
+    /**
+     * Gets how many bytes can still be reserved in the current streaming region (0, if not in streaming mode).
+     */
+    size_t getStreamingRegionBytesLeft() const;
+
+    /**
+     * Checks, if the buffer has been created in streaming mode.
+     */
+    bool isStreaming() const;
+
     /**
      * Gets OpenGL-assigned buffer ID.
      */
@@ -100,6 +149,8 @@ public:
     void deleteVBO();
 
 private:
+    static const size_t STREAMING_ALIGNMENT = 16; // Alignment of streamed data chunks within the buffer (in bytes)
+
     GLuint bufferID_{ 0 }; // OpenGL assigned buffer ID
     GLenum bufferType_{ 0 }; // Buffer type (GL_ARRAY_BUFFER, GL_ELEMENT_BUFFER...)
 
@@ -107,6 +158,8 @@ private:
     size_t bytesAdded_{ 0 }; // Number of bytes added to the buffer so far
     size_t uploadedDataSize_{ 0 }; // Holds buffer data size after uploading to GPU (if it's not null, then data have been uploaded)
 
+    BufferStreamingRing streamingRing_; // Persistently mapped ring of regions (only in streaming mode)
+
     /**
      * Checks if the buffer has been created and has OpenGL-assigned ID.
      */
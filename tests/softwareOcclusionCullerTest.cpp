@@ -0,0 +1,144 @@
+// STL
+#include <algorithm>
+#include <iostream>
+
+// GLM
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+// Project
+#include "../common_classes/softwareOcclusionCuller.h"
+
+namespace {
+
+int numFailedChecks = 0; // Number of checks, that have failed so far
+
+/**
+ * Checks the condition and reports it, if it doesn't hold.
+ */
+void check(const bool condition, const char* description)
+{
+    if (!condition)
+    {
+        std::cout << "FAILED: " << description << std::endl;
+        numFailedChecks++;
+    }
+}
+
+/**
+ * Gets projection and view matrix of camera at the origin looking along negative Z axis.
+ */
+glm::mat4 getProjectionViewMatrix()
+{
+    const auto projectionMatrix = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.5f, 500.0f);
+    const auto viewMatrix = glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    return projectionMatrix * viewMatrix;
+}
+
+/**
+ * Adds square wall of given half size facing the camera at given distance.
+ */
+size_t addWall(SoftwareOcclusionCuller& culler, const float halfSize, const float distance)
+{
+    return culler.addOccluder({ glm::vec3(-halfSize, -halfSize, -distance), glm::vec3(halfSize, -halfSize, -distance),
+        glm::vec3(-halfSize, halfSize, -distance), glm::vec3(halfSize, halfSize, -distance) }, { 0, 1, 2, 2, 1, 3 });
+}
+
+void testResolution()
+{
+    SoftwareOcclusionCuller culler(100, 50);
+    check(culler.getWidth() == 104, "Width is rounded up to the multiple of 8");
+    check(culler.getHeight() == 50, "Height is kept");
+
+    const auto lastLevel = culler.getNumPyramidLevels() - 1;
+    check(culler.getPyramidLevel(0).size() == 104 * 50, "Level 0 has the size of the depth buffer");
+    check(culler.getPyramidLevel(lastLevel).size() == 1, "Last pyramid level has single texel");
+}
+
+void testRasterizer()
+{
+    SoftwareOcclusionCuller culler(64, 32);
+    addWall(culler, 1000.0f, 10.0f);
+    culler.renderOccluders(getProjectionViewMatrix());
+    check(culler.getNumRasterizedTriangles() == 2, "Both triangles of the wall are rasterized");
+
+    // Wall covers the whole screen at the same distance, so every pixel must have the same depth nearer than far plane
+    const auto& depths = culler.getPyramidLevel(0);
+    const auto minMaxDepth = std::minmax_element(depths.begin(), depths.end());
+    check(*minMaxDepth.second < 1.0f, "Wall covering the screen writes every pixel");
+    check(*minMaxDepth.second - *minMaxDepth.first < 1e-4f, "Wall facing the camera has constant depth");
+}
+
+void testDepthPyramid()
+{
+    SoftwareOcclusionCuller culler(64, 32);
+    addWall(culler, 2.0f, 10.0f);
+    culler.renderOccluders(getProjectionViewMatrix());
+
+    // Every texel of the higher level holds the farthest depth of the texels below it
+    auto lowerWidth = culler.getWidth();
+    auto lowerHeight = culler.getHeight();
+    for (auto level = 1; level < culler.getNumPyramidLevels(); level++)
+    {
+        const auto& lowerDepths = culler.getPyramidLevel(level - 1);
+        const auto& depths = culler.getPyramidLevel(level);
+        const auto width = std::max(1, (lowerWidth + 1) / 2);
+        const auto height = std::max(1, (lowerHeight + 1) / 2);
+        check(depths.size() == static_cast<size_t>(width * height), "Pyramid level has half the size of the level below");
+        for (auto y = 0; y < lowerHeight; y++)
+        {
+            for (auto x = 0; x < lowerWidth; x++) {
+                check(lowerDepths[y * lowerWidth + x] <= depths[(y / 2) * width + x / 2], "Pyramid texel is not nearer than texels below it");
+            }
+        }
+
+        lowerWidth = width;
+        lowerHeight = height;
+    }
+
+    const auto& topDepths = culler.getPyramidLevel(culler.getNumPyramidLevels() - 1);
+    check(topDepths[0] == 1.0f, "Small wall doesn't cover the whole screen, so the top of the pyramid is far");
+}
+
+void testAABBVisibility()
+{
+    SoftwareOcclusionCuller culler(128, 72);
+    const auto wallIndex = addWall(culler, 5.0f, 10.0f);
+    culler.renderOccluders(getProjectionViewMatrix());
+    check(!culler.isAABBVisible(AABB::fromCenterAndExtents(glm::vec3(0.0f, 0.0f, -30.0f), glm::vec3(1.0f))), "Box behind the wall is hidden");
+    check(culler.isAABBVisible(AABB::fromCenterAndExtents(glm::vec3(0.0f, 0.0f, -5.0f), glm::vec3(1.0f))), "Box in front of the wall is visible");
+    check(culler.isAABBVisible(AABB::fromCenterAndExtents(glm::vec3(16.0f, 0.0f, -30.0f), glm::vec3(1.0f))), "Box sticking out of the wall is visible");
+    check(culler.isAABBVisible(AABB::fromCenterAndExtents(glm::vec3(0.0f, 0.0f, -0.5f), glm::vec3(1.0f))), "Box crossing the near plane is visible");
+    check(!culler.isAABBVisible(AABB::fromCenterAndExtents(glm::vec3(200.0f, 0.0f, -30.0f), glm::vec3(1.0f))), "Box outside of the screen is not visible");
+
+    // Occluder without model matrices isn't rasterized, more model matrices rasterize it more times
+    culler.setOccluderModelMatrices(wallIndex, {});
+    culler.renderOccluders(getProjectionViewMatrix());
+    check(culler.getNumRasterizedTriangles() == 0, "Occluder without model matrices isn't rasterized");
+    check(culler.isAABBVisible(AABB::fromCenterAndExtents(glm::vec3(0.0f, 0.0f, -30.0f), glm::vec3(1.0f))), "Box is visible without occluders");
+
+    culler.setOccluderModelMatrices(wallIndex, { glm::mat4(1.0f), glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -10.0f)) });
+    culler.renderOccluders(getProjectionViewMatrix());
+    check(culler.getNumRasterizedTriangles() == 4, "Occluder is rasterized once per model matrix");
+    check(!culler.isAABBVisible(AABB::fromCenterAndExtents(glm::vec3(0.0f, 0.0f, -30.0f), glm::vec3(1.0f))), "Box behind the walls is hidden");
+}
+
+} // namespace
+
+int main()
+{
+    std::cout << "Testing software occlusion culler (SIMD instruction set: " << SoftwareOcclusionCuller::getSIMDInstructionSet() << ")..." << std::endl;
+    testResolution();
+    testRasterizer();
+    testDepthPyramid();
+    testAABBVisibility();
+
+    if (numFailedChecks > 0)
+    {
+        std::cout << numFailedChecks << " check(s) failed!" << std::endl;
+        return 1;
+    }
+
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}